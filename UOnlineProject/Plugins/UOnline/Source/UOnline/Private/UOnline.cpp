@@ -1,20 +1,33 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "UOnline.h"
+#include "UOnlineWarmup.h"
 
 #define LOCTEXT_NAMESPACE "FUOnlineModule"
 
 void FUOnlineModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	
+	FUOnlineWarmupOptions WarmupOptions;
+	WarmupOptions.LoadConfig();
+
+	// Only a game on its way to the main menu benefits, and the editor or a server would log in for nothing
+	if (WarmupOptions.bEnabled && !GIsEditor && !IsRunningCommandlet() && !IsRunningDedicatedServer())
+	{
+		Warmup = MakeShareable(new FUOnlineWarmup(WarmupOptions));
+		Warmup->Start();
+	}
 }
 
 void FUOnlineModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	if (Warmup.IsValid())
+	{
+		Warmup->Stop();
+		Warmup.Reset();
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,349 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineAsyncActions.h"
+#include "Runtime/Engine/Classes/Engine/LocalPlayer.h"
+#include "Runtime/Engine/Classes/GameFramework/PlayerController.h"
+#include "Runtime/Engine/Classes/GameFramework/PlayerState.h"
+#include "UOnlineObject.h"
+
+TSharedPtr<const FUniqueNetId> UOnlineAsyncAction::GetUserNetId(APlayerController* arg_PlayerController)
+{
+	if (!arg_PlayerController || !arg_PlayerController->PlayerState)
+	{
+		return nullptr;
+	}
+
+	return arg_PlayerController->PlayerState->UniqueId.GetUniqueNetId();
+}
+
+int32 UOnlineAsyncAction::GetLocalUserNum(APlayerController* arg_PlayerController)
+{
+	const ULocalPlayer* LocalPlayer = arg_PlayerController ? arg_PlayerController->GetLocalPlayer() : nullptr;
+
+	if (!LocalPlayer)
+	{
+		return 0;
+	}
+
+	return LocalPlayer->GetControllerId();
+}
+
+UOnlineCreateSessionAction* UOnlineCreateSessionAction::CreateSession(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, FName SessionName, FName MapName, bool bIsLAN, bool bIsPresence, int32 MaxNumPlayers)
+{
+	UOnlineCreateSessionAction* Action = NewObject<UOnlineCreateSessionAction>();
+	Action->OnlineObject = OnlineObject;
+	Action->PlayerController = PlayerController;
+	Action->SessionName = SessionName;
+	Action->MapName = MapName;
+	Action->bIsLAN = bIsLAN;
+	Action->bIsPresence = bIsPresence;
+	Action->MaxNumPlayers = MaxNumPlayers;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UOnlineCreateSessionAction::Activate()
+{
+	int32 RequestId = FUOnlineRequest::InvalidId;
+
+	if (OnlineObject)
+	{
+		RequestId = OnlineObject->CreateSession(GetUserNetId(PlayerController.Get()), SessionName, MapName, bIsLAN, bIsPresence, MaxNumPlayers, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineCreateSessionAction::OnRequestComplete));
+	}
+
+	if (RequestId == FUOnlineRequest::InvalidId && !bIsDone)
+	{
+		bIsDone = true;
+		OnFailure.Broadcast(SessionName, EUOnlineRequestStatus::Failed);
+		SetReadyToDestroy();
+	}
+}
+
+void UOnlineCreateSessionAction::OnRequestComplete(const FUOnlineRequestResult& arg_Result)
+{
+	if (bIsDone)
+	{
+		return;
+	}
+
+	bIsDone = true;
+
+	if (arg_Result.WasSuccessful())
+	{
+		OnSuccess.Broadcast(arg_Result.SessionName, arg_Result.Status);
+	}
+	else
+	{
+		OnFailure.Broadcast(arg_Result.SessionName, arg_Result.Status);
+	}
+
+	SetReadyToDestroy();
+}
+
+UOnlineFindSessionsAction* UOnlineFindSessionsAction::FindSessions(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, bool bIsLAN, bool bIsPresence, const FUOnlineSessionFilter& Filter)
+{
+	UOnlineFindSessionsAction* Action = NewObject<UOnlineFindSessionsAction>();
+	Action->OnlineObject = OnlineObject;
+	Action->PlayerController = PlayerController;
+	Action->bIsLAN = bIsLAN;
+	Action->bIsPresence = bIsPresence;
+	Action->Filter = Filter;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UOnlineFindSessionsAction::Activate()
+{
+	int32 RequestId = FUOnlineRequest::InvalidId;
+
+	if (OnlineObject)
+	{
+		RequestId = OnlineObject->FindSessions(GetUserNetId(PlayerController.Get()), bIsLAN, bIsPresence, Filter, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineFindSessionsAction::OnRequestComplete));
+	}
+
+	if (RequestId == FUOnlineRequest::InvalidId && !bIsDone)
+	{
+		bIsDone = true;
+		OnFailure.Broadcast(TArray<FBlueprintSessionResult>(), EUOnlineRequestStatus::Failed);
+		SetReadyToDestroy();
+	}
+}
+
+void UOnlineFindSessionsAction::OnRequestComplete(const FUOnlineRequestResult& arg_Result)
+{
+	if (bIsDone)
+	{
+		return;
+	}
+
+	bIsDone = true;
+
+	// The results are only valid during this callback, so they are copied into the pin right away
+	TArray<FBlueprintSessionResult> Results;
+
+	if (arg_Result.SearchResults)
+	{
+		Results.Reserve(arg_Result.SearchResults->Num());
+
+		for (const FOnlineSessionSearchResult& SearchResult : *arg_Result.SearchResults)
+		{
+			FBlueprintSessionResult& Result = Results[Results.AddDefaulted()];
+			Result.OnlineResult = SearchResult;
+		}
+	}
+	else if (arg_Result.CachedResults.IsValid())
+	{
+		Results.SetNum(arg_Result.CachedResults->Num());
+
+		// Blueprint holds full results, so every cached one is read
+		for (int32 ResultIndex = 0; ResultIndex < Results.Num(); ++ResultIndex)
+		{
+			arg_Result.CachedResults->Rehydrate(ResultIndex, Results[ResultIndex].OnlineResult);
+		}
+	}
+
+	if (arg_Result.WasSuccessful())
+	{
+		OnSuccess.Broadcast(Results, arg_Result.Status);
+	}
+	else
+	{
+		OnFailure.Broadcast(Results, arg_Result.Status);
+	}
+
+	SetReadyToDestroy();
+}
+
+UOnlineJoinSessionAction* UOnlineJoinSessionAction::JoinSession(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, FName SessionName, const FBlueprintSessionResult& SearchResult)
+{
+	UOnlineJoinSessionAction* Action = NewObject<UOnlineJoinSessionAction>();
+	Action->OnlineObject = OnlineObject;
+	Action->PlayerController = PlayerController;
+	Action->SessionName = SessionName;
+	Action->SearchResult = SearchResult;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UOnlineJoinSessionAction::Activate()
+{
+	if (!OnlineObject)
+	{
+		bIsDone = true;
+		OnFailure.Broadcast(EUOnlineJoinResult::UnknownError, 0.f);
+		SetReadyToDestroy();
+		return;
+	}
+
+	// Refused joins complete before returning, so there is nothing to check afterwards
+	APlayerController* Controller = PlayerController.Get();
+	OnlineObject->JoinSessionAndTravel(GetUserNetId(Controller), Controller, SessionName, SearchResult.OnlineResult, FOnUOnlineJoinComplete::CreateUObject(this, &UOnlineJoinSessionAction::OnJoinComplete));
+}
+
+void UOnlineJoinSessionAction::OnJoinComplete(const FUOnlineJoinResult& arg_Result)
+{
+	if (bIsDone)
+	{
+		return;
+	}
+
+	bIsDone = true;
+
+	if (arg_Result.WasSuccessful())
+	{
+		OnSuccess.Broadcast(EUOnlineJoinResult::Success, arg_Result.Timings.TotalInMs);
+	}
+	else
+	{
+		OnFailure.Broadcast(ToJoinResult(arg_Result), arg_Result.Timings.TotalInMs);
+	}
+
+	SetReadyToDestroy();
+}
+
+EUOnlineJoinResult UOnlineJoinSessionAction::ToJoinResult(const FUOnlineJoinResult& arg_Result)
+{
+	switch (arg_Result.JoinResult)
+	{
+	case EOnJoinSessionCompleteResult::Success:
+		return arg_Result.bHasTravelled ? EUOnlineJoinResult::Success : EUOnlineJoinResult::CouldNotTravel;
+	case EOnJoinSessionCompleteResult::SessionIsFull:
+		return EUOnlineJoinResult::SessionIsFull;
+	case EOnJoinSessionCompleteResult::SessionDoesNotExist:
+		return EUOnlineJoinResult::SessionDoesNotExist;
+	case EOnJoinSessionCompleteResult::CouldNotRetrieveAddress:
+		return EUOnlineJoinResult::CouldNotRetrieveAddress;
+	case EOnJoinSessionCompleteResult::AlreadyInSession:
+		return EUOnlineJoinResult::AlreadyInSession;
+	default:
+		return EUOnlineJoinResult::UnknownError;
+	}
+}
+
+UOnlineDestroySessionAction* UOnlineDestroySessionAction::DestroySession(UObject* WorldContextObject, UOnlineObject* OnlineObject, FName SessionName)
+{
+	UOnlineDestroySessionAction* Action = NewObject<UOnlineDestroySessionAction>();
+	Action->OnlineObject = OnlineObject;
+	Action->SessionName = SessionName;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UOnlineDestroySessionAction::Activate()
+{
+	int32 RequestId = FUOnlineRequest::InvalidId;
+
+	if (OnlineObject)
+	{
+		RequestId = OnlineObject->DestroySession(SessionName, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineDestroySessionAction::OnRequestComplete));
+	}
+
+	if (RequestId == FUOnlineRequest::InvalidId && !bIsDone)
+	{
+		bIsDone = true;
+		OnFailure.Broadcast(SessionName, EUOnlineRequestStatus::Failed);
+		SetReadyToDestroy();
+	}
+}
+
+void UOnlineDestroySessionAction::OnRequestComplete(const FUOnlineRequestResult& arg_Result)
+{
+	if (bIsDone)
+	{
+		return;
+	}
+
+	bIsDone = true;
+
+	if (arg_Result.WasSuccessful())
+	{
+		OnSuccess.Broadcast(arg_Result.SessionName, arg_Result.Status);
+	}
+	else
+	{
+		OnFailure.Broadcast(arg_Result.SessionName, arg_Result.Status);
+	}
+
+	SetReadyToDestroy();
+}
+
+UOnlineReadFriendsAction* UOnlineReadFriendsAction::ReadFriends(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController)
+{
+	UOnlineReadFriendsAction* Action = NewObject<UOnlineReadFriendsAction>();
+	Action->OnlineObject = OnlineObject;
+	Action->LocalUserNum = GetLocalUserNum(PlayerController);
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UOnlineReadFriendsAction::Activate()
+{
+	if (!OnlineObject)
+	{
+		Finish(false);
+		return;
+	}
+
+	// Bound before reading, some subsystems answer before ReadFriendsList returns
+	OnFriendsListReadHandle = OnlineObject->OnFriendsListRead.AddUObject(this, &UOnlineReadFriendsAction::OnFriendsListRead);
+
+	if (!OnlineObject->ReadFriendsList(LocalUserNum))
+	{
+		Finish(false);
+	}
+}
+
+void UOnlineReadFriendsAction::OnFriendsListRead(int32 arg_LocalUserNum, bool arg_bWasSuccessful)
+{
+	if (arg_LocalUserNum == LocalUserNum)
+	{
+		Finish(arg_bWasSuccessful);
+	}
+}
+
+void UOnlineReadFriendsAction::Finish(bool arg_bWasSuccessful)
+{
+	if (bIsDone)
+	{
+		return;
+	}
+
+	bIsDone = true;
+
+	TArray<FUOnlineBlueprintFriend> Friends;
+
+	if (OnlineObject)
+	{
+		OnlineObject->OnFriendsListRead.Remove(OnFriendsListReadHandle);
+
+		// A failed read still leaves whatever the cache knew before
+		FUOnlineFriendsSnapshotRef FriendsSnapshot = OnlineObject->GetFriendsSnapshot(LocalUserNum);
+		Friends.Reserve(FriendsSnapshot->Num());
+
+		for (const FUOnlineFriendEntry& FriendEntry : *FriendsSnapshot)
+		{
+			FUOnlineBlueprintFriend& Friend = Friends[Friends.AddDefaulted()];
+			Friend.UserId.SetUniqueNetId(FriendEntry.UserId);
+			Friend.DisplayName = FriendEntry.DisplayName;
+			Friend.bIsOnline = FriendEntry.Presence.bIsOnline;
+			Friend.bIsPlayingThisGame = FriendEntry.Presence.bIsPlayingThisGame;
+			Friend.Status = FriendEntry.Presence.Status.StatusStr;
+		}
+	}
+
+	if (arg_bWasSuccessful)
+	{
+		OnSuccess.Broadcast(Friends);
+	}
+	else
+	{
+		OnFailure.Broadcast(Friends);
+	}
+
+	SetReadyToDestroy();
+}
@@ -12,3 +12,40 @@ float UUOnlineBPLibrary::UOnlineSampleFunction(float Param)
 {
 	return -1;
 }
+
+FUOnlineSessionFilter UUOnlineBPLibrary::AddIntSessionFilter(const FUOnlineSessionFilter& Filter, FName Key, EUOnlineSessionFilterOp Op, int32 Value, bool bLocalOnly)
+{
+	FUOnlineSessionFilter NewFilter = Filter;
+
+	return NewFilter.Where(Key, Op, Value, bLocalOnly);
+}
+
+FUOnlineSessionFilter UUOnlineBPLibrary::AddStringSessionFilter(const FUOnlineSessionFilter& Filter, FName Key, EUOnlineSessionFilterOp Op, const FString& Value, bool bLocalOnly)
+{
+	FUOnlineSessionFilter NewFilter = Filter;
+
+	return NewFilter.Where(Key, Op, Value, bLocalOnly);
+}
+
+TArray<FBlueprintSessionResult> UUOnlineBPLibrary::FilterSessionResults(const TArray<FBlueprintSessionResult>& Results, const FUOnlineSessionFilter& Filter)
+{
+	if (Filter.IsEmpty())
+	{
+		return Results;
+	}
+
+	const FUOnlineSessionFilterPredicate SessionFilter(Filter);
+
+	TArray<FBlueprintSessionResult> FilteredResults;
+	FilteredResults.Reserve(Results.Num());
+
+	for (const FBlueprintSessionResult& Result : Results)
+	{
+		if (SessionFilter.Matches(Result.OnlineResult))
+		{
+			FilteredResults.Add(Result);
+		}
+	}
+
+	return FilteredResults;
+}
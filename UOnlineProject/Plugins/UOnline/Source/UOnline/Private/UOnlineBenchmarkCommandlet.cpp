@@ -0,0 +1,378 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineBenchmarkCommandlet.h"
+#include "UOnlineObject.h"
+#include "UOnlineStandInSession.h"
+#include "UOnlineStats.h"
+#include "Containers/Ticker.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUOnlineBenchmark, Log, All);
+
+UOnlineBenchmarkCommandlet::UOnlineBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	OnlineObject = nullptr;
+	SubsystemName = TEXT("Null");
+	Iterations = 50;
+	Concurrency = 8;
+	Timeout = 30.0;
+	LastTickTime = 0.0;
+}
+
+int32 UOnlineBenchmarkCommandlet::Main(const FString& arg_Params)
+{
+	FString SubsystemString = SubsystemName.ToString();
+	FString OutputFilename = FPaths::ProjectSavedDir() / TEXT("Benchmarks/UOnlineBenchmark.json");
+
+	FParse::Value(*arg_Params, TEXT("Subsystem="), SubsystemString);
+	FParse::Value(*arg_Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*arg_Params, TEXT("Concurrency="), Concurrency);
+	FParse::Value(*arg_Params, TEXT("Timeout="), Timeout);
+	FParse::Value(*arg_Params, TEXT("Output="), OutputFilename);
+
+	SubsystemName = FName(*SubsystemString);
+	Iterations = FMath::Max(1, Iterations);
+	Concurrency = FMath::Max(1, Concurrency);
+
+	IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(SubsystemName);
+
+	if (!OnlineSubsystemInterface || !OnlineSubsystemInterface->GetSessionInterface().IsValid() || !OnlineSubsystemInterface->GetIdentityInterface().IsValid())
+	{
+		UE_LOG(LogUOnlineBenchmark, Error, TEXT("Online subsystem %s is not available"), *SubsystemString);
+		return 1;
+	}
+
+	// Sessions only need an id for the host, no login required
+	UserNetId = OnlineSubsystemInterface->GetIdentityInterface()->CreateUniquePlayerId(FGuid::NewGuid().ToString());
+
+	OnlineObject = NewObject<UOnlineObject>(GetTransientPackage());
+	OnlineObject->SetOnlineSubsystemName(SubsystemName);
+
+#if !UE_BUILD_SHIPPING
+	// The subsystem still provides the user id, sessions go to the stand-in
+	if (FParse::Param(*arg_Params, TEXT("StandIn")))
+	{
+		FUOnlineStandInOptions StandInOptions;
+		StandInOptions.ParseCommandLine(*arg_Params);
+
+		OnlineObject->SetSessionInterfaceOverride(MakeShareable(new FUOnlineStandInSession(StandInOptions)));
+
+		UE_LOG(LogUOnlineBenchmark, Display, TEXT("Running against the stand-in session interface"));
+	}
+#endif
+
+	LastTickTime = FPlatformTime::Seconds();
+
+	RunLifecycle();
+	RunThroughput();
+
+	OnlineObject = nullptr;
+
+	if (!WriteReport(OutputFilename))
+	{
+		UE_LOG(LogUOnlineBenchmark, Error, TEXT("Failed to write %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogUOnlineBenchmark, Display, TEXT("Wrote %s"), *OutputFilename);
+
+	for (const TPair<FString, FSamples>& Sample : Samples)
+	{
+		if (Sample.Value.NumFailures > 0)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void UOnlineBenchmarkCommandlet::RunLifecycle()
+{
+	const FName HostSessionName(TEXT("UOnlineBenchmarkHost"));
+	const FName JoinSessionName(TEXT("UOnlineBenchmarkJoin"));
+
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		TSharedRef<FCompletion> Create = MakeShareable(new FCompletion());
+		Track(OnlineObject->CreateSession(UserNetId, HostSessionName, NAME_None, true, false, 4, MakeCompletion(Create)), Create);
+		WaitFor({ Create });
+		AddSample(TEXT("CreateAndStart"), *Create);
+
+		if (Create->bWasSuccessful)
+		{
+			// Every search has to reach the subsystem, a cache hit would only measure the cache
+			OnlineObject->InvalidateSessionCache();
+
+			TSharedRef<FCompletion> Find = MakeShareable(new FCompletion());
+			Track(OnlineObject->FindSessions(UserNetId, true, false, MakeCompletion(Find)), Find);
+			WaitFor({ Find });
+			AddSample(TEXT("Find"), *Find);
+
+			TSharedRef<FCompletion> Join = MakeShareable(new FCompletion());
+
+			if (Find->bWasSuccessful && Find->SearchResults.Num() > 0)
+			{
+				Track(OnlineObject->JoinSession(UserNetId, JoinSessionName, Find->SearchResults[0], MakeCompletion(Join)), Join);
+				WaitFor({ Join });
+			}
+			else
+			{
+				// Nothing to join counts against the join, not the search
+				Join->bIsDone = true;
+			}
+
+			AddSample(TEXT("Join"), *Join);
+
+			if (Join->bWasSuccessful)
+			{
+				TSharedRef<FCompletion> Leave = MakeShareable(new FCompletion());
+				Track(OnlineObject->DestroySession(JoinSessionName, MakeCompletion(Leave)), Leave);
+				WaitFor({ Leave });
+			}
+
+			// Compare with Destroy and CreateAndStart, which is what the next match costs without recycling
+			TSharedRef<FCompletion> Rematch = MakeShareable(new FCompletion());
+			Track(OnlineObject->RecycleSession(UserNetId, HostSessionName, FName(*FString::Printf(TEXT("UOnlineBenchmarkMap%d"), Iteration)), MakeCompletion(Rematch)), Rematch);
+			WaitFor({ Rematch });
+			AddSample(TEXT("Rematch"), *Rematch);
+		}
+
+		TSharedRef<FCompletion> Destroy = MakeShareable(new FCompletion());
+		Track(OnlineObject->DestroySession(HostSessionName, MakeCompletion(Destroy)), Destroy);
+		WaitFor({ Destroy });
+
+		if (Create->bWasSuccessful)
+		{
+			AddSample(TEXT("Destroy"), *Destroy);
+		}
+	}
+}
+
+void UOnlineBenchmarkCommandlet::RunThroughput()
+{
+	TArray<FName> SessionNames;
+
+	for (int32 SessionIndex = 0; SessionIndex < Concurrency; ++SessionIndex)
+	{
+		SessionNames.Add(FName(*FString::Printf(TEXT("UOnlineBenchmark%d"), SessionIndex)));
+	}
+
+	TArray<TSharedRef<FCompletion>> Creates;
+
+	for (const FName& SessionName : SessionNames)
+	{
+		TSharedRef<FCompletion> Create = MakeShareable(new FCompletion());
+		Track(OnlineObject->CreateSession(UserNetId, SessionName, NAME_None, true, false, 4, MakeCompletion(Create)), Create);
+		Creates.Add(Create);
+	}
+
+	WaitFor(Creates);
+	AddThroughput(TEXT("ConcurrentCreateAndStart"), Creates);
+
+	// Two different queries, so the pipeline both merges identical searches and queues different ones
+	OnlineObject->InvalidateSessionCache();
+
+	TArray<TSharedRef<FCompletion>> Finds;
+
+	for (int32 SearchIndex = 0; SearchIndex < Concurrency; ++SearchIndex)
+	{
+		TSharedRef<FCompletion> Find = MakeShareable(new FCompletion());
+		Track(OnlineObject->FindSessions(UserNetId, true, SearchIndex % 2 == 1, MakeCompletion(Find)), Find);
+		Finds.Add(Find);
+	}
+
+	WaitFor(Finds);
+	AddThroughput(TEXT("ConcurrentFind"), Finds);
+
+	TArray<TSharedRef<FCompletion>> Destroys;
+
+	for (const FName& SessionName : SessionNames)
+	{
+		TSharedRef<FCompletion> Destroy = MakeShareable(new FCompletion());
+		Track(OnlineObject->DestroySession(SessionName, MakeCompletion(Destroy)), Destroy);
+		Destroys.Add(Destroy);
+	}
+
+	WaitFor(Destroys);
+	AddThroughput(TEXT("ConcurrentDestroy"), Destroys);
+}
+
+FOnUOnlineRequestComplete UOnlineBenchmarkCommandlet::MakeCompletion(const TSharedRef<FCompletion>& arg_Completion)
+{
+	return FOnUOnlineRequestComplete::CreateLambda([arg_Completion](const FUOnlineRequestResult& arg_Result)
+	{
+		arg_Completion->bIsDone = true;
+		arg_Completion->bWasSuccessful = arg_Result.WasSuccessful();
+		arg_Completion->EndTime = FPlatformTime::Seconds();
+
+		if (arg_Result.SearchResults)
+		{
+			arg_Completion->SearchResults = *arg_Result.SearchResults;
+		}
+		else if (arg_Result.CachedResults.IsValid() && arg_Result.CachedResults->Num() > 0)
+		{
+			// Only the first session is ever joined
+			arg_Completion->SearchResults.SetNum(1);
+			arg_Result.CachedResults->Rehydrate(0, arg_Completion->SearchResults[0]);
+		}
+	});
+}
+
+void UOnlineBenchmarkCommandlet::Track(int32 arg_RequestId, const TSharedRef<FCompletion>& arg_Completion)
+{
+	arg_Completion->RequestId = arg_RequestId;
+
+	// A search served from the cache completes before the id is returned, so only a rejected request is marked here
+	if (arg_RequestId == FUOnlineRequest::InvalidId)
+	{
+		arg_Completion->bIsDone = true;
+		arg_Completion->bWasSuccessful = false;
+	}
+}
+
+bool UOnlineBenchmarkCommandlet::WaitFor(const TArray<TSharedRef<FCompletion>>& arg_Completions)
+{
+	const double Deadline = FPlatformTime::Seconds() + Timeout;
+
+	while (FPlatformTime::Seconds() < Deadline)
+	{
+		bool bAreAllDone = true;
+
+		for (const TSharedRef<FCompletion>& Completion : arg_Completions)
+		{
+			bAreAllDone &= Completion->bIsDone;
+		}
+
+		if (bAreAllDone)
+		{
+			return true;
+		}
+
+		TickOnce();
+	}
+
+	// Whatever is left is reported as failed, cancel it so it doesn't leak into the next phase
+	for (const TSharedRef<FCompletion>& Completion : arg_Completions)
+	{
+		if (!Completion->bIsDone)
+		{
+			OnlineObject->CancelRequest(Completion->RequestId);
+			Completion->bIsDone = true;
+			Completion->bWasSuccessful = false;
+		}
+	}
+
+	UE_LOG(LogUOnlineBenchmark, Warning, TEXT("Requests didn't finish within %.1f seconds"), Timeout);
+
+	return false;
+}
+
+void UOnlineBenchmarkCommandlet::TickOnce()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	FTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTickTime));
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+	LastTickTime = Now;
+
+	// Yield without adding a whole frame to every round trip
+	FPlatformProcess::Sleep(0.001f);
+}
+
+void UOnlineBenchmarkCommandlet::AddSample(const FString& arg_Name, const FCompletion& arg_Completion)
+{
+	if (!Samples.Contains(arg_Name))
+	{
+		SampleNames.Add(arg_Name);
+	}
+
+	FSamples& NamedSamples = Samples.FindOrAdd(arg_Name);
+
+	if (arg_Completion.bWasSuccessful)
+	{
+		NamedSamples.Milliseconds.Add((arg_Completion.EndTime - arg_Completion.StartTime) * 1000.0);
+	}
+	else
+	{
+		++NamedSamples.NumFailures;
+	}
+}
+
+void UOnlineBenchmarkCommandlet::AddThroughput(const FString& arg_Name, const TArray<TSharedRef<FCompletion>>& arg_Completions)
+{
+	double StartTime = TNumericLimits<double>::Max();
+	double EndTime = 0.0;
+	int32 NumSuccessful = 0;
+
+	for (const TSharedRef<FCompletion>& Completion : arg_Completions)
+	{
+		AddSample(arg_Name, *Completion);
+
+		StartTime = FMath::Min(StartTime, Completion->StartTime);
+
+		if (Completion->bWasSuccessful)
+		{
+			EndTime = FMath::Max(EndTime, Completion->EndTime);
+			++NumSuccessful;
+		}
+	}
+
+	const double Duration = EndTime - StartTime;
+
+	ThroughputNames.Add(arg_Name);
+	Throughput.Add(arg_Name, NumSuccessful > 0 && Duration > 0.0 ? NumSuccessful / Duration : 0.0);
+}
+
+bool UOnlineBenchmarkCommandlet::WriteReport(const FString& arg_Filename) const
+{
+	FString Report;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Subsystem"), SubsystemName.ToString());
+	Writer->WriteValue(TEXT("Iterations"), Iterations);
+	Writer->WriteValue(TEXT("Concurrency"), Concurrency);
+
+	Writer->WriteObjectStart(TEXT("LatencyInMs"));
+
+	for (const FString& SampleName : SampleNames)
+	{
+		const FSamples& NamedSamples = Samples.FindChecked(SampleName);
+		const FUOnlineSampleSummary Latency(NamedSamples.Milliseconds);
+
+		Writer->WriteObjectStart(SampleName);
+		Writer->WriteValue(TEXT("Count"), Latency.GetCount());
+		Writer->WriteValue(TEXT("Failures"), NamedSamples.NumFailures);
+		Writer->WriteValue(TEXT("Mean"), Latency.GetMean());
+		Latency.WritePercentiles(*Writer, { 0.0, 50.0, 90.0, 99.0, 100.0 });
+		Writer->WriteObjectEnd();
+
+		UE_LOG(LogUOnlineBenchmark, Display, TEXT("%s: %d samples, %d failures, p50 %.2f ms, p99 %.2f ms"), *SampleName, Latency.GetCount(), NamedSamples.NumFailures, Latency.GetPercentile(50.0), Latency.GetPercentile(99.0));
+	}
+
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("RequestsPerSecond"));
+
+	for (const FString& ThroughputName : ThroughputNames)
+	{
+		Writer->WriteValue(ThroughputName, Throughput.FindChecked(ThroughputName));
+	}
+
+	Writer->WriteObjectEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return FFileHelper::SaveStringToFile(Report, *arg_Filename);
+}
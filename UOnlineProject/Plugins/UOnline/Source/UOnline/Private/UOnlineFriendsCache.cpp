@@ -0,0 +1,312 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineFriendsCache.h"
+
+FUOnlineFriendsCache::FUOnlineFriendsCache() : MaxFriendsPerUser(5000)
+{
+
+}
+
+void FUOnlineFriendsCache::SetMaxFriendsPerUser(int32 arg_MaxFriendsPerUser)
+{
+	MaxFriendsPerUser = FMath::Max(1, arg_MaxFriendsPerUser);
+}
+
+void FUOnlineFriendsCache::SetLocalUserId(int32 arg_LocalUserNum, const FUniqueNetId& arg_LocalUserId)
+{
+	Users.FindOrAdd(arg_LocalUserNum).LocalUserId = arg_LocalUserId.ToString();
+}
+
+int32 FUOnlineFriendsCache::FindLocalUserNum(const FUniqueNetId& arg_LocalUserId) const
+{
+	const FString LocalUserId = arg_LocalUserId.ToString();
+
+	for (const TPair<int32, FUserFriends>& User : Users)
+	{
+		if (User.Value.LocalUserId == LocalUserId)
+		{
+			return User.Key;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+bool FUOnlineFriendsCache::ApplyFriendsList(int32 arg_LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& arg_Friends)
+{
+	BeginFriendsList(arg_LocalUserNum, arg_Friends);
+
+	bool bHasChanged = false;
+	ContinueFriendsList(arg_LocalUserNum, MAX_int32, bHasChanged);
+
+	return bHasChanged;
+}
+
+void FUOnlineFriendsCache::BeginFriendsList(int32 arg_LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& arg_Friends)
+{
+	TSharedRef<FPendingFriendsList> PendingList = MakeShareable(new FPendingFriendsList());
+
+	// Over the limit, keep the friends that are online since those are the ones the UI asks about
+	if (arg_Friends.Num() > MaxFriendsPerUser)
+	{
+		PendingList->Friends.Reserve(MaxFriendsPerUser);
+
+		for (const TSharedRef<FOnlineFriend>& Friend : arg_Friends)
+		{
+			if (PendingList->Friends.Num() < MaxFriendsPerUser && Friend->GetPresence().bIsOnline)
+			{
+				PendingList->Friends.Add(Friend);
+			}
+		}
+
+		for (const TSharedRef<FOnlineFriend>& Friend : arg_Friends)
+		{
+			if (PendingList->Friends.Num() < MaxFriendsPerUser && !Friend->GetPresence().bIsOnline)
+			{
+				PendingList->Friends.Add(Friend);
+			}
+		}
+	}
+	else
+	{
+		PendingList->Friends = arg_Friends;
+	}
+
+	PendingList->UserIds.Reserve(PendingList->Friends.Num());
+
+	Users.FindOrAdd(arg_LocalUserNum).PendingList = PendingList;
+}
+
+bool FUOnlineFriendsCache::ContinueFriendsList(int32 arg_LocalUserNum, int32 arg_MaxFriends, bool& arg_OutbHasChanged)
+{
+	arg_OutbHasChanged = false;
+
+	FUserFriends* UserFriends = Users.Find(arg_LocalUserNum);
+
+	if (!UserFriends || !UserFriends->PendingList.IsValid())
+	{
+		return true;
+	}
+
+	FPendingFriendsList& PendingList = *UserFriends->PendingList;
+	int32 NumSteps = 0;
+
+	if (PendingList.Step == FPendingFriendsList::EStep::CollectUserIds)
+	{
+		for (; PendingList.NextIndex < PendingList.Friends.Num() && NumSteps < arg_MaxFriends; ++PendingList.NextIndex, ++NumSteps)
+		{
+			PendingList.UserIds.Add(PendingList.Friends[PendingList.NextIndex]->GetUserId()->ToString());
+		}
+
+		if (PendingList.NextIndex < PendingList.Friends.Num())
+		{
+			return false;
+		}
+
+		PendingList.Step = FPendingFriendsList::EStep::Remove;
+		PendingList.NextIndex = UserFriends->Friends.Num() - 1;
+	}
+
+	// Remove first so the list never goes over the limit while adding
+	if (PendingList.Step == FPendingFriendsList::EStep::Remove)
+	{
+		// Friends may have been removed by events between two slices
+		PendingList.NextIndex = FMath::Min(PendingList.NextIndex, UserFriends->Friends.Num() - 1);
+
+		for (; PendingList.NextIndex >= 0 && NumSteps < arg_MaxFriends; --PendingList.NextIndex, ++NumSteps)
+		{
+			if (!PendingList.UserIds.Contains(UserFriends->Friends[PendingList.NextIndex].UserId->ToString()))
+			{
+				PendingList.bHasChanged |= RemoveAt(*UserFriends, PendingList.NextIndex);
+			}
+		}
+
+		if (PendingList.NextIndex >= 0)
+		{
+			return false;
+		}
+
+		PendingList.Step = FPendingFriendsList::EStep::AddOrUpdate;
+		PendingList.NextIndex = 0;
+	}
+
+	for (; PendingList.NextIndex < PendingList.Friends.Num() && NumSteps < arg_MaxFriends; ++PendingList.NextIndex, ++NumSteps)
+	{
+		PendingList.bHasChanged |= AddOrUpdate(*UserFriends, *PendingList.Friends[PendingList.NextIndex]);
+	}
+
+	if (PendingList.NextIndex < PendingList.Friends.Num())
+	{
+		return false;
+	}
+
+	arg_OutbHasChanged = PendingList.bHasChanged;
+	UserFriends->PendingList.Reset();
+
+	return true;
+}
+
+bool FUOnlineFriendsCache::UpdateFriend(int32 arg_LocalUserNum, const FOnlineFriend& arg_Friend)
+{
+	return AddOrUpdate(Users.FindOrAdd(arg_LocalUserNum), arg_Friend);
+}
+
+bool FUOnlineFriendsCache::RemoveFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_FriendId)
+{
+	FUserFriends* UserFriends = Users.Find(arg_LocalUserNum);
+
+	if (!UserFriends)
+	{
+		return false;
+	}
+
+	const int32* FriendIndex = UserFriends->IndexByUserId.Find(arg_FriendId.ToString());
+
+	return FriendIndex && RemoveAt(*UserFriends, *FriendIndex);
+}
+
+void FUOnlineFriendsCache::UpdatePresence(const FUniqueNetId& arg_UserId, const FOnlineUserPresence& arg_Presence, TArray<int32>& arg_OutLocalUserNums)
+{
+	arg_OutLocalUserNums.Reset();
+
+	const FString UserId = arg_UserId.ToString();
+
+	for (TPair<int32, FUserFriends>& User : Users)
+	{
+		const int32* FriendIndex = User.Value.IndexByUserId.Find(UserId);
+
+		if (FriendIndex)
+		{
+			FUOnlineFriendEntry& FriendEntry = User.Value.Friends[*FriendIndex];
+
+			if (!IsSamePresence(FriendEntry.Presence, arg_Presence))
+			{
+				FriendEntry.Presence = arg_Presence;
+				User.Value.bIsSnapshotDirty = true;
+				arg_OutLocalUserNums.Add(User.Key);
+			}
+		}
+	}
+}
+
+const FUOnlineFriendEntry* FUOnlineFriendsCache::FindFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const
+{
+	const FUserFriends* UserFriends = Users.Find(arg_LocalUserNum);
+
+	if (UserFriends)
+	{
+		const int32* FriendIndex = UserFriends->IndexByUserId.Find(arg_UserId.ToString());
+
+		if (FriendIndex)
+		{
+			return &UserFriends->Friends[*FriendIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+bool FUOnlineFriendsCache::IsFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const
+{
+	return FindFriend(arg_LocalUserNum, arg_UserId) != nullptr;
+}
+
+FUOnlineFriendsSnapshotRef FUOnlineFriendsCache::GetSnapshot(int32 arg_LocalUserNum) const
+{
+	FUserFriends* UserFriends = Users.Find(arg_LocalUserNum);
+
+	if (!UserFriends)
+	{
+		static const FUOnlineFriendsSnapshotRef EmptySnapshot = MakeShareable(new TArray<FUOnlineFriendEntry>());
+		return EmptySnapshot;
+	}
+
+	// Asked every frame by the UI, so only copy when something changed
+	if (UserFriends->bIsSnapshotDirty || !UserFriends->Snapshot.IsValid())
+	{
+		UserFriends->Snapshot = MakeShareable(new TArray<FUOnlineFriendEntry>(UserFriends->Friends));
+		UserFriends->bIsSnapshotDirty = false;
+	}
+
+	return UserFriends->Snapshot.ToSharedRef();
+}
+
+int32 FUOnlineFriendsCache::NumFriends(int32 arg_LocalUserNum) const
+{
+	const FUserFriends* UserFriends = Users.Find(arg_LocalUserNum);
+
+	return UserFriends ? UserFriends->Friends.Num() : 0;
+}
+
+void FUOnlineFriendsCache::ResetUser(int32 arg_LocalUserNum)
+{
+	Users.Remove(arg_LocalUserNum);
+}
+
+bool FUOnlineFriendsCache::AddOrUpdate(FUserFriends& arg_UserFriends, const FOnlineFriend& arg_Friend)
+{
+	const FString UserId = arg_Friend.GetUserId()->ToString();
+	const int32* FriendIndex = arg_UserFriends.IndexByUserId.Find(UserId);
+
+	if (FriendIndex)
+	{
+		FUOnlineFriendEntry& FriendEntry = arg_UserFriends.Friends[*FriendIndex];
+		const FString DisplayName = arg_Friend.GetDisplayName();
+
+		if (FriendEntry.DisplayName == DisplayName && FriendEntry.InviteStatus == arg_Friend.GetInviteStatus() && IsSamePresence(FriendEntry.Presence, arg_Friend.GetPresence()))
+		{
+			return false;
+		}
+
+		FriendEntry.DisplayName = DisplayName;
+		FriendEntry.InviteStatus = arg_Friend.GetInviteStatus();
+		FriendEntry.Presence = arg_Friend.GetPresence();
+	}
+	else
+	{
+		if (arg_UserFriends.Friends.Num() >= MaxFriendsPerUser)
+		{
+			return false;
+		}
+
+		arg_UserFriends.IndexByUserId.Add(UserId, arg_UserFriends.Friends.Num());
+		arg_UserFriends.Friends.Emplace(arg_Friend);
+	}
+
+	arg_UserFriends.bIsSnapshotDirty = true;
+
+	return true;
+}
+
+bool FUOnlineFriendsCache::RemoveAt(FUserFriends& arg_UserFriends, int32 arg_FriendIndex)
+{
+	if (!arg_UserFriends.Friends.IsValidIndex(arg_FriendIndex))
+	{
+		return false;
+	}
+
+	arg_UserFriends.IndexByUserId.Remove(arg_UserFriends.Friends[arg_FriendIndex].UserId->ToString());
+
+	// Swap the last friend into the hole so removal stays constant time, its index has to follow
+	const int32 LastFriendIndex = arg_UserFriends.Friends.Num() - 1;
+
+	if (arg_FriendIndex != LastFriendIndex)
+	{
+		arg_UserFriends.IndexByUserId.Add(arg_UserFriends.Friends[LastFriendIndex].UserId->ToString(), arg_FriendIndex);
+	}
+
+	arg_UserFriends.Friends.RemoveAtSwap(arg_FriendIndex, 1, false);
+	arg_UserFriends.bIsSnapshotDirty = true;
+
+	return true;
+}
+
+bool FUOnlineFriendsCache::IsSamePresence(const FOnlineUserPresence& arg_PresenceA, const FOnlineUserPresence& arg_PresenceB)
+{
+	return arg_PresenceA.bIsOnline == arg_PresenceB.bIsOnline
+		&& arg_PresenceA.bIsPlaying == arg_PresenceB.bIsPlaying
+		&& arg_PresenceA.bIsPlayingThisGame == arg_PresenceB.bIsPlayingThisGame
+		&& arg_PresenceA.bIsJoinable == arg_PresenceB.bIsJoinable
+		&& arg_PresenceA.Status.State == arg_PresenceB.Status.State
+		&& arg_PresenceA.Status.StatusStr == arg_PresenceB.Status.StatusStr;
+}
@@ -0,0 +1,132 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineJoinPipeline.h"
+
+FUOnlineConnectStringCache::FUOnlineConnectStringCache() : TimeToLive(30.0), MaxEntries(64)
+{
+
+}
+
+void FUOnlineConnectStringCache::SetLimits(double arg_TimeToLive, int32 arg_MaxEntries)
+{
+	TimeToLive = FMath::Max(0.0, arg_TimeToLive);
+	MaxEntries = FMath::Max(0, arg_MaxEntries);
+}
+
+int32 FUOnlineConnectStringCache::Prefetch(const IOnlineSessionPtr& arg_SessionInterface, const TArray<FOnlineSessionSearchResult>& arg_SearchResults, int32 arg_MaxSessions, double arg_Now)
+{
+	if (!arg_SessionInterface.IsValid() || arg_MaxSessions <= 0 || MaxEntries == 0)
+	{
+		return 0;
+	}
+
+	TArray<int32> CandidateIndices;
+	SelectCandidates(arg_SearchResults, FMath::Min(arg_MaxSessions, MaxEntries), CandidateIndices);
+
+	return Prefetch(arg_SessionInterface, arg_SearchResults, CandidateIndices, arg_Now);
+}
+
+int32 FUOnlineConnectStringCache::Prefetch(const IOnlineSessionPtr& arg_SessionInterface, const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const TArray<int32>& arg_CandidateIndices, double arg_Now)
+{
+	if (!arg_SessionInterface.IsValid() || MaxEntries == 0)
+	{
+		return 0;
+	}
+
+	const int32 NumCandidates = FMath::Min(arg_CandidateIndices.Num(), MaxEntries);
+
+	// Make room, stale entries go first and if that's not enough we start over
+	if (Entries.Num() + NumCandidates > MaxEntries)
+	{
+		for (TMap<FString, FEntry>::TIterator Entry = Entries.CreateIterator(); Entry; ++Entry)
+		{
+			if (arg_Now - Entry.Value().ResolveTime > TimeToLive)
+			{
+				Entry.RemoveCurrent();
+			}
+		}
+
+		if (Entries.Num() + NumCandidates > MaxEntries)
+		{
+			Entries.Reset();
+		}
+	}
+
+	int32 NumResolved = 0;
+
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (!arg_SearchResults.IsValidIndex(arg_CandidateIndices[CandidateIndex]))
+		{
+			continue;
+		}
+
+		const FOnlineSessionSearchResult& SearchResult = arg_SearchResults[arg_CandidateIndices[CandidateIndex]];
+
+		FEntry Entry;
+		Entry.ResolveTime = arg_Now;
+
+		if (arg_SessionInterface->GetResolvedConnectString(SearchResult, NAME_GamePort, Entry.ConnectString))
+		{
+			Entries.Add(SearchResult.GetSessionIdStr(), MoveTemp(Entry));
+			++NumResolved;
+		}
+	}
+
+	return NumResolved;
+}
+
+void FUOnlineConnectStringCache::SelectCandidates(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, int32 arg_MaxSessions, TArray<int32>& arg_OutCandidateIndices)
+{
+	arg_OutCandidateIndices.Reset();
+
+	if (arg_MaxSessions <= 0)
+	{
+		return;
+	}
+
+	// The closest sessions that have room are the ones a player is going to pick
+	arg_OutCandidateIndices.Reserve(arg_SearchResults.Num());
+
+	for (int32 ResultIndex = 0; ResultIndex < arg_SearchResults.Num(); ++ResultIndex)
+	{
+		const FOnlineSessionSearchResult& SearchResult = arg_SearchResults[ResultIndex];
+
+		if (SearchResult.IsValid() && SearchResult.Session.NumOpenPublicConnections > 0)
+		{
+			arg_OutCandidateIndices.Add(ResultIndex);
+		}
+	}
+
+	arg_OutCandidateIndices.Sort([&arg_SearchResults](int32 arg_IndexA, int32 arg_IndexB)
+	{
+		return arg_SearchResults[arg_IndexA].PingInMs < arg_SearchResults[arg_IndexB].PingInMs;
+	});
+
+	if (arg_OutCandidateIndices.Num() > arg_MaxSessions)
+	{
+		arg_OutCandidateIndices.SetNum(arg_MaxSessions, false);
+	}
+}
+
+const FString* FUOnlineConnectStringCache::Find(const FOnlineSessionSearchResult& arg_SearchResult, double arg_Now) const
+{
+	if (!arg_SearchResult.IsValid())
+	{
+		return nullptr;
+	}
+
+	const FEntry* Entry = Entries.Find(arg_SearchResult.GetSessionIdStr());
+
+	if (!Entry || arg_Now - Entry->ResolveTime > TimeToLive)
+	{
+		return nullptr;
+	}
+
+	return &Entry->ConnectString;
+}
+
+void FUOnlineConnectStringCache::Empty()
+{
+	Entries.Empty();
+}
@@ -0,0 +1,907 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineLanBeacon.h"
+#include "Containers/Ticker.h"
+#include "UOnlineLanTransport.h"
+#include "UOnlineStats.h"
+
+namespace UOnlineLanBeacon
+{
+	// "UO" on the wire
+	static const uint16 Magic = 0x4F55;
+	static const uint8 Version = 1;
+
+	// Magic, version, type, protocol id, nonce
+	static const int32 HeaderSize = 12;
+
+	// Longer names are cut, a packet always fits in one datagram
+	static const int32 MaxStringBytes = 64;
+
+	static void WriteUInt8(TArray<uint8>& arg_OutPacket, uint8 arg_Value)
+	{
+		arg_OutPacket.Add(arg_Value);
+	}
+
+	static void WriteUInt16(TArray<uint8>& arg_OutPacket, uint16 arg_Value)
+	{
+		arg_OutPacket.Add(arg_Value & 0xFF);
+		arg_OutPacket.Add(arg_Value >> 8);
+	}
+
+	static void WriteUInt32(TArray<uint8>& arg_OutPacket, uint32 arg_Value)
+	{
+		for (int32 ByteIndex = 0; ByteIndex < 4; ++ByteIndex)
+		{
+			arg_OutPacket.Add((arg_Value >> (ByteIndex * 8)) & 0xFF);
+		}
+	}
+
+	// 7 bits per byte, small numbers take a single byte
+	static void WriteVarUInt(TArray<uint8>& arg_OutPacket, uint32 arg_Value)
+	{
+		while (arg_Value >= 0x80)
+		{
+			arg_OutPacket.Add((arg_Value & 0x7F) | 0x80);
+			arg_Value >>= 7;
+		}
+
+		arg_OutPacket.Add(static_cast<uint8>(arg_Value));
+	}
+
+	static void WriteString(TArray<uint8>& arg_OutPacket, const FString& arg_Value)
+	{
+		FTCHARToUTF8 Utf8(*arg_Value);
+		int32 Length = FMath::Min(Utf8.Length(), MaxStringBytes);
+
+		// Never cut in the middle of a character
+		if (Length < Utf8.Length())
+		{
+			while (Length > 0 && (static_cast<uint8>(Utf8.Get()[Length]) & 0xC0) == 0x80)
+			{
+				--Length;
+			}
+		}
+
+		WriteVarUInt(arg_OutPacket, Length);
+		arg_OutPacket.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+	}
+
+	static bool ReadUInt8(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, uint8& arg_OutValue)
+	{
+		if (arg_InOutOffset + 1 > arg_Packet.Num())
+		{
+			return false;
+		}
+
+		arg_OutValue = arg_Packet[arg_InOutOffset++];
+
+		return true;
+	}
+
+	static bool ReadUInt16(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, uint16& arg_OutValue)
+	{
+		if (arg_InOutOffset + 2 > arg_Packet.Num())
+		{
+			return false;
+		}
+
+		arg_OutValue = arg_Packet[arg_InOutOffset] | (arg_Packet[arg_InOutOffset + 1] << 8);
+		arg_InOutOffset += 2;
+
+		return true;
+	}
+
+	static bool ReadUInt32(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, uint32& arg_OutValue)
+	{
+		if (arg_InOutOffset + 4 > arg_Packet.Num())
+		{
+			return false;
+		}
+
+		arg_OutValue = 0;
+
+		for (int32 ByteIndex = 0; ByteIndex < 4; ++ByteIndex)
+		{
+			arg_OutValue |= static_cast<uint32>(arg_Packet[arg_InOutOffset + ByteIndex]) << (ByteIndex * 8);
+		}
+
+		arg_InOutOffset += 4;
+
+		return true;
+	}
+
+	static bool ReadVarUInt(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, uint32& arg_OutValue)
+	{
+		arg_OutValue = 0;
+
+		// 5 bytes hold 32 bits
+		for (int32 Shift = 0; Shift < 35; Shift += 7)
+		{
+			uint8 Byte = 0;
+
+			if (!ReadUInt8(arg_Packet, arg_InOutOffset, Byte))
+			{
+				return false;
+			}
+
+			arg_OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static bool ReadString(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, FString& arg_OutValue)
+	{
+		uint32 Length = 0;
+
+		if (!ReadVarUInt(arg_Packet, arg_InOutOffset, Length) || Length > static_cast<uint32>(MaxStringBytes) || arg_InOutOffset + static_cast<int32>(Length) > arg_Packet.Num())
+		{
+			return false;
+		}
+
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(arg_Packet.GetData() + arg_InOutOffset), Length);
+		arg_OutValue = FString(Converted.Length(), Converted.Get());
+		arg_InOutOffset += Length;
+
+		return true;
+	}
+}
+
+FUOnlineLanBeaconSession FUOnlineLanBeaconSession::FromNamedSession(const FNamedOnlineSession& arg_NamedSession, int32 arg_Port)
+{
+	FUOnlineLanBeaconSession Session;
+
+	Session.SessionId = arg_NamedSession.SessionInfo.IsValid() && arg_NamedSession.SessionInfo->IsValid() ? arg_NamedSession.SessionInfo->GetSessionId().ToString() : arg_NamedSession.SessionName.ToString();
+	Session.OwnerName = arg_NamedSession.OwningUserName;
+	Session.MaxPlayers = arg_NamedSession.SessionSettings.NumPublicConnections;
+	Session.NumPlayers = FMath::Max(0, Session.MaxPlayers - arg_NamedSession.NumOpenPublicConnections);
+	Session.Port = arg_Port;
+
+	arg_NamedSession.SessionSettings.Get(SETTING_MAPNAME, Session.MapName);
+	arg_NamedSession.SessionSettings.Get(SETTING_GAMEMODE, Session.GameMode);
+
+	return Session;
+}
+
+FOnlineSessionSearchResult FUOnlineLanBeaconSession::ToSearchResult() const
+{
+	FOnlineSessionSearchResult SearchResult;
+	SearchResult.PingInMs = PingInMs;
+
+	FOnlineSession& Session = SearchResult.Session;
+	Session.OwningUserName = OwnerName;
+	Session.SessionInfo = MakeShareable(new FUOnlineLanBeaconSessionInfo(SessionId, GetConnectString()));
+	Session.NumOpenPublicConnections = FMath::Max(0, MaxPlayers - NumPlayers);
+	Session.NumOpenPrivateConnections = 0;
+
+	FOnlineSessionSettings& SessionSettings = Session.SessionSettings;
+	SessionSettings.NumPublicConnections = MaxPlayers;
+	SessionSettings.NumPrivateConnections = 0;
+	SessionSettings.bIsLANMatch = true;
+	SessionSettings.bShouldAdvertise = true;
+
+	if (!MapName.IsEmpty())
+	{
+		SessionSettings.Set(SETTING_MAPNAME, MapName, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+
+	if (!GameMode.IsEmpty())
+	{
+		SessionSettings.Set(SETTING_GAMEMODE, GameMode, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+
+	return SearchResult;
+}
+
+FString FUOnlineLanBeaconSession::GetConnectString() const
+{
+	FString Host = HostAddress;
+
+	// The address the host answered from has the port of its beacon, clients connect to the game port
+	HostAddress.Split(TEXT(":"), &Host, nullptr, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+
+	return FString::Printf(TEXT("%s:%d"), *Host, Port);
+}
+
+FUOnlineLanBeacon::FUOnlineLanBeacon(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options)
+	: NumPacketsSent(0)
+	, NumPacketsReceived(0)
+	, NumPacketsRejected(0)
+	, Transport(arg_Transport)
+	, Options(arg_Options)
+	, Random(arg_Options.RandomSeed)
+{
+	Options.MaxResponsesPerSecond = FMath::Max(0.01f, Options.MaxResponsesPerSecond);
+	Options.ResponseBurst = FMath::Max(1, Options.ResponseBurst);
+	Options.ResponseJitter = FMath::Max(0.f, Options.ResponseJitter);
+	Options.MaxPendingResponses = FMath::Max(1, Options.MaxPendingResponses);
+}
+
+FUOnlineLanBeacon::~FUOnlineLanBeacon()
+{
+	Stop();
+}
+
+void FUOnlineLanBeacon::Start()
+{
+	Stop();
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FUOnlineLanBeacon::Tick));
+}
+
+void FUOnlineLanBeacon::Stop()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+bool FUOnlineLanBeacon::Tick(float arg_DeltaTime)
+{
+	Update(FPlatformTime::Seconds());
+
+	return true;
+}
+
+uint8 FUOnlineLanBeacon::DiffFields(const FUOnlineLanBeaconSession& arg_A, const FUOnlineLanBeaconSession& arg_B)
+{
+	uint8 Fields = 0;
+
+	if (!arg_A.OwnerName.Equals(arg_B.OwnerName, ESearchCase::CaseSensitive))
+	{
+		Fields |= Field_OwnerName;
+	}
+
+	if (!arg_A.MapName.Equals(arg_B.MapName, ESearchCase::CaseSensitive))
+	{
+		Fields |= Field_MapName;
+	}
+
+	if (!arg_A.GameMode.Equals(arg_B.GameMode, ESearchCase::CaseSensitive))
+	{
+		Fields |= Field_GameMode;
+	}
+
+	if (arg_A.NumPlayers != arg_B.NumPlayers)
+	{
+		Fields |= Field_NumPlayers;
+	}
+
+	if (arg_A.MaxPlayers != arg_B.MaxPlayers)
+	{
+		Fields |= Field_MaxPlayers;
+	}
+
+	if (arg_A.Port != arg_B.Port)
+	{
+		Fields |= Field_Port;
+	}
+
+	return Fields;
+}
+
+void FUOnlineLanBeacon::CopyFields(FUOnlineLanBeaconSession& arg_To, const FUOnlineLanBeaconSession& arg_From, uint8 arg_Fields)
+{
+	if (arg_Fields & Field_OwnerName)
+	{
+		arg_To.OwnerName = arg_From.OwnerName;
+	}
+
+	if (arg_Fields & Field_MapName)
+	{
+		arg_To.MapName = arg_From.MapName;
+	}
+
+	if (arg_Fields & Field_GameMode)
+	{
+		arg_To.GameMode = arg_From.GameMode;
+	}
+
+	if (arg_Fields & Field_NumPlayers)
+	{
+		arg_To.NumPlayers = arg_From.NumPlayers;
+	}
+
+	if (arg_Fields & Field_MaxPlayers)
+	{
+		arg_To.MaxPlayers = arg_From.MaxPlayers;
+	}
+
+	if (arg_Fields & Field_Port)
+	{
+		arg_To.Port = arg_From.Port;
+	}
+}
+
+void FUOnlineLanBeacon::WriteHeader(TArray<uint8>& arg_OutPacket, EPacketType arg_Type, uint32 arg_Nonce) const
+{
+	UOnlineLanBeacon::WriteUInt16(arg_OutPacket, UOnlineLanBeacon::Magic);
+	UOnlineLanBeacon::WriteUInt8(arg_OutPacket, UOnlineLanBeacon::Version);
+	UOnlineLanBeacon::WriteUInt8(arg_OutPacket, static_cast<uint8>(arg_Type));
+	UOnlineLanBeacon::WriteUInt32(arg_OutPacket, Options.ProtocolId);
+	UOnlineLanBeacon::WriteUInt32(arg_OutPacket, arg_Nonce);
+}
+
+void FUOnlineLanBeacon::WriteSession(TArray<uint8>& arg_OutPacket, const FUOnlineLanBeaconSession& arg_Session, uint8 arg_Fields)
+{
+	UOnlineLanBeacon::WriteString(arg_OutPacket, arg_Session.SessionId);
+	UOnlineLanBeacon::WriteVarUInt(arg_OutPacket, arg_Session.Sequence);
+	UOnlineLanBeacon::WriteUInt8(arg_OutPacket, arg_Fields);
+
+	// In the order of the mask bits, see ReadSession
+	if (arg_Fields & Field_OwnerName)
+	{
+		UOnlineLanBeacon::WriteString(arg_OutPacket, arg_Session.OwnerName);
+	}
+
+	if (arg_Fields & Field_MapName)
+	{
+		UOnlineLanBeacon::WriteString(arg_OutPacket, arg_Session.MapName);
+	}
+
+	if (arg_Fields & Field_GameMode)
+	{
+		UOnlineLanBeacon::WriteString(arg_OutPacket, arg_Session.GameMode);
+	}
+
+	if (arg_Fields & Field_NumPlayers)
+	{
+		UOnlineLanBeacon::WriteVarUInt(arg_OutPacket, FMath::Max(0, arg_Session.NumPlayers));
+	}
+
+	if (arg_Fields & Field_MaxPlayers)
+	{
+		UOnlineLanBeacon::WriteVarUInt(arg_OutPacket, FMath::Max(0, arg_Session.MaxPlayers));
+	}
+
+	if (arg_Fields & Field_Port)
+	{
+		UOnlineLanBeacon::WriteUInt16(arg_OutPacket, static_cast<uint16>(arg_Session.Port));
+	}
+}
+
+bool FUOnlineLanBeacon::ReadHeader(const TArray<uint8>& arg_Packet, EPacketType& arg_OutType, uint32& arg_OutNonce, int32& arg_OutOffset) const
+{
+	if (arg_Packet.Num() < UOnlineLanBeacon::HeaderSize)
+	{
+		return false;
+	}
+
+	int32 Offset = 0;
+	uint16 Magic = 0;
+	uint8 Version = 0;
+	uint8 Type = 0;
+	uint32 ProtocolId = 0;
+
+	if (!UOnlineLanBeacon::ReadUInt16(arg_Packet, Offset, Magic) || !UOnlineLanBeacon::ReadUInt8(arg_Packet, Offset, Version) || !UOnlineLanBeacon::ReadUInt8(arg_Packet, Offset, Type)
+		|| !UOnlineLanBeacon::ReadUInt32(arg_Packet, Offset, ProtocolId) || !UOnlineLanBeacon::ReadUInt32(arg_Packet, Offset, arg_OutNonce))
+	{
+		return false;
+	}
+
+	if (Magic != UOnlineLanBeacon::Magic || Version != UOnlineLanBeacon::Version || ProtocolId != Options.ProtocolId
+		|| Type < static_cast<uint8>(EPacketType::Query) || Type > static_cast<uint8>(EPacketType::Withdraw))
+	{
+		return false;
+	}
+
+	arg_OutType = static_cast<EPacketType>(Type);
+	arg_OutOffset = Offset;
+
+	return true;
+}
+
+bool FUOnlineLanBeacon::ReadSession(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, FUOnlineLanBeaconSession& arg_OutSession, uint8& arg_OutFields)
+{
+	uint8 Fields = 0;
+
+	if (!UOnlineLanBeacon::ReadString(arg_Packet, arg_InOutOffset, arg_OutSession.SessionId) || arg_OutSession.SessionId.IsEmpty()
+		|| !UOnlineLanBeacon::ReadVarUInt(arg_Packet, arg_InOutOffset, arg_OutSession.Sequence) || !UOnlineLanBeacon::ReadUInt8(arg_Packet, arg_InOutOffset, Fields))
+	{
+		return false;
+	}
+
+	uint32 NumPlayers = 0;
+	uint32 MaxPlayers = 0;
+	uint16 Port = 0;
+
+	if (((Fields & Field_OwnerName) && !UOnlineLanBeacon::ReadString(arg_Packet, arg_InOutOffset, arg_OutSession.OwnerName))
+		|| ((Fields & Field_MapName) && !UOnlineLanBeacon::ReadString(arg_Packet, arg_InOutOffset, arg_OutSession.MapName))
+		|| ((Fields & Field_GameMode) && !UOnlineLanBeacon::ReadString(arg_Packet, arg_InOutOffset, arg_OutSession.GameMode))
+		|| ((Fields & Field_NumPlayers) && !UOnlineLanBeacon::ReadVarUInt(arg_Packet, arg_InOutOffset, NumPlayers))
+		|| ((Fields & Field_MaxPlayers) && !UOnlineLanBeacon::ReadVarUInt(arg_Packet, arg_InOutOffset, MaxPlayers))
+		|| ((Fields & Field_Port) && !UOnlineLanBeacon::ReadUInt16(arg_Packet, arg_InOutOffset, Port)))
+	{
+		return false;
+	}
+
+	if (Fields & Field_NumPlayers)
+	{
+		arg_OutSession.NumPlayers = FMath::Min<uint32>(NumPlayers, MAX_int32);
+	}
+
+	if (Fields & Field_MaxPlayers)
+	{
+		arg_OutSession.MaxPlayers = FMath::Min<uint32>(MaxPlayers, MAX_int32);
+	}
+
+	if (Fields & Field_Port)
+	{
+		arg_OutSession.Port = Port;
+	}
+
+	// Fields of a later version come after these and are left unread
+	arg_OutFields = Fields & Field_All;
+
+	return true;
+}
+
+void FUOnlineLanBeacon::Broadcast(const TArray<uint8>& arg_Packet)
+{
+	if (Transport->Broadcast(arg_Packet))
+	{
+		++NumPacketsSent;
+	}
+}
+
+void FUOnlineLanBeacon::SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet)
+{
+	if (Transport->SendTo(arg_Address, arg_Packet))
+	{
+		++NumPacketsSent;
+	}
+}
+
+bool FUOnlineLanBeacon::ReceiveNext(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress, EPacketType& arg_OutType, uint32& arg_OutNonce, int32& arg_OutOffset)
+{
+	while (Transport->Receive(arg_OutPacket, arg_OutAddress))
+	{
+		++NumPacketsReceived;
+
+		if (ReadHeader(arg_OutPacket, arg_OutType, arg_OutNonce, arg_OutOffset))
+		{
+			return true;
+		}
+
+		++NumPacketsRejected;
+	}
+
+	return false;
+}
+
+FUOnlineLanBeaconHost::FUOnlineLanBeaconHost(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options)
+	: FUOnlineLanBeacon(arg_Transport, arg_Options)
+	, NumResponses(0)
+	, NumAnnouncements(0)
+	, NumQueriesDropped(0)
+	, bIsAdvertising(false)
+	, PendingAnnounceFields(0)
+	, AnnounceBaseSequence(0)
+	, LastAnnounceTime(-1.0)
+	, ResponseTokens(static_cast<float>(Options.ResponseBurst))
+	, LastUpdateTime(-1.0)
+{
+
+}
+
+FUOnlineLanBeaconHost::~FUOnlineLanBeaconHost()
+{
+	StopAdvertising();
+}
+
+void FUOnlineLanBeaconHost::Advertise(const FUOnlineLanBeaconSession& arg_Session)
+{
+	FUOnlineLanBeaconSession Advertised = arg_Session;
+	Advertised.HostAddress.Empty();
+	Advertised.PingInMs = 0;
+	Advertised.LastSeenTime = 0.0;
+
+	if (!bIsAdvertising || !Advertised.SessionId.Equals(Session.SessionId, ESearchCase::CaseSensitive))
+	{
+		StopAdvertising();
+
+		// Announced in full, clients that hear it list the session without asking. The sequence goes on from the last advertisement,
+		// a client that missed the withdraw still has that one and would take everything after it for old news
+		Advertised.Sequence = Session.Sequence + 1;
+		Session = Advertised;
+		bIsAdvertising = true;
+		PendingAnnounceFields = Field_All;
+		AnnounceBaseSequence = 0;
+		return;
+	}
+
+	const uint8 ChangedFields = DiffFields(Session, Advertised);
+
+	if (ChangedFields == 0)
+	{
+		return;
+	}
+
+	// Changes that wait for the announce interval go out together, on top of what clients had before the first of them
+	if (PendingAnnounceFields == 0)
+	{
+		AnnounceBaseSequence = Session.Sequence;
+	}
+
+	Advertised.Sequence = Session.Sequence + 1;
+	Session = Advertised;
+	PendingAnnounceFields |= ChangedFields;
+}
+
+void FUOnlineLanBeaconHost::StopAdvertising()
+{
+	if (!bIsAdvertising)
+	{
+		return;
+	}
+
+	TArray<uint8> Packet;
+	WriteHeader(Packet, EPacketType::Withdraw, 0);
+	WriteSession(Packet, Session, 0);
+	Broadcast(Packet);
+
+	bIsAdvertising = false;
+	PendingAnnounceFields = 0;
+	PendingResponses.Reset();
+}
+
+void FUOnlineLanBeaconHost::Update(double arg_Now)
+{
+	if (LastUpdateTime >= 0.0)
+	{
+		ResponseTokens = FMath::Min(static_cast<float>(Options.ResponseBurst), ResponseTokens + static_cast<float>(arg_Now - LastUpdateTime) * Options.MaxResponsesPerSecond);
+	}
+
+	LastUpdateTime = arg_Now;
+
+	ReceiveQueries(arg_Now);
+
+	if (!bIsAdvertising)
+	{
+		return;
+	}
+
+	SendResponses(arg_Now);
+
+	if (PendingAnnounceFields != 0 && (LastAnnounceTime < 0.0 || arg_Now - LastAnnounceTime >= Options.MinAnnounceInterval))
+	{
+		SendAnnouncement(arg_Now);
+	}
+}
+
+void FUOnlineLanBeaconHost::ReceiveQueries(double arg_Now)
+{
+	TArray<uint8> Packet;
+	FString Address;
+	EPacketType Type = EPacketType::Query;
+	uint32 Nonce = 0;
+	int32 Offset = 0;
+
+	while (ReceiveNext(Packet, Address, Type, Nonce, Offset))
+	{
+		if (Type != EPacketType::Query || !bIsAdvertising)
+		{
+			continue;
+		}
+
+		// Asked again before the answer went out, the one answer does for both
+		FPendingResponse* PendingResponse = PendingResponses.FindByPredicate([&Address](const FPendingResponse& arg_PendingResponse)
+		{
+			return arg_PendingResponse.Address == Address;
+		});
+
+		if (PendingResponse)
+		{
+			PendingResponse->Nonce = Nonce;
+			PendingResponse->ReceiveTime = arg_Now;
+			continue;
+		}
+
+		if (PendingResponses.Num() >= Options.MaxPendingResponses)
+		{
+			++NumQueriesDropped;
+			continue;
+		}
+
+		FPendingResponse NewResponse;
+		NewResponse.Address = Address;
+		NewResponse.Nonce = Nonce;
+		NewResponse.ReceiveTime = arg_Now;
+		NewResponse.SendTime = arg_Now + Random.FRand() * Options.ResponseJitter;
+
+		int32 InsertIndex = PendingResponses.Num();
+
+		while (InsertIndex > 0 && PendingResponses[InsertIndex - 1].SendTime > NewResponse.SendTime)
+		{
+			--InsertIndex;
+		}
+
+		PendingResponses.Insert(NewResponse, InsertIndex);
+	}
+}
+
+void FUOnlineLanBeaconHost::SendResponses(double arg_Now)
+{
+	TArray<uint8> Packet;
+	int32 NumSent = 0;
+
+	while (NumSent < PendingResponses.Num() && PendingResponses[NumSent].SendTime <= arg_Now && ResponseTokens >= 1.f)
+	{
+		const FPendingResponse& PendingResponse = PendingResponses[NumSent];
+
+		// Clients take the time the answer was held back off the ping
+		const uint32 HoldTimeInMs = static_cast<uint32>(FMath::Max(0, FMath::RoundToInt(static_cast<float>(arg_Now - PendingResponse.ReceiveTime) * 1000.f)));
+
+		Packet.Reset();
+		WriteHeader(Packet, EPacketType::Response, PendingResponse.Nonce);
+		UOnlineLanBeacon::WriteVarUInt(Packet, HoldTimeInMs);
+		WriteSession(Packet, Session, Field_All);
+		SendTo(PendingResponse.Address, Packet);
+
+		ResponseTokens -= 1.f;
+		++NumResponses;
+		++NumSent;
+	}
+
+	PendingResponses.RemoveAt(0, NumSent, false);
+}
+
+void FUOnlineLanBeaconHost::SendAnnouncement(double arg_Now)
+{
+	TArray<uint8> Packet;
+	WriteHeader(Packet, EPacketType::Announce, 0);
+	UOnlineLanBeacon::WriteVarUInt(Packet, AnnounceBaseSequence);
+	WriteSession(Packet, Session, PendingAnnounceFields);
+	Broadcast(Packet);
+
+	PendingAnnounceFields = 0;
+	LastAnnounceTime = arg_Now;
+	++NumAnnouncements;
+}
+
+FUOnlineLanBeaconClient::FUOnlineLanBeaconClient(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options)
+	: FUOnlineLanBeacon(arg_Transport, arg_Options)
+	, bIsSearching(false)
+	, bHasPendingSearch(false)
+	, LastBroadcastTime(-1.0)
+	, bHasPendingExpiry(false)
+{
+
+}
+
+void FUOnlineLanBeaconClient::Search()
+{
+	bIsSearching = true;
+	bHasPendingSearch = true;
+}
+
+void FUOnlineLanBeaconClient::StopSearching()
+{
+	bIsSearching = false;
+	bHasPendingSearch = false;
+}
+
+void FUOnlineLanBeaconClient::Update(double arg_Now)
+{
+	TArray<uint8> Packet;
+	FString Address;
+	EPacketType Type = EPacketType::Query;
+	uint32 Nonce = 0;
+	int32 Offset = 0;
+
+	while (ReceiveNext(Packet, Address, Type, Nonce, Offset))
+	{
+		switch (Type)
+		{
+		case EPacketType::Response:
+			OnResponse(Packet, Offset, Address, Nonce, arg_Now);
+			break;
+
+		case EPacketType::Announce:
+			OnAnnouncement(Packet, Offset, Address, arg_Now);
+			break;
+
+		case EPacketType::Withdraw:
+			OnWithdraw(Packet, Offset);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	if (bHasPendingSearch || (bIsSearching && Options.QueryInterval > 0.f && arg_Now - LastBroadcastTime >= Options.QueryInterval))
+	{
+		bHasPendingSearch = false;
+		SendQuery(FString(), arg_Now);
+	}
+
+	ExpireSessions(arg_Now);
+}
+
+void FUOnlineLanBeaconClient::SendQuery(const FString& arg_Address, double arg_Now)
+{
+	// 0 is the nonce of announcements
+	uint32 Nonce = 0;
+
+	while (Nonce == 0 || QueryTimes.Contains(Nonce))
+	{
+		Nonce = Random.GetUnsignedInt();
+	}
+
+	QueryTimes.Add(Nonce, arg_Now);
+
+	TArray<uint8> Packet;
+	WriteHeader(Packet, EPacketType::Query, Nonce);
+
+	if (arg_Address.IsEmpty())
+	{
+		Broadcast(Packet);
+
+		LastBroadcastTime = arg_Now;
+		bHasPendingExpiry = true;
+	}
+	else
+	{
+		SendTo(arg_Address, Packet);
+	}
+}
+
+void FUOnlineLanBeaconClient::OnResponse(const TArray<uint8>& arg_Packet, int32 arg_Offset, const FString& arg_Address, uint32 arg_Nonce, double arg_Now)
+{
+	const double* QueryTime = QueryTimes.Find(arg_Nonce);
+
+	// Answer to a query of another client, or too late
+	if (!QueryTime)
+	{
+		return;
+	}
+
+	uint32 HoldTimeInMs = 0;
+	FUOnlineLanBeaconSession Received;
+	uint8 Fields = 0;
+
+	if (!UOnlineLanBeacon::ReadVarUInt(arg_Packet, arg_Offset, HoldTimeInMs) || !ReadSession(arg_Packet, arg_Offset, Received, Fields) || Fields != Field_All)
+	{
+		++NumPacketsRejected;
+		return;
+	}
+
+	const int32 PingInMs = FMath::Max(0, FMath::RoundToInt(static_cast<float>(arg_Now - *QueryTime) * 1000.f) - static_cast<int32>(FMath::Min<uint32>(HoldTimeInMs, MAX_int32)));
+
+	FUOnlineLanBeaconSession* Known = Sessions.Find(Received.SessionId);
+
+	if (!Known)
+	{
+		Received.HostAddress = arg_Address;
+		Received.PingInMs = PingInMs;
+		Received.LastSeenTime = arg_Now;
+
+		OnSessionFound.Broadcast(Sessions.Add(Received.SessionId, Received));
+		return;
+	}
+
+	const bool bIsNewer = Received.Sequence >= Known->Sequence;
+	const bool bHasChanged = (bIsNewer && DiffFields(*Known, Received) != 0) || Known->PingInMs != PingInMs || Known->HostAddress != arg_Address;
+
+	if (bIsNewer)
+	{
+		CopyFields(*Known, Received, Field_All);
+		Known->Sequence = Received.Sequence;
+	}
+
+	Known->HostAddress = arg_Address;
+	Known->PingInMs = PingInMs;
+	Known->LastSeenTime = arg_Now;
+
+	if (bHasChanged)
+	{
+		OnSessionUpdated.Broadcast(*Known);
+	}
+}
+
+void FUOnlineLanBeaconClient::OnAnnouncement(const TArray<uint8>& arg_Packet, int32 arg_Offset, const FString& arg_Address, double arg_Now)
+{
+	uint32 BaseSequence = 0;
+	FUOnlineLanBeaconSession Received;
+	uint8 Fields = 0;
+
+	if (!UOnlineLanBeacon::ReadVarUInt(arg_Packet, arg_Offset, BaseSequence) || !ReadSession(arg_Packet, arg_Offset, Received, Fields))
+	{
+		++NumPacketsRejected;
+		return;
+	}
+
+	FUOnlineLanBeaconSession* Known = Sessions.Find(Received.SessionId);
+
+	if (!Known)
+	{
+		// Changes alone don't make a session, the next answer to a query will
+		if (Fields == Field_All)
+		{
+			Received.HostAddress = arg_Address;
+			Received.LastSeenTime = arg_Now;
+
+			OnSessionFound.Broadcast(Sessions.Add(Received.SessionId, Received));
+		}
+
+		return;
+	}
+
+	if (Received.Sequence <= Known->Sequence)
+	{
+		return;
+	}
+
+	// An announcement was lost, only a full answer brings the session up to date again
+	if (Known->Sequence < BaseSequence && Fields != Field_All)
+	{
+		SendQuery(arg_Address, arg_Now);
+		return;
+	}
+
+	CopyFields(*Known, Received, Fields);
+	Known->Sequence = Received.Sequence;
+	Known->HostAddress = arg_Address;
+	Known->LastSeenTime = arg_Now;
+
+	OnSessionUpdated.Broadcast(*Known);
+}
+
+void FUOnlineLanBeaconClient::OnWithdraw(const TArray<uint8>& arg_Packet, int32 arg_Offset)
+{
+	FUOnlineLanBeaconSession Received;
+	uint8 Fields = 0;
+
+	if (!ReadSession(arg_Packet, arg_Offset, Received, Fields))
+	{
+		++NumPacketsRejected;
+		return;
+	}
+
+	if (Sessions.Remove(Received.SessionId) > 0)
+	{
+		OnSessionLost.Broadcast(Received.SessionId);
+	}
+}
+
+void FUOnlineLanBeaconClient::ExpireSessions(double arg_Now)
+{
+	for (TMap<uint32, double>::TIterator It(QueryTimes); It; ++It)
+	{
+		if (arg_Now - It.Value() >= Options.ResponseTimeout)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (!bHasPendingExpiry || arg_Now - LastBroadcastTime < Options.ResponseTimeout)
+	{
+		return;
+	}
+
+	bHasPendingExpiry = false;
+
+	TArray<FString> LostSessionIds;
+
+	for (TMap<FString, FUOnlineLanBeaconSession>::TIterator It(Sessions); It; ++It)
+	{
+		if (It.Value().LastSeenTime < LastBroadcastTime)
+		{
+			LostSessionIds.Add(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FString& SessionId : LostSessionIds)
+	{
+		OnSessionLost.Broadcast(SessionId);
+	}
+}
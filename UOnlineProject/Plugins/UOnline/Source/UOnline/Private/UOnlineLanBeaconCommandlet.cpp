@@ -0,0 +1,244 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineLanBeaconCommandlet.h"
+#include "UOnlineLanTransport.h"
+#include "UOnlineStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUOnlineLanBeacon, Log, All);
+
+UOnlineLanBeaconCommandlet::UOnlineLanBeaconCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	NumHosts = 300;
+	NumClients = 4;
+	Duration = 20.f;
+	SettleTime = 10.f;
+	TickInterval = 0.01f;
+	ChangeRate = 0.2f;
+	LossRate = 0.f;
+}
+
+int32 UOnlineLanBeaconCommandlet::Main(const FString& arg_Params)
+{
+	FString OutputFilename = FPaths::ProjectSavedDir() / TEXT("Benchmarks/UOnlineLanBeacon.json");
+
+	FParse::Value(*arg_Params, TEXT("Hosts="), NumHosts);
+	FParse::Value(*arg_Params, TEXT("Clients="), NumClients);
+	FParse::Value(*arg_Params, TEXT("Duration="), Duration);
+	FParse::Value(*arg_Params, TEXT("SettleTime="), SettleTime);
+	FParse::Value(*arg_Params, TEXT("TickInterval="), TickInterval);
+	FParse::Value(*arg_Params, TEXT("ChangeRate="), ChangeRate);
+	FParse::Value(*arg_Params, TEXT("LossRate="), LossRate);
+	FParse::Value(*arg_Params, TEXT("Output="), OutputFilename);
+
+	FParse::Value(*arg_Params, TEXT("MaxResponsesPerSecond="), BeaconOptions.MaxResponsesPerSecond);
+	FParse::Value(*arg_Params, TEXT("ResponseBurst="), BeaconOptions.ResponseBurst);
+	FParse::Value(*arg_Params, TEXT("ResponseJitter="), BeaconOptions.ResponseJitter);
+	FParse::Value(*arg_Params, TEXT("MaxPendingResponses="), BeaconOptions.MaxPendingResponses);
+	FParse::Value(*arg_Params, TEXT("MinAnnounceInterval="), BeaconOptions.MinAnnounceInterval);
+	FParse::Value(*arg_Params, TEXT("ResponseTimeout="), BeaconOptions.ResponseTimeout);
+	FParse::Value(*arg_Params, TEXT("QueryInterval="), BeaconOptions.QueryInterval);
+	FParse::Value(*arg_Params, TEXT("Seed="), BeaconOptions.RandomSeed);
+
+	NumHosts = FMath::Max(1, NumHosts);
+	NumClients = FMath::Max(1, NumClients);
+	TickInterval = FMath::Max(0.001f, TickInterval);
+
+	TSharedRef<FUOnlineLanLoopbackNetwork> Network = MakeShareable(new FUOnlineLanLoopbackNetwork(LossRate, BeaconOptions.RandomSeed));
+	FRandomStream Random(BeaconOptions.RandomSeed);
+
+	TArray<TSharedRef<FUOnlineLanBeaconHost>> Hosts;
+	TArray<FUOnlineLanBeaconSession> HostSessions;
+
+	for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+	{
+		FUOnlineLanBeaconOptions HostOptions = BeaconOptions;
+		HostOptions.RandomSeed += HostIndex;
+
+		FUOnlineLanBeaconSession& Session = HostSessions[HostSessions.AddDefaulted()];
+		Session.SessionId = FString::Printf(TEXT("LanSession%d"), HostIndex);
+		Session.OwnerName = FString::Printf(TEXT("LAN Host %d"), HostIndex);
+		Session.MapName = TEXT("Highrise");
+		Session.GameMode = TEXT("Deathmatch");
+		Session.MaxPlayers = 16;
+		Session.NumPlayers = Random.RandRange(0, Session.MaxPlayers);
+		Session.Port = 7777;
+
+		TSharedRef<FUOnlineLanBeaconHost> Host = MakeShareable(new FUOnlineLanBeaconHost(Network->CreateEndpoint(true), HostOptions));
+		Host->Advertise(Session);
+		Host->Update(0.0);
+
+		Hosts.Add(Host);
+	}
+
+	// Clients come up after the hosts announced themselves, they find them with a query
+	TArray<TSharedRef<FUOnlineLanBeaconClient>> Clients;
+	TArray<double> DiscoveryTimes;
+	DiscoveryTimes.Init(-1.0, NumClients);
+
+	for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		FUOnlineLanBeaconOptions ClientOptions = BeaconOptions;
+		ClientOptions.RandomSeed += NumHosts + ClientIndex;
+
+		TSharedRef<FUOnlineLanBeaconClient> Client = MakeShareable(new FUOnlineLanBeaconClient(Network->CreateEndpoint(false), ClientOptions));
+		Client->Search();
+
+		Clients.Add(Client);
+	}
+
+	const int32 NumPacketsBefore = Network->NumPacketsSent;
+	const int64 NumBytesBefore = Network->NumBytesSent;
+	int32 NumChanges = 0;
+
+	for (double Now = TickInterval; Now < Duration + SettleTime; Now += TickInterval)
+	{
+		if (Now < Duration)
+		{
+			for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+			{
+				if (Random.FRand() < ChangeRate * TickInterval)
+				{
+					FUOnlineLanBeaconSession& Session = HostSessions[HostIndex];
+					Session.NumPlayers = Random.RandRange(0, Session.MaxPlayers);
+					Hosts[HostIndex]->Advertise(Session);
+					++NumChanges;
+				}
+			}
+		}
+
+		for (const TSharedRef<FUOnlineLanBeaconHost>& Host : Hosts)
+		{
+			Host->Update(Now);
+		}
+
+		for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+		{
+			Clients[ClientIndex]->Update(Now);
+
+			if (DiscoveryTimes[ClientIndex] < 0.0 && Clients[ClientIndex]->GetSessions().Num() == NumHosts)
+			{
+				DiscoveryTimes[ClientIndex] = Now;
+			}
+		}
+	}
+
+	int32 NumMissing = 0;
+	int32 NumStale = 0;
+	TArray<double> Pings;
+
+	for (const TSharedRef<FUOnlineLanBeaconClient>& Client : Clients)
+	{
+		for (const FUOnlineLanBeaconSession& HostSession : HostSessions)
+		{
+			const FUOnlineLanBeaconSession* Known = Client->GetSessions().Find(HostSession.SessionId);
+
+			if (!Known)
+			{
+				++NumMissing;
+			}
+			else if (Known->NumPlayers != HostSession.NumPlayers)
+			{
+				++NumStale;
+			}
+			else
+			{
+				Pings.Add(Known->PingInMs);
+			}
+		}
+	}
+
+	int32 NumResponses = 0;
+	int32 NumAnnouncements = 0;
+	int32 NumQueriesDropped = 0;
+
+	for (const TSharedRef<FUOnlineLanBeaconHost>& Host : Hosts)
+	{
+		NumResponses += Host->NumResponses;
+		NumAnnouncements += Host->NumAnnouncements;
+		NumQueriesDropped += Host->NumQueriesDropped;
+	}
+
+	const int32 NumPackets = Network->NumPacketsSent - NumPacketsBefore;
+	const int64 NumBytes = Network->NumBytesSent - NumBytesBefore;
+
+	TArray<double> FinishedDiscoveryTimes;
+
+	for (double DiscoveryTime : DiscoveryTimes)
+	{
+		if (DiscoveryTime >= 0.0)
+		{
+			FinishedDiscoveryTimes.Add(DiscoveryTime);
+		}
+	}
+
+	const FUOnlineSampleSummary Discovery(FinishedDiscoveryTimes);
+	const FUOnlineSampleSummary PingSummary(Pings);
+
+	FString Report;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Hosts"), NumHosts);
+	Writer->WriteValue(TEXT("Clients"), NumClients);
+	Writer->WriteValue(TEXT("Duration"), Duration);
+	Writer->WriteValue(TEXT("LossRate"), LossRate);
+	Writer->WriteValue(TEXT("Changes"), NumChanges);
+
+	Writer->WriteObjectStart(TEXT("DiscoveryInSeconds"));
+	Writer->WriteValue(TEXT("ClientsDone"), Discovery.GetCount());
+	Discovery.WritePercentiles(*Writer, { 50.0, 100.0 });
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("PingInMs"));
+	PingSummary.WritePercentiles(*Writer, { 50.0, 100.0 });
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("Network"));
+	Writer->WriteValue(TEXT("Packets"), NumPackets);
+	Writer->WriteValue(TEXT("Bytes"), static_cast<double>(NumBytes));
+	Writer->WriteValue(TEXT("BytesPerPacket"), NumPackets > 0 ? static_cast<double>(NumBytes) / NumPackets : 0.0);
+	Writer->WriteValue(TEXT("Delivered"), Network->NumPacketsDelivered);
+	Writer->WriteValue(TEXT("Lost"), Network->NumPacketsLost);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("HostTraffic"));
+	Writer->WriteValue(TEXT("Responses"), NumResponses);
+	Writer->WriteValue(TEXT("Announcements"), NumAnnouncements);
+	Writer->WriteValue(TEXT("QueriesDropped"), NumQueriesDropped);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("Sessions"));
+	Writer->WriteValue(TEXT("Missing"), NumMissing);
+	Writer->WriteValue(TEXT("Stale"), NumStale);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	UE_LOG(LogUOnlineLanBeacon, Display, TEXT("%d of %d clients found all %d hosts, slowest after %.2f s. %d packets, %.1f bytes per packet, %d missing, %d stale"),
+		Discovery.GetCount(), NumClients, NumHosts, Discovery.GetPercentile(100.0), NumPackets, NumPackets > 0 ? static_cast<double>(NumBytes) / NumPackets : 0.0, NumMissing, NumStale);
+
+	if (!FFileHelper::SaveStringToFile(Report, *OutputFilename))
+	{
+		UE_LOG(LogUOnlineLanBeacon, Error, TEXT("Failed to write %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogUOnlineLanBeacon, Display, TEXT("Report written to %s"), *OutputFilename);
+
+	// With losses a host can miss a query or a client an answer right before the end, that is what the next query is for
+	if (LossRate <= 0.f && (NumMissing > 0 || NumStale > 0))
+	{
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,273 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineLanTransport.h"
+#include "Containers/Queue.h"
+#include "IPAddress.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "UOnlineStats.h"
+
+namespace UOnlineLanTransport
+{
+	// Larger than any beacon packet, anything longer is cut and then rejected by the beacon
+	static const int32 MaxPacketSize = 1024;
+
+	static const TCHAR* LoopbackPrefix = TEXT("loopback:");
+}
+
+/**
+ * A transport on a FUOnlineLanLoopbackNetwork.
+ */
+class FUOnlineLanLoopbackEndpoint : public IUOnlineLanTransport
+{
+public:
+	FUOnlineLanLoopbackEndpoint(const TSharedRef<FUOnlineLanLoopbackNetwork>& arg_Network, bool arg_bIsHost)
+		: Network(arg_Network)
+		, bIsHost(arg_bIsHost)
+		, Index(INDEX_NONE)
+	{
+		Network->AddEndpoint(*this);
+	}
+
+	virtual ~FUOnlineLanLoopbackEndpoint()
+	{
+		Network->RemoveEndpoint(*this);
+	}
+
+	// IUOnlineLanTransport interface
+	virtual bool Broadcast(const TArray<uint8>& arg_Packet) override
+	{
+		Network->Broadcast(*this, arg_Packet);
+		return true;
+	}
+
+	virtual bool SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet) override
+	{
+		return Network->SendTo(*this, arg_Address, arg_Packet);
+	}
+
+	virtual bool Receive(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress) override
+	{
+		TPair<FString, TArray<uint8>> Received;
+
+		if (!Inbox.Dequeue(Received))
+		{
+			return false;
+		}
+
+		arg_OutAddress = MoveTemp(Received.Key);
+		arg_OutPacket = MoveTemp(Received.Value);
+
+		return true;
+	}
+
+	FString GetAddress() const { return FString::Printf(TEXT("%s%d"), UOnlineLanTransport::LoopbackPrefix, Index); }
+
+	TSharedRef<FUOnlineLanLoopbackNetwork> Network;
+	bool bIsHost;
+
+	// Index in the endpoints of the network
+	int32 Index;
+
+	// Sender address and packet
+	TQueue<TPair<FString, TArray<uint8>>> Inbox;
+};
+
+FUOnlineLanSocketTransport::FUOnlineLanSocketTransport(int32 arg_ListenPort, int32 arg_BroadcastPort)
+	: Socket(nullptr)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	if (!SocketSubsystem)
+	{
+		return;
+	}
+
+	Socket = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("UOnline LAN beacon"), true);
+
+	if (!Socket)
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Failed to create the LAN beacon socket"));
+		return;
+	}
+
+	TSharedRef<FInternetAddr> ListenAddress = SocketSubsystem->CreateInternetAddr();
+	ListenAddress->SetAnyAddress();
+	ListenAddress->SetPort(arg_ListenPort);
+
+	// Several hosts or clients can run on one machine
+	Socket->SetReuseAddr();
+
+	if (!Socket->SetNonBlocking() || !Socket->SetBroadcast() || !Socket->Bind(*ListenAddress))
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Failed to bind the LAN beacon socket to port %d"), arg_ListenPort);
+
+		SocketSubsystem->DestroySocket(Socket);
+		Socket = nullptr;
+		return;
+	}
+
+	BroadcastAddress = SocketSubsystem->CreateInternetAddr();
+	BroadcastAddress->SetIp(0xFFFFFFFF);
+	BroadcastAddress->SetPort(arg_BroadcastPort);
+}
+
+FUOnlineLanSocketTransport::~FUOnlineLanSocketTransport()
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+TSharedPtr<IUOnlineLanTransport> FUOnlineLanSocketTransport::CreateHost(int32 arg_BeaconPort)
+{
+	TSharedPtr<FUOnlineLanSocketTransport> Transport = MakeShareable(new FUOnlineLanSocketTransport(arg_BeaconPort, arg_BeaconPort + 1));
+
+	return Transport->IsValid() ? Transport : nullptr;
+}
+
+TSharedPtr<IUOnlineLanTransport> FUOnlineLanSocketTransport::CreateClient(int32 arg_BeaconPort)
+{
+	TSharedPtr<FUOnlineLanSocketTransport> Transport = MakeShareable(new FUOnlineLanSocketTransport(arg_BeaconPort + 1, arg_BeaconPort));
+
+	return Transport->IsValid() ? Transport : nullptr;
+}
+
+bool FUOnlineLanSocketTransport::Broadcast(const TArray<uint8>& arg_Packet)
+{
+	return Socket && Send(*BroadcastAddress, arg_Packet);
+}
+
+bool FUOnlineLanSocketTransport::SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet)
+{
+	FString Ip;
+	FString PortString;
+
+	if (!Socket || !arg_Address.Split(TEXT(":"), &Ip, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> Address = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	bool bIsValid = false;
+	Address->SetIp(*Ip, bIsValid);
+	Address->SetPort(FCString::Atoi(*PortString));
+
+	return bIsValid && Send(*Address, arg_Packet);
+}
+
+bool FUOnlineLanSocketTransport::Receive(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress)
+{
+	uint32 PendingDataSize = 0;
+
+	if (!Socket || !Socket->HasPendingData(PendingDataSize))
+	{
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> FromAddress = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	int32 BytesRead = 0;
+
+	arg_OutPacket.SetNumUninitialized(UOnlineLanTransport::MaxPacketSize, false);
+
+	if (!Socket->RecvFrom(arg_OutPacket.GetData(), arg_OutPacket.Num(), BytesRead, *FromAddress))
+	{
+		arg_OutPacket.Reset();
+		return false;
+	}
+
+	arg_OutPacket.SetNum(BytesRead, false);
+	arg_OutAddress = FromAddress->ToString(true);
+
+	return true;
+}
+
+bool FUOnlineLanSocketTransport::Send(const FInternetAddr& arg_Address, const TArray<uint8>& arg_Packet)
+{
+	int32 BytesSent = 0;
+
+	return Socket->SendTo(arg_Packet.GetData(), arg_Packet.Num(), BytesSent, arg_Address) && BytesSent == arg_Packet.Num();
+}
+
+FUOnlineLanLoopbackNetwork::FUOnlineLanLoopbackNetwork(float arg_LossRate, int32 arg_RandomSeed)
+	: NumPacketsSent(0)
+	, NumBytesSent(0)
+	, NumPacketsDelivered(0)
+	, NumPacketsLost(0)
+	, LossRate(FMath::Clamp(arg_LossRate, 0.f, 1.f))
+	, Random(arg_RandomSeed)
+{
+
+}
+
+TSharedRef<IUOnlineLanTransport> FUOnlineLanLoopbackNetwork::CreateEndpoint(bool arg_bIsHost)
+{
+	return MakeShareable(new FUOnlineLanLoopbackEndpoint(AsShared(), arg_bIsHost));
+}
+
+void FUOnlineLanLoopbackNetwork::Broadcast(const FUOnlineLanLoopbackEndpoint& arg_From, const TArray<uint8>& arg_Packet)
+{
+	++NumPacketsSent;
+	NumBytesSent += arg_Packet.Num();
+
+	const FString FromAddress = arg_From.GetAddress();
+
+	for (FUOnlineLanLoopbackEndpoint* Endpoint : Endpoints)
+	{
+		if (Endpoint->bIsHost != arg_From.bIsHost)
+		{
+			Deliver(*Endpoint, FromAddress, arg_Packet);
+		}
+	}
+}
+
+bool FUOnlineLanLoopbackNetwork::SendTo(const FUOnlineLanLoopbackEndpoint& arg_From, const FString& arg_Address, const TArray<uint8>& arg_Packet)
+{
+	if (!arg_Address.StartsWith(UOnlineLanTransport::LoopbackPrefix, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+
+	++NumPacketsSent;
+	NumBytesSent += arg_Packet.Num();
+
+	const int32 Index = FCString::Atoi(*arg_Address + FCString::Strlen(UOnlineLanTransport::LoopbackPrefix));
+
+	// Like UDP, a packet to nobody is gone without an error
+	if (Endpoints.IsValidIndex(Index))
+	{
+		Deliver(*Endpoints[Index], arg_From.GetAddress(), arg_Packet);
+	}
+
+	return true;
+}
+
+void FUOnlineLanLoopbackNetwork::Deliver(FUOnlineLanLoopbackEndpoint& arg_To, const FString& arg_FromAddress, const TArray<uint8>& arg_Packet)
+{
+	if (LossRate > 0.f && Random.FRand() < LossRate)
+	{
+		++NumPacketsLost;
+		return;
+	}
+
+	++NumPacketsDelivered;
+	arg_To.Inbox.Enqueue(TPair<FString, TArray<uint8>>(arg_FromAddress, arg_Packet));
+}
+
+void FUOnlineLanLoopbackNetwork::AddEndpoint(FUOnlineLanLoopbackEndpoint& arg_Endpoint)
+{
+	arg_Endpoint.Index = Endpoints.Add(&arg_Endpoint);
+}
+
+void FUOnlineLanLoopbackNetwork::RemoveEndpoint(FUOnlineLanLoopbackEndpoint& arg_Endpoint)
+{
+	if (Endpoints.IsValidIndex(arg_Endpoint.Index))
+	{
+		Endpoints.RemoveAt(arg_Endpoint.Index);
+	}
+
+	arg_Endpoint.Index = INDEX_NONE;
+}
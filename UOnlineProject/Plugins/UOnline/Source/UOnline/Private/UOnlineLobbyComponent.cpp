@@ -0,0 +1,299 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineLobbyComponent.h"
+#include "UnrealNetwork.h"
+#include "OnlineSubsystemUtils.h"
+#include "Runtime/Engine/Classes/Engine/World.h"
+#include "Runtime/Engine/Classes/GameFramework/GameStateBase.h"
+#include "Runtime/Engine/Classes/GameFramework/PlayerState.h"
+#include "UOnlineStats.h"
+
+void FUOnlineLobbyMember::PreReplicatedRemove(const FUOnlineLobbyRoster& arg_Roster)
+{
+	if (arg_Roster.OwnerComponent)
+	{
+		arg_Roster.OwnerComponent->NotifyMemberRemoved(*this);
+	}
+}
+
+void FUOnlineLobbyMember::PostReplicatedAdd(const FUOnlineLobbyRoster& arg_Roster)
+{
+	if (arg_Roster.OwnerComponent)
+	{
+		arg_Roster.OwnerComponent->NotifyMemberAdded(*this);
+	}
+}
+
+void FUOnlineLobbyMember::PostReplicatedChange(const FUOnlineLobbyRoster& arg_Roster)
+{
+	if (arg_Roster.OwnerComponent)
+	{
+		arg_Roster.OwnerComponent->NotifyMemberChanged(*this);
+	}
+}
+
+UOnlineLobbyComponent::UOnlineLobbyComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	bReplicates = true;
+
+	SessionName = NAME_GameSession;
+	OnlineSubsystemName = NAME_None;
+
+	Roster.OwnerComponent = this;
+}
+
+void UOnlineLobbyComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UOnlineLobbyComponent, Roster);
+}
+
+void UOnlineLobbyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients only receive the roster
+	if (!GetOwner() || !GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	IOnlineSessionPtr OnlineSessionInterface = Online::GetSessionInterface(GetWorld(), OnlineSubsystemName);
+
+	if (!OnlineSessionInterface.IsValid())
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Lobby of %s has no session interface, members have to be added by hand"), *GetOwner()->GetName());
+		return;
+	}
+
+	OnRegisterPlayersCompleteDelegateHandle = OnlineSessionInterface->AddOnRegisterPlayersCompleteDelegate_Handle(FOnRegisterPlayersCompleteDelegate::CreateUObject(this, &UOnlineLobbyComponent::OnRegisterPlayersComplete));
+	OnUnregisterPlayersCompleteDelegateHandle = OnlineSessionInterface->AddOnUnregisterPlayersCompleteDelegate_Handle(FOnUnregisterPlayersCompleteDelegate::CreateUObject(this, &UOnlineLobbyComponent::OnUnregisterPlayersComplete));
+	BoundSessionInterface = OnlineSessionInterface;
+
+	// Players that registered before the lobby existed, e.g. after a seamless travel
+	const FNamedOnlineSession* NamedSession = OnlineSessionInterface->GetNamedSession(SessionName);
+
+	if (NamedSession)
+	{
+		for (const TSharedRef<const FUniqueNetId>& RegisteredPlayer : NamedSession->RegisteredPlayers)
+		{
+			AddMember(FUniqueNetIdRepl(RegisteredPlayer), FindPlayerName(*RegisteredPlayer));
+		}
+	}
+}
+
+void UOnlineLobbyComponent::EndPlay(const EEndPlayReason::Type arg_EndPlayReason)
+{
+	IOnlineSessionPtr OnlineSessionInterface = BoundSessionInterface.Pin();
+
+	if (OnlineSessionInterface.IsValid())
+	{
+		OnlineSessionInterface->ClearOnRegisterPlayersCompleteDelegate_Handle(OnRegisterPlayersCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnUnregisterPlayersCompleteDelegate_Handle(OnUnregisterPlayersCompleteDelegateHandle);
+	}
+
+	BoundSessionInterface.Reset();
+
+	Super::EndPlay(arg_EndPlayReason);
+}
+
+bool UOnlineLobbyComponent::AddMember(const FUniqueNetIdRepl& UserId, const FString& DisplayName)
+{
+	if (!UserId.IsValid())
+	{
+		return false;
+	}
+
+	const int32 ExistingIndex = FindMemberIndex(UserId);
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		// Names can arrive later than the player, e.g. when the player state was created after registering
+		if (DisplayName.IsEmpty() || Roster.Members[ExistingIndex].DisplayName == DisplayName)
+		{
+			return false;
+		}
+
+		Roster.Members[ExistingIndex].DisplayName = DisplayName;
+		MarkMemberDirty(ExistingIndex);
+		return true;
+	}
+
+	FUOnlineLobbyMember& Member = Roster.Members[Roster.Members.AddDefaulted()];
+	Member.UserId = UserId;
+	Member.DisplayName = DisplayName;
+	Roster.MarkItemDirty(Member);
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Lobby member %s joined"), *UserId.ToString());
+
+	NotifyMemberAdded(Member);
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::RemoveMember(const FUniqueNetIdRepl& UserId)
+{
+	const int32 MemberIndex = FindMemberIndex(UserId);
+
+	if (MemberIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Lobby member %s left"), *UserId.ToString());
+
+	NotifyMemberRemoved(Roster.Members[MemberIndex]);
+
+	// Clients match members by their replication id, so the order of the array doesn't matter
+	Roster.Members.RemoveAtSwap(MemberIndex);
+	Roster.MarkArrayDirty();
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::SetReady(const FUniqueNetIdRepl& UserId, bool bIsReady)
+{
+	const int32 MemberIndex = FindMemberIndex(UserId);
+
+	if (MemberIndex == INDEX_NONE || Roster.Members[MemberIndex].bIsReady == bIsReady)
+	{
+		return false;
+	}
+
+	Roster.Members[MemberIndex].bIsReady = bIsReady;
+	MarkMemberDirty(MemberIndex);
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::SetTeam(const FUniqueNetIdRepl& UserId, uint8 Team)
+{
+	const int32 MemberIndex = FindMemberIndex(UserId);
+
+	if (MemberIndex == INDEX_NONE || Roster.Members[MemberIndex].Team == Team)
+	{
+		return false;
+	}
+
+	Roster.Members[MemberIndex].Team = Team;
+	MarkMemberDirty(MemberIndex);
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::SetLoadout(const FUniqueNetIdRepl& UserId, const TArray<FName>& Loadout)
+{
+	const int32 MemberIndex = FindMemberIndex(UserId);
+
+	if (MemberIndex == INDEX_NONE || Roster.Members[MemberIndex].Loadout == Loadout)
+	{
+		return false;
+	}
+
+	Roster.Members[MemberIndex].Loadout = Loadout;
+	MarkMemberDirty(MemberIndex);
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::FindMember(const FUniqueNetIdRepl& UserId, FUOnlineLobbyMember& OutMember) const
+{
+	const int32 MemberIndex = FindMemberIndex(UserId);
+
+	if (MemberIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutMember = Roster.Members[MemberIndex];
+
+	return true;
+}
+
+bool UOnlineLobbyComponent::AreAllMembersReady() const
+{
+	if (Roster.Members.Num() == 0)
+	{
+		return false;
+	}
+
+	for (const FUOnlineLobbyMember& Member : Roster.Members)
+	{
+		if (!Member.bIsReady)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 UOnlineLobbyComponent::FindMemberIndex(const FUniqueNetIdRepl& arg_UserId) const
+{
+	if (!arg_UserId.IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	// A lobby holds a few dozen players at most, a scan is cheaper than keeping a map in sync with replication
+	return Roster.Members.IndexOfByPredicate([&arg_UserId](const FUOnlineLobbyMember& arg_Member)
+	{
+		return arg_Member.UserId == arg_UserId;
+	});
+}
+
+void UOnlineLobbyComponent::MarkMemberDirty(int32 arg_MemberIndex)
+{
+	FUOnlineLobbyMember& Member = Roster.Members[arg_MemberIndex];
+	Roster.MarkItemDirty(Member);
+
+	// Clients hear about it from PostReplicatedChange, the server right away
+	NotifyMemberChanged(Member);
+}
+
+FString UOnlineLobbyComponent::FindPlayerName(const FUniqueNetId& arg_UserId) const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+
+	if (GameState)
+	{
+		for (const APlayerState* PlayerState : GameState->PlayerArray)
+		{
+			if (PlayerState && PlayerState->UniqueId.IsValid() && *PlayerState->UniqueId == arg_UserId)
+			{
+				return PlayerState->GetPlayerName();
+			}
+		}
+	}
+
+	return FString();
+}
+
+void UOnlineLobbyComponent::OnRegisterPlayersComplete(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasSuccessful)
+{
+	if (arg_SessionName != SessionName || !arg_bWasSuccessful)
+	{
+		return;
+	}
+
+	for (const TSharedRef<const FUniqueNetId>& Player : arg_Players)
+	{
+		AddMember(FUniqueNetIdRepl(Player), FindPlayerName(*Player));
+	}
+}
+
+void UOnlineLobbyComponent::OnUnregisterPlayersComplete(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasSuccessful)
+{
+	// A failed unregister still means the player left
+	if (arg_SessionName != SessionName)
+	{
+		return;
+	}
+
+	for (const TSharedRef<const FUniqueNetId>& Player : arg_Players)
+	{
+		RemoveMember(FUniqueNetIdRepl(Player));
+	}
+}
@@ -0,0 +1,490 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineMatchmaker.h"
+#include "Containers/Ticker.h"
+#include "UOnlineObject.h"
+#include "UOnlineStats.h"
+
+namespace UOnlineMatchmaker
+{
+	// Ids of tickets that left the queue a bucket keeps at its front before they are dropped
+	static const int32 MinTrimCount = 64;
+}
+
+FUOnlineMatchmaker::FUOnlineMatchmaker(const FUOnlineMatchmakingOptions& arg_Options)
+	: Options(arg_Options)
+	, NextBucketIndex(0)
+	, NextTicketId(1)
+{
+	Options.PlayersPerMatch = FMath::Max(1, Options.PlayersPerMatch);
+	Options.SkillBucketWidth = FMath::Max(1.f, Options.SkillBucketWidth);
+	Options.MaxSkillWidening = FMath::Max(0, Options.MaxSkillWidening);
+	Options.MaxTicketsPerTick = FMath::Max(Options.PlayersPerMatch, Options.MaxTicketsPerTick);
+}
+
+int32 FUOnlineMatchmaker::Enqueue(const TSharedPtr<const FUniqueNetId>& arg_PlayerId, FName arg_Region, float arg_Skill, double arg_Now)
+{
+	FUOnlineMatchmakingTicket Ticket;
+	Ticket.Id = NextTicketId++;
+	Ticket.PlayerId = arg_PlayerId;
+	Ticket.Region = arg_Region;
+	Ticket.Skill = arg_Skill;
+	Ticket.EnqueueTime = arg_Now;
+
+	AddTicket(Ticket, false);
+
+	return Ticket.Id;
+}
+
+bool FUOnlineMatchmaker::Cancel(int32 arg_TicketId)
+{
+	return RemoveTicket(arg_TicketId, nullptr);
+}
+
+bool FUOnlineMatchmaker::Requeue(const FUOnlineMatchmakingTicket& arg_Ticket)
+{
+	if (Tickets.Contains(arg_Ticket.Id))
+	{
+		return false;
+	}
+
+	AddTicket(arg_Ticket, true);
+
+	return true;
+}
+
+void FUOnlineMatchmaker::SetBackfillSession(FName arg_SessionName, FName arg_Region, float arg_Skill, int32 arg_NumOpenSlots)
+{
+	FBackfillSession& Session = BackfillSessions.FindOrAdd(arg_SessionName);
+	Session.Key = MakeKey(arg_Region, arg_Skill);
+	Session.Skill = arg_Skill;
+	Session.NumOpenSlots = FMath::Max(0, arg_NumOpenSlots);
+}
+
+void FUOnlineMatchmaker::RemoveBackfillSession(FName arg_SessionName)
+{
+	BackfillSessions.Remove(arg_SessionName);
+}
+
+bool FUOnlineMatchmaker::AddOpenSlots(FName arg_SessionName, int32 arg_NumSlots)
+{
+	FBackfillSession* Session = BackfillSessions.Find(arg_SessionName);
+
+	if (!Session)
+	{
+		return false;
+	}
+
+	Session->NumOpenSlots = FMath::Max(0, Session->NumOpenSlots + arg_NumSlots);
+
+	return true;
+}
+
+int32 FUOnlineMatchmaker::GetNumOpenSlots(FName arg_SessionName) const
+{
+	const FBackfillSession* Session = BackfillSessions.Find(arg_SessionName);
+
+	return Session ? Session->NumOpenSlots : 0;
+}
+
+void FUOnlineMatchmaker::Tick(double arg_Now, int32 arg_MaxNewMatches, TArray<FUOnlineMatch>& arg_OutMatches, TArray<FUOnlineMatchmakingTicket>& arg_OutTimedOutTickets)
+{
+	// Every bucket is in arrival order, so only the tickets at the front can have timed out. Not counted in the budget, they have to go anyway
+	if (Options.TicketTimeout > 0.f)
+	{
+		for (const FBucketKey& Key : BucketOrder)
+		{
+			FBucket& Bucket = Buckets.FindChecked(Key);
+
+			while (Bucket.Head < Bucket.TicketIds.Num())
+			{
+				const FUOnlineMatchmakingTicket& Ticket = Tickets.FindChecked(Bucket.TicketIds[Bucket.Head]);
+
+				if (arg_Now - Ticket.EnqueueTime < Options.TicketTimeout)
+				{
+					break;
+				}
+
+				RemoveTicket(Ticket.Id, &arg_OutTimedOutTickets[arg_OutTimedOutTickets.AddDefaulted()]);
+			}
+		}
+	}
+
+	int32 Budget = Options.MaxTicketsPerTick;
+	TArray<int32> TicketIds;
+
+	// Running matches first, their players are already waiting for the empty slots to fill
+	for (TPair<FName, FBackfillSession>& Pair : BackfillSessions)
+	{
+		if (Budget <= 0)
+		{
+			break;
+		}
+
+		FBackfillSession& Session = Pair.Value;
+
+		if (Session.NumOpenSlots <= 0 || CountReachable(Session.Key) == 0)
+		{
+			continue;
+		}
+
+		TicketIds.Reset();
+		PeekTickets(Session.Key, Session.NumOpenSlots, arg_Now, Budget, TicketIds);
+
+		if (TicketIds.Num() == 0)
+		{
+			continue;
+		}
+
+		FUOnlineMatch& Match = arg_OutMatches[arg_OutMatches.AddDefaulted()];
+		Match.SessionName = Pair.Key;
+		Match.Region = Session.Key.Region;
+		Match.bIsBackfill = true;
+
+		TakeTickets(TicketIds, Match);
+
+		Session.NumOpenSlots -= Match.Tickets.Num();
+	}
+
+	// New matches, starting with the bucket the previous tick stopped at so every bucket gets its turn when the budget runs out
+	int32 NumNewMatches = 0;
+	int32 NumVisited = 0;
+
+	for (; NumVisited < BucketOrder.Num() && Budget > 0 && NumNewMatches < arg_MaxNewMatches; ++NumVisited)
+	{
+		const FBucketKey Key = BucketOrder[(NextBucketIndex + NumVisited) % BucketOrder.Num()];
+		const FBucket& Bucket = Buckets.FindChecked(Key);
+
+		while (Bucket.NumQueued > 0 && Budget > 0 && NumNewMatches < arg_MaxNewMatches && CountReachable(Key) >= Options.PlayersPerMatch)
+		{
+			TicketIds.Reset();
+			PeekTickets(Key, Options.PlayersPerMatch, arg_Now, Budget, TicketIds);
+
+			if (TicketIds.Num() < Options.PlayersPerMatch)
+			{
+				break;
+			}
+
+			FUOnlineMatch& Match = arg_OutMatches[arg_OutMatches.AddDefaulted()];
+			Match.Region = Key.Region;
+
+			TakeTickets(TicketIds, Match);
+
+			++NumNewMatches;
+		}
+	}
+
+	if (BucketOrder.Num() > 0)
+	{
+		NextBucketIndex = (NextBucketIndex + NumVisited) % BucketOrder.Num();
+	}
+
+	// Empty buckets go, skill brackets nobody plays in don't cost anything
+	for (int32 Index = BucketOrder.Num() - 1; Index >= 0; --Index)
+	{
+		if (Buckets.FindChecked(BucketOrder[Index]).NumQueued > 0)
+		{
+			continue;
+		}
+
+		Buckets.Remove(BucketOrder[Index]);
+		BucketOrder.RemoveAt(Index, 1, false);
+
+		if (Index < NextBucketIndex)
+		{
+			--NextBucketIndex;
+		}
+	}
+
+	if (NextBucketIndex >= BucketOrder.Num())
+	{
+		NextBucketIndex = 0;
+	}
+}
+
+FUOnlineMatchmaker::FBucketKey FUOnlineMatchmaker::MakeKey(FName arg_Region, float arg_Skill) const
+{
+	return FBucketKey(arg_Region, FMath::FloorToInt(arg_Skill / Options.SkillBucketWidth));
+}
+
+int32 FUOnlineMatchmaker::GetWidening(const FUOnlineMatchmakingTicket& arg_Ticket, double arg_Now) const
+{
+	if (Options.WideningInterval <= 0.f)
+	{
+		return Options.MaxSkillWidening;
+	}
+
+	return FMath::Clamp(FMath::FloorToInt((arg_Now - arg_Ticket.EnqueueTime) / Options.WideningInterval), 0, Options.MaxSkillWidening);
+}
+
+int32 FUOnlineMatchmaker::CountReachable(const FBucketKey& arg_Center) const
+{
+	int32 Count = 0;
+
+	for (int32 Offset = -Options.MaxSkillWidening; Offset <= Options.MaxSkillWidening; ++Offset)
+	{
+		const FBucket* Bucket = Buckets.Find(FBucketKey(arg_Center.Region, arg_Center.SkillBucket + Offset));
+
+		if (Bucket)
+		{
+			Count += Bucket->NumQueued;
+		}
+	}
+
+	return Count;
+}
+
+void FUOnlineMatchmaker::PeekTickets(const FBucketKey& arg_Center, int32 arg_NumWanted, double arg_Now, int32& arg_InOutBudget, TArray<int32>& arg_OutTicketIds) const
+{
+	for (int32 Distance = 0; Distance <= Options.MaxSkillWidening && arg_OutTicketIds.Num() < arg_NumWanted && arg_InOutBudget > 0; ++Distance)
+	{
+		for (int32 Side = -1; Side <= 1; Side += 2)
+		{
+			if (Distance == 0 && Side > 0)
+			{
+				break;
+			}
+
+			const FBucket* Bucket = Buckets.Find(FBucketKey(arg_Center.Region, arg_Center.SkillBucket + Side * Distance));
+
+			if (!Bucket)
+			{
+				continue;
+			}
+
+			for (int32 Index = Bucket->Head; Index < Bucket->TicketIds.Num() && arg_OutTicketIds.Num() < arg_NumWanted && arg_InOutBudget > 0; ++Index)
+			{
+				--arg_InOutBudget;
+
+				const FUOnlineMatchmakingTicket* Ticket = Tickets.Find(Bucket->TicketIds[Index]);
+
+				if (!Ticket)
+				{
+					continue;
+				}
+
+				// The tickets behind this one waited even less
+				if (GetWidening(*Ticket, arg_Now) < Distance)
+				{
+					break;
+				}
+
+				arg_OutTicketIds.Add(Ticket->Id);
+			}
+		}
+	}
+}
+
+void FUOnlineMatchmaker::TakeTickets(const TArray<int32>& arg_TicketIds, FUOnlineMatch& arg_OutMatch)
+{
+	float SkillSum = 0.f;
+
+	arg_OutMatch.Tickets.Reserve(arg_OutMatch.Tickets.Num() + arg_TicketIds.Num());
+
+	for (int32 TicketId : arg_TicketIds)
+	{
+		FUOnlineMatchmakingTicket& Ticket = arg_OutMatch.Tickets[arg_OutMatch.Tickets.AddDefaulted()];
+
+		if (!RemoveTicket(TicketId, &Ticket))
+		{
+			arg_OutMatch.Tickets.Pop(false);
+			continue;
+		}
+
+		SkillSum += Ticket.Skill;
+	}
+
+	arg_OutMatch.Skill = arg_OutMatch.Tickets.Num() > 0 ? SkillSum / arg_OutMatch.Tickets.Num() : 0.f;
+}
+
+void FUOnlineMatchmaker::AddTicket(const FUOnlineMatchmakingTicket& arg_Ticket, bool arg_bIsRequeued)
+{
+	Tickets.Add(arg_Ticket.Id, arg_Ticket);
+
+	const FBucketKey Key = MakeKey(arg_Ticket.Region, arg_Ticket.Skill);
+	FBucket* Bucket = Buckets.Find(Key);
+
+	if (!Bucket)
+	{
+		Bucket = &Buckets.Add(Key);
+		BucketOrder.Add(Key);
+	}
+
+	// A requeued ticket may still have its old id past the head, which would now count it twice. A new id can't be there,
+	// so enqueueing never scans the bucket
+	if (arg_bIsRequeued)
+	{
+		const int32 StaleIndex = Bucket->TicketIds.FindLast(arg_Ticket.Id);
+
+		if (StaleIndex >= Bucket->Head)
+		{
+			Bucket->TicketIds.RemoveAt(StaleIndex);
+		}
+	}
+
+	// The timeout sweep and PeekTickets rely on the arrival order, a requeued ticket goes back to its place in the line.
+	// New tickets are the youngest and stop the scan right away, ids of tickets that left are passed over
+	int32 InsertIndex = Bucket->TicketIds.Num();
+
+	while (InsertIndex > Bucket->Head)
+	{
+		const FUOnlineMatchmakingTicket* PreviousTicket = Tickets.Find(Bucket->TicketIds[InsertIndex - 1]);
+
+		if (PreviousTicket && PreviousTicket->EnqueueTime <= arg_Ticket.EnqueueTime)
+		{
+			break;
+		}
+
+		--InsertIndex;
+	}
+
+	Bucket->TicketIds.Insert(arg_Ticket.Id, InsertIndex);
+	++Bucket->NumQueued;
+}
+
+bool FUOnlineMatchmaker::RemoveTicket(int32 arg_TicketId, FUOnlineMatchmakingTicket* arg_OutTicket)
+{
+	FUOnlineMatchmakingTicket Ticket;
+
+	if (!Tickets.RemoveAndCopyValue(arg_TicketId, Ticket))
+	{
+		return false;
+	}
+
+	FBucket* Bucket = Buckets.Find(MakeKey(Ticket.Region, Ticket.Skill));
+
+	if (Bucket)
+	{
+		--Bucket->NumQueued;
+		TrimBucket(*Bucket, Tickets);
+	}
+
+	if (arg_OutTicket)
+	{
+		*arg_OutTicket = MoveTemp(Ticket);
+	}
+
+	return true;
+}
+
+void FUOnlineMatchmaker::TrimBucket(FBucket& arg_Bucket, const TMap<int32, FUOnlineMatchmakingTicket>& arg_Tickets)
+{
+	while (arg_Bucket.Head < arg_Bucket.TicketIds.Num() && !arg_Tickets.Contains(arg_Bucket.TicketIds[arg_Bucket.Head]))
+	{
+		++arg_Bucket.Head;
+	}
+
+	if (arg_Bucket.Head == arg_Bucket.TicketIds.Num())
+	{
+		arg_Bucket.TicketIds.Reset();
+		arg_Bucket.Head = 0;
+	}
+	else if (arg_Bucket.Head >= UOnlineMatchmaker::MinTrimCount && arg_Bucket.Head * 2 >= arg_Bucket.TicketIds.Num())
+	{
+		arg_Bucket.TicketIds.RemoveAt(0, arg_Bucket.Head, false);
+		arg_Bucket.Head = 0;
+	}
+}
+
+FUOnlineMatchmakingService::FUOnlineMatchmakingService(const FUOnlineMatchmakingOptions& arg_Options)
+	: Matchmaker(arg_Options)
+{
+
+}
+
+FUOnlineMatchmakingService::~FUOnlineMatchmakingService()
+{
+	Stop();
+}
+
+void FUOnlineMatchmakingService::Start(UOnlineObject* arg_OnlineObject, float arg_TickInterval)
+{
+	Stop();
+
+	OnlineObject = arg_OnlineObject;
+
+	// A fixed interval batches the tickets that arrived in between, instead of matching whoever shows up first
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FUOnlineMatchmakingService::Tick), FMath::Max(0.f, arg_TickInterval));
+}
+
+void FUOnlineMatchmakingService::Stop()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+int32 FUOnlineMatchmakingService::Enqueue(const TSharedPtr<const FUniqueNetId>& arg_PlayerId, FName arg_Region, float arg_Skill)
+{
+	return Matchmaker.Enqueue(arg_PlayerId, arg_Region, arg_Skill, FPlatformTime::Seconds());
+}
+
+bool FUOnlineMatchmakingService::NotifyPlayerLeft(FName arg_SessionName)
+{
+	return Matchmaker.AddOpenSlots(arg_SessionName, 1);
+}
+
+bool FUOnlineMatchmakingService::EndMatch(FName arg_SessionName, const FOnlineSessionSettings* arg_NextSessionSettings)
+{
+	Matchmaker.RemoveBackfillSession(arg_SessionName);
+
+	UOnlineObject* Object = OnlineObject.Get();
+
+	return Object && Object->ReleaseHostedSession(arg_SessionName, arg_NextSessionSettings);
+}
+
+bool FUOnlineMatchmakingService::Tick(float arg_DeltaTime)
+{
+	UOnlineObject* Object = OnlineObject.Get();
+
+	if (!Object)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	TArray<FUOnlineMatch> Matches;
+	TArray<FUOnlineMatchmakingTicket> TimedOutTickets;
+
+	// No more new matches than sessions to host them, the others keep their place in the queue
+	Matchmaker.Tick(FPlatformTime::Seconds(), Object->GetNumHostedSessions(EUOnlineHostedSessionState::Available), Matches, TimedOutTickets);
+
+	for (const FUOnlineMatchmakingTicket& Ticket : TimedOutTickets)
+	{
+		OnTicketTimedOut.Broadcast(Ticket);
+	}
+
+	for (FUOnlineMatch& Match : Matches)
+	{
+		if (!Match.bIsBackfill)
+		{
+			Match.SessionName = Object->AcquireHostedSession();
+
+			if (Match.SessionName.IsNone())
+			{
+				UE_LOG(LogUOnline, Warning, TEXT("No hosted session for a match of %d players in %s, they go back to the queue"), Match.Tickets.Num(), *Match.Region.ToString());
+
+				for (const FUOnlineMatchmakingTicket& Ticket : Match.Tickets)
+				{
+					Matchmaker.Requeue(Ticket);
+				}
+
+				continue;
+			}
+
+			const FUOnlineHostedSession* HostedSession = Object->GetHostedSession(Match.SessionName);
+
+			// Kept even when full, a player that leaves opens a slot again
+			if (HostedSession && HostedSession->Settings->bAllowJoinInProgress)
+			{
+				Matchmaker.SetBackfillSession(Match.SessionName, Match.Region, Match.Skill, HostedSession->Settings->NumPublicConnections - Match.Tickets.Num());
+			}
+		}
+
+		OnMatchFound.Broadcast(Match);
+	}
+
+	return true;
+}
@@ -0,0 +1,292 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineMatchmakingCommandlet.h"
+#include "UOnlineStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUOnlineMatchmaking, Log, All);
+
+UOnlineMatchmakingCommandlet::UOnlineMatchmakingCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	ArrivalRate = 100.f;
+	Duration = 600.f;
+	TickInterval = 1.f;
+	NumRegions = 4;
+	SkillMean = 1500.f;
+	SkillDeviation = 300.f;
+	MaxPlayers = 10;
+	MatchLength = 300.f;
+	LeaveRate = 0.001f;
+	NumSessions = 0;
+	NextSessionNumber = 0;
+
+	NumEnqueued = 0;
+	NumMatched = 0;
+	NumBackfilled = 0;
+	NumTimedOut = 0;
+	NumLeft = 0;
+	NumMatches = 0;
+	NumBackfills = 0;
+	PeakQueued = 0;
+	PeakBuckets = 0;
+}
+
+int32 UOnlineMatchmakingCommandlet::Main(const FString& arg_Params)
+{
+	FString OutputFilename = FPaths::ProjectSavedDir() / TEXT("Benchmarks/UOnlineMatchmaking.json");
+	int32 Seed = 0;
+	float MaxTickCostMs = 0.f;
+
+	FParse::Value(*arg_Params, TEXT("ArrivalRate="), ArrivalRate);
+	FParse::Value(*arg_Params, TEXT("Duration="), Duration);
+	FParse::Value(*arg_Params, TEXT("TickInterval="), TickInterval);
+	FParse::Value(*arg_Params, TEXT("Regions="), NumRegions);
+	FParse::Value(*arg_Params, TEXT("SkillMean="), SkillMean);
+	FParse::Value(*arg_Params, TEXT("SkillDeviation="), SkillDeviation);
+	FParse::Value(*arg_Params, TEXT("MaxPlayers="), MaxPlayers);
+	FParse::Value(*arg_Params, TEXT("MatchLength="), MatchLength);
+	FParse::Value(*arg_Params, TEXT("LeaveRate="), LeaveRate);
+	FParse::Value(*arg_Params, TEXT("Sessions="), NumSessions);
+	FParse::Value(*arg_Params, TEXT("Seed="), Seed);
+	FParse::Value(*arg_Params, TEXT("MaxTickCostMs="), MaxTickCostMs);
+	FParse::Value(*arg_Params, TEXT("Output="), OutputFilename);
+
+	FUOnlineMatchmakingOptions Options;
+	FParse::Value(*arg_Params, TEXT("PlayersPerMatch="), Options.PlayersPerMatch);
+	FParse::Value(*arg_Params, TEXT("SkillBucketWidth="), Options.SkillBucketWidth);
+	FParse::Value(*arg_Params, TEXT("WideningInterval="), Options.WideningInterval);
+	FParse::Value(*arg_Params, TEXT("MaxSkillWidening="), Options.MaxSkillWidening);
+	FParse::Value(*arg_Params, TEXT("MaxTicketsPerTick="), Options.MaxTicketsPerTick);
+	FParse::Value(*arg_Params, TEXT("TicketTimeout="), Options.TicketTimeout);
+
+	// The matchmaker clamps what makes no sense, report what it actually ran with
+	MatchmakingOptions = FUOnlineMatchmaker(Options).GetOptions();
+
+	TickInterval = FMath::Max(0.01f, TickInterval);
+	NumRegions = FMath::Max(1, NumRegions);
+	MaxPlayers = FMath::Max(MatchmakingOptions.PlayersPerMatch, MaxPlayers);
+	Random.Initialize(Seed);
+
+	for (int32 Index = 0; Index < NumRegions; ++Index)
+	{
+		RegionNames.Add(FName(TEXT("Region"), Index + 1));
+	}
+
+	Simulate();
+
+	if (!WriteReport(OutputFilename))
+	{
+		UE_LOG(LogUOnlineMatchmaking, Error, TEXT("Failed to write %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogUOnlineMatchmaking, Display, TEXT("Report written to %s"), *OutputFilename);
+
+	const double SlowestTickMs = FUOnlineSampleSummary(TickMilliseconds).GetPercentile(100.0);
+
+	if (MaxTickCostMs > 0.f && SlowestTickMs > MaxTickCostMs)
+	{
+		UE_LOG(LogUOnlineMatchmaking, Error, TEXT("Slowest tick took %.3f ms, more than %.3f ms"), SlowestTickMs, MaxTickCostMs);
+		return 1;
+	}
+
+	return 0;
+}
+
+void UOnlineMatchmakingCommandlet::Simulate()
+{
+	FUOnlineMatchmaker Matchmaker(MatchmakingOptions);
+
+	TArray<FUOnlineMatch> Matches;
+	TArray<FUOnlineMatchmakingTicket> TimedOutTickets;
+
+	const double ExpectedArrivals = ArrivalRate * TickInterval;
+	const float LeaveChance = LeaveRate * TickInterval;
+
+	for (double Now = 0.0; Now < Duration; Now += TickInterval)
+	{
+		// Whole arrivals plus one more as often as the fraction says, the rate comes out right on average
+		const int32 NumArrivals = FMath::FloorToInt(static_cast<float>(ExpectedArrivals) + Random.FRand());
+
+		for (int32 Index = 0; Index < NumArrivals; ++Index)
+		{
+			Matchmaker.Enqueue(nullptr, RegionNames[Random.RandRange(0, RegionNames.Num() - 1)], RollSkill(), Now);
+		}
+
+		NumEnqueued += NumArrivals;
+
+		for (TMap<FName, FSimulatedSession>::TIterator It(Sessions); It; ++It)
+		{
+			FSimulatedSession& Session = It.Value();
+
+			if (Session.EndTime <= Now)
+			{
+				Matchmaker.RemoveBackfillSession(It.Key());
+				It.RemoveCurrent();
+				continue;
+			}
+
+			int32 NumLeaving = 0;
+
+			for (int32 Index = 0; Index < Session.NumPlayers; ++Index)
+			{
+				if (Random.FRand() < LeaveChance)
+				{
+					++NumLeaving;
+				}
+			}
+
+			if (NumLeaving > 0)
+			{
+				Session.NumPlayers -= NumLeaving;
+				NumLeft += NumLeaving;
+				Matchmaker.AddOpenSlots(It.Key(), NumLeaving);
+			}
+		}
+
+		const int32 MaxNewMatches = NumSessions > 0 ? FMath::Max(0, NumSessions - Sessions.Num()) : MAX_int32;
+
+		Matches.Reset();
+		TimedOutTickets.Reset();
+
+		const double TickStartTime = FPlatformTime::Seconds();
+
+		Matchmaker.Tick(Now, MaxNewMatches, Matches, TimedOutTickets);
+
+		TickMilliseconds.Add((FPlatformTime::Seconds() - TickStartTime) * 1000.0);
+
+		NumTimedOut += TimedOutTickets.Num();
+		PeakQueued = FMath::Max(PeakQueued, Matchmaker.NumQueued());
+		PeakBuckets = FMath::Max(PeakBuckets, Matchmaker.NumBuckets());
+
+		for (FUOnlineMatch& Match : Matches)
+		{
+			if (Match.bIsBackfill)
+			{
+				FSimulatedSession* Session = Sessions.Find(Match.SessionName);
+
+				if (Session)
+				{
+					Session->NumPlayers += Match.Tickets.Num();
+				}
+			}
+			else
+			{
+				Match.SessionName = FName(TEXT("Match"), ++NextSessionNumber);
+
+				FSimulatedSession& Session = Sessions.Add(Match.SessionName);
+				Session.NumPlayers = Match.Tickets.Num();
+				Session.EndTime = Now + MatchLength;
+
+				Matchmaker.SetBackfillSession(Match.SessionName, Match.Region, Match.Skill, MaxPlayers - Session.NumPlayers);
+			}
+
+			RecordMatch(Match, Now);
+		}
+	}
+
+	UE_LOG(LogUOnlineMatchmaking, Display, TEXT("%d players queued, %d matched, %d backfilled, %d timed out, %d still queued"), NumEnqueued, NumMatched, NumBackfilled, NumTimedOut, Matchmaker.NumQueued());
+}
+
+void UOnlineMatchmakingCommandlet::RecordMatch(const FUOnlineMatch& arg_Match, double arg_Now)
+{
+	float MinSkill = MAX_flt;
+	float MaxSkill = -MAX_flt;
+
+	for (const FUOnlineMatchmakingTicket& Ticket : arg_Match.Tickets)
+	{
+		WaitSeconds.Add(arg_Now - Ticket.EnqueueTime);
+		MinSkill = FMath::Min(MinSkill, Ticket.Skill);
+		MaxSkill = FMath::Max(MaxSkill, Ticket.Skill);
+	}
+
+	if (arg_Match.bIsBackfill)
+	{
+		NumBackfilled += arg_Match.Tickets.Num();
+		++NumBackfills;
+	}
+	else
+	{
+		NumMatched += arg_Match.Tickets.Num();
+		++NumMatches;
+		SkillSpreads.Add(MaxSkill - MinSkill);
+	}
+}
+
+float UOnlineMatchmakingCommandlet::RollSkill()
+{
+	// Box-Muller
+	const float U1 = FMath::Max(Random.FRand(), SMALL_NUMBER);
+	const float U2 = Random.FRand();
+
+	return FMath::Max(0.f, SkillMean + SkillDeviation * FMath::Sqrt(-2.f * FMath::Loge(U1)) * FMath::Cos(2.f * PI * U2));
+}
+
+bool UOnlineMatchmakingCommandlet::WriteReport(const FString& arg_Filename) const
+{
+	const FUOnlineSampleSummary Waits(WaitSeconds);
+	const FUOnlineSampleSummary Spreads(SkillSpreads);
+	const FUOnlineSampleSummary Ticks(TickMilliseconds);
+
+	FString Report;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+
+	Writer->WriteObjectStart();
+
+	Writer->WriteObjectStart(TEXT("Options"));
+	Writer->WriteValue(TEXT("ArrivalRate"), ArrivalRate);
+	Writer->WriteValue(TEXT("Duration"), Duration);
+	Writer->WriteValue(TEXT("TickInterval"), TickInterval);
+	Writer->WriteValue(TEXT("Regions"), NumRegions);
+	Writer->WriteValue(TEXT("MaxPlayers"), MaxPlayers);
+	Writer->WriteValue(TEXT("MatchLength"), MatchLength);
+	Writer->WriteValue(TEXT("LeaveRate"), LeaveRate);
+	Writer->WriteValue(TEXT("Sessions"), NumSessions);
+	Writer->WriteValue(TEXT("PlayersPerMatch"), MatchmakingOptions.PlayersPerMatch);
+	Writer->WriteValue(TEXT("SkillBucketWidth"), MatchmakingOptions.SkillBucketWidth);
+	Writer->WriteValue(TEXT("WideningInterval"), MatchmakingOptions.WideningInterval);
+	Writer->WriteValue(TEXT("MaxSkillWidening"), MatchmakingOptions.MaxSkillWidening);
+	Writer->WriteValue(TEXT("MaxTicketsPerTick"), MatchmakingOptions.MaxTicketsPerTick);
+	Writer->WriteValue(TEXT("TicketTimeout"), MatchmakingOptions.TicketTimeout);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("Players"));
+	Writer->WriteValue(TEXT("Queued"), NumEnqueued);
+	Writer->WriteValue(TEXT("Matched"), NumMatched);
+	Writer->WriteValue(TEXT("Backfilled"), NumBackfilled);
+	Writer->WriteValue(TEXT("TimedOut"), NumTimedOut);
+	Writer->WriteValue(TEXT("Left"), NumLeft);
+	Writer->WriteValue(TEXT("PeakQueued"), PeakQueued);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteValue(TEXT("Matches"), NumMatches);
+	Writer->WriteValue(TEXT("Backfills"), NumBackfills);
+	Writer->WriteValue(TEXT("PeakBuckets"), PeakBuckets);
+
+	Writer->WriteObjectStart(TEXT("WaitInSeconds"));
+	Waits.WritePercentiles(*Writer, { 50.0, 90.0, 99.0, 100.0 });
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("SkillSpread"));
+	Spreads.WritePercentiles(*Writer, { 50.0, 90.0, 100.0 });
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("TickCostInMs"));
+	Writer->WriteValue(TEXT("Mean"), Ticks.GetMean());
+	Ticks.WritePercentiles(*Writer, { 50.0, 99.0, 100.0 });
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	UE_LOG(LogUOnlineMatchmaking, Display, TEXT("%d matches, %d backfills, wait p50 %.1f s, p99 %.1f s, tick p99 %.3f ms, max %.3f ms"), NumMatches, NumBackfills, Waits.GetPercentile(50.0), Waits.GetPercentile(99.0), Ticks.GetPercentile(99.0), Ticks.GetPercentile(100.0));
+
+	return FFileHelper::SaveStringToFile(Report, *arg_Filename);
+}
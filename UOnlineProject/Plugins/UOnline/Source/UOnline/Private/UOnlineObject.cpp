@@ -4,31 +4,128 @@
 #include "Runtime/Engine/Classes/Engine/Engine.h"
 #include "Runtime/Engine/Classes/Kismet/GameplayStatics.h"
 #include "Runtime/Engine/Classes/Engine/LocalPlayer.h"
+#include "Runtime/Engine/Classes/GameFramework/PlayerController.h"
+#include "Containers/Ticker.h"
+#include "Async/Async.h"
+#include "UOnlineStats.h"
+#include "UOnline.h"
+#include "UOnlineWarmup.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tick requests"), STAT_UOnline_TickRequests, STATGROUP_UOnline);
 
 UOnlineObject::UOnlineObject(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	OnCreateSessionCompleteDelegate = FOnCreateSessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnCreateSessionComplete);
 	OnStartSessionCompleteDelegate = FOnStartSessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnStartSessionComplete);
+	OnEndSessionCompleteDelegate = FOnEndSessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnEndSessionComplete);
 	OnFindSessionsCompleteDelegate = FOnFindSessionsCompleteDelegate::CreateUObject(this, &UOnlineObject::OnFindSessionsComplete);
 	OnJoinSessionCompleteDelegate = FOnJoinSessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnJoinSessionComplete);
 	OnDestroySessionCompleteDelegate = FOnDestroySessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnDestroySessionComplete);
+	OnUpdateSessionCompleteDelegate = FOnUpdateSessionCompleteDelegate::CreateUObject(this, &UOnlineObject::OnUpdateSessionComplete);
 	OnReadFriendsListCompleteDelegate = FOnReadFriendsListComplete::CreateUObject(this, &UOnlineObject::OnReadFriendsListComplete);
 	OnSessionUserInviteAcceptedDelegate = FOnSessionUserInviteAcceptedDelegate::CreateUObject(this, &UOnlineObject::OnSessionUserInviteAccepted);
+	OnFriendRemovedDelegate = FOnFriendRemovedDelegate::CreateUObject(this, &UOnlineObject::OnFriendRemoved);
+	OnFriendInviteAcceptedDelegate = FOnInviteAcceptedDelegate::CreateUObject(this, &UOnlineObject::OnFriendInviteAccepted);
+	OnPresenceReceivedDelegate = FOnPresenceReceivedDelegate::CreateUObject(this, &UOnlineObject::OnPresenceReceived);
+
+	SessionSearchMaxResults = 100;
+	SessionCacheTimeToLive = 30.f;
+	SessionCacheMaxQueries = 8;
+	RequestTimeout = 30.f;
+	MaxActiveRequests = 16;
+	MaxPendingRequests = 64;
+	MaxFriendsPerLocalUser = 5000;
+	OnlineSubsystemName = NAME_None;
+	HostedSessionCreatesPerTick = 4;
+	SessionUpdateMinInterval = 1.f;
+	ConnectStringPrefetchCount = 8;
+	SearchPostProcessMinResults = 64;
+	FriendsAppliedPerTick = 500;
+}
+
+void UOnlineObject::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Config values are only known from here on
+	SessionCache.SetTimeToLive(SessionCacheTimeToLive);
+	SessionCache.SetMaxEntries(SessionCacheMaxQueries);
+	RequestQueue.SetLimits(MaxActiveRequests, MaxPendingRequests);
+	FriendsCache.SetMaxFriendsPerUser(MaxFriendsPerLocalUser);
+	SessionSettingsTracker.SetMinUpdateInterval(SessionUpdateMinInterval);
+	ConnectStringCache.SetLimits(SessionCacheTimeToLive, ConnectStringPrefetchCount * SessionCacheMaxQueries);
+
+	// Invites can arrive before any request was made
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		BindSessionDelegates();
+		ConsumeWarmup();
+	}
+}
+
+void UOnlineObject::BeginDestroy()
+{
+	if (RequestTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(RequestTickerHandle);
+		RequestTickerHandle.Reset();
+	}
+
+	if (WarmupCompleteDelegateHandle.IsValid())
+	{
+		FUOnlineModule* UOnlineModule = FUOnlineModule::GetPtr();
+		TSharedPtr<FUOnlineWarmup> Warmup = UOnlineModule ? UOnlineModule->GetWarmup() : nullptr;
+
+		if (Warmup.IsValid())
+		{
+			Warmup->OnComplete().Remove(WarmupCompleteDelegateHandle);
+		}
+
+		WarmupCompleteDelegateHandle.Reset();
+	}
+
+	if (WarmupSearchCompleteDelegateHandle.IsValid())
+	{
+		FUOnlineModule* UOnlineModule = FUOnlineModule::GetPtr();
+		TSharedPtr<FUOnlineWarmup> Warmup = UOnlineModule ? UOnlineModule->GetWarmup() : nullptr;
+
+		if (Warmup.IsValid())
+		{
+			Warmup->OnSearchComplete().Remove(WarmupSearchCompleteDelegateHandle);
+		}
+
+		WarmupSearchCompleteDelegateHandle.Reset();
+	}
+
+	UnbindSessionDelegates();
+	UnbindFriendsDelegates();
+	DrainingSearchRequests.Empty();
+
+	for (const TSharedRef<FUOnlineSessionRanker>& SessionRanker : SessionRankers)
+	{
+		SessionRanker->Cancel();
+	}
+
+	SessionRankers.Empty();
+	JoinTravels.Empty();
+
+	Super::BeginDestroy();
 }
 
-bool UOnlineObject::CreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxNumPlayers)
+int32 UOnlineObject::CreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxNumPlayers, const FOnUOnlineRequestComplete& arg_OnComplete)
 {
 	// Get the Online Subsystem to work with
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(OnlineSubsystemName);
 
 	if (OnlineSubsystemInterface)
 	{
 		// Get the Session Interface, so we can call the "CreateSession" function on it
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
 
-		if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid())
+		if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid() && arg_SessionName != NAME_None)
 		{
-			SessionSettings = MakeShareable(new FOnlineSessionSettings());
+			// Every request owns its settings, so overlapping creates don't overwrite each other
+			TSharedRef<FOnlineSessionSettings> SessionSettings = MakeShareable(new FOnlineSessionSettings());
 
 			SessionSettings->bIsLANMatch = arg_bIsLAN;
 			SessionSettings->bUsesPresence = arg_bIsPresence;
@@ -45,250 +142,2503 @@ bool UOnlineObject::CreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId,
 				SessionSettings->Set(SETTING_MAPNAME, arg_Map, EOnlineDataAdvertisementType::ViaOnlineService);
 			}
 
-			// Set the delegate to the Handle of the SessionInterface
-			OnCreateSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegate);
-
 			// Our delegate should get called when this is complete (doesn't need to be successful!)
-			return OnlineSessionInterface->CreateSession(*arg_UserNetId, arg_SessionName, *SessionSettings);
+			return SubmitCreateSession(arg_UserNetId, arg_SessionName, SessionSettings, arg_OnComplete);
 		}
 		else
 		{
-			return false;
+			return FUOnlineRequest::InvalidId;
 		}
 	}
 	else
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, TEXT("No OnlineSubsytem found!"));
+		UE_LOG(LogUOnline, Warning, TEXT("No OnlineSubsystem found"));
 
-		return false;
+		return FUOnlineRequest::InvalidId;
 	}
 }
 
-bool UOnlineObject::JoinSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult & arg_SearchResult)
+int32 UOnlineObject::JoinSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult & arg_SearchResult, const FOnUOnlineRequestComplete& arg_OnComplete)
 {
-	// Get OnlineSubsystem we want to work with
-	IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
+	// Get SessionInterface from the OnlineSubsystem
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
 
-	if (OnlineSubsystemInterface)
+	if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid() && arg_SessionName != NAME_None)
 	{
-		// Get SessionInterface from the OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		// The "SessionSearch->SearchResults" of a search request can be used to get such a "FOnlineSessionSearchResult" and pass it.
+		TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::JoinSession, arg_SessionName));
+		Request->UserNetId = arg_UserNetId;
+		Request->SearchResult = arg_SearchResult;
 
-		if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid())
+		if (arg_OnComplete.IsBound())
 		{
-			// Call the "JoinSession" Function with the passed "SearchResult". The "SessionSearch->SearchResults" can be used to get such a
-			// "FOnlineSessionSearchResult" and pass it. Pretty straight forward!
-			return OnlineSessionInterface->JoinSession(*arg_UserNetId, arg_SessionName, arg_SearchResult);
+			Request->Completions.Add(arg_OnComplete);
 		}
+
+		return SubmitRequest(Request);
 	}
 
-	return false;
+	return FUOnlineRequest::InvalidId;
 }
 
-void UOnlineObject::FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence)
+int32 UOnlineObject::JoinSessionAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, const FOnUOnlineJoinComplete& arg_OnComplete)
 {
-	// Get the OnlineSubsystem we want to work with
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
+	return SubmitJoinAndTravel(arg_UserNetId, arg_PlayerController, arg_SessionName, arg_SearchResult, false, arg_OnComplete);
+}
 
-	if (OnlineSubsystemInterface)
+int32 UOnlineObject::JoinSessionAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FUOnlineSessionResultStore& arg_SearchResults, int32 arg_ResultIndex, const FOnUOnlineJoinComplete& arg_OnComplete)
+{
+	FOnlineSessionSearchResult SearchResult;
+
+	// Only the session that is joined is rebuilt in full
+	if (arg_ResultIndex >= 0 && arg_ResultIndex < arg_SearchResults.Num())
+	{
+		arg_SearchResults.Rehydrate(arg_ResultIndex, SearchResult);
+	}
+
+	return SubmitJoinAndTravel(arg_UserNetId, arg_PlayerController, arg_SessionName, SearchResult, false, arg_OnComplete);
+}
+
+void UOnlineObject::PrefetchConnectStrings(const TArray<FOnlineSessionSearchResult>& arg_SearchResults)
+{
+	ConnectStringCache.Prefetch(GetSessionInterface(), arg_SearchResults, ConnectStringPrefetchCount, FPlatformTime::Seconds());
+}
+
+int32 UOnlineObject::FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	return FindSessions(arg_UserNetId, arg_bIsLAN, arg_bIsPresence, FUOnlineSessionFilter(), arg_OnComplete);
+}
+
+int32 UOnlineObject::FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	return SubmitFindSessions(arg_UserNetId, arg_bIsLAN, arg_bIsPresence, arg_Filter, arg_OnComplete, INDEX_NONE);
+}
+
+int32 UOnlineObject::SubmitFindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete, int32 arg_LocalUserNum)
+{
+	// Get the SessionInterface from our OnlineSubsystem
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid())
 	{
-		// Get the SessionInterface from our OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		TSharedRef<FOnlineSessionSearch> SearchSettingsRef = MakeSessionSearch(arg_bIsLAN, arg_bIsPresence);
+		arg_Filter.ApplyToSearch(*SearchSettingsRef);
+
+		const TSharedPtr<const FUOnlineSessionFilterPredicate> SessionFilter = MakeSessionFilter(arg_Filter);
+		const FUOnlineSessionQueryKey QueryKey(arg_bIsLAN, arg_bIsPresence, *SearchSettingsRef, SessionFilter.Get());
+
+		// If we have seen this query before, its snapshot can be read right away, even if it is stale. The delta is empty,
+		// nothing changed since the snapshot, and a refresh is reported as a delta against it
+		const TSharedPtr<const FUOnlineSessionResultStore> CachedResults = SessionCache.GetResults(QueryKey);
+
+		if (CachedResults.IsValid())
+		{
+			OnSessionSearchUpdated.Broadcast(FUOnlineSessionSearchDelta(QueryKey, true));
 
-		if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid())
+			// Fresh enough, no need to ask the subsystem. The snapshot is handed out as it is, callers rehydrate what they read
+			if (SessionCache.IsFresh(QueryKey, FPlatformTime::Seconds()))
+			{
+				FUOnlineRequestResult RequestResult;
+				RequestResult.RequestId = RequestQueue.AllocateId();
+				RequestResult.Type = EUOnlineRequestType::FindSessions;
+				RequestResult.Status = EUOnlineRequestStatus::Succeeded;
+				RequestResult.CachedResults = CachedResults;
+
+				arg_OnComplete.ExecuteIfBound(RequestResult);
+
+				return RequestResult.RequestId;
+			}
+		}
+
+		// This query is already queued or running, share its outcome instead of searching twice
+		TSharedPtr<FUOnlineRequest> RunningRequest = RequestQueue.FindByPredicate([&QueryKey](const FUOnlineRequest& arg_Request)
+		{
+			return arg_Request.Type == EUOnlineRequestType::FindSessions && !arg_Request.SearchStream.IsValid() && arg_Request.QueryKey == QueryKey;
+		});
+
+		if (RunningRequest.IsValid())
 		{
-			SessionSearch = MakeShareable(new FOnlineSessionSearch());
-			SessionSearch->bIsLanQuery = arg_bIsLAN;
-			SessionSearch->MaxSearchResults = 20;
-			SessionSearch->PingBucketSize = 50;
+			RunningRequest->SearchOwners.Add(arg_LocalUserNum);
 
-			if (arg_bIsPresence)
+			if (arg_OnComplete.IsBound())
 			{
-				SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, arg_bIsPresence, EOnlineComparisonOp::Equals);
+				RunningRequest->Completions.Add(arg_OnComplete);
 			}
 
-			TSharedRef<FOnlineSessionSearch> SearchSettingsRef = SessionSearch.ToSharedRef();
+			return RunningRequest->Id;
+		}
 
-			// Set the Delegate to the Delegate Handle of the FindSession function
-			OnFindSessionsCompleteDelegateHandle = OnlineSessionInterface->AddOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegate);
+		TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::FindSessions, NAME_None));
+		Request->UserNetId = arg_UserNetId;
+		Request->SessionSearch = SearchSettingsRef;
+		Request->QueryKey = QueryKey;
+		Request->SessionFilter = SessionFilter;
+		Request->SearchOwners.Add(arg_LocalUserNum);
 
-			// Finally call the SessionInterface function. The Delegate gets called once this is finished
-			OnlineSessionInterface->FindSessions(*arg_UserNetId, SearchSettingsRef);
+		if (arg_OnComplete.IsBound())
+		{
+			Request->Completions.Add(arg_OnComplete);
 		}
+
+		return SubmitRequest(Request);
 	}
-	else
-	{
-		// If something goes wrong, just call the Delegate Function directly with "false".
-		OnFindSessionsComplete(false);
-	}
+
+	return FUOnlineRequest::InvalidId;
+}
+
+int32 UOnlineObject::FindSessionsStreaming(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionSearchStreamOptions& arg_Options, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	return FindSessionsStreaming(arg_UserNetId, arg_bIsLAN, arg_bIsPresence, arg_Options, FUOnlineSessionFilter(), arg_OnComplete);
 }
 
-bool UOnlineObject::DestroySession(FName arg_SessionName)
+int32 UOnlineObject::FindSessionsStreaming(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionSearchStreamOptions& arg_Options, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete)
 {
-	// Get OnlineSubsystem we want to work with
-	IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
+	// Get the SessionInterface from our OnlineSubsystem
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
 
-	if (OnlineSubsystemInterface)
+	if (OnlineSessionInterface.IsValid() && arg_UserNetId.IsValid())
 	{
-		// Get SessionInterface from the OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		TSharedRef<FOnlineSessionSearch> SearchSettingsRef = MakeSessionSearch(arg_bIsLAN, arg_bIsPresence, arg_Options.MaxResults);
+		arg_Filter.ApplyToSearch(*SearchSettingsRef);
+
+		const TSharedPtr<const FUOnlineSessionFilterPredicate> SessionFilter = MakeSessionFilter(arg_Filter);
 
-		if (OnlineSessionInterface.IsValid() && arg_SessionName.IsValid())
+		TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::FindSessions, NAME_None));
+		Request->UserNetId = arg_UserNetId;
+		Request->SessionSearch = SearchSettingsRef;
+		Request->QueryKey = FUOnlineSessionQueryKey(arg_bIsLAN, arg_bIsPresence, *SearchSettingsRef, SessionFilter.Get());
+		Request->SessionFilter = SessionFilter;
+
+		// Results trickle into SearchResults while the query runs, the pipeline ticker hands them out as they arrive
+		Request->SearchStream = MakeShareable(new FUOnlineSessionSearchStream(SearchSettingsRef, arg_Options, SessionFilter));
+
+		if (arg_OnComplete.IsBound())
 		{
-			OnlineSessionInterface->AddOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegate);
-			return OnlineSessionInterface->DestroySession(arg_SessionName);
+			Request->Completions.Add(arg_OnComplete);
 		}
+
+		return SubmitRequest(Request);
 	}
 
-	return false;
+	return FUOnlineRequest::InvalidId;
 }
 
-void UOnlineObject::OnDestroySessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+int32 UOnlineObject::FindSessionsForLocalUser(int32 arg_LocalUserNum, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnDestroySessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful));
+	FUOnlineLocalUserState& LocalUser = FindOrAddLocalUser(arg_LocalUserNum);
 
-	// Get the OnlineSubsystem we want to work with
-	IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
-	if (OnlineSubsystemInterface)
+	if (!LocalUser.UserNetId.IsValid())
 	{
-		// Get the SessionInterface from the OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		return FUOnlineRequest::InvalidId;
+	}
 
-		if (OnlineSessionInterface.IsValid())
-		{
-			// Clear the Delegate
-			OnlineSessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegateHandle);
-		}
+	const int32 PreviousRequestId = LocalUser.SearchRequestId;
+	const TSharedPtr<const FUniqueNetId> UserNetId = LocalUser.UserNetId;
+
+	LocalUser.bHasSearched = true;
+	LocalUser.SearchQueryKey = MakeSessionQueryKey(arg_bIsLAN, arg_bIsPresence, arg_Filter);
+	LocalUser.SearchRequestId = FUOnlineRequest::InvalidId;
+
+	// The request of another local user with the same query is shared. Results served from the cache are handed out
+	// before it returns, and the callback may add local users, so the state is looked up again afterwards
+	const int32 RequestId = SubmitFindSessions(UserNetId, arg_bIsLAN, arg_bIsPresence, arg_Filter, arg_OnComplete, arg_LocalUserNum);
+
+	if (FUOnlineLocalUserState* SearchingUser = LocalUsers.Find(arg_LocalUserNum))
+	{
+		SearchingUser->SearchRequestId = RequestId;
+	}
+
+	if (PreviousRequestId != RequestId)
+	{
+		CancelSupersededSearch(PreviousRequestId, arg_LocalUserNum);
 	}
+
+	return RequestId;
 }
 
-void UOnlineObject::OnReadFriendsListComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FString& arg_FriendsListName, const FString& arg_ErrorString)
+TSharedPtr<const FUOnlineSessionResultStore> UOnlineObject::GetLocalUserSessionResults(int32 arg_LocalUserNum) const
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnReadFriendsListComplete: %d"), arg_bWasSuccessful));
+	const FUOnlineLocalUserState* LocalUser = LocalUsers.Find(arg_LocalUserNum);
 
-	if (arg_bWasSuccessful)
+	if (!LocalUser || !LocalUser->bHasSearched)
 	{
-		IOnlineFriendsPtr OnlineFriendInterface = Online::GetFriendsInterface();
-
-		if (OnlineFriendInterface.IsValid())
-		{
-			OnlineFriendInterface->GetFriendsList(arg_LocalUserNum, arg_FriendsListName, FriendsList);
-		}
+		return nullptr;
 	}
-	else
+
+	return SessionCache.GetResults(LocalUser->SearchQueryKey);
+}
+
+bool UOnlineObject::GetCachedSessions(bool arg_bIsLAN, bool arg_bIsPresence, TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const
+{
+	return GetCachedSessions(arg_bIsLAN, arg_bIsPresence, FUOnlineSessionFilter(), arg_OutSearchResults);
+}
+
+bool UOnlineObject::GetCachedSessions(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const
+{
+	const TSharedPtr<const FUOnlineSessionResultStore> CachedResults = GetCachedSessionResults(arg_bIsLAN, arg_bIsPresence, arg_Filter);
+
+	if (CachedResults.IsValid())
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, FString::Printf(TEXT("Failed to read friends: %s"), *arg_ErrorString));
+		CachedResults->RehydrateAll(arg_OutSearchResults);
+		return true;
 	}
+
+	return false;
 }
 
-void UOnlineObject::OnSessionUserInviteAccepted(const bool arg_bWasSuccesful, const int32 arg_LocalUserNum, TSharedPtr<const FUniqueNetId> arg_NetId, const FOnlineSessionSearchResult& arg_SessionSearchResult)
+TSharedPtr<const FUOnlineSessionResultStore> UOnlineObject::GetCachedSessionResults(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter) const
+{
+	return SessionCache.GetResults(MakeSessionQueryKey(arg_bIsLAN, arg_bIsPresence, arg_Filter));
+}
+
+void UOnlineObject::InvalidateSessionCache()
+{
+	SessionCache.Empty();
+	ConnectStringCache.Empty();
+}
+
+FUOnlineSessionQueryKey UOnlineObject::MakeSessionQueryKey(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter) const
+{
+	const TSharedRef<FOnlineSessionSearch> SessionSearch = MakeSessionSearch(arg_bIsLAN, arg_bIsPresence);
+	arg_Filter.ApplyToSearch(*SessionSearch);
+
+	const TSharedPtr<const FUOnlineSessionFilterPredicate> SessionFilter = MakeSessionFilter(arg_Filter);
+
+	return FUOnlineSessionQueryKey(arg_bIsLAN, arg_bIsPresence, *SessionSearch, SessionFilter.Get());
+}
+
+TSharedRef<FOnlineSessionSearch> UOnlineObject::MakeSessionSearch(bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxResults) const
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnSessionUserInviteAccepted: %d"), arg_bWasSuccesful));
+	TSharedRef<FOnlineSessionSearch> NewSessionSearch = MakeShareable(new FOnlineSessionSearch());
+	NewSessionSearch->bIsLanQuery = arg_bIsLAN;
+	NewSessionSearch->MaxSearchResults = arg_MaxResults > 0 ? arg_MaxResults : SessionSearchMaxResults;
+	NewSessionSearch->PingBucketSize = 50;
 
-	if (arg_bWasSuccesful)
+	if (arg_bIsPresence)
 	{
-		if (arg_SessionSearchResult.IsValid())
-		{
-			IOnlineSessionPtr SessionInt = IOnlineSubsystem::Get()->GetSessionInterface();
-			SessionInt->JoinSession(arg_LocalUserNum, GameSessionName, arg_SessionSearchResult);
-		}
+		NewSessionSearch->QuerySettings.Set(SEARCH_PRESENCE, arg_bIsPresence, EOnlineComparisonOp::Equals);
 	}
+
+	return NewSessionSearch;
 }
 
-void UOnlineObject::OnCreateSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+int32 UOnlineObject::SubmitJoinAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, bool arg_bCanUsePrivateSlots, const FOnUOnlineJoinComplete& arg_OnComplete)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnCreateSessionComplete %d"), arg_bWasSuccessful));
+	TSharedRef<FUOnlineJoinTravel> JoinTravel = MakeShareable(new FUOnlineJoinTravel());
+	JoinTravel->PlayerController = arg_PlayerController;
+	JoinTravel->OnComplete = arg_OnComplete;
+	JoinTravel->StartTime = FPlatformTime::Seconds();
+	JoinTravel->Result.SessionName = arg_SessionName;
 
-	// Get the OnlineSubsystem so we can get the Session Interface
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
-	if (OnlineSubsystemInterface)
+	FUOnlineStats::Get().BeginOperation(EUOnlineOperation::JoinAndTravel);
+
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid() || !arg_UserNetId.IsValid() || !arg_PlayerController || arg_SessionName == NAME_None || !arg_SearchResult.IsValid())
 	{
-		// Get the Session Interface to call the StartSession function
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		FinishJoinAndTravel(JoinTravel);
+		return FUOnlineRequest::InvalidId;
+	}
 
-		if (OnlineSessionInterface.IsValid())
+	// The search result is a snapshot, but a session that was full back then isn't worth a round trip
+	const FOnlineSession& Session = arg_SearchResult.Session;
+	const int32 NumOpenConnections = Session.NumOpenPublicConnections + (arg_bCanUsePrivateSlots ? Session.NumOpenPrivateConnections : 0);
+
+	if (NumOpenConnections <= 0)
+	{
+		JoinTravel->Result.JoinResult = EOnJoinSessionCompleteResult::SessionIsFull;
+		FinishJoinAndTravel(JoinTravel);
+		return FUOnlineRequest::InvalidId;
+	}
+
+	if (const FString* ConnectString = ConnectStringCache.Find(arg_SearchResult, JoinTravel->StartTime))
+	{
+		JoinTravel->Result.ConnectString = *ConnectString;
+		JoinTravel->Result.bWasPrefetched = true;
+	}
+
+	// Joining fails while a session of the same name exists, so the join waits for the destroy and fails with it
+	if (OnlineSessionInterface->GetNamedSession(arg_SessionName))
+	{
+		JoinTravel->LeaveStartTime = FPlatformTime::Seconds();
+		JoinTravel->Result.Timings.ValidateInMs = (JoinTravel->LeaveStartTime - JoinTravel->StartTime) * 1000.0;
+
+		const int32 DestroyRequestId = DestroySession(arg_SessionName, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnJoinAndTravelDestroyComplete, arg_UserNetId, arg_SearchResult, JoinTravel));
+
+		// Never queued, so the completion won't come
+		if (DestroyRequestId == FUOnlineRequest::InvalidId)
 		{
-			// Clear the SessionComplete delegate handle, since we finished this call
-			OnlineSessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegateHandle);
+			FinishJoinAndTravel(JoinTravel);
+			return DestroyRequestId;
+		}
 
-			if (arg_bWasSuccessful)
+		// The destroy id stands for the whole join, so it can still be cancelled and followed once the join is queued.
+		// The destroy may have completed already and queued the join
+		if (!JoinTravel->bIsFinished)
+		{
+			if (JoinTravel->PendingRequestId == FUOnlineRequest::InvalidId)
 			{
-				// Set the StartSession delegate handle
-				OnStartSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegate);
-				
-				OnlineSessionInterface->StartSession(arg_SessionName);
+				JoinTravel->PendingRequestId = DestroyRequestId;
 			}
+
+			JoinTravels.Add(DestroyRequestId, JoinTravel);
 		}
+
+		return DestroyRequestId;
 	}
+
+	return StartJoinAndTravel(arg_UserNetId, arg_SessionName, arg_SearchResult, JoinTravel);
 }
 
-void UOnlineObject::OnStartSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+void UOnlineObject::OnJoinAndTravelDestroyComplete(const FUOnlineRequestResult& arg_Result, TSharedPtr<const FUniqueNetId> arg_UserNetId, FOnlineSessionSearchResult arg_SearchResult, TSharedRef<FUOnlineJoinTravel> arg_JoinTravel)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnStartSessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful));
+	arg_JoinTravel->Result.RequestId = arg_Result.RequestId;
+	arg_JoinTravel->Result.Timings.LeaveInMs = (FPlatformTime::Seconds() - arg_JoinTravel->LeaveStartTime) * 1000.0;
 
-	// Get the Online Subsystem so we can get the Session Interface
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
-	if (OnlineSubsystemInterface)
+	if (!arg_Result.WasSuccessful())
+	{
+		FinishJoinAndTravel(arg_JoinTravel);
+		return;
+	}
+
+	StartJoinAndTravel(arg_UserNetId, arg_Result.SessionName, arg_SearchResult, arg_JoinTravel);
+}
+
+int32 UOnlineObject::StartJoinAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, const TSharedRef<FUOnlineJoinTravel>& arg_JoinTravel)
+{
+	arg_JoinTravel->JoinStartTime = FPlatformTime::Seconds();
+
+	// Validation ended when the join was queued, unless a previous session was left in between
+	if (arg_JoinTravel->LeaveStartTime == 0.0)
+	{
+		arg_JoinTravel->Result.Timings.ValidateInMs = (arg_JoinTravel->JoinStartTime - arg_JoinTravel->StartTime) * 1000.0;
+	}
+
+	const int32 RequestId = JoinSession(arg_UserNetId, arg_SessionName, arg_SearchResult, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnJoinAndTravelRequestComplete, arg_JoinTravel));
+
+	// Never queued, so the completion won't come
+	if (RequestId == FUOnlineRequest::InvalidId)
+	{
+		FinishJoinAndTravel(arg_JoinTravel);
+		return RequestId;
+	}
+
+	if (!arg_JoinTravel->bIsFinished)
+	{
+		arg_JoinTravel->PendingRequestId = RequestId;
+	}
+
+	return RequestId;
+}
+
+void UOnlineObject::OnJoinAndTravelRequestComplete(const FUOnlineRequestResult& arg_Result, TSharedRef<FUOnlineJoinTravel> arg_JoinTravel)
+{
+	FUOnlineJoinResult& JoinResult = arg_JoinTravel->Result;
+	JoinResult.JoinResult = arg_Result.JoinResult;
+
+	// A join that left a previous session first keeps the id of the destroy
+	if (JoinResult.RequestId == FUOnlineRequest::InvalidId)
+	{
+		JoinResult.RequestId = arg_Result.RequestId;
+	}
+
+	const double JoinEndTime = FPlatformTime::Seconds();
+	JoinResult.Timings.JoinInMs = (JoinEndTime - arg_JoinTravel->JoinStartTime) * 1000.0;
+
+	// Cancelled and timed out joins keep the result the subsystem never sent
+	if (!arg_Result.WasSuccessful())
+	{
+		if (JoinResult.JoinResult == EOnJoinSessionCompleteResult::Success)
+		{
+			JoinResult.JoinResult = EOnJoinSessionCompleteResult::UnknownError;
+		}
+
+		FinishJoinAndTravel(arg_JoinTravel);
+		return;
+	}
+
+	if (JoinResult.ConnectString.IsEmpty())
 	{
-		// Get the Session Interface to clear the Delegate
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
 		if (OnlineSessionInterface.IsValid())
 		{
-			// Clear the delegate, since we are done with this call
-			OnlineSessionInterface->ClearOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegateHandle);
+			OnlineSessionInterface->GetResolvedConnectString(arg_Result.SessionName, JoinResult.ConnectString);
 		}
 	}
+
+	JoinResult.Timings.ResolveInMs = (FPlatformTime::Seconds() - JoinEndTime) * 1000.0;
+
+	APlayerController* PlayerController = arg_JoinTravel->PlayerController.Get();
+
+	if (PlayerController && !JoinResult.ConnectString.IsEmpty())
+	{
+		PlayerController->ClientTravel(JoinResult.ConnectString, TRAVEL_Absolute);
+		JoinResult.bHasTravelled = true;
+	}
+	else
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Joined %s but can't travel, %s"), *arg_Result.SessionName.ToString(), PlayerController ? TEXT("no connect string") : TEXT("the player controller is gone"));
+	}
+
+	FinishJoinAndTravel(arg_JoinTravel);
 }
 
-void UOnlineObject::OnFindSessionsComplete(bool arg_bWasSuccessful)
+void UOnlineObject::FinishJoinAndTravel(const TSharedRef<FUOnlineJoinTravel>& arg_JoinTravel)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnFindSessionsComplete %d"), arg_bWasSuccessful));
+	FUOnlineJoinResult& JoinResult = arg_JoinTravel->Result;
+	JoinResult.Timings.TotalInMs = (FPlatformTime::Seconds() - arg_JoinTravel->StartTime) * 1000.0;
 
-	// Get OnlineSubsystem we want to work with
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
-	if (OnlineSubsystemInterface)
+	arg_JoinTravel->bIsFinished = true;
+	JoinTravels.Remove(JoinResult.RequestId);
+
+	FUOnlineStats::Get().EndOperation(EUOnlineOperation::JoinAndTravel, arg_JoinTravel->StartTime, JoinResult.WasSuccessful());
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Join and travel %s, result %d, travelled %d, prefetched %d: validate %.1f ms, leave %.1f ms, join %.1f ms, resolve %.1f ms, total %.1f ms"),
+		*JoinResult.SessionName.ToString(), static_cast<int32>(JoinResult.JoinResult), JoinResult.bHasTravelled, JoinResult.bWasPrefetched,
+		JoinResult.Timings.ValidateInMs, JoinResult.Timings.LeaveInMs, JoinResult.Timings.JoinInMs, JoinResult.Timings.ResolveInMs, JoinResult.Timings.TotalInMs);
+
+	// Copy, listeners may start another join
+	const FUOnlineJoinResult Result = JoinResult;
+
+	arg_JoinTravel->OnComplete.ExecuteIfBound(Result);
+	OnJoinAndTravelComplete.Broadcast(Result);
+}
+
+APlayerController* UOnlineObject::FindLocalPlayerController(int32 arg_LocalUserNum) const
+{
+	if (!GEngine)
 	{
-		// Get SessionInterface of the OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
-		if (OnlineSessionInterface.IsValid())
+		return nullptr;
+	}
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UWorld* World = WorldContext.World();
+
+		if (!World || (WorldContext.WorldType != EWorldType::Game && WorldContext.WorldType != EWorldType::PIE))
 		{
-			// Clear the Delegate handle, since we finished this call
-			OnlineSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+			continue;
+		}
 
-			// Just debugging the Number of Search results. Can be displayed in UMG or something later on
-			GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Num Search Results: %d"), SessionSearch->SearchResults.Num()));
+		ULocalPlayer* LocalPlayer = GEngine->GetLocalPlayerFromControllerId(World, arg_LocalUserNum);
 
-			// If we have found at least 1 session, we just going to debug them. You could add them to a list of UMG Widgets, like it is done in the BP version!
-			if (SessionSearch->SearchResults.Num() > 0)
-			{
-				// "SessionSearch->SearchResults" is an Array that contains all the information. You can access the Session in this and get a lot of information.
-				// This can be customized later on with your own classes to add more information that can be set and displayed
-				for (int32 SearchIdx = 0; SearchIdx < SessionSearch->SearchResults.Num(); SearchIdx++)
-				{
-					// OwningUserName is just the SessionName for now. I guess you can create your own Host Settings class and GameSession Class and add a proper GameServer Name here.
-					// This is something you can't do in Blueprint for example!
-					GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Session Number: %d | Sessionname: %s "), SearchIdx + 1, *(SessionSearch->SearchResults[SearchIdx].Session.OwningUserName)));
-				}
-			}
+		if (LocalPlayer && LocalPlayer->PlayerController)
+		{
+			return LocalPlayer->PlayerController;
 		}
 	}
+
+	return nullptr;
 }
 
-void UOnlineObject::OnJoinSessionComplete(FName arg_SessionName, EOnJoinSessionCompleteResult::Type arg_Result)
+int32 UOnlineObject::GetNumLocalPlayers() const
 {
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("OnJoinSessionComplete %s, %d"), *arg_SessionName.ToString(), static_cast<int32>(arg_Result)));
+	if (!GEngine)
+	{
+		return 0;
+	}
 
-	// Get the OnlineSubsystem we want to work with
-	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get();
-	if (OnlineSubsystemInterface)
+	int32 NumLocalPlayers = 0;
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
 	{
-		// Get SessionInterface from the OnlineSubsystem
-		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+		UWorld* World = WorldContext.World();
 
-		if (OnlineSessionInterface.IsValid())
+		if (World && (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE))
+		{
+			NumLocalPlayers = FMath::Max(NumLocalPlayers, GEngine->GetNumGamePlayers(World));
+		}
+	}
+
+	return NumLocalPlayers;
+}
+
+FUOnlineLocalUserState& UOnlineObject::FindOrAddLocalUser(int32 arg_LocalUserNum)
+{
+	FUOnlineLocalUserState& LocalUser = LocalUsers.FindOrAdd(arg_LocalUserNum);
+	LocalUser.LocalUserNum = arg_LocalUserNum;
+
+	// Local users sign in and out while the game runs, the id is looked up every time
+	IOnlineIdentityPtr OnlineIdentityInterface = Online::GetIdentityInterface(OnlineSubsystemName);
+
+	if (OnlineIdentityInterface.IsValid())
+	{
+		TSharedPtr<const FUniqueNetId> UserNetId = OnlineIdentityInterface->GetUniquePlayerId(arg_LocalUserNum);
+
+		if (UserNetId.IsValid())
 		{
-			// Clear the Delegate again
-			OnlineSessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegateHandle);
+			LocalUser.UserNetId = UserNetId;
 		}
 	}
-}
\ No newline at end of file
+
+	return LocalUser;
+}
+
+int32 UOnlineObject::JoinLocalUserInvite(int32 arg_LocalUserNum)
+{
+	FUOnlineLocalUserState* LocalUser = LocalUsers.Find(arg_LocalUserNum);
+
+	if (!LocalUser)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	LocalUser->bIsInvitePending = false;
+
+	const TSharedPtr<const FUniqueNetId> UserNetId = LocalUser->UserNetId;
+	const FOnlineSessionSearchResult Invite = LocalUser->Invite;
+	APlayerController* PlayerController = FindLocalPlayerController(arg_LocalUserNum);
+
+	int32 RequestId = FUOnlineRequest::InvalidId;
+
+	// Without a player in a game world there is nothing to travel yet, the game has to do that itself
+	if (PlayerController)
+	{
+		RequestId = SubmitJoinAndTravel(UserNetId, PlayerController, GameSessionName, Invite, true, FOnUOnlineJoinComplete());
+	}
+	else
+	{
+		RequestId = JoinSession(UserNetId, GameSessionName, Invite);
+	}
+
+	// A refused join is reported before SubmitJoinAndTravel returns, and listeners may have added local users meanwhile
+	LocalUser = LocalUsers.Find(arg_LocalUserNum);
+
+	if (LocalUser)
+	{
+		LocalUser->InviteRequestId = RequestId;
+	}
+
+	return RequestId;
+}
+
+void UOnlineObject::CancelSupersededSearch(int32 arg_RequestId, int32 arg_LocalUserNum)
+{
+	if (arg_RequestId == FUOnlineRequest::InvalidId)
+	{
+		return;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.Find(arg_RequestId);
+
+	if (!Request.IsValid())
+	{
+		return;
+	}
+
+	Request->SearchOwners.Remove(arg_LocalUserNum);
+
+	// A search that runs already costs nothing more to finish and refreshes the cache. One that other local users or callers of
+	// FindSessions share stays
+	if (Request->Status == EUOnlineRequestStatus::Pending && Request->SearchOwners.Num() == 0)
+	{
+		CancelRequest(arg_RequestId);
+	}
+}
+
+TSharedPtr<const FUOnlineSessionFilterPredicate> UOnlineObject::MakeSessionFilter(const FUOnlineSessionFilter& arg_Filter) const
+{
+	if (arg_Filter.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	return MakeShareable(new FUOnlineSessionFilterPredicate(arg_Filter));
+}
+
+void UOnlineObject::RankSessions(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const FUOnlineSessionRankingOptions& arg_Options, const FOnUOnlineSessionRankingComplete& arg_OnComplete)
+{
+	// Rankers can't be dropped from their own completion callback, so clean up finished ones here
+	SessionRankers.RemoveAll([](const TSharedRef<FUOnlineSessionRanker>& arg_SessionRanker)
+	{
+		return arg_SessionRanker->IsComplete();
+	});
+
+	TSharedRef<FUOnlineSessionRanker> SessionRanker = MakeShareable(new FUOnlineSessionRanker(arg_SearchResults, arg_Options, arg_OnComplete));
+	SessionRankers.Add(SessionRanker);
+
+	// The session interface resolves the host addresses of the results
+	SessionRanker->Start(GetSessionInterface());
+}
+
+int32 UOnlineObject::DestroySession(FName arg_SessionName, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	// Get SessionInterface from the OnlineSubsystem
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (OnlineSessionInterface.IsValid() && arg_SessionName != NAME_None)
+	{
+		TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::DestroySession, arg_SessionName));
+
+		if (arg_OnComplete.IsBound())
+		{
+			Request->Completions.Add(arg_OnComplete);
+		}
+
+		return SubmitRequest(Request);
+	}
+
+	return FUOnlineRequest::InvalidId;
+}
+
+int32 UOnlineObject::UpdateSession(FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid() || arg_SessionName == NAME_None)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	const int32 RequestId = SubmitUpdateSession(arg_SessionName, MakeShareable(new FOnlineSessionSettings(arg_SessionSettings)), arg_OnComplete);
+
+	// A full update replaces whatever changes were waiting to be coalesced
+	if (RequestId != FUOnlineRequest::InvalidId)
+	{
+		SessionSettingsTracker.Reset(arg_SessionName, arg_SessionSettings);
+	}
+
+	return RequestId;
+}
+
+bool UOnlineObject::SetSessionSetting(FName arg_SessionName, FName arg_Key, const FVariantData& arg_Value, EOnlineDataAdvertisementType::Type arg_AdvertisementType)
+{
+	if (!TrackSessionSettings(arg_SessionName) || !SessionSettingsTracker.SetSetting(arg_SessionName, arg_Key, arg_Value, arg_AdvertisementType))
+	{
+		return false;
+	}
+
+	EnsureRequestTicker();
+
+	return true;
+}
+
+bool UOnlineObject::RemoveSessionSetting(FName arg_SessionName, FName arg_Key)
+{
+	if (!TrackSessionSettings(arg_SessionName) || !SessionSettingsTracker.RemoveSetting(arg_SessionName, arg_Key))
+	{
+		return false;
+	}
+
+	EnsureRequestTicker();
+
+	return true;
+}
+
+bool UOnlineObject::ModifySessionSettings(FName arg_SessionName, TFunctionRef<void(FOnlineSessionSettings&)> arg_Modifier)
+{
+	if (!TrackSessionSettings(arg_SessionName) || !SessionSettingsTracker.ModifySettings(arg_SessionName, arg_Modifier))
+	{
+		return false;
+	}
+
+	EnsureRequestTicker();
+
+	return true;
+}
+
+int32 UOnlineObject::RecycleSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid() || arg_SessionName == NAME_None)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::RecycleSession, arg_SessionName));
+	Request->UserNetId = arg_UserNetId;
+	Request->SessionSettings = MakeShareable(new FOnlineSessionSettings(arg_SessionSettings));
+
+	if (arg_OnComplete.IsBound())
+	{
+		Request->Completions.Add(arg_OnComplete);
+	}
+
+	const int32 RequestId = SubmitRequest(Request);
+
+	// The next match starts from these settings, changes that were waiting to be coalesced belonged to the last one
+	if (RequestId != FUOnlineRequest::InvalidId && SessionSettingsTracker.IsTracked(arg_SessionName))
+	{
+		SessionSettingsTracker.Reset(arg_SessionName, arg_SessionSettings);
+	}
+
+	return RequestId;
+}
+
+int32 UOnlineObject::RecycleSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	// Changes that are still waiting to be sent are part of the current settings
+	const FOnlineSessionSettings* CurrentSettings = SessionSettingsTracker.GetSettings(arg_SessionName);
+
+	if (!CurrentSettings && OnlineSessionInterface.IsValid())
+	{
+		CurrentSettings = OnlineSessionInterface->GetSessionSettings(arg_SessionName);
+	}
+
+	if (!CurrentSettings)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	FOnlineSessionSettings SessionSettings(*CurrentSettings);
+
+	if (arg_Map != NAME_None)
+	{
+		SessionSettings.Set(SETTING_MAPNAME, arg_Map.ToString(), EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+
+	return RecycleSession(arg_UserNetId, arg_SessionName, SessionSettings, arg_OnComplete);
+}
+
+int32 UOnlineObject::HostSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionNamePrefix, int32 arg_NumSessions, const FOnlineSessionSettings& arg_SessionSettings)
+{
+	if (!GetSessionInterface().IsValid() || arg_SessionNamePrefix == NAME_None)
+	{
+		return 0;
+	}
+
+	HostUserNetId = arg_UserNetId;
+
+	// Every session starts from the same settings, they only get their own copy once they are recycled with different ones
+	const TSharedRef<FOnlineSessionSettings> SessionSettings = MakeShareable(new FOnlineSessionSettings(arg_SessionSettings));
+	const double Now = FPlatformTime::Seconds();
+
+	int32 NumQueued = 0;
+
+	for (int32 SessionIndex = 1; SessionIndex <= arg_NumSessions; ++SessionIndex)
+	{
+		const FName SessionName(*FString::Printf(TEXT("%s_%d"), *arg_SessionNamePrefix.ToString(), SessionIndex));
+		FUOnlineHostedSession* Session = SessionRegistry.Find(SessionName);
+
+		if (!Session)
+		{
+			Session = SessionRegistry.Add(SessionName, SessionSettings, Now);
+			OnHostedSessionChanged.Broadcast(SessionName, EUOnlineHostedSessionState::Queued);
+			++NumQueued;
+		}
+		else if (Session->State == EUOnlineHostedSessionState::Failed)
+		{
+			Session->Settings = SessionSettings;
+			SetHostedSessionState(*Session, EUOnlineHostedSessionState::Queued);
+			++NumQueued;
+		}
+	}
+
+	EnsureRequestTicker();
+	PumpHostedSessions();
+
+	return NumQueued;
+}
+
+FName UOnlineObject::AcquireHostedSession()
+{
+	FUOnlineHostedSession* Session = SessionRegistry.FindOldest(EUOnlineHostedSessionState::Available);
+
+	if (!Session)
+	{
+		return NAME_None;
+	}
+
+	SetHostedSessionState(*Session, EUOnlineHostedSessionState::InUse);
+
+	return Session->SessionName;
+}
+
+bool UOnlineObject::ReleaseHostedSession(FName arg_SessionName, const FOnlineSessionSettings* arg_SessionSettings)
+{
+	FUOnlineHostedSession* Session = SessionRegistry.Find(arg_SessionName);
+
+	if (!Session || (Session->State != EUOnlineHostedSessionState::InUse && Session->State != EUOnlineHostedSessionState::Available))
+	{
+		return false;
+	}
+
+	if (arg_SessionSettings)
+	{
+		Session->Settings = MakeShareable(new FOnlineSessionSettings(*arg_SessionSettings));
+	}
+
+	const EUOnlineHostedSessionState PreviousState = Session->State;
+	SetHostedSessionState(*Session, EUOnlineHostedSessionState::Recycling);
+
+	// The session stays registered with the subsystem, it's only ended and started again with the settings of the next match
+	const int32 RequestId = RecycleSession(HostUserNetId, arg_SessionName, *Session->Settings, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnHostedSessionRequestComplete));
+
+	// Recycling can complete before we get here, so look the session up again
+	Session = SessionRegistry.Find(arg_SessionName);
+
+	if (!Session || Session->State != EUOnlineHostedSessionState::Recycling)
+	{
+		return true;
+	}
+
+	if (RequestId == FUOnlineRequest::InvalidId)
+	{
+		SetHostedSessionState(*Session, PreviousState);
+		return false;
+	}
+
+	Session->RequestId = RequestId;
+
+	return true;
+}
+
+void UOnlineObject::StopHostingSessions()
+{
+	TArray<FName> SessionNames;
+	SessionRegistry.GetSessionNames(SessionNames);
+
+	for (const FName& SessionName : SessionNames)
+	{
+		FUOnlineHostedSession* Session = SessionRegistry.Find(SessionName);
+
+		if (!Session || Session->State == EUOnlineHostedSessionState::Destroying)
+		{
+			if (Session)
+			{
+				Session->bRecreateAfterDestroy = false;
+			}
+
+			continue;
+		}
+
+		// Never handed to the subsystem, nothing to destroy
+		if (Session->State == EUOnlineHostedSessionState::Queued || Session->State == EUOnlineHostedSessionState::Failed)
+		{
+			SessionRegistry.Remove(SessionName);
+			continue;
+		}
+
+		Session->bRecreateAfterDestroy = false;
+		SetHostedSessionState(*Session, EUOnlineHostedSessionState::Destroying);
+
+		// Queued behind a create or update that is still running on the same session, the lane keeps them in order
+		const int32 RequestId = DestroySession(SessionName, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnHostedSessionRequestComplete));
+
+		Session = SessionRegistry.Find(SessionName);
+
+		if (Session && Session->State == EUOnlineHostedSessionState::Destroying)
+		{
+			Session->RequestId = RequestId;
+
+			if (RequestId == FUOnlineRequest::InvalidId)
+			{
+				SessionRegistry.Remove(SessionName);
+			}
+		}
+	}
+}
+
+const FUOnlineHostedSession* UOnlineObject::GetHostedSession(FName arg_SessionName) const
+{
+	return SessionRegistry.Find(arg_SessionName);
+}
+
+int32 UOnlineObject::GetNumHostedSessions(EUOnlineHostedSessionState arg_State) const
+{
+	return SessionRegistry.Num(arg_State);
+}
+
+bool UOnlineObject::CancelRequest(int32 arg_RequestId)
+{
+	// A join and travel is cancelled through the request it waits for, its completion then fails the join
+	if (const TSharedRef<FUOnlineJoinTravel>* JoinTravel = JoinTravels.Find(arg_RequestId))
+	{
+		arg_RequestId = (*JoinTravel)->PendingRequestId;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.Find(arg_RequestId);
+
+	if (!Request.IsValid() || Request->bIsAbandoned)
+	{
+		return false;
+	}
+
+	StopRequest(Request.ToSharedRef(), EUOnlineRequestStatus::Cancelled);
+
+	return true;
+}
+
+bool UOnlineObject::IsRequestInFlight(int32 arg_RequestId) const
+{
+	if (JoinTravels.Contains(arg_RequestId))
+	{
+		return true;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.Find(arg_RequestId);
+
+	return Request.IsValid() && !Request->bIsAbandoned;
+}
+
+int32 UOnlineObject::GetNumRequestsInFlight() const
+{
+	return RequestQueue.NumPending() + RequestQueue.NumActive();
+}
+
+void UOnlineObject::OnDestroySessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnDestroySessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnDestroySessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful);
+
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	if (CompleteRecycleStep(arg_SessionName, EUOnlineRecycleStep::DestroySession, arg_bWasSuccessful))
+	{
+		return;
+	}
+
+	// Find the request this callback belongs to, sessions destroyed by someone else are none of our business
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::DestroySession, arg_SessionName);
+
+	if (Request.IsValid())
+	{
+		CompleteRequest(Request.ToSharedRef(), arg_bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+	}
+}
+
+void UOnlineObject::OnUpdateSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnUpdateSessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnUpdateSessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful);
+
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	if (CompleteRecycleStep(arg_SessionName, EUOnlineRecycleStep::UpdateSession, arg_bWasSuccessful))
+	{
+		return;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::UpdateSession, arg_SessionName);
+
+	if (Request.IsValid())
+	{
+		CompleteRequest(Request.ToSharedRef(), arg_bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+	}
+}
+
+void UOnlineObject::OnReadFriendsListComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FString& arg_FriendsListName, const FString& arg_ErrorString)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnReadFriendsListComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnReadFriendsListComplete %d, %d"), arg_LocalUserNum, arg_bWasSuccessful);
+
+	const double* ReadStartTime = FriendsListReadsInFlight.Find(arg_LocalUserNum);
+
+	if (ReadStartTime)
+	{
+		FUOnlineStats::Get().EndOperation(EUOnlineOperation::ReadFriendsList, *ReadStartTime, arg_bWasSuccessful);
+		FriendsListReadsInFlight.Remove(arg_LocalUserNum);
+	}
+
+	if (!arg_bWasSuccessful)
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Failed to read friends of local user %d: %s"), arg_LocalUserNum, *arg_ErrorString);
+		FinishFriendsListRead(arg_LocalUserNum, false, false);
+		return;
+	}
+
+	IOnlineFriendsPtr OnlineFriendInterface = Online::GetFriendsInterface(OnlineSubsystemName);
+
+	if (!OnlineFriendInterface.IsValid())
+	{
+		FinishFriendsListRead(arg_LocalUserNum, true, false);
+		return;
+	}
+
+	TArray<TSharedRef<FOnlineFriend>> FriendsList;
+	OnlineFriendInterface->GetFriendsList(arg_LocalUserNum, arg_FriendsListName, FriendsList);
+
+	// Only the friends that differ from the cache are touched. The friends belong to the subsystem and can't leave the game thread,
+	// so a long list is applied a slice per tick instead. A short one is done right here
+	FriendsCache.BeginFriendsList(arg_LocalUserNum, FriendsList);
+	FriendsListsApplying.Add(arg_LocalUserNum);
+
+	if (!ApplyFriendsListSlice(arg_LocalUserNum))
+	{
+		EnsureRequestTicker();
+	}
+}
+
+bool UOnlineObject::ApplyFriendsListSlice(int32 arg_LocalUserNum)
+{
+	bool bHasChanged = false;
+
+	if (!FriendsCache.ContinueFriendsList(arg_LocalUserNum, FriendsAppliedPerTick, bHasChanged))
+	{
+		return false;
+	}
+
+	FriendsListsApplying.Remove(arg_LocalUserNum);
+	FinishFriendsListRead(arg_LocalUserNum, true, bHasChanged);
+
+	return true;
+}
+
+void UOnlineObject::FinishFriendsListRead(int32 arg_LocalUserNum, bool arg_bWasSuccessful, bool arg_bHasChanged)
+{
+	if (arg_bHasChanged)
+	{
+		OnFriendsUpdated.Broadcast(arg_LocalUserNum);
+	}
+
+	OnFriendsListRead.Broadcast(arg_LocalUserNum, arg_bWasSuccessful);
+
+	// The list changed while we were reading it
+	if (FriendsListRereads.Remove(arg_LocalUserNum) > 0)
+	{
+		ReadFriendsList(arg_LocalUserNum);
+	}
+}
+
+void UOnlineObject::ConsumeWarmup()
+{
+	FUOnlineModule* UOnlineModule = FUOnlineModule::GetPtr();
+	TSharedPtr<FUOnlineWarmup> Warmup = UOnlineModule ? UOnlineModule->GetWarmup() : nullptr;
+
+	// Results of another subsystem are of no use
+	bool bIsWarmupUsable = Warmup.IsValid() && IOnlineSubsystem::Get(Warmup->GetOptions().OnlineSubsystemName) == IOnlineSubsystem::Get(OnlineSubsystemName);
+
+#if !UE_BUILD_SHIPPING
+	bIsWarmupUsable = bIsWarmupUsable && !SessionInterfaceOverride.IsValid();
+#endif
+
+	if (bIsWarmupUsable && !Warmup->IsComplete())
+	{
+		if (!WarmupCompleteDelegateHandle.IsValid())
+		{
+			WarmupCompleteDelegateHandle = Warmup->OnComplete().AddUObject(this, &UOnlineObject::ConsumeWarmup);
+
+			// The subsystem would refuse our searches, or we would take the warm-up's results for ours. The warm-up may still wait for
+			// the subsystem before its search starts, so the lane is held for as long as a search is to come, and not a moment longer
+			if (Warmup->IsSearching())
+			{
+				WarmupSearchCompleteDelegateHandle = Warmup->OnSearchComplete().AddUObject(this, &UOnlineObject::ConsumeWarmupSearch);
+				RequestQueue.SetLaneHeld(NAME_None, true);
+			}
+			else
+			{
+				FUOnlineWarmupResults WarmupResults;
+
+				// The search is over already, its results needn't wait for the other stages either
+				if (Warmup->TakeSearchResults(WarmupResults))
+				{
+					ApplyWarmupSearchResults(WarmupResults);
+				}
+			}
+		}
+
+		return;
+	}
+
+	FUOnlineWarmupResults WarmupResults;
+
+	if (bIsWarmupUsable && Warmup->TakeResults(WarmupResults))
+	{
+		UE_LOG(LogUOnline, Log, TEXT("Taking the warm-up results, %d sessions, friends list %s"), WarmupResults.SearchResults.Num(), WarmupResults.bHasFriendsList ? TEXT("read") : TEXT("not read"));
+
+		ApplyWarmupSearchResults(WarmupResults);
+
+		// The subsystem holds the list already, only our cache needs it
+		if (WarmupResults.bHasFriendsList && !FriendsListReadsInFlight.Contains(WarmupResults.LocalUserNum))
+		{
+			if (WarmupResults.UserId.IsValid())
+			{
+				FriendsCache.SetLocalUserId(WarmupResults.LocalUserNum, *WarmupResults.UserId);
+			}
+
+			BindFriendsDelegates(WarmupResults.LocalUserNum);
+			OnReadFriendsListComplete(WarmupResults.LocalUserNum, true, EFriendsLists::ToString(EFriendsLists::Default), FString());
+		}
+	}
+
+	// Done waiting, whether we got the results or another object did
+	if (WarmupCompleteDelegateHandle.IsValid())
+	{
+		if (Warmup.IsValid())
+		{
+			Warmup->OnComplete().Remove(WarmupCompleteDelegateHandle);
+		}
+
+		WarmupCompleteDelegateHandle.Reset();
+	}
+
+	// The search lane is normally released when the search completed already, never keep it held past the warm-up
+	ConsumeWarmupSearch();
+}
+
+void UOnlineObject::ConsumeWarmupSearch()
+{
+	if (!WarmupSearchCompleteDelegateHandle.IsValid())
+	{
+		return;
+	}
+
+	FUOnlineModule* UOnlineModule = FUOnlineModule::GetPtr();
+	TSharedPtr<FUOnlineWarmup> Warmup = UOnlineModule ? UOnlineModule->GetWarmup() : nullptr;
+
+	if (Warmup.IsValid())
+	{
+		Warmup->OnSearchComplete().Remove(WarmupSearchCompleteDelegateHandle);
+
+		FUOnlineWarmupResults WarmupResults;
+
+		if (Warmup->TakeSearchResults(WarmupResults))
+		{
+			UE_LOG(LogUOnline, Log, TEXT("Taking the warm-up search results, %d sessions"), WarmupResults.SearchResults.Num());
+
+			ApplyWarmupSearchResults(WarmupResults);
+		}
+	}
+
+	// Searches that waited are served from the cache if it was filled
+	WarmupSearchCompleteDelegateHandle.Reset();
+	RequestQueue.SetLaneHeld(NAME_None, false);
+
+	EnsureRequestTicker();
+	PumpRequests();
+}
+
+void UOnlineObject::ApplyWarmupSearchResults(const FUOnlineWarmupResults& arg_WarmupResults)
+{
+	if (!arg_WarmupResults.bHasSearchResults)
+	{
+		return;
+	}
+
+	// Keyed like the search FindSessions would make, and as old as the warm-up search really is
+	const TSharedRef<FOnlineSessionSearch> SessionSearch = MakeSessionSearch(arg_WarmupResults.bIsLANQuery, arg_WarmupResults.bIsPresenceQuery);
+	const FUOnlineSessionQueryKey QueryKey(arg_WarmupResults.bIsLANQuery, arg_WarmupResults.bIsPresenceQuery, *SessionSearch);
+
+	FUOnlineSessionSearchDelta SearchDelta;
+	SessionCache.Apply(QueryKey, arg_WarmupResults.SearchResults, arg_WarmupResults.SearchTime, SearchDelta);
+
+	ConnectStringCache.Prefetch(GetSessionInterface(), arg_WarmupResults.SearchResults, ConnectStringPrefetchCount, FPlatformTime::Seconds());
+
+	if (SearchDelta.HasChanges())
+	{
+		OnSessionSearchUpdated.Broadcast(SearchDelta);
+	}
+}
+
+void UOnlineObject::OnFriendsChange(int32 arg_LocalUserNum)
+{
+	// The subsystem doesn't say what changed, read the list again and let the cache work out the difference
+	if (FriendsListReadsInFlight.Contains(arg_LocalUserNum))
+	{
+		FriendsListRereads.Add(arg_LocalUserNum);
+	}
+	else
+	{
+		ReadFriendsList(arg_LocalUserNum);
+	}
+}
+
+void UOnlineObject::OnFriendRemoved(const FUniqueNetId& arg_UserId, const FUniqueNetId& arg_FriendId)
+{
+	const int32 LocalUserNum = FriendsCache.FindLocalUserNum(arg_UserId);
+
+	if (LocalUserNum != INDEX_NONE && FriendsCache.RemoveFriend(LocalUserNum, arg_FriendId))
+	{
+		OnFriendsUpdated.Broadcast(LocalUserNum);
+	}
+}
+
+void UOnlineObject::OnFriendInviteAccepted(const FUniqueNetId& arg_UserId, const FUniqueNetId& arg_FriendId)
+{
+	const int32 LocalUserNum = FriendsCache.FindLocalUserNum(arg_UserId);
+	IOnlineFriendsPtr OnlineFriendInterface = Online::GetFriendsInterface(OnlineSubsystemName);
+
+	if (LocalUserNum == INDEX_NONE || !OnlineFriendInterface.IsValid())
+	{
+		return;
+	}
+
+	// The subsystem already knows the new friend, no need to read the whole list
+	TSharedPtr<FOnlineFriend> Friend = OnlineFriendInterface->GetFriend(LocalUserNum, arg_FriendId, EFriendsLists::ToString(EFriendsLists::Default));
+
+	if (Friend.IsValid() && FriendsCache.UpdateFriend(LocalUserNum, *Friend))
+	{
+		OnFriendsUpdated.Broadcast(LocalUserNum);
+	}
+}
+
+void UOnlineObject::OnPresenceReceived(const FUniqueNetId& arg_UserId, const TSharedRef<FOnlineUserPresence>& arg_Presence)
+{
+	TArray<int32> ChangedLocalUserNums;
+	FriendsCache.UpdatePresence(arg_UserId, *arg_Presence, ChangedLocalUserNums);
+
+	for (int32 LocalUserNum : ChangedLocalUserNums)
+	{
+		OnFriendsUpdated.Broadcast(LocalUserNum);
+	}
+}
+
+bool UOnlineObject::ReadFriendsList(int32 arg_LocalUserNum)
+{
+	if (FriendsListReadsInFlight.Contains(arg_LocalUserNum))
+	{
+		return true;
+	}
+
+	IOnlineFriendsPtr OnlineFriendInterface = Online::GetFriendsInterface(OnlineSubsystemName);
+
+	if (!OnlineFriendInterface.IsValid())
+	{
+		return false;
+	}
+
+	// Events about friends only carry the unique net id of the local user
+	IOnlineIdentityPtr OnlineIdentityInterface = Online::GetIdentityInterface(OnlineSubsystemName);
+	if (OnlineIdentityInterface.IsValid())
+	{
+		TSharedPtr<const FUniqueNetId> LocalUserId = OnlineIdentityInterface->GetUniquePlayerId(arg_LocalUserNum);
+
+		if (LocalUserId.IsValid())
+		{
+			FriendsCache.SetLocalUserId(arg_LocalUserNum, *LocalUserId);
+		}
+	}
+
+	BindFriendsDelegates(arg_LocalUserNum);
+
+	const double ReadStartTime = FPlatformTime::Seconds();
+
+	FriendsListReadsInFlight.Add(arg_LocalUserNum, ReadStartTime);
+	FUOnlineStats::Get().BeginOperation(EUOnlineOperation::ReadFriendsList);
+
+	if (!OnlineFriendInterface->ReadFriendsList(arg_LocalUserNum, EFriendsLists::ToString(EFriendsLists::Default), OnReadFriendsListCompleteDelegate))
+	{
+		// Some subsystems report the failure through the delegate before returning
+		if (FriendsListReadsInFlight.Remove(arg_LocalUserNum) > 0)
+		{
+			FUOnlineStats::Get().EndOperation(EUOnlineOperation::ReadFriendsList, ReadStartTime, false);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+bool UOnlineObject::IsFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const
+{
+	return FriendsCache.IsFriend(arg_LocalUserNum, arg_UserId);
+}
+
+const FUOnlineFriendEntry* UOnlineObject::FindFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const
+{
+	return FriendsCache.FindFriend(arg_LocalUserNum, arg_UserId);
+}
+
+FUOnlineFriendsSnapshotRef UOnlineObject::GetFriendsSnapshot(int32 arg_LocalUserNum) const
+{
+	return FriendsCache.GetSnapshot(arg_LocalUserNum);
+}
+
+bool UOnlineObject::GetPendingInvite(int32 arg_LocalUserNum, FOnlineSessionSearchResult& arg_OutInvite) const
+{
+	const FUOnlineLocalUserState* LocalUser = LocalUsers.Find(arg_LocalUserNum);
+
+	if (!LocalUser || !LocalUser->bIsInvitePending)
+	{
+		return false;
+	}
+
+	arg_OutInvite = LocalUser->Invite;
+	return true;
+}
+
+int32 UOnlineObject::AcceptPendingInvite(int32 arg_LocalUserNum)
+{
+	FUOnlineLocalUserState* LocalUser = LocalUsers.Find(arg_LocalUserNum);
+
+	if (!LocalUser || !LocalUser->bIsInvitePending)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	return JoinLocalUserInvite(arg_LocalUserNum);
+}
+
+void UOnlineObject::DeclinePendingInvite(int32 arg_LocalUserNum)
+{
+	FUOnlineLocalUserState* LocalUser = LocalUsers.Find(arg_LocalUserNum);
+
+	if (LocalUser)
+	{
+		LocalUser->bIsInvitePending = false;
+	}
+}
+
+void UOnlineObject::RemoveLocalUser(int32 arg_LocalUserNum)
+{
+	FUOnlineLocalUserState LocalUser;
+
+	if (LocalUsers.RemoveAndCopyValue(arg_LocalUserNum, LocalUser))
+	{
+		CancelSupersededSearch(LocalUser.SearchRequestId, arg_LocalUserNum);
+	}
+
+	FriendsCache.ResetUser(arg_LocalUserNum);
+	FriendsListRereads.Remove(arg_LocalUserNum);
+
+	FDelegateHandle FriendsChangeDelegateHandle;
+	IOnlineFriendsPtr OnlineFriendInterface = BoundFriendsInterface.Pin();
+
+	if (OnFriendsChangeDelegateHandles.RemoveAndCopyValue(arg_LocalUserNum, FriendsChangeDelegateHandle) && OnlineFriendInterface.IsValid())
+	{
+		OnlineFriendInterface->ClearOnFriendsChangeDelegate_Handle(arg_LocalUserNum, FriendsChangeDelegateHandle);
+	}
+}
+
+void UOnlineObject::BindFriendsDelegates(int32 arg_LocalUserNum)
+{
+	IOnlineFriendsPtr OnlineFriendInterface = Online::GetFriendsInterface(OnlineSubsystemName);
+
+	if (OnlineFriendInterface.IsValid())
+	{
+		if (BoundFriendsInterface.Pin() != OnlineFriendInterface)
+		{
+			UnbindFriendsDelegates();
+
+			OnFriendRemovedDelegateHandle = OnlineFriendInterface->AddOnFriendRemovedDelegate_Handle(OnFriendRemovedDelegate);
+			OnFriendInviteAcceptedDelegateHandle = OnlineFriendInterface->AddOnInviteAcceptedDelegate_Handle(OnFriendInviteAcceptedDelegate);
+			BoundFriendsInterface = OnlineFriendInterface;
+		}
+
+		// Friends list changes are reported per local user
+		if (!OnFriendsChangeDelegateHandles.Contains(arg_LocalUserNum))
+		{
+			FOnFriendsChangeDelegate FriendsChangeDelegate = FOnFriendsChangeDelegate::CreateUObject(this, &UOnlineObject::OnFriendsChange, arg_LocalUserNum);
+			OnFriendsChangeDelegateHandles.Add(arg_LocalUserNum, OnlineFriendInterface->AddOnFriendsChangeDelegate_Handle(arg_LocalUserNum, FriendsChangeDelegate));
+		}
+	}
+
+	IOnlinePresencePtr OnlinePresenceInterface = Online::GetPresenceInterface(OnlineSubsystemName);
+
+	if (OnlinePresenceInterface.IsValid() && BoundPresenceInterface.Pin() != OnlinePresenceInterface)
+	{
+		IOnlinePresencePtr PreviousPresenceInterface = BoundPresenceInterface.Pin();
+
+		if (PreviousPresenceInterface.IsValid())
+		{
+			PreviousPresenceInterface->ClearOnPresenceReceivedDelegate_Handle(OnPresenceReceivedDelegateHandle);
+		}
+
+		OnPresenceReceivedDelegateHandle = OnlinePresenceInterface->AddOnPresenceReceivedDelegate_Handle(OnPresenceReceivedDelegate);
+		BoundPresenceInterface = OnlinePresenceInterface;
+	}
+}
+
+void UOnlineObject::UnbindFriendsDelegates()
+{
+	IOnlineFriendsPtr OnlineFriendInterface = BoundFriendsInterface.Pin();
+
+	if (OnlineFriendInterface.IsValid())
+	{
+		OnlineFriendInterface->ClearOnFriendRemovedDelegate_Handle(OnFriendRemovedDelegateHandle);
+		OnlineFriendInterface->ClearOnInviteAcceptedDelegate_Handle(OnFriendInviteAcceptedDelegateHandle);
+
+		for (TPair<int32, FDelegateHandle>& FriendsChangeDelegateHandle : OnFriendsChangeDelegateHandles)
+		{
+			OnlineFriendInterface->ClearOnFriendsChangeDelegate_Handle(FriendsChangeDelegateHandle.Key, FriendsChangeDelegateHandle.Value);
+		}
+	}
+
+	OnFriendsChangeDelegateHandles.Empty();
+	BoundFriendsInterface.Reset();
+
+	IOnlinePresencePtr OnlinePresenceInterface = BoundPresenceInterface.Pin();
+
+	if (OnlinePresenceInterface.IsValid())
+	{
+		OnlinePresenceInterface->ClearOnPresenceReceivedDelegate_Handle(OnPresenceReceivedDelegateHandle);
+	}
+
+	BoundPresenceInterface.Reset();
+}
+
+void UOnlineObject::OnSessionUserInviteAccepted(const bool arg_bWasSuccesful, const int32 arg_LocalUserNum, TSharedPtr<const FUniqueNetId> arg_NetId, const FOnlineSessionSearchResult& arg_SessionSearchResult)
+{
+	UE_LOG(LogUOnline, Verbose, TEXT("OnSessionUserInviteAccepted %d, %d"), arg_bWasSuccesful, arg_LocalUserNum);
+
+	if (!arg_bWasSuccesful || !arg_SessionSearchResult.IsValid())
+	{
+		return;
+	}
+
+	FUOnlineLocalUserState& LocalUser = FindOrAddLocalUser(arg_LocalUserNum);
+
+	// The invite names the user it is for, even if they aren't signed in with the identity interface yet
+	if (arg_NetId.IsValid())
+	{
+		LocalUser.UserNetId = arg_NetId;
+	}
+
+	LocalUser.Invite = arg_SessionSearchResult;
+	LocalUser.bIsInvitePending = false;
+	LocalUser.InviteRequestId = FUOnlineRequest::InvalidId;
+
+	const FString SessionId = arg_SessionSearchResult.GetSessionIdStr();
+	bool bIsJoiningOtherSession = false;
+
+	// Local players share the game session. If another local user's invite to the same session is being joined, that join is enough
+	for (const TPair<int32, FUOnlineLocalUserState>& OtherUser : LocalUsers)
+	{
+		if (OtherUser.Key == arg_LocalUserNum || !IsRequestInFlight(OtherUser.Value.InviteRequestId))
+		{
+			continue;
+		}
+
+		if (OtherUser.Value.Invite.GetSessionIdStr() == SessionId)
+		{
+			LocalUser.InviteRequestId = OtherUser.Value.InviteRequestId;
+			return;
+		}
+
+		bIsJoiningOtherSession = true;
+	}
+
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+	const FNamedOnlineSession* GameSession = OnlineSessionInterface.IsValid() ? OnlineSessionInterface->GetNamedSession(GameSessionName) : nullptr;
+
+	if (GameSession && GameSession->SessionInfo.IsValid() && GameSession->SessionInfo->GetSessionId().ToString() == SessionId)
+	{
+		UE_LOG(LogUOnline, Log, TEXT("Local user %d is already in the session they were invited to"), arg_LocalUserNum);
+		return;
+	}
+
+	// Joining replaces the game session of every local player. With more than one, the game decides whether they all follow
+	if (bIsJoiningOtherSession || (GameSession && GetNumLocalPlayers() > 1))
+	{
+		LocalUser.bIsInvitePending = true;
+		OnLocalUserInvitePending.Broadcast(arg_LocalUserNum);
+		return;
+	}
+
+	JoinLocalUserInvite(arg_LocalUserNum);
+}
+
+void UOnlineObject::OnCreateSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnCreateSessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnCreateSessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful);
+
+	// Owed to a request that was dropped long after it was abandoned, not to the one that runs in the lane now
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	if (CompleteRecycleStep(arg_SessionName, EUOnlineRecycleStep::CreateSession, arg_bWasSuccessful))
+	{
+		return;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::CreateSession, arg_SessionName);
+
+	if (!Request.IsValid() || Request->bIsStarting)
+	{
+		return;
+	}
+
+	// Don't start sessions nobody is waiting for anymore
+	if (!arg_bWasSuccessful || Request->bIsAbandoned)
+	{
+		CompleteRequest(Request.ToSharedRef(), arg_bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+		return;
+	}
+
+	// Get the Session Interface to call the StartSession function
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (OnlineSessionInterface.IsValid())
+	{
+		// The request stays in flight until the session has started
+		Request->bIsStarting = true;
+		Request->StartSessionTime = FPlatformTime::Seconds();
+
+		FUOnlineStats::Get().EndOperation(EUOnlineOperation::CreateSession, Request->StartTime, true);
+		FUOnlineStats::Get().BeginOperation(EUOnlineOperation::StartSession);
+
+		if (OnlineSessionInterface->StartSession(arg_SessionName))
+		{
+			return;
+		}
+	}
+
+	CompleteRequest(Request.ToSharedRef(), EUOnlineRequestStatus::Failed);
+}
+
+void UOnlineObject::OnStartSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnStartSessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnStartSessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful);
+
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	if (CompleteRecycleStep(arg_SessionName, EUOnlineRecycleStep::StartSession, arg_bWasSuccessful))
+	{
+		return;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::CreateSession, arg_SessionName);
+
+	if (Request.IsValid() && Request->bIsStarting)
+	{
+		CompleteRequest(Request.ToSharedRef(), arg_bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+	}
+}
+
+void UOnlineObject::OnEndSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnEndSessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnEndSessionComplete %s, %d"), *arg_SessionName.ToString(), arg_bWasSuccessful);
+
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	// Sessions are only ended on their way to the next match
+	CompleteRecycleStep(arg_SessionName, EUOnlineRecycleStep::EndSession, arg_bWasSuccessful);
+}
+
+void UOnlineObject::OnFindSessionsComplete(bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnFindSessionsComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnFindSessionsComplete %d"), arg_bWasSuccessful);
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::FindSessions, NAME_None);
+
+	// Other code can search on the same interface, only a search that is no longer in progress can be ours
+	if (!Request.IsValid() || !Request->SessionSearch.IsValid() || Request->SessionSearch->SearchState == EOnlineAsyncTaskState::InProgress || Request->bIsPostProcessing)
+	{
+		return;
+	}
+
+	const TSharedRef<FOnlineSessionSearch> SessionSearch = Request->SessionSearch.ToSharedRef();
+
+	// Large result lists are filtered and snapshotted on a worker thread, so this callback stays short whatever the number of results.
+	// Streams keep working on the results the subsystem filled in and spread their work over ticks already
+	if (arg_bWasSuccessful && !Request->SearchStream.IsValid() && SessionSearch->SearchResults.Num() >= SearchPostProcessMinResults)
+	{
+		StartSearchPostProcess(Request.ToSharedRef());
+		return;
+	}
+
+	// Store the new snapshot and only tell listeners about what actually changed
+	if (arg_bWasSuccessful)
+	{
+		const TArray<FOnlineSessionSearchResult>* SearchResults = &SessionSearch->SearchResults;
+		TArray<FOnlineSessionSearchResult> FilteredSearchResults;
+
+		// Not every subsystem evaluates QuerySettings, and some criteria never go to the backend, so only keep the sessions we can use
+		if (Request->SessionFilter.IsValid())
+		{
+			// A stream hands out results by their index and filters its batches itself, so it keeps the results as they came
+			if (Request->SearchStream.IsValid())
+			{
+				FilteredSearchResults = SessionSearch->SearchResults;
+				Request->SessionFilter->FilterResults(FilteredSearchResults);
+				SearchResults = &FilteredSearchResults;
+			}
+			else
+			{
+				const int32 NumFilteredOut = Request->SessionFilter->FilterResults(SessionSearch->SearchResults);
+				UE_LOG(LogUOnline, Verbose, TEXT("Filtered out %d search results"), NumFilteredOut);
+			}
+		}
+
+		FUOnlineSessionSearchDelta SearchDelta;
+		SessionCache.Apply(Request->QueryKey, *SearchResults, FPlatformTime::Seconds(), SearchDelta);
+
+		// The player is about to pick one of these, have their addresses ready
+		ConnectStringCache.Prefetch(GetSessionInterface(), *SearchResults, ConnectStringPrefetchCount, FPlatformTime::Seconds());
+
+		if (SearchDelta.HasChanges())
+		{
+			OnSessionSearchUpdated.Broadcast(SearchDelta);
+		}
+	}
+	else
+	{
+		SessionCache.SetRefreshing(Request->QueryKey, false);
+	}
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Num Search Results: %d"), SessionSearch->SearchResults.Num());
+
+	// Listing every result is only worth its cost when someone asked for it
+	if (UE_LOG_ACTIVE(LogUOnline, VeryVerbose))
+	{
+		for (int32 SearchIdx = 0; SearchIdx < SessionSearch->SearchResults.Num(); SearchIdx++)
+		{
+			UE_LOG(LogUOnline, VeryVerbose, TEXT("Session Number: %d | Sessionname: %s"), SearchIdx + 1, *SessionSearch->SearchResults[SearchIdx].Session.OwningUserName);
+		}
+	}
+
+	CompleteRequest(Request.ToSharedRef(), arg_bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+}
+
+void UOnlineObject::StartSearchPostProcess(const TSharedRef<FUOnlineRequest>& arg_Request)
+{
+	TSharedRef<FUOnlineSearchPostProcess, ESPMode::ThreadSafe> PostProcess = MakeShareable(new FUOnlineSearchPostProcess());
+	PostProcess->RequestId = arg_Request->Id;
+	PostProcess->QueryKey = arg_Request->QueryKey;
+	PostProcess->PreviousFingerprints = SessionCache.GetFingerprints(arg_Request->QueryKey);
+	PostProcess->MaxPrefetchCandidates = ConnectStringPrefetchCount;
+	PostProcess->bLogResults = UE_LOG_ACTIVE(LogUOnline, VeryVerbose);
+
+	// The worker gets its own copy of the filter, the request may be gone before it's done
+	if (arg_Request->SessionFilter.IsValid())
+	{
+		PostProcess->SessionFilter = MakeUnique<FUOnlineSessionFilterPredicate>(*arg_Request->SessionFilter);
+	}
+
+	// Moving the results is constant time, and nobody else holds on to them until they come back
+	PostProcess->SearchResults = MoveTemp(arg_Request->SessionSearch->SearchResults);
+	arg_Request->bIsPostProcessing = true;
+
+	TWeakObjectPtr<UOnlineObject> WeakThis(this);
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [PostProcess, WeakThis]()
+	{
+		PostProcess->Run();
+
+		AsyncTask(ENamedThreads::GameThread, [PostProcess, WeakThis]()
+		{
+			if (UOnlineObject* OnlineObject = WeakThis.Get())
+			{
+				OnlineObject->FinishSearchPostProcess(PostProcess);
+			}
+		});
+	});
+}
+
+void UOnlineObject::FinishSearchPostProcess(const TSharedRef<FUOnlineSearchPostProcess, ESPMode::ThreadSafe>& arg_PostProcess)
+{
+	SCOPED_NAMED_EVENT(UOnline_FinishSearchPostProcess, FColor::Blue);
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::FindSessions, NAME_None);
+
+	// Timed out or cancelled meanwhile, its listeners were told already
+	if (!Request.IsValid() || Request->Id != arg_PostProcess->RequestId || !Request->SessionSearch.IsValid())
+	{
+		return;
+	}
+
+	Request->bIsPostProcessing = false;
+
+	// Everything is moved out, so the worker never releases anything the game thread shares. What's left here is constant time,
+	// apart from resolving a bounded number of connect strings
+	Request->SessionSearch->SearchResults = MoveTemp(arg_PostProcess->SearchResults);
+
+	FUOnlineSessionCacheUpdate CacheUpdate = MoveTemp(arg_PostProcess->CacheUpdate);
+	const double Now = FPlatformTime::Seconds();
+
+	SessionCache.Commit(Request->QueryKey, CacheUpdate, Now);
+	ConnectStringCache.Prefetch(GetSessionInterface(), Request->SessionSearch->SearchResults, arg_PostProcess->PrefetchCandidates, Now);
+
+	if (CacheUpdate.Delta.HasChanges())
+	{
+		OnSessionSearchUpdated.Broadcast(CacheUpdate.Delta);
+	}
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Filtered out %d search results"), arg_PostProcess->NumFilteredOut);
+	UE_LOG(LogUOnline, Verbose, TEXT("Num Search Results: %d"), Request->SessionSearch->SearchResults.Num());
+
+	CompleteRequest(Request.ToSharedRef(), EUOnlineRequestStatus::Succeeded);
+}
+
+void UOnlineObject::OnJoinSessionComplete(FName arg_SessionName, EOnJoinSessionCompleteResult::Type arg_Result)
+{
+	SCOPED_NAMED_EVENT(UOnline_OnJoinSessionComplete, FColor::Blue);
+	UE_LOG(LogUOnline, Verbose, TEXT("OnJoinSessionComplete %s, %d"), *arg_SessionName.ToString(), static_cast<int32>(arg_Result));
+
+	if (RequestQueue.ConsumeStaleCallback(arg_SessionName, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::JoinSession, arg_SessionName);
+
+	if (Request.IsValid())
+	{
+		Request->JoinResult = arg_Result;
+		CompleteRequest(Request.ToSharedRef(), arg_Result == EOnJoinSessionCompleteResult::Success ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+	}
+}
+
+void UOnlineObject::SetOnlineSubsystemName(FName arg_SubsystemName)
+{
+	OnlineSubsystemName = arg_SubsystemName;
+
+	// Cached results came from the previous subsystem
+	SessionCache.Empty();
+	ConnectStringCache.Empty();
+
+	BindSessionDelegates();
+}
+
+#if !UE_BUILD_SHIPPING
+void UOnlineObject::SetSessionInterfaceOverride(IOnlineSessionPtr arg_SessionInterface)
+{
+	SessionInterfaceOverride = arg_SessionInterface;
+
+	// Cached results came from the previous interface
+	SessionCache.Empty();
+	ConnectStringCache.Empty();
+
+	BindSessionDelegates();
+}
+#endif
+
+IOnlineSessionPtr UOnlineObject::GetSessionInterface() const
+{
+#if !UE_BUILD_SHIPPING
+	if (SessionInterfaceOverride.IsValid())
+	{
+		return SessionInterfaceOverride;
+	}
+#endif
+
+	// Get the OnlineSubsystem we want to work with
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(OnlineSubsystemName);
+
+	if (OnlineSubsystemInterface)
+	{
+		return OnlineSubsystemInterface->GetSessionInterface();
+	}
+
+	return nullptr;
+}
+
+void UOnlineObject::BindSessionDelegates()
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid() || BoundSessionInterface.Pin() == OnlineSessionInterface)
+	{
+		return;
+	}
+
+	// The subsystem changed, move our delegates over
+	UnbindSessionDelegates();
+
+	// Registered once for the lifetime of this object, every callback is routed to the request it belongs to
+	OnCreateSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegate);
+	OnStartSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegate);
+	OnEndSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnEndSessionCompleteDelegate_Handle(OnEndSessionCompleteDelegate);
+	OnFindSessionsCompleteDelegateHandle = OnlineSessionInterface->AddOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegate);
+	OnJoinSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
+	OnDestroySessionCompleteDelegateHandle = OnlineSessionInterface->AddOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegate);
+	OnUpdateSessionCompleteDelegateHandle = OnlineSessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(OnUpdateSessionCompleteDelegate);
+	OnSessionUserInviteAcceptedDelegateHandle = OnlineSessionInterface->AddOnSessionUserInviteAcceptedDelegate_Handle(OnSessionUserInviteAcceptedDelegate);
+
+	BoundSessionInterface = OnlineSessionInterface;
+}
+
+void UOnlineObject::UnbindSessionDelegates()
+{
+	IOnlineSessionPtr OnlineSessionInterface = BoundSessionInterface.Pin();
+
+	if (OnlineSessionInterface.IsValid())
+	{
+		OnlineSessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnEndSessionCompleteDelegate_Handle(OnEndSessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnUpdateSessionCompleteDelegate_Handle(OnUpdateSessionCompleteDelegateHandle);
+		OnlineSessionInterface->ClearOnSessionUserInviteAcceptedDelegate_Handle(OnSessionUserInviteAcceptedDelegateHandle);
+	}
+
+	BoundSessionInterface.Reset();
+}
+
+int32 UOnlineObject::SubmitCreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::CreateSession, arg_SessionName));
+	Request->UserNetId = arg_UserNetId;
+	Request->SessionSettings = arg_SessionSettings;
+
+	if (arg_OnComplete.IsBound())
+	{
+		Request->Completions.Add(arg_OnComplete);
+	}
+
+	return SubmitRequest(Request);
+}
+
+int32 UOnlineObject::SubmitUpdateSession(FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete)
+{
+	TSharedRef<FUOnlineRequest> Request = MakeShareable(new FUOnlineRequest(EUOnlineRequestType::UpdateSession, arg_SessionName));
+	Request->SessionSettings = arg_SessionSettings;
+
+	if (arg_OnComplete.IsBound())
+	{
+		Request->Completions.Add(arg_OnComplete);
+	}
+
+	return SubmitRequest(Request);
+}
+
+EUOnlineRecycleStep UOnlineObject::GetNextRecycleStep(const FUOnlineRequest& arg_Request, bool arg_bWasSuccessful) const
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+	const FNamedOnlineSession* NamedSession = OnlineSessionInterface.IsValid() ? OnlineSessionInterface->GetNamedSession(arg_Request.SessionName) : nullptr;
+
+	// A session that was created again gets no second chance
+	const EUOnlineRecycleStep FallbackStep = arg_Request.bIsRecreating ? EUOnlineRecycleStep::None : EUOnlineRecycleStep::DestroySession;
+
+	switch (arg_Request.RecycleStep)
+	{
+	case EUOnlineRecycleStep::None:
+		if (!NamedSession)
+		{
+			return EUOnlineRecycleStep::CreateSession;
+		}
+
+		if (!FUOnlineSessionSettingsTracker::CanUpdateInPlace(NamedSession->SessionSettings, *arg_Request.SessionSettings))
+		{
+			return EUOnlineRecycleStep::DestroySession;
+		}
+
+		if (NamedSession->SessionState == EOnlineSessionState::InProgress)
+		{
+			return EUOnlineRecycleStep::EndSession;
+		}
+
+		// Nothing to end, e.g. the match never started. Sessions that are busy with anything else can't be taken over
+		if (NamedSession->SessionState != EOnlineSessionState::Pending && NamedSession->SessionState != EOnlineSessionState::Ended)
+		{
+			return EUOnlineRecycleStep::DestroySession;
+		}
+
+		return FUOnlineSessionSettingsTracker::IsSameSettings(NamedSession->SessionSettings, *arg_Request.SessionSettings) ? EUOnlineRecycleStep::StartSession : EUOnlineRecycleStep::UpdateSession;
+
+	case EUOnlineRecycleStep::EndSession:
+		if (!arg_bWasSuccessful || !NamedSession)
+		{
+			return FallbackStep;
+		}
+
+		// A rematch on the same settings costs no update at all
+		return FUOnlineSessionSettingsTracker::IsSameSettings(NamedSession->SessionSettings, *arg_Request.SessionSettings) ? EUOnlineRecycleStep::StartSession : EUOnlineRecycleStep::UpdateSession;
+
+	case EUOnlineRecycleStep::UpdateSession:
+		return arg_bWasSuccessful ? EUOnlineRecycleStep::StartSession : FallbackStep;
+
+	case EUOnlineRecycleStep::StartSession:
+		return arg_bWasSuccessful ? EUOnlineRecycleStep::None : FallbackStep;
+
+	case EUOnlineRecycleStep::DestroySession:
+		return arg_bWasSuccessful ? EUOnlineRecycleStep::CreateSession : EUOnlineRecycleStep::None;
+
+	case EUOnlineRecycleStep::CreateSession:
+		return arg_bWasSuccessful ? EUOnlineRecycleStep::StartSession : EUOnlineRecycleStep::None;
+	}
+
+	return EUOnlineRecycleStep::None;
+}
+
+void UOnlineObject::AdvanceRecycleSession(const TSharedRef<FUOnlineRequest>& arg_Request, bool arg_bWasSuccessful)
+{
+	if (arg_Request->RecycleStep != EUOnlineRecycleStep::None)
+	{
+		UE_LOG(LogUOnline, Verbose, TEXT("Recycling session %s: step %d took %.1f ms, %d"), *arg_Request->SessionName.ToString(), static_cast<int32>(arg_Request->RecycleStep), (FPlatformTime::Seconds() - arg_Request->RecycleStepTime) * 1000.0, arg_bWasSuccessful);
+	}
+
+	// Don't restart sessions nobody is waiting for anymore
+	const EUOnlineRecycleStep NextStep = arg_Request->bIsAbandoned ? EUOnlineRecycleStep::None : GetNextRecycleStep(*arg_Request, arg_bWasSuccessful);
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (NextStep == EUOnlineRecycleStep::None || !OnlineSessionInterface.IsValid())
+	{
+		const bool bWasSuccessful = arg_bWasSuccessful && NextStep == EUOnlineRecycleStep::None;
+		arg_Request->RecycleStep = EUOnlineRecycleStep::None;
+		CompleteRequest(arg_Request, bWasSuccessful ? EUOnlineRequestStatus::Succeeded : EUOnlineRequestStatus::Failed);
+		return;
+	}
+
+	if ((NextStep == EUOnlineRecycleStep::DestroySession || NextStep == EUOnlineRecycleStep::CreateSession) && !arg_Request->bIsRecreating)
+	{
+		UE_LOG(LogUOnline, Log, TEXT("Session %s can't be recycled in place, creating it again"), *arg_Request->SessionName.ToString());
+		arg_Request->bIsRecreating = true;
+	}
+
+	arg_Request->RecycleStep = NextStep;
+	arg_Request->RecycleStepTime = FPlatformTime::Seconds();
+	const int32 NumRecycleSteps = ++arg_Request->NumRecycleSteps;
+
+	bool bIsStarted = false;
+
+	switch (NextStep)
+	{
+	case EUOnlineRecycleStep::EndSession:
+		bIsStarted = OnlineSessionInterface->EndSession(arg_Request->SessionName);
+		break;
+
+	case EUOnlineRecycleStep::UpdateSession:
+		bIsStarted = OnlineSessionInterface->UpdateSession(arg_Request->SessionName, *arg_Request->SessionSettings, true);
+		break;
+
+	case EUOnlineRecycleStep::StartSession:
+		bIsStarted = OnlineSessionInterface->StartSession(arg_Request->SessionName);
+		break;
+
+	case EUOnlineRecycleStep::DestroySession:
+		bIsStarted = OnlineSessionInterface->DestroySession(arg_Request->SessionName);
+		break;
+
+	case EUOnlineRecycleStep::CreateSession:
+		// A dedicated server has no user, it hosts as the first player
+		if (!arg_Request->UserNetId.IsValid())
+		{
+			bIsStarted = OnlineSessionInterface->CreateSession(0, arg_Request->SessionName, *arg_Request->SessionSettings);
+		}
+		else
+		{
+			bIsStarted = OnlineSessionInterface->CreateSession(*arg_Request->UserNetId, arg_Request->SessionName, *arg_Request->SessionSettings);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	// Some subsystems call back before returning, so only a call that is still the current one failed here
+	if (!bIsStarted && arg_Request->RecycleStep == NextStep && arg_Request->NumRecycleSteps == NumRecycleSteps)
+	{
+		AdvanceRecycleSession(arg_Request, false);
+	}
+}
+
+bool UOnlineObject::CompleteRecycleStep(FName arg_SessionName, EUOnlineRecycleStep arg_Step, bool arg_bWasSuccessful)
+{
+	// Requests on the same session name never run at the same time, so a recycle request waiting for this call owns the callback
+	TSharedPtr<FUOnlineRequest> Request = RequestQueue.FindActive(EUOnlineRequestType::RecycleSession, arg_SessionName);
+
+	if (!Request.IsValid() || Request->RecycleStep != arg_Step)
+	{
+		return false;
+	}
+
+	AdvanceRecycleSession(Request.ToSharedRef(), arg_bWasSuccessful);
+
+	return true;
+}
+
+bool UOnlineObject::TrackSessionSettings(FName arg_SessionName)
+{
+	if (SessionSettingsTracker.IsTracked(arg_SessionName))
+	{
+		return true;
+	}
+
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid())
+	{
+		return false;
+	}
+
+	const FOnlineSessionSettings* SessionSettings = OnlineSessionInterface->GetSessionSettings(arg_SessionName);
+
+	if (!SessionSettings)
+	{
+		return false;
+	}
+
+	SessionSettingsTracker.Track(arg_SessionName, *SessionSettings);
+
+	return true;
+}
+
+void UOnlineObject::PumpSessionUpdates(double arg_Now)
+{
+	TArray<FName> SessionNames;
+	SessionSettingsTracker.TakeDueUpdates(arg_Now, SessionNames);
+
+	if (SessionNames.Num() == 0)
+	{
+		return;
+	}
+
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	for (const FName& SessionName : SessionNames)
+	{
+		// Destroyed behind our back, its changes have nowhere to go
+		if (!OnlineSessionInterface.IsValid() || !OnlineSessionInterface->GetNamedSession(SessionName))
+		{
+			SessionSettingsTracker.Untrack(SessionName);
+			continue;
+		}
+
+		UE_LOG(LogUOnline, Verbose, TEXT("Sending coalesced settings update of session %s"), *SessionName.ToString());
+
+		const TSharedRef<FOnlineSessionSettings> SessionSettings = SessionSettingsTracker.BeginUpdate(SessionName, arg_Now);
+
+		// The pipeline is full, the changes go out with the next update
+		if (SubmitUpdateSession(SessionName, SessionSettings, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnSessionUpdateComplete)) == FUOnlineRequest::InvalidId)
+		{
+			SessionSettingsTracker.EndUpdate(SessionName, false);
+		}
+	}
+}
+
+void UOnlineObject::OnSessionUpdateComplete(const FUOnlineRequestResult& arg_Result)
+{
+	SessionSettingsTracker.EndUpdate(arg_Result.SessionName, arg_Result.WasSuccessful());
+}
+
+void UOnlineObject::PumpHostedSessions()
+{
+	// A few per tick, so dozens of sessions at boot neither stall a frame nor fill up the pending queue
+	for (int32 NumCreated = 0; NumCreated < HostedSessionCreatesPerTick; ++NumCreated)
+	{
+		FUOnlineHostedSession* Session = SessionRegistry.FindOldest(EUOnlineHostedSessionState::Queued);
+
+		if (!Session)
+		{
+			return;
+		}
+
+		const FName SessionName = Session->SessionName;
+		SetHostedSessionState(*Session, EUOnlineHostedSessionState::Creating);
+
+		const int32 RequestId = SubmitCreateSession(HostUserNetId, SessionName, Session->Settings, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnHostedSessionRequestComplete));
+
+		// The create can complete before we get here, so look the session up again
+		Session = SessionRegistry.Find(SessionName);
+
+		if (!Session || Session->State != EUOnlineHostedSessionState::Creating)
+		{
+			continue;
+		}
+
+		if (RequestId == FUOnlineRequest::InvalidId)
+		{
+			// The pipeline is full, try again next tick
+			SetHostedSessionState(*Session, EUOnlineHostedSessionState::Queued);
+			return;
+		}
+
+		Session->RequestId = RequestId;
+	}
+}
+
+void UOnlineObject::OnHostedSessionRequestComplete(const FUOnlineRequestResult& arg_Result)
+{
+	FUOnlineHostedSession* Session = SessionRegistry.Find(arg_Result.SessionName);
+
+	// Requests complete synchronously on some subsystems, before their id is stored
+	if (!Session || (Session->RequestId != arg_Result.RequestId && Session->RequestId != FUOnlineRequest::InvalidId))
+	{
+		return;
+	}
+
+	Session->RequestId = FUOnlineRequest::InvalidId;
+
+	const bool bWasSuccessful = arg_Result.WasSuccessful();
+
+	switch (arg_Result.Type)
+	{
+	case EUOnlineRequestType::CreateSession:
+		if (Session->State == EUOnlineHostedSessionState::Creating)
+		{
+			SetHostedSessionState(*Session, bWasSuccessful ? EUOnlineHostedSessionState::Available : EUOnlineHostedSessionState::Failed);
+		}
+		break;
+
+	case EUOnlineRequestType::RecycleSession:
+		if (Session->State != EUOnlineHostedSessionState::Recycling)
+		{
+			break;
+		}
+
+		if (bWasSuccessful)
+		{
+			++Session->NumMatches;
+			SetHostedSessionState(*Session, EUOnlineHostedSessionState::Available);
+		}
+		else
+		{
+			// Even creating it again in place failed, tear down whatever is left and let the queue bring it back with the same name
+			Session->bRecreateAfterDestroy = true;
+			SetHostedSessionState(*Session, EUOnlineHostedSessionState::Destroying);
+
+			const FName SessionName = Session->SessionName;
+			const int32 RequestId = DestroySession(SessionName, FOnUOnlineRequestComplete::CreateUObject(this, &UOnlineObject::OnHostedSessionRequestComplete));
+
+			Session = SessionRegistry.Find(SessionName);
+
+			if (Session && Session->State == EUOnlineHostedSessionState::Destroying)
+			{
+				Session->RequestId = RequestId;
+
+				if (RequestId == FUOnlineRequest::InvalidId)
+				{
+					SetHostedSessionState(*Session, EUOnlineHostedSessionState::Failed);
+				}
+			}
+		}
+		break;
+
+	case EUOnlineRequestType::DestroySession:
+		if (Session->State != EUOnlineHostedSessionState::Destroying)
+		{
+			break;
+		}
+
+		if (Session->bRecreateAfterDestroy)
+		{
+			Session->bRecreateAfterDestroy = false;
+			SetHostedSessionState(*Session, EUOnlineHostedSessionState::Queued);
+			EnsureRequestTicker();
+		}
+		else
+		{
+			const FName SessionName = Session->SessionName;
+			SessionRegistry.Remove(SessionName);
+			OnHostedSessionChanged.Broadcast(SessionName, EUOnlineHostedSessionState::Destroying);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UOnlineObject::SetHostedSessionState(FUOnlineHostedSession& arg_Session, EUOnlineHostedSessionState arg_State)
+{
+	SessionRegistry.SetState(arg_Session, arg_State, FPlatformTime::Seconds());
+
+	UE_LOG(LogUOnline, Verbose, TEXT("Hosted session %s is now %d"), *arg_Session.SessionName.ToString(), static_cast<int32>(arg_State));
+
+	// Copy the name, listeners may change the registry
+	const FName SessionName = arg_Session.SessionName;
+	OnHostedSessionChanged.Broadcast(SessionName, arg_State);
+}
+
+int32 UOnlineObject::SubmitRequest(const TSharedRef<FUOnlineRequest>& arg_Request)
+{
+	BindSessionDelegates();
+
+	if (arg_Request->Timeout <= 0.f)
+	{
+		arg_Request->Timeout = RequestTimeout;
+	}
+
+	const int32 RequestId = RequestQueue.Enqueue(arg_Request, FPlatformTime::Seconds());
+
+	// The queue is full, the caller has to try again later
+	if (RequestId == FUOnlineRequest::InvalidId)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	EnsureRequestTicker();
+	PumpRequests();
+
+	return RequestId;
+}
+
+void UOnlineObject::PumpRequests()
+{
+	TArray<TSharedRef<FUOnlineRequest>> StartableRequests;
+	RequestQueue.TakeStartable(FPlatformTime::Seconds(), StartableRequests);
+
+	for (const TSharedRef<FUOnlineRequest>& Request : StartableRequests)
+	{
+		FUOnlineStats::Get().BeginOperation(FUOnlineStats::GetOperation(Request->Type));
+
+		// Some subsystems call back before returning, so only fail requests that are still running
+		if (!StartRequest(Request) && Request->Status == EUOnlineRequestStatus::Running)
+		{
+			CompleteRequest(Request, EUOnlineRequestStatus::Failed);
+		}
+	}
+}
+
+bool UOnlineObject::StartRequest(const TSharedRef<FUOnlineRequest>& arg_Request)
+{
+	IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+	if (!OnlineSessionInterface.IsValid())
+	{
+		return false;
+	}
+
+	switch (arg_Request->Type)
+	{
+	case EUOnlineRequestType::CreateSession:
+		// A dedicated server has no user, it hosts as the first player
+		if (!arg_Request->UserNetId.IsValid())
+		{
+			return OnlineSessionInterface->CreateSession(0, arg_Request->SessionName, *arg_Request->SessionSettings);
+		}
+
+		return OnlineSessionInterface->CreateSession(*arg_Request->UserNetId, arg_Request->SessionName, *arg_Request->SessionSettings);
+
+	case EUOnlineRequestType::FindSessions:
+		// The cache may have been filled while the request waited, e.g. by the warm-up
+		if (!arg_Request->SearchStream.IsValid() && SessionCache.IsFresh(arg_Request->QueryKey, FPlatformTime::Seconds()))
+		{
+			const TSharedPtr<const FUOnlineSessionResultStore> CachedResults = SessionCache.GetResults(arg_Request->QueryKey);
+
+			if (CachedResults.IsValid())
+			{
+				arg_Request->CachedResults = CachedResults;
+				arg_Request->SessionSearch->SearchState = EOnlineAsyncTaskState::Done;
+				CompleteRequest(arg_Request, EUOnlineRequestStatus::Succeeded);
+				return true;
+			}
+		}
+
+		SessionCache.SetRefreshing(arg_Request->QueryKey, true);
+
+		if (OnlineSessionInterface->FindSessions(*arg_Request->UserNetId, arg_Request->SessionSearch.ToSharedRef()))
+		{
+			return true;
+		}
+
+		// The subsystem refused the search, so don't leave the query flagged as refreshing
+		SessionCache.SetRefreshing(arg_Request->QueryKey, false);
+		return false;
+
+	case EUOnlineRequestType::JoinSession:
+		return OnlineSessionInterface->JoinSession(*arg_Request->UserNetId, arg_Request->SessionName, arg_Request->SearchResult);
+
+	case EUOnlineRequestType::DestroySession:
+		return OnlineSessionInterface->DestroySession(arg_Request->SessionName);
+
+	case EUOnlineRequestType::UpdateSession:
+		return OnlineSessionInterface->UpdateSession(arg_Request->SessionName, *arg_Request->SessionSettings, true);
+
+	case EUOnlineRequestType::RecycleSession:
+		// Takes several calls, every one of them completes the request itself if it fails
+		AdvanceRecycleSession(arg_Request, true);
+		return true;
+	}
+
+	return false;
+}
+
+void UOnlineObject::CompleteRequest(const TSharedRef<FUOnlineRequest>& arg_Request, EUOnlineRequestStatus arg_Status)
+{
+	// Already completed, e.g. a subsystem that both calls back and returns false
+	if (!RequestQueue.Remove(arg_Request->Id).IsValid())
+	{
+		return;
+	}
+
+	// Measured up to the subsystem answering, even for requests the caller stopped waiting for
+	if (arg_Request->bIsStarting)
+	{
+		FUOnlineStats::Get().EndOperation(EUOnlineOperation::StartSession, arg_Request->StartSessionTime, arg_Status == EUOnlineRequestStatus::Succeeded);
+	}
+	else
+	{
+		FUOnlineStats::Get().EndOperation(FUOnlineStats::GetOperation(arg_Request->Type), arg_Request->StartTime, arg_Status == EUOnlineRequestStatus::Succeeded);
+	}
+
+	// The settings tracker follows what the subsystem did, even for requests the caller stopped waiting for
+	if (arg_Status == EUOnlineRequestStatus::Succeeded)
+	{
+		if (arg_Request->Type == EUOnlineRequestType::CreateSession || arg_Request->Type == EUOnlineRequestType::RecycleSession)
+		{
+			SessionSettingsTracker.Track(arg_Request->SessionName, *arg_Request->SessionSettings);
+		}
+		else if (arg_Request->Type == EUOnlineRequestType::DestroySession)
+		{
+			SessionSettingsTracker.Untrack(arg_Request->SessionName);
+		}
+	}
+
+	// Abandoned requests already told their listeners, the subsystem finally answering just frees the lane
+	if (!arg_Request->bIsAbandoned)
+	{
+		arg_Request->Status = arg_Status;
+
+		if (arg_Request->SearchStream.IsValid())
+		{
+			arg_Request->SearchStream->MarkComplete(arg_Status != EUOnlineRequestStatus::Succeeded);
+			DrainingSearchRequests.Add(arg_Request);
+			EnsureRequestTicker();
+		}
+
+		NotifyRequestComplete(*arg_Request);
+	}
+
+	PumpRequests();
+}
+
+void UOnlineObject::StopRequest(const TSharedRef<FUOnlineRequest>& arg_Request, EUOnlineRequestStatus arg_Status)
+{
+	if (arg_Status == EUOnlineRequestStatus::TimedOut)
+	{
+		FUOnlineStats::Get().AddTimeout(arg_Request->bIsStarting ? EUOnlineOperation::StartSession : FUOnlineStats::GetOperation(arg_Request->Type));
+	}
+
+	// Never handed to the subsystem, just drop it
+	if (arg_Request->Status == EUOnlineRequestStatus::Pending)
+	{
+		RequestQueue.Remove(arg_Request->Id);
+		arg_Request->Status = arg_Status;
+		NotifyRequestComplete(*arg_Request);
+		return;
+	}
+
+	// Searches can be cancelled in the subsystem, which frees the search lane right away
+	if (arg_Request->Type == EUOnlineRequestType::FindSessions)
+	{
+		IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+		// The subsystem is done with a search that is being post processed, cancelling would hit whatever it runs next.
+		// FinishSearchPostProcess drops the worker's result once the request is gone
+		if (OnlineSessionInterface.IsValid() && !arg_Request->bIsPostProcessing)
+		{
+			OnlineSessionInterface->CancelFindSessions();
+		}
+
+		SessionCache.SetRefreshing(arg_Request->QueryKey, false);
+		CompleteRequest(arg_Request, arg_Status);
+		return;
+	}
+
+	// Other operations will still complete in the subsystem, keep the lane blocked until they do
+	arg_Request->Status = arg_Status;
+	arg_Request->bIsAbandoned = true;
+	arg_Request->AbandonTime = FPlatformTime::Seconds();
+	NotifyRequestComplete(*arg_Request);
+}
+
+void UOnlineObject::NotifyRequestComplete(const FUOnlineRequest& arg_Request) const
+{
+	FUOnlineRequestResult RequestResult;
+	RequestResult.RequestId = arg_Request.Id;
+	RequestResult.Type = arg_Request.Type;
+	RequestResult.Status = arg_Request.Status;
+	RequestResult.SessionName = arg_Request.SessionName;
+	RequestResult.JoinResult = arg_Request.JoinResult;
+	RequestResult.SearchResults = arg_Request.SessionSearch.IsValid() && !arg_Request.CachedResults.IsValid() ? &arg_Request.SessionSearch->SearchResults : nullptr;
+	RequestResult.CachedResults = arg_Request.CachedResults;
+
+	// Listeners may queue new requests, so work on a copy
+	const TArray<FOnUOnlineRequestComplete> Completions = arg_Request.Completions;
+
+	for (const FOnUOnlineRequestComplete& Completion : Completions)
+	{
+		Completion.ExecuteIfBound(RequestResult);
+	}
+}
+
+void UOnlineObject::EnsureRequestTicker()
+{
+	if (!RequestTickerHandle.IsValid())
+	{
+		RequestTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UOnlineObject::TickRequests));
+	}
+}
+
+bool UOnlineObject::TickRequests(float arg_DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UOnline_TickRequests);
+
+	const double Now = FPlatformTime::Seconds();
+
+	TArray<TSharedRef<FUOnlineRequest>> TimedOutRequests;
+	RequestQueue.CollectTimedOut(Now, TimedOutRequests);
+
+	for (const TSharedRef<FUOnlineRequest>& Request : TimedOutRequests)
+	{
+		StopRequest(Request, EUOnlineRequestStatus::TimedOut);
+	}
+
+	// Hand out batches of the running streaming search
+	TSharedPtr<FUOnlineRequest> ActiveSearchRequest = RequestQueue.FindActive(EUOnlineRequestType::FindSessions, NAME_None);
+
+	if (ActiveSearchRequest.IsValid() && ActiveSearchRequest->SearchStream.IsValid() && !ActiveSearchRequest->bIsAbandoned)
+	{
+		TickSearchStream(ActiveSearchRequest.ToSharedRef(), Now);
+	}
+
+	// And of streaming searches the subsystem is done with
+	for (int32 DrainingIndex = DrainingSearchRequests.Num() - 1; DrainingIndex >= 0; --DrainingIndex)
+	{
+		const TSharedRef<FUOnlineRequest> Request = DrainingSearchRequests[DrainingIndex];
+
+		if (TickSearchStream(Request, Now))
+		{
+			DrainingSearchRequests.RemoveAt(DrainingIndex);
+		}
+	}
+
+	// Timeouts and completions may have freed lanes
+	PumpRequests();
+	PumpHostedSessions();
+	PumpSessionUpdates(Now);
+
+	// Friends lists that are too long to apply in one go
+	for (const int32 LocalUserNum : TSet<int32>(FriendsListsApplying))
+	{
+		ApplyFriendsListSlice(LocalUserNum);
+	}
+
+	if (RequestQueue.IsEmpty() && DrainingSearchRequests.Num() == 0 && SessionRegistry.Num(EUOnlineHostedSessionState::Queued) == 0 && !SessionSettingsTracker.HasDirtySessions() && FriendsListsApplying.Num() == 0)
+	{
+		RequestTickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool UOnlineObject::TickSearchStream(const TSharedRef<FUOnlineRequest>& arg_Request, double arg_Now)
+{
+	const TSharedRef<FUOnlineSessionSearchStream> SearchStream = arg_Request->SearchStream.ToSharedRef();
+
+	TArray<FOnlineSessionSearchResult> SearchResultBatch;
+	SearchStream->TakeBatch(arg_Now, SearchResultBatch);
+
+	// Only a stream the subsystem is done with can run dry, a stream stopped below hands out its final batch from the draining list
+	const bool bIsFinalBatch = SearchStream->IsDrained();
+
+	// Stop the query as soon as we have enough good results, there's no point in waiting for the rest
+	if (!SearchStream->IsComplete() && SearchStream->HasEnoughGoodResults())
+	{
+		IOnlineSessionPtr OnlineSessionInterface = GetSessionInterface();
+
+		if (OnlineSessionInterface.IsValid())
+		{
+			OnlineSessionInterface->CancelFindSessions();
+		}
+
+		// A partial result set must not replace the cached snapshot
+		SessionCache.SetRefreshing(arg_Request->QueryKey, false);
+		CompleteRequest(arg_Request, EUOnlineRequestStatus::Succeeded);
+	}
+
+	if (SearchResultBatch.Num() > 0 || bIsFinalBatch)
+	{
+		OnSessionSearchBatch.Broadcast(arg_Request->Id, SearchResultBatch, bIsFinalBatch);
+	}
+
+	return bIsFinalBatch;
+}
@@ -0,0 +1,261 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineRequestQueue.h"
+
+FUOnlineRequestQueue::FUOnlineRequestQueue() : NextRequestId(FUOnlineRequest::InvalidId + 1), MaxActive(16), MaxPending(64)
+{
+
+}
+
+void FUOnlineRequestQueue::SetLimits(int32 arg_MaxActive, int32 arg_MaxPending)
+{
+	MaxActive = FMath::Max(1, arg_MaxActive);
+	MaxPending = FMath::Max(0, arg_MaxPending);
+}
+
+int32 FUOnlineRequestQueue::AllocateId()
+{
+	const int32 RequestId = NextRequestId++;
+
+	// Skip the invalid id when wrapping around
+	if (NextRequestId <= FUOnlineRequest::InvalidId)
+	{
+		NextRequestId = FUOnlineRequest::InvalidId + 1;
+	}
+
+	return RequestId;
+}
+
+int32 FUOnlineRequestQueue::Enqueue(const TSharedRef<FUOnlineRequest>& arg_Request, double arg_Now)
+{
+	if (Pending.Num() >= MaxPending)
+	{
+		return FUOnlineRequest::InvalidId;
+	}
+
+	if (arg_Request->Id == FUOnlineRequest::InvalidId)
+	{
+		arg_Request->Id = AllocateId();
+	}
+
+	arg_Request->Status = EUOnlineRequestStatus::Pending;
+	arg_Request->EnqueueTime = arg_Now;
+	Pending.Add(arg_Request);
+
+	return arg_Request->Id;
+}
+
+void FUOnlineRequestQueue::TakeStartable(double arg_Now, TArray<TSharedRef<FUOnlineRequest>>& arg_OutRequests)
+{
+	arg_OutRequests.Reset();
+
+	// Lanes claimed by earlier requests in this pass, so later requests in the same lane keep their order
+	TArray<FName, TInlineAllocator<8>> ClaimedLanes;
+
+	for (int32 PendingIndex = 0; PendingIndex < Pending.Num() && Active.Num() < MaxActive; )
+	{
+		const TSharedRef<FUOnlineRequest> Request = Pending[PendingIndex];
+		const FName Lane = Request->GetLane();
+
+		if (ClaimedLanes.Contains(Lane) || IsLaneBusy(Lane))
+		{
+			ClaimedLanes.AddUnique(Lane);
+			++PendingIndex;
+			continue;
+		}
+
+		ClaimedLanes.Add(Lane);
+		Pending.RemoveAt(PendingIndex, 1, false);
+
+		Request->Status = EUOnlineRequestStatus::Running;
+		Request->StartTime = arg_Now;
+		Active.Add(Request);
+		arg_OutRequests.Add(Request);
+	}
+}
+
+TSharedPtr<FUOnlineRequest> FUOnlineRequestQueue::FindActive(EUOnlineRequestType arg_Type, FName arg_Lane) const
+{
+	TSharedPtr<FUOnlineRequest> LiveRequest;
+
+	for (const TSharedRef<FUOnlineRequest>& Request : Active)
+	{
+		if (Request->Type != arg_Type || Request->GetLane() != arg_Lane)
+		{
+			continue;
+		}
+
+		// An abandoned request was called first, so a callback is its before it is anyone else's
+		if (Request->bIsAbandoned)
+		{
+			return Request;
+		}
+
+		if (!LiveRequest.IsValid())
+		{
+			LiveRequest = Request;
+		}
+	}
+
+	return LiveRequest;
+}
+
+bool FUOnlineRequestQueue::ConsumeStaleCallback(FName arg_Lane, double arg_Now)
+{
+	for (int32 StaleIndex = 0; StaleIndex < StaleCallbacks.Num(); ++StaleIndex)
+	{
+		if (StaleCallbacks[StaleIndex].Key == arg_Lane && StaleCallbacks[StaleIndex].Value > arg_Now)
+		{
+			StaleCallbacks.RemoveAt(StaleIndex);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TSharedPtr<FUOnlineRequest> FUOnlineRequestQueue::Find(int32 arg_RequestId) const
+{
+	for (const TSharedRef<FUOnlineRequest>& Request : Active)
+	{
+		if (Request->Id == arg_RequestId)
+		{
+			return Request;
+		}
+	}
+
+	for (const TSharedRef<FUOnlineRequest>& Request : Pending)
+	{
+		if (Request->Id == arg_RequestId)
+		{
+			return Request;
+		}
+	}
+
+	return nullptr;
+}
+
+TSharedPtr<FUOnlineRequest> FUOnlineRequestQueue::FindByPredicate(TFunctionRef<bool(const FUOnlineRequest&)> arg_Predicate) const
+{
+	for (const TSharedRef<FUOnlineRequest>& Request : Active)
+	{
+		if (!Request->bIsAbandoned && arg_Predicate(*Request))
+		{
+			return Request;
+		}
+	}
+
+	for (const TSharedRef<FUOnlineRequest>& Request : Pending)
+	{
+		if (arg_Predicate(*Request))
+		{
+			return Request;
+		}
+	}
+
+	return nullptr;
+}
+
+TSharedPtr<FUOnlineRequest> FUOnlineRequestQueue::Remove(int32 arg_RequestId)
+{
+	for (int32 ActiveIndex = 0; ActiveIndex < Active.Num(); ++ActiveIndex)
+	{
+		if (Active[ActiveIndex]->Id == arg_RequestId)
+		{
+			const TSharedRef<FUOnlineRequest> Request = Active[ActiveIndex];
+			Active.RemoveAt(ActiveIndex);
+			return Request;
+		}
+	}
+
+	for (int32 PendingIndex = 0; PendingIndex < Pending.Num(); ++PendingIndex)
+	{
+		if (Pending[PendingIndex]->Id == arg_RequestId)
+		{
+			const TSharedRef<FUOnlineRequest> Request = Pending[PendingIndex];
+			Pending.RemoveAt(PendingIndex);
+			return Request;
+		}
+	}
+
+	return nullptr;
+}
+
+void FUOnlineRequestQueue::CollectTimedOut(double arg_Now, TArray<TSharedRef<FUOnlineRequest>>& arg_OutRequests)
+{
+	arg_OutRequests.Reset();
+
+	StaleCallbacks.RemoveAll([arg_Now](const TPair<FName, double>& arg_StaleCallback)
+	{
+		return arg_StaleCallback.Value <= arg_Now;
+	});
+
+	for (int32 ActiveIndex = Active.Num() - 1; ActiveIndex >= 0; --ActiveIndex)
+	{
+		const TSharedRef<FUOnlineRequest>& Request = Active[ActiveIndex];
+
+		if (Request->Timeout <= 0.f)
+		{
+			continue;
+		}
+
+		if (Request->bIsAbandoned)
+		{
+			// The subsystem never answered, give the lane back. Session callbacks only carry the session name, so if the answer still
+			// comes it is swallowed for another timeout instead of completing the next request of the lane. Searches are told apart
+			// by their search object
+			if (arg_Now - Request->AbandonTime >= Request->Timeout)
+			{
+				if (Request->Type != EUOnlineRequestType::FindSessions)
+				{
+					StaleCallbacks.Add(TPair<FName, double>(Request->GetLane(), arg_Now + Request->Timeout));
+				}
+
+				Active.RemoveAt(ActiveIndex);
+			}
+		}
+		// Time spent waiting for the lane doesn't count against the call
+		else if (arg_Now - Request->StartTime >= Request->Timeout)
+		{
+			arg_OutRequests.Add(Request);
+		}
+	}
+
+	for (const TSharedRef<FUOnlineRequest>& Request : Pending)
+	{
+		if (Request->Timeout > 0.f && arg_Now - Request->EnqueueTime >= Request->Timeout)
+		{
+			arg_OutRequests.Add(Request);
+		}
+	}
+}
+
+void FUOnlineRequestQueue::SetLaneHeld(FName arg_Lane, bool arg_bIsHeld)
+{
+	if (arg_bIsHeld)
+	{
+		HeldLanes.Add(arg_Lane);
+	}
+	else
+	{
+		HeldLanes.Remove(arg_Lane);
+	}
+}
+
+bool FUOnlineRequestQueue::IsLaneBusy(FName arg_Lane) const
+{
+	if (HeldLanes.Contains(arg_Lane))
+	{
+		return true;
+	}
+
+	for (const TSharedRef<FUOnlineRequest>& Request : Active)
+	{
+		if (Request->GetLane() == arg_Lane)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
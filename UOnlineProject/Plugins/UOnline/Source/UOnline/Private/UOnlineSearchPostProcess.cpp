@@ -0,0 +1,28 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSearchPostProcess.h"
+#include "UOnlineJoinPipeline.h"
+#include "UOnlineStats.h"
+
+void FUOnlineSearchPostProcess::Run()
+{
+	SCOPED_NAMED_EVENT(UOnline_SearchPostProcess, FColor::Blue);
+
+	if (SessionFilter.IsValid())
+	{
+		NumFilteredOut = SessionFilter->FilterResults(SearchResults);
+	}
+
+	FUOnlineSessionCache::BuildUpdate(QueryKey, SearchResults, PreviousFingerprints, CacheUpdate);
+
+	// Resolving has to go through the subsystem on the game thread, picking the sessions doesn't
+	FUOnlineConnectStringCache::SelectCandidates(SearchResults, MaxPrefetchCandidates, PrefetchCandidates);
+
+	if (bLogResults)
+	{
+		for (int32 SearchIdx = 0; SearchIdx < SearchResults.Num(); SearchIdx++)
+		{
+			UE_LOG(LogUOnline, VeryVerbose, TEXT("Session Number: %d | Sessionname: %s"), SearchIdx + 1, *SearchResults[SearchIdx].Session.OwningUserName);
+		}
+	}
+}
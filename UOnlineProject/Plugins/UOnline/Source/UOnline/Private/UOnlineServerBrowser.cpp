@@ -0,0 +1,448 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineServerBrowser.h"
+
+namespace
+{
+	/**
+	* @param RowIds: row ids sorted on the order of IsBeforeRow.
+	* @param IsBeforeRow: returns true for the rows that come before the one looked for.
+	* @returns the first position whose row doesn't come before the one looked for.
+	*/
+	template<typename PredicateType>
+	int32 FindLowerBound(const TArray<int32>& arg_RowIds, PredicateType arg_IsBeforeRow)
+	{
+		int32 First = 0;
+		int32 Count = arg_RowIds.Num();
+
+		while (Count > 0)
+		{
+			const int32 Step = Count / 2;
+			const int32 Middle = First + Step;
+
+			if (arg_IsBeforeRow(arg_RowIds[Middle]))
+			{
+				First = Middle + 1;
+				Count -= Step + 1;
+			}
+			else
+			{
+				Count = Step;
+			}
+		}
+
+		return First;
+	}
+}
+
+FUOnlineServerBrowser::FUOnlineServerBrowser() : SortBy(EUOnlineServerBrowserSort::Ping), bSortAscending(true)
+{
+
+}
+
+void FUOnlineServerBrowser::Reset(const TArray<FOnlineSessionSearchResult>& arg_SearchResults)
+{
+	if (RowIds.Num() == 0)
+	{
+		AddRowsInBulk(arg_SearchResults);
+		return;
+	}
+
+	TSet<FString> SessionIds;
+	SessionIds.Reserve(arg_SearchResults.Num());
+
+	for (const FOnlineSessionSearchResult& SearchResult : arg_SearchResults)
+	{
+		if (SearchResult.IsValid())
+		{
+			SessionIds.Add(SearchResult.GetSessionIdStr());
+		}
+	}
+
+	TArray<int32> RowIdsToRemove;
+
+	for (const TPair<FString, int32>& RowId : RowIds)
+	{
+		if (!SessionIds.Contains(RowId.Key))
+		{
+			RowIdsToRemove.Add(RowId.Value);
+		}
+	}
+
+	for (const int32 RowId : RowIdsToRemove)
+	{
+		RemoveRow(RowId);
+	}
+
+	AddOrUpdate(arg_SearchResults);
+}
+
+void FUOnlineServerBrowser::ApplyDelta(const FUOnlineSessionSearchDelta& arg_SearchDelta)
+{
+	for (const FString& SessionId : arg_SearchDelta.Removed)
+	{
+		Remove(SessionId);
+	}
+
+	if (RowIds.Num() == 0)
+	{
+		AddRowsInBulk(arg_SearchDelta.Added);
+	}
+	else
+	{
+		AddOrUpdate(arg_SearchDelta.Added);
+	}
+
+	AddOrUpdate(arg_SearchDelta.Changed);
+}
+
+void FUOnlineServerBrowser::AddOrUpdate(const TArray<FOnlineSessionSearchResult>& arg_SearchResults)
+{
+	for (const FOnlineSessionSearchResult& SearchResult : arg_SearchResults)
+	{
+		if (!SearchResult.IsValid())
+		{
+			continue;
+		}
+
+		if (const int32* RowId = RowIds.Find(SearchResult.GetSessionIdStr()))
+		{
+			UpdateRow(*RowId, SearchResult);
+		}
+		else
+		{
+			AddRow(SearchResult);
+		}
+	}
+}
+
+void FUOnlineServerBrowser::Remove(const FString& arg_SessionId)
+{
+	if (const int32* RowId = RowIds.Find(arg_SessionId))
+	{
+		RemoveRow(*RowId);
+	}
+}
+
+void FUOnlineServerBrowser::Empty()
+{
+	Rows.Empty();
+	RowIds.Empty();
+
+	for (TArray<int32>& SortIndex : SortIndices)
+	{
+		SortIndex.Empty();
+	}
+
+	VisibleRowIds.Empty();
+	OnViewReset.Broadcast();
+}
+
+void FUOnlineServerBrowser::SetSort(EUOnlineServerBrowserSort arg_SortBy, bool arg_bAscending)
+{
+	if (arg_SortBy == EUOnlineServerBrowserSort::Num || (arg_SortBy == SortBy && arg_bAscending == bSortAscending))
+	{
+		return;
+	}
+
+	SortBy = arg_SortBy;
+	bSortAscending = arg_bAscending;
+
+	RebuildView();
+}
+
+void FUOnlineServerBrowser::SetFilter(const FUOnlineServerBrowserFilter& arg_Filter)
+{
+	Filter = arg_Filter;
+	RebuildView();
+}
+
+void FUOnlineServerBrowser::RefreshFilter()
+{
+	RebuildView();
+}
+
+int32 FUOnlineServerBrowser::FindRowId(const FString& arg_SessionId) const
+{
+	const int32* RowId = RowIds.Find(arg_SessionId);
+	return RowId ? *RowId : INDEX_NONE;
+}
+
+int32 FUOnlineServerBrowser::FindViewIndex(int32 arg_RowId) const
+{
+	const int32 ViewIndex = LowerBoundInView(arg_RowId);
+
+	if (!VisibleRowIds.IsValidIndex(ViewIndex) || VisibleRowIds[ViewIndex] != arg_RowId)
+	{
+		return INDEX_NONE;
+	}
+
+	return ViewIndex;
+}
+
+bool FUOnlineServerBrowser::IsBefore(EUOnlineServerBrowserSort arg_SortBy, int32 arg_RowIdA, int32 arg_RowIdB) const
+{
+	const FUOnlineServerBrowserRow& RowA = Rows[arg_RowIdA];
+	const FUOnlineServerBrowserRow& RowB = Rows[arg_RowIdB];
+
+	switch (arg_SortBy)
+	{
+	case EUOnlineServerBrowserSort::Ping:
+		if (RowA.PingInMs != RowB.PingInMs)
+		{
+			return RowA.PingInMs < RowB.PingInMs;
+		}
+		break;
+	case EUOnlineServerBrowserSort::Players:
+		if (RowA.NumPlayers != RowB.NumPlayers)
+		{
+			return RowA.NumPlayers < RowB.NumPlayers;
+		}
+		break;
+	case EUOnlineServerBrowserSort::Name:
+	{
+		const int32 Comparison = RowA.Name.Compare(RowB.Name, ESearchCase::IgnoreCase);
+
+		if (Comparison != 0)
+		{
+			return Comparison < 0;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	// Rows have to be found again by binary search, so equal keys still need a fixed order
+	return arg_RowIdA < arg_RowIdB;
+}
+
+bool FUOnlineServerBrowser::IsBeforeInView(int32 arg_RowIdA, int32 arg_RowIdB) const
+{
+	if (bSortAscending)
+	{
+		return IsBefore(SortBy, arg_RowIdA, arg_RowIdB);
+	}
+
+	return IsBefore(SortBy, arg_RowIdB, arg_RowIdA);
+}
+
+int32 FUOnlineServerBrowser::LowerBound(const TArray<int32>& arg_Index, EUOnlineServerBrowserSort arg_SortBy, int32 arg_RowId) const
+{
+	return FindLowerBound(arg_Index, [this, arg_SortBy, arg_RowId](int32 arg_IndexRowId)
+	{
+		return IsBefore(arg_SortBy, arg_IndexRowId, arg_RowId);
+	});
+}
+
+int32 FUOnlineServerBrowser::LowerBoundInView(int32 arg_RowId) const
+{
+	return FindLowerBound(VisibleRowIds, [this, arg_RowId](int32 arg_ViewRowId)
+	{
+		return IsBeforeInView(arg_ViewRowId, arg_RowId);
+	});
+}
+
+bool FUOnlineServerBrowser::PassesFilter(int32 arg_RowId) const
+{
+	return !Filter || Filter(Rows[arg_RowId]);
+}
+
+void FUOnlineServerBrowser::AddRow(const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	const int32 RowId = Rows.Add(FUOnlineServerBrowserRow());
+	FillRow(Rows[RowId], arg_SearchResult);
+	RowIds.Add(Rows[RowId].SessionId, RowId);
+
+	AddToIndices(RowId);
+
+	if (PassesFilter(RowId))
+	{
+		const int32 ViewIndex = LowerBoundInView(RowId);
+		VisibleRowIds.Insert(RowId, ViewIndex);
+		OnRowInserted.Broadcast(ViewIndex, RowId);
+	}
+}
+
+void FUOnlineServerBrowser::UpdateRow(int32 arg_RowId, const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	FUOnlineServerBrowserRow& Row = Rows[arg_RowId];
+
+	// Refreshes report most sessions unchanged, those don't move and don't need to be redrawn
+	if (Row.PingInMs == arg_SearchResult.PingInMs && Row.Fingerprint == FUOnlineSessionCache::ComputeFingerprint(arg_SearchResult))
+	{
+		return;
+	}
+
+	// The row has to be found with its old values before they are replaced
+	const int32 OldViewIndex = FindViewIndex(arg_RowId);
+
+	if (OldViewIndex != INDEX_NONE)
+	{
+		VisibleRowIds.RemoveAt(OldViewIndex, 1, false);
+	}
+
+	RemoveFromIndices(arg_RowId);
+	FillRow(Row, arg_SearchResult);
+	AddToIndices(arg_RowId);
+
+	int32 NewViewIndex = INDEX_NONE;
+
+	if (PassesFilter(arg_RowId))
+	{
+		NewViewIndex = LowerBoundInView(arg_RowId);
+		VisibleRowIds.Insert(arg_RowId, NewViewIndex);
+	}
+
+	if (OldViewIndex != INDEX_NONE && OldViewIndex == NewViewIndex)
+	{
+		OnRowUpdated.Broadcast(NewViewIndex, arg_RowId);
+		return;
+	}
+
+	// Moved, shown or hidden. Applying the removal first and then the insertion gives the new visible rows
+	if (OldViewIndex != INDEX_NONE)
+	{
+		OnRowRemoved.Broadcast(OldViewIndex, arg_RowId);
+	}
+
+	if (NewViewIndex != INDEX_NONE)
+	{
+		OnRowInserted.Broadcast(NewViewIndex, arg_RowId);
+	}
+}
+
+void FUOnlineServerBrowser::RemoveRow(int32 arg_RowId)
+{
+	const int32 ViewIndex = FindViewIndex(arg_RowId);
+
+	if (ViewIndex != INDEX_NONE)
+	{
+		VisibleRowIds.RemoveAt(ViewIndex, 1, false);
+
+		// The row is still there for listeners that want to look at it
+		OnRowRemoved.Broadcast(ViewIndex, arg_RowId);
+	}
+
+	RemoveFromIndices(arg_RowId);
+	RowIds.Remove(Rows[arg_RowId].SessionId);
+	Rows.RemoveAt(arg_RowId);
+}
+
+void FUOnlineServerBrowser::AddToIndices(int32 arg_RowId)
+{
+	for (int32 SortIndex = 0; SortIndex < static_cast<int32>(EUOnlineServerBrowserSort::Num); ++SortIndex)
+	{
+		const EUOnlineServerBrowserSort IndexSortBy = static_cast<EUOnlineServerBrowserSort>(SortIndex);
+		TArray<int32>& Index = SortIndices[SortIndex];
+
+		Index.Insert(arg_RowId, LowerBound(Index, IndexSortBy, arg_RowId));
+	}
+}
+
+void FUOnlineServerBrowser::RemoveFromIndices(int32 arg_RowId)
+{
+	for (int32 SortIndex = 0; SortIndex < static_cast<int32>(EUOnlineServerBrowserSort::Num); ++SortIndex)
+	{
+		const EUOnlineServerBrowserSort IndexSortBy = static_cast<EUOnlineServerBrowserSort>(SortIndex);
+		TArray<int32>& Index = SortIndices[SortIndex];
+
+		const int32 Position = LowerBound(Index, IndexSortBy, arg_RowId);
+
+		if (Index.IsValidIndex(Position) && Index[Position] == arg_RowId)
+		{
+			Index.RemoveAt(Position, 1, false);
+		}
+	}
+}
+
+void FUOnlineServerBrowser::AddRowsInBulk(const TArray<FOnlineSessionSearchResult>& arg_SearchResults)
+{
+	if (arg_SearchResults.Num() == 0)
+	{
+		return;
+	}
+
+	Rows.Reserve(arg_SearchResults.Num());
+	RowIds.Reserve(arg_SearchResults.Num());
+
+	for (const FOnlineSessionSearchResult& SearchResult : arg_SearchResults)
+	{
+		// Some subsystems report the same session twice, keep the first one
+		if (!SearchResult.IsValid() || RowIds.Contains(SearchResult.GetSessionIdStr()))
+		{
+			continue;
+		}
+
+		const int32 RowId = Rows.Add(FUOnlineServerBrowserRow());
+		FillRow(Rows[RowId], SearchResult);
+		RowIds.Add(Rows[RowId].SessionId, RowId);
+	}
+
+	for (int32 SortIndex = 0; SortIndex < static_cast<int32>(EUOnlineServerBrowserSort::Num); ++SortIndex)
+	{
+		const EUOnlineServerBrowserSort IndexSortBy = static_cast<EUOnlineServerBrowserSort>(SortIndex);
+		TArray<int32>& Index = SortIndices[SortIndex];
+
+		Index.Reset(Rows.Num());
+
+		for (TSparseArray<FUOnlineServerBrowserRow>::TConstIterator Row(Rows); Row; ++Row)
+		{
+			Index.Add(Row.GetIndex());
+		}
+
+		Index.Sort([this, IndexSortBy](int32 arg_RowIdA, int32 arg_RowIdB)
+		{
+			return IsBefore(IndexSortBy, arg_RowIdA, arg_RowIdB);
+		});
+	}
+
+	RebuildView();
+}
+
+void FUOnlineServerBrowser::RebuildView()
+{
+	const TArray<int32>& Index = SortIndices[static_cast<int32>(SortBy)];
+
+	VisibleRowIds.Reset(Index.Num());
+
+	// The index is sorted already, descending is the same walk backwards
+	if (bSortAscending)
+	{
+		for (int32 Position = 0; Position < Index.Num(); ++Position)
+		{
+			if (PassesFilter(Index[Position]))
+			{
+				VisibleRowIds.Add(Index[Position]);
+			}
+		}
+	}
+	else
+	{
+		for (int32 Position = Index.Num() - 1; Position >= 0; --Position)
+		{
+			if (PassesFilter(Index[Position]))
+			{
+				VisibleRowIds.Add(Index[Position]);
+			}
+		}
+	}
+
+	OnViewReset.Broadcast();
+}
+
+void FUOnlineServerBrowser::FillRow(FUOnlineServerBrowserRow& arg_Row, const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	const FOnlineSession& Session = arg_SearchResult.Session;
+
+	arg_Row.SessionId = arg_SearchResult.GetSessionIdStr();
+	arg_Row.Name = Session.OwningUserName;
+	arg_Row.PingInMs = arg_SearchResult.PingInMs;
+	arg_Row.MaxPlayers = Session.SessionSettings.NumPublicConnections;
+	arg_Row.NumPlayers = FMath::Max(0, arg_Row.MaxPlayers - Session.NumOpenPublicConnections);
+	arg_Row.Fingerprint = FUOnlineSessionCache::ComputeFingerprint(arg_SearchResult);
+	arg_Row.SearchResult = arg_SearchResult;
+
+	arg_Row.MapName.Empty();
+	Session.SessionSettings.Get(SETTING_MAPNAME, arg_Row.MapName);
+}
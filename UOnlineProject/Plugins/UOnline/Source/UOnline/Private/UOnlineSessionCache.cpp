@@ -0,0 +1,314 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionCache.h"
+#include "Async/ParallelFor.h"
+
+FUOnlineSessionQueryKey::FUOnlineSessionQueryKey() : bIsLAN(false), bIsPresence(false), MaxSearchResults(0), Hash(0)
+{
+
+}
+
+FUOnlineSessionQueryKey::FUOnlineSessionQueryKey(bool arg_bIsLAN, bool arg_bIsPresence, const FOnlineSessionSearch& arg_SessionSearch, const FUOnlineSessionFilterPredicate* arg_ResultFilter)
+	: bIsLAN(arg_bIsLAN)
+	, bIsPresence(arg_bIsPresence)
+	, MaxSearchResults(arg_SessionSearch.MaxSearchResults)
+	, Hash(0)
+{
+	if (arg_ResultFilter)
+	{
+		ResultFilter = *arg_ResultFilter;
+	}
+
+	QueryParams.Reserve(arg_SessionSearch.QuerySettings.SearchParams.Num());
+
+	for (const TPair<FName, FOnlineSessionSearchParam>& SearchParam : arg_SessionSearch.QuerySettings.SearchParams)
+	{
+		QueryParams.Add({ SearchParam.Key, SearchParam.Value.Data, SearchParam.Value.ComparisonOp });
+	}
+
+	QueryParams.Sort([](const FQueryParam& arg_ParamA, const FQueryParam& arg_ParamB)
+	{
+		return arg_ParamA.Key.Compare(arg_ParamB.Key) < 0;
+	});
+
+	for (const FQueryParam& QueryParam : QueryParams)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(QueryParam.Key));
+		Hash = HashCombine(Hash, GetTypeHash(QueryParam.Value.ToString()));
+		Hash = HashCombine(Hash, GetTypeHash(static_cast<int32>(QueryParam.ComparisonOp)));
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(MaxSearchResults));
+	Hash = HashCombine(Hash, (bIsLAN ? 1u : 0u) | (bIsPresence ? 2u : 0u));
+
+	if (ResultFilter.IsSet())
+	{
+		Hash = HashCombine(Hash, ResultFilter->GetHash());
+	}
+}
+
+bool FUOnlineSessionQueryKey::operator==(const FUOnlineSessionQueryKey& arg_Other) const
+{
+	if (Hash != arg_Other.Hash || bIsLAN != arg_Other.bIsLAN || bIsPresence != arg_Other.bIsPresence || MaxSearchResults != arg_Other.MaxSearchResults)
+	{
+		return false;
+	}
+
+	if (QueryParams.Num() != arg_Other.QueryParams.Num())
+	{
+		return false;
+	}
+
+	for (int32 ParamIndex = 0; ParamIndex < QueryParams.Num(); ++ParamIndex)
+	{
+		const FQueryParam& QueryParam = QueryParams[ParamIndex];
+		const FQueryParam& OtherQueryParam = arg_Other.QueryParams[ParamIndex];
+
+		if (QueryParam.Key != OtherQueryParam.Key || QueryParam.ComparisonOp != OtherQueryParam.ComparisonOp || !(QueryParam.Value == OtherQueryParam.Value))
+		{
+			return false;
+		}
+	}
+
+	// Both unfiltered, or filtered by the same criteria
+	if (ResultFilter.IsSet() != arg_Other.ResultFilter.IsSet())
+	{
+		return false;
+	}
+
+	return !ResultFilter.IsSet() || ResultFilter.GetValue() == arg_Other.ResultFilter.GetValue();
+}
+
+FUOnlineSessionCache::FUOnlineSessionCache() : TimeToLive(30.0), MaxEntries(8)
+{
+
+}
+
+void FUOnlineSessionCache::SetTimeToLive(double arg_TimeToLive)
+{
+	TimeToLive = FMath::Max(0.0, arg_TimeToLive);
+}
+
+void FUOnlineSessionCache::SetMaxEntries(int32 arg_MaxEntries)
+{
+	MaxEntries = FMath::Max(1, arg_MaxEntries);
+
+	while (Entries.Num() > MaxEntries)
+	{
+		EvictOldest();
+	}
+}
+
+bool FUOnlineSessionCache::Contains(const FUOnlineSessionQueryKey& arg_Key) const
+{
+	const FEntry* Entry = Entries.Find(arg_Key);
+	return Entry && Entry->bHasResults;
+}
+
+bool FUOnlineSessionCache::IsFresh(const FUOnlineSessionQueryKey& arg_Key, double arg_Now) const
+{
+	const FEntry* Entry = Entries.Find(arg_Key);
+	return Entry && Entry->bHasResults && (arg_Now - Entry->LastUpdateTime) < TimeToLive;
+}
+
+bool FUOnlineSessionCache::IsRefreshing(const FUOnlineSessionQueryKey& arg_Key) const
+{
+	const FEntry* Entry = Entries.Find(arg_Key);
+	return Entry && Entry->bIsRefreshing;
+}
+
+void FUOnlineSessionCache::SetRefreshing(const FUOnlineSessionQueryKey& arg_Key, bool arg_bIsRefreshing)
+{
+	if (arg_bIsRefreshing)
+	{
+		if (!Entries.Contains(arg_Key) && Entries.Num() >= MaxEntries)
+		{
+			EvictOldest();
+		}
+
+		Entries.FindOrAdd(arg_Key).bIsRefreshing = true;
+	}
+	else if (FEntry* Entry = Entries.Find(arg_Key))
+	{
+		Entry->bIsRefreshing = false;
+
+		// Nothing to keep if the very first query for this key failed
+		if (!Entry->bHasResults)
+		{
+			Entries.Remove(arg_Key);
+		}
+	}
+}
+
+void FUOnlineSessionCache::Apply(const FUOnlineSessionQueryKey& arg_Key, const TArray<FOnlineSessionSearchResult>& arg_Results, double arg_Now, FUOnlineSessionSearchDelta& arg_OutDelta)
+{
+	FUOnlineSessionCacheUpdate Update;
+	BuildUpdate(arg_Key, arg_Results, GetFingerprints(arg_Key), Update);
+	Commit(arg_Key, Update, arg_Now);
+
+	arg_OutDelta = MoveTemp(Update.Delta);
+}
+
+FUOnlineSessionFingerprintsPtr FUOnlineSessionCache::GetFingerprints(const FUOnlineSessionQueryKey& arg_Key) const
+{
+	const FEntry* Entry = Entries.Find(arg_Key);
+
+	if (!Entry || !Entry->bHasResults)
+	{
+		return nullptr;
+	}
+
+	return Entry->Fingerprints;
+}
+
+void FUOnlineSessionCache::BuildUpdate(const FUOnlineSessionQueryKey& arg_Key, const TArray<FOnlineSessionSearchResult>& arg_Results, const FUOnlineSessionFingerprintsPtr& arg_PreviousFingerprints, FUOnlineSessionCacheUpdate& arg_OutUpdate)
+{
+	FUOnlineSessionSearchDelta& Delta = arg_OutUpdate.Delta;
+	Delta.Key = arg_Key;
+	Delta.bFromCache = false;
+
+	// Hashing every setting is what makes large result lists expensive, and it only reads the results
+	TArray<FString> SessionIds;
+	TArray<uint32> Fingerprints;
+	SessionIds.SetNum(arg_Results.Num());
+	Fingerprints.SetNumZeroed(arg_Results.Num());
+
+	ParallelFor(arg_Results.Num(), [&arg_Results, &SessionIds, &Fingerprints](int32 arg_ResultIndex)
+	{
+		const FOnlineSessionSearchResult& SearchResult = arg_Results[arg_ResultIndex];
+
+		if (SearchResult.IsValid())
+		{
+			SessionIds[arg_ResultIndex] = SearchResult.GetSessionIdStr();
+			Fingerprints[arg_ResultIndex] = ComputeFingerprint(SearchResult);
+		}
+	});
+
+	TSharedRef<FUOnlineSessionResultStore> NewResults = MakeShareable(new FUOnlineSessionResultStore());
+	NewResults->Reserve(arg_Results.Num());
+
+	TSharedRef<TMap<FString, uint32>, ESPMode::ThreadSafe> NewFingerprints = MakeShareable(new TMap<FString, uint32>());
+	NewFingerprints->Reserve(arg_Results.Num());
+
+	for (int32 ResultIndex = 0; ResultIndex < arg_Results.Num(); ++ResultIndex)
+	{
+		const FString& SessionId = SessionIds[ResultIndex];
+
+		// Invalid results have no id. Some subsystems report the same session twice, keep the first one
+		if (SessionId.IsEmpty() || NewFingerprints->Contains(SessionId))
+		{
+			continue;
+		}
+
+		const FOnlineSessionSearchResult& SearchResult = arg_Results[ResultIndex];
+		const uint32 Fingerprint = Fingerprints[ResultIndex];
+
+		NewFingerprints->Add(SessionId, Fingerprint);
+		NewResults->Add(SearchResult);
+
+		const uint32* PreviousFingerprint = arg_PreviousFingerprints.IsValid() ? arg_PreviousFingerprints->Find(SessionId) : nullptr;
+
+		if (!PreviousFingerprint)
+		{
+			Delta.Added.Add(SearchResult);
+		}
+		else if (*PreviousFingerprint != Fingerprint)
+		{
+			Delta.Changed.Add(SearchResult);
+		}
+	}
+
+	if (arg_PreviousFingerprints.IsValid())
+	{
+		for (const TPair<FString, uint32>& PreviousFingerprint : *arg_PreviousFingerprints)
+		{
+			if (!NewFingerprints->Contains(PreviousFingerprint.Key))
+			{
+				Delta.Removed.Add(PreviousFingerprint.Key);
+			}
+		}
+	}
+
+	arg_OutUpdate.Results = NewResults;
+	arg_OutUpdate.Fingerprints = NewFingerprints;
+}
+
+void FUOnlineSessionCache::Commit(const FUOnlineSessionQueryKey& arg_Key, const FUOnlineSessionCacheUpdate& arg_Update, double arg_Now)
+{
+	if (!Entries.Contains(arg_Key) && Entries.Num() >= MaxEntries)
+	{
+		EvictOldest();
+	}
+
+	FEntry& Entry = Entries.FindOrAdd(arg_Key);
+	Entry.Results = arg_Update.Results;
+	Entry.Fingerprints = arg_Update.Fingerprints;
+	Entry.LastUpdateTime = arg_Now;
+	Entry.bHasResults = true;
+	Entry.bIsRefreshing = false;
+}
+
+TSharedPtr<const FUOnlineSessionResultStore> FUOnlineSessionCache::GetResults(const FUOnlineSessionQueryKey& arg_Key) const
+{
+	const FEntry* Entry = Entries.Find(arg_Key);
+
+	if (!Entry || !Entry->bHasResults)
+	{
+		return nullptr;
+	}
+
+	return Entry->Results;
+}
+
+void FUOnlineSessionCache::Invalidate(const FUOnlineSessionQueryKey& arg_Key)
+{
+	Entries.Remove(arg_Key);
+}
+
+void FUOnlineSessionCache::Empty()
+{
+	Entries.Empty();
+}
+
+uint32 FUOnlineSessionCache::ComputeFingerprint(const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	const FOnlineSession& Session = arg_SearchResult.Session;
+
+	uint32 Fingerprint = GetTypeHash(Session.OwningUserName);
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(Session.NumOpenPublicConnections));
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(Session.NumOpenPrivateConnections));
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(Session.SessionSettings.NumPublicConnections));
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(Session.SessionSettings.NumPrivateConnections));
+
+	// Same as the query key, the settings map has no guaranteed order
+	uint32 SettingsHash = 0;
+
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : Session.SessionSettings.Settings)
+	{
+		SettingsHash += HashCombine(GetTypeHash(Setting.Key), GetTypeHash(Setting.Value.Data.ToString()));
+	}
+
+	return HashCombine(Fingerprint, SettingsHash);
+}
+
+void FUOnlineSessionCache::EvictOldest()
+{
+	const FUOnlineSessionQueryKey* OldestKey = nullptr;
+	double OldestTime = TNumericLimits<double>::Max();
+
+	for (const TPair<FUOnlineSessionQueryKey, FEntry>& Entry : Entries)
+	{
+		// Never drop a query that is waiting for its results
+		if (!Entry.Value.bIsRefreshing && Entry.Value.LastUpdateTime < OldestTime)
+		{
+			OldestTime = Entry.Value.LastUpdateTime;
+			OldestKey = &Entry.Key;
+		}
+	}
+
+	if (OldestKey)
+	{
+		const FUOnlineSessionQueryKey KeyToRemove = *OldestKey;
+		Entries.Remove(KeyToRemove);
+	}
+}
@@ -0,0 +1,363 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionFilter.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	EOnlineComparisonOp::Type ToComparisonOp(EUOnlineSessionFilterOp arg_Op)
+	{
+		switch (arg_Op)
+		{
+		case EUOnlineSessionFilterOp::NotEquals:
+			return EOnlineComparisonOp::NotEquals;
+		case EUOnlineSessionFilterOp::GreaterThan:
+			return EOnlineComparisonOp::GreaterThan;
+		case EUOnlineSessionFilterOp::GreaterThanEquals:
+			return EOnlineComparisonOp::GreaterThanEquals;
+		case EUOnlineSessionFilterOp::LessThan:
+			return EOnlineComparisonOp::LessThan;
+		case EUOnlineSessionFilterOp::LessThanEquals:
+			return EOnlineComparisonOp::LessThanEquals;
+		default:
+			return EOnlineComparisonOp::Equals;
+		}
+	}
+
+	/**
+	* @param Data: value of a setting.
+	* @param OutNumber: receives the value as a number.
+	* @returns true if the value is numeric.
+	*/
+	bool ToNumber(const FVariantData& arg_Data, double& arg_OutNumber)
+	{
+		switch (arg_Data.GetType())
+		{
+		case EOnlineKeyValuePairDataType::Int32:
+		{
+			int32 Value = 0;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::UInt32:
+		{
+			uint32 Value = 0;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Int64:
+		{
+			int64 Value = 0;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::UInt64:
+		{
+			uint64 Value = 0;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Float:
+		{
+			float Value = 0.f;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Double:
+		{
+			double Value = 0.0;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Bool:
+		{
+			bool Value = false;
+			arg_Data.GetValue(Value);
+			arg_OutNumber = Value ? 1.0 : 0.0;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	template<typename ValueType>
+	bool CompareValues(const ValueType& arg_SettingValue, const ValueType& arg_FilterValue, EUOnlineSessionFilterOp arg_Op)
+	{
+		switch (arg_Op)
+		{
+		case EUOnlineSessionFilterOp::NotEquals:
+			return arg_SettingValue != arg_FilterValue;
+		case EUOnlineSessionFilterOp::GreaterThan:
+			return arg_SettingValue > arg_FilterValue;
+		case EUOnlineSessionFilterOp::GreaterThanEquals:
+			return arg_SettingValue >= arg_FilterValue;
+		case EUOnlineSessionFilterOp::LessThan:
+			return arg_SettingValue < arg_FilterValue;
+		case EUOnlineSessionFilterOp::LessThanEquals:
+			return arg_SettingValue <= arg_FilterValue;
+		default:
+			return arg_SettingValue == arg_FilterValue;
+		}
+	}
+}
+
+FUOnlineSessionFilter& FUOnlineSessionFilter::Where(FName arg_Key, EUOnlineSessionFilterOp arg_Op, int32 arg_Value, bool arg_bLocalOnly)
+{
+	FUOnlineSessionFilterSetting& Setting = Settings[Settings.AddDefaulted()];
+	Setting.Key = arg_Key;
+	Setting.Op = arg_Op;
+	Setting.bIsInteger = true;
+	Setting.IntValue = arg_Value;
+	Setting.bLocalOnly = arg_bLocalOnly;
+
+	return *this;
+}
+
+FUOnlineSessionFilter& FUOnlineSessionFilter::Where(FName arg_Key, EUOnlineSessionFilterOp arg_Op, const FString& arg_Value, bool arg_bLocalOnly)
+{
+	FUOnlineSessionFilterSetting& Setting = Settings[Settings.AddDefaulted()];
+	Setting.Key = arg_Key;
+	Setting.Op = arg_Op;
+	Setting.bIsInteger = false;
+	Setting.StringValue = arg_Value;
+	Setting.bLocalOnly = arg_bLocalOnly;
+
+	return *this;
+}
+
+bool FUOnlineSessionFilter::IsEmpty() const
+{
+	return MapName == NAME_None && GameMode.IsEmpty() && MinOpenSlots <= 0 && MaxPingInMs <= 0 && BuildUniqueId == 0 && !bDedicatedOnly && Settings.Num() == 0;
+}
+
+void FUOnlineSessionFilter::ApplyToSearch(FOnlineSessionSearch& arg_SessionSearch) const
+{
+	FOnlineSearchSettings& QuerySettings = arg_SessionSearch.QuerySettings;
+
+	if (MapName != NAME_None)
+	{
+		QuerySettings.Set(SETTING_MAPNAME, MapName.ToString(), EOnlineComparisonOp::Equals);
+	}
+
+	if (!GameMode.IsEmpty())
+	{
+		QuerySettings.Set(SETTING_GAMEMODE, GameMode, EOnlineComparisonOp::Equals);
+	}
+
+	if (bDedicatedOnly)
+	{
+		QuerySettings.Set(SEARCH_DEDICATED_ONLY, true, EOnlineComparisonOp::Equals);
+	}
+
+#ifdef SEARCH_MINSLOTSAVAILABLE
+	if (MinOpenSlots > 0)
+	{
+		QuerySettings.Set(SEARCH_MINSLOTSAVAILABLE, MinOpenSlots, EOnlineComparisonOp::GreaterThanEquals);
+	}
+#endif
+
+	for (const FUOnlineSessionFilterSetting& Setting : Settings)
+	{
+		if (Setting.bLocalOnly || Setting.Key == NAME_None)
+		{
+			continue;
+		}
+
+		if (Setting.bIsInteger)
+		{
+			QuerySettings.Set(Setting.Key, Setting.IntValue, ToComparisonOp(Setting.Op));
+		}
+		else
+		{
+			QuerySettings.Set(Setting.Key, Setting.StringValue, ToComparisonOp(Setting.Op));
+		}
+	}
+}
+
+FUOnlineSessionFilterPredicate::FUOnlineSessionFilterPredicate(const FUOnlineSessionFilter& arg_Filter)
+	: MinOpenSlots(arg_Filter.MinOpenSlots)
+	, MaxPingInMs(arg_Filter.MaxPingInMs)
+	, BuildUniqueId(arg_Filter.BuildUniqueId)
+	, bDedicatedOnly(arg_Filter.bDedicatedOnly)
+	, Hash(0)
+{
+	if (arg_Filter.MapName != NAME_None)
+	{
+		Comparisons.Add({ SETTING_MAPNAME, FVariantData(arg_Filter.MapName.ToString()), EUOnlineSessionFilterOp::Equals });
+	}
+
+	if (!arg_Filter.GameMode.IsEmpty())
+	{
+		Comparisons.Add({ SETTING_GAMEMODE, FVariantData(arg_Filter.GameMode), EUOnlineSessionFilterOp::Equals });
+	}
+
+	for (const FUOnlineSessionFilterSetting& Setting : arg_Filter.Settings)
+	{
+		if (Setting.Key == NAME_None)
+		{
+			continue;
+		}
+
+		if (Setting.bIsInteger)
+		{
+			Comparisons.Add({ Setting.Key, FVariantData(Setting.IntValue), Setting.Op });
+		}
+		else
+		{
+			Comparisons.Add({ Setting.Key, FVariantData(Setting.StringValue), Setting.Op });
+		}
+	}
+
+	// Sorted so the order the criteria were added in doesn't matter
+	Comparisons.Sort([](const FComparison& arg_ComparisonA, const FComparison& arg_ComparisonB)
+	{
+		const int32 KeyOrder = arg_ComparisonA.Key.Compare(arg_ComparisonB.Key);
+
+		if (KeyOrder != 0)
+		{
+			return KeyOrder < 0;
+		}
+
+		if (arg_ComparisonA.Op != arg_ComparisonB.Op)
+		{
+			return arg_ComparisonA.Op < arg_ComparisonB.Op;
+		}
+
+		return arg_ComparisonA.Value.ToString() < arg_ComparisonB.Value.ToString();
+	});
+
+	for (const FComparison& Comparison : Comparisons)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Comparison.Key));
+		Hash = HashCombine(Hash, GetTypeHash(Comparison.Value.ToString()));
+		Hash = HashCombine(Hash, GetTypeHash(static_cast<int32>(Comparison.Op)));
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(MinOpenSlots));
+	Hash = HashCombine(Hash, GetTypeHash(MaxPingInMs));
+	Hash = HashCombine(Hash, GetTypeHash(BuildUniqueId));
+	Hash = HashCombine(Hash, GetTypeHash(bDedicatedOnly));
+}
+
+bool FUOnlineSessionFilterPredicate::operator==(const FUOnlineSessionFilterPredicate& arg_Other) const
+{
+	if (Hash != arg_Other.Hash || MinOpenSlots != arg_Other.MinOpenSlots || MaxPingInMs != arg_Other.MaxPingInMs
+		|| BuildUniqueId != arg_Other.BuildUniqueId || bDedicatedOnly != arg_Other.bDedicatedOnly)
+	{
+		return false;
+	}
+
+	if (Comparisons.Num() != arg_Other.Comparisons.Num())
+	{
+		return false;
+	}
+
+	for (int32 ComparisonIndex = 0; ComparisonIndex < Comparisons.Num(); ++ComparisonIndex)
+	{
+		const FComparison& Comparison = Comparisons[ComparisonIndex];
+		const FComparison& OtherComparison = arg_Other.Comparisons[ComparisonIndex];
+
+		if (Comparison.Key != OtherComparison.Key || Comparison.Op != OtherComparison.Op || !(Comparison.Value == OtherComparison.Value))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FUOnlineSessionFilterPredicate::Matches(const FOnlineSessionSearchResult& arg_SearchResult) const
+{
+	const FOnlineSession& Session = arg_SearchResult.Session;
+
+	// The cheap checks first, most results fail on one of them
+	if (Session.NumOpenPublicConnections < MinOpenSlots)
+	{
+		return false;
+	}
+
+	if (MaxPingInMs > 0 && arg_SearchResult.PingInMs > MaxPingInMs)
+	{
+		return false;
+	}
+
+	if ((BuildUniqueId != 0 && Session.SessionSettings.BuildUniqueId != BuildUniqueId) || (bDedicatedOnly && !Session.SessionSettings.bIsDedicated))
+	{
+		return false;
+	}
+
+	for (const FComparison& Comparison : Comparisons)
+	{
+		const FOnlineSessionSetting* Setting = Session.SessionSettings.Settings.Find(Comparison.Key);
+
+		// A session that doesn't advertise the key can only differ from the value
+		if (!Setting)
+		{
+			if (Comparison.Op != EUOnlineSessionFilterOp::NotEquals)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if (!Compare(Setting->Data, Comparison.Value, Comparison.Op))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 FUOnlineSessionFilterPredicate::FilterResults(TArray<FOnlineSessionSearchResult>& arg_SearchResults) const
+{
+	// Matching only reads the results, so every result is checked at once and the survivors are compacted afterwards
+	TArray<bool> bDoesMatch;
+	bDoesMatch.SetNumZeroed(arg_SearchResults.Num());
+
+	ParallelFor(arg_SearchResults.Num(), [this, &arg_SearchResults, &bDoesMatch](int32 arg_ResultIndex)
+	{
+		bDoesMatch[arg_ResultIndex] = Matches(arg_SearchResults[arg_ResultIndex]);
+	});
+
+	int32 NumKept = 0;
+
+	for (int32 ResultIndex = 0; ResultIndex < arg_SearchResults.Num(); ++ResultIndex)
+	{
+		if (bDoesMatch[ResultIndex])
+		{
+			if (NumKept != ResultIndex)
+			{
+				arg_SearchResults[NumKept] = MoveTemp(arg_SearchResults[ResultIndex]);
+			}
+
+			++NumKept;
+		}
+	}
+
+	const int32 NumFilteredOut = arg_SearchResults.Num() - NumKept;
+	arg_SearchResults.SetNum(NumKept, false);
+
+	return NumFilteredOut;
+}
+
+bool FUOnlineSessionFilterPredicate::Compare(const FVariantData& arg_SettingValue, const FVariantData& arg_FilterValue, EUOnlineSessionFilterOp arg_Op)
+{
+	double SettingNumber = 0.0;
+	double FilterNumber = 0.0;
+
+	if (ToNumber(arg_SettingValue, SettingNumber) && ToNumber(arg_FilterValue, FilterNumber))
+	{
+		return CompareValues(SettingNumber, FilterNumber, arg_Op);
+	}
+
+	return CompareValues(arg_SettingValue.ToString(), arg_FilterValue.ToString(), arg_Op);
+}
@@ -0,0 +1,278 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionRanking.h"
+#include "Containers/Ticker.h"
+#include "Icmp.h"
+
+FUOnlineSessionRanker::FUOnlineSessionRanker(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const FUOnlineSessionRankingOptions& arg_Options, const FOnUOnlineSessionRankingComplete& arg_OnComplete)
+	: Options(arg_Options)
+	, OnComplete(arg_OnComplete)
+	, NextProbeIndex(0)
+	, NumProbesInFlight(0)
+	, NumProbesComplete(0)
+	, ProbeTokens(1.f)
+	, Deadline(0.0)
+	, bIsComplete(false)
+{
+	Sessions.Reserve(arg_SearchResults.Num());
+
+	for (const FOnlineSessionSearchResult& SearchResult : arg_SearchResults)
+	{
+		if (SearchResult.IsValid())
+		{
+			FUOnlineRankedSession& RankedSession = Sessions[Sessions.AddDefaulted()];
+			RankedSession.SearchResult = SearchResult;
+			RankedSession.RoundTripInMs = SearchResult.PingInMs;
+		}
+	}
+}
+
+FUOnlineSessionRanker::~FUOnlineSessionRanker()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+void FUOnlineSessionRanker::Start(IOnlineSessionPtr arg_SessionInterface)
+{
+	// Probe the candidates that look closest first, the subsystem ping is the best guess we have
+	TArray<int32> CandidateIndices;
+	CandidateIndices.Reserve(Sessions.Num());
+
+	for (int32 SessionIndex = 0; SessionIndex < Sessions.Num(); ++SessionIndex)
+	{
+		// Nothing to gain from probing a session we can't join
+		if (Sessions[SessionIndex].SearchResult.Session.NumOpenPublicConnections > 0)
+		{
+			CandidateIndices.Add(SessionIndex);
+		}
+	}
+
+	CandidateIndices.Sort([this](int32 arg_IndexA, int32 arg_IndexB)
+	{
+		return Sessions[arg_IndexA].RoundTripInMs < Sessions[arg_IndexB].RoundTripInMs;
+	});
+
+	if (CandidateIndices.Num() > Options.MaxCandidates)
+	{
+		CandidateIndices.SetNum(FMath::Max(0, Options.MaxCandidates));
+	}
+
+	// Several sessions can share a host, probe every address once
+	TMap<FString, int32> ProbeIndexByAddress;
+
+	for (int32 SessionIndex : CandidateIndices)
+	{
+		FString ConnectString;
+
+		if (!arg_SessionInterface.IsValid() || !arg_SessionInterface->GetResolvedConnectString(Sessions[SessionIndex].SearchResult, NAME_GamePort, ConnectString))
+		{
+			continue;
+		}
+
+		const FString Address = GetHostAddress(ConnectString);
+
+		if (Address.IsEmpty())
+		{
+			continue;
+		}
+
+		int32* ExistingProbeIndex = ProbeIndexByAddress.Find(Address);
+
+		if (ExistingProbeIndex)
+		{
+			Probes[*ExistingProbeIndex].SessionIndices.Add(SessionIndex);
+		}
+		else
+		{
+			FProbe& Probe = Probes[Probes.AddDefaulted()];
+			Probe.Address = Address;
+			Probe.SessionIndices.Add(SessionIndex);
+			ProbeIndexByAddress.Add(Address, Probes.Num() - 1);
+		}
+	}
+
+	if (Probes.Num() == 0)
+	{
+		Finish();
+		return;
+	}
+
+	// Enough time for every probe to be started at the allowed rate and to time out
+	const float ProbesPerSecond = FMath::Max(Options.ProbesPerSecond, 1.f);
+	Deadline = FPlatformTime::Seconds() + Probes.Num() / ProbesPerSecond + Options.ProbeTimeout + 0.5;
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FUOnlineSessionRanker::Tick));
+
+	// Start the first probes right away instead of waiting a frame
+	Tick(0.f);
+}
+
+void FUOnlineSessionRanker::Cancel()
+{
+	bIsComplete = true;
+	OnComplete.Unbind();
+}
+
+bool FUOnlineSessionRanker::Tick(float arg_DeltaTime)
+{
+	if (bIsComplete)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	if (FPlatformTime::Seconds() >= Deadline)
+	{
+		// Hosts that didn't answer keep the ping the subsystem reported
+		Finish();
+		TickerHandle.Reset();
+		return false;
+	}
+
+	const float ProbesPerSecond = FMath::Max(Options.ProbesPerSecond, 1.f);
+	ProbeTokens = FMath::Min(ProbeTokens + arg_DeltaTime * ProbesPerSecond, static_cast<float>(FMath::Max(1, Options.MaxConcurrentProbes)));
+
+	while (NextProbeIndex < Probes.Num() && NumProbesInFlight < Options.MaxConcurrentProbes && ProbeTokens >= 1.f)
+	{
+		const int32 ProbeIndex = NextProbeIndex++;
+		Probes[ProbeIndex].bIsStarted = true;
+
+		ProbeTokens -= 1.f;
+		++NumProbesInFlight;
+
+		// The ranker can be gone by the time the echo comes back
+		TWeakPtr<FUOnlineSessionRanker> WeakRanker = AsShared();
+
+		FIcmp::Send(Probes[ProbeIndex].Address, Options.ProbeTimeout, [WeakRanker, ProbeIndex](FIcmpEchoResult arg_EchoResult)
+		{
+			TSharedPtr<FUOnlineSessionRanker> Ranker = WeakRanker.Pin();
+
+			if (Ranker.IsValid())
+			{
+				Ranker->OnProbeComplete(ProbeIndex, arg_EchoResult.Status == EIcmpResponseStatus::Success, arg_EchoResult.Time);
+			}
+		});
+	}
+
+	return !bIsComplete;
+}
+
+void FUOnlineSessionRanker::OnProbeComplete(int32 arg_ProbeIndex, bool arg_bWasSuccessful, float arg_RoundTripInSeconds)
+{
+	if (bIsComplete || !Probes.IsValidIndex(arg_ProbeIndex))
+	{
+		return;
+	}
+
+	--NumProbesInFlight;
+	++NumProbesComplete;
+
+	if (arg_bWasSuccessful)
+	{
+		const int32 RoundTripInMs = FMath::RoundToInt(arg_RoundTripInSeconds * 1000.f);
+
+		for (int32 SessionIndex : Probes[arg_ProbeIndex].SessionIndices)
+		{
+			Sessions[SessionIndex].RoundTripInMs = RoundTripInMs;
+			Sessions[SessionIndex].bWasProbed = true;
+		}
+	}
+
+	if (NumProbesComplete >= Probes.Num())
+	{
+		Finish();
+	}
+}
+
+void FUOnlineSessionRanker::Finish()
+{
+	if (bIsComplete)
+	{
+		return;
+	}
+
+	bIsComplete = true;
+
+	ScoreSessions(Sessions, Options);
+
+	if (Sessions.Num() > Options.ShortlistSize)
+	{
+		Sessions.SetNum(FMath::Max(0, Options.ShortlistSize));
+	}
+
+	// The listener may drop the last reference to us
+	const FOnUOnlineSessionRankingComplete Completion = OnComplete;
+	OnComplete.Unbind();
+
+	Completion.ExecuteIfBound(Sessions);
+}
+
+void FUOnlineSessionRanker::ScoreSessions(TArray<FUOnlineRankedSession>& arg_Sessions, const FUOnlineSessionRankingOptions& arg_Options)
+{
+	arg_Sessions.RemoveAll([](const FUOnlineRankedSession& arg_Session)
+	{
+		return arg_Session.SearchResult.Session.NumOpenPublicConnections <= 0;
+	});
+
+	const float MaxAcceptablePingInMs = static_cast<float>(FMath::Max(1, arg_Options.MaxAcceptablePingInMs));
+
+	for (FUOnlineRankedSession& RankedSession : arg_Sessions)
+	{
+		const FOnlineSession& Session = RankedSession.SearchResult.Session;
+		const int32 NumPublicConnections = Session.SessionSettings.NumPublicConnections;
+
+		// Fuller sessions rank higher, players end up in populated matches instead of spreading over empty ones
+		RankedSession.FillRatio = NumPublicConnections > 0 ? static_cast<float>(NumPublicConnections - Session.NumOpenPublicConnections) / NumPublicConnections : 0.f;
+
+		const float PingScore = 1.f - FMath::Clamp(RankedSession.RoundTripInMs / MaxAcceptablePingInMs, 0.f, 1.f);
+
+		float MapScore = 0.f;
+
+		if (arg_Options.PreferredMap != NAME_None)
+		{
+			const FOnlineSessionSetting* MapSetting = Session.SessionSettings.Settings.Find(SETTING_MAPNAME);
+
+			if (MapSetting && FName(*MapSetting->Data.ToString()) == arg_Options.PreferredMap)
+			{
+				MapScore = 1.f;
+			}
+		}
+
+		RankedSession.Score = arg_Options.PingWeight * PingScore + arg_Options.FillWeight * RankedSession.FillRatio + arg_Options.MapWeight * MapScore;
+	}
+
+	arg_Sessions.Sort([](const FUOnlineRankedSession& arg_SessionA, const FUOnlineRankedSession& arg_SessionB)
+	{
+		return arg_SessionA.Score > arg_SessionB.Score;
+	});
+}
+
+FString FUOnlineSessionRanker::GetHostAddress(const FString& arg_ConnectString)
+{
+	// "[::1]:7777"
+	if (arg_ConnectString.StartsWith(TEXT("[")))
+	{
+		int32 ClosingBracketIndex = INDEX_NONE;
+
+		if (arg_ConnectString.FindChar(TEXT(']'), ClosingBracketIndex))
+		{
+			return arg_ConnectString.Mid(1, ClosingBracketIndex - 1);
+		}
+
+		return FString();
+	}
+
+	// "127.0.0.1:7777", a bare IPv6 address has more than one colon and no port
+	int32 FirstColonIndex = INDEX_NONE;
+	int32 LastColonIndex = INDEX_NONE;
+
+	if (arg_ConnectString.FindChar(TEXT(':'), FirstColonIndex) && arg_ConnectString.FindLastChar(TEXT(':'), LastColonIndex) && FirstColonIndex == LastColonIndex)
+	{
+		return arg_ConnectString.Left(FirstColonIndex);
+	}
+
+	return arg_ConnectString;
+}
@@ -0,0 +1,109 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionRegistry.h"
+
+FUOnlineSessionRegistry::FUOnlineSessionRegistry()
+{
+	FMemory::Memzero(NumByState);
+}
+
+FUOnlineHostedSession* FUOnlineSessionRegistry::Add(FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_Settings, double arg_Now)
+{
+	if (arg_SessionName == NAME_None || IndexBySessionName.Contains(arg_SessionName))
+	{
+		return nullptr;
+	}
+
+	const int32 SessionIndex = Sessions.Emplace(arg_SessionName, arg_Settings);
+	IndexBySessionName.Add(arg_SessionName, SessionIndex);
+
+	FUOnlineHostedSession& Session = Sessions[SessionIndex];
+	Session.StateTime = arg_Now;
+	++NumByState[static_cast<int32>(Session.State)];
+
+	return &Session;
+}
+
+bool FUOnlineSessionRegistry::Remove(FName arg_SessionName)
+{
+	int32 SessionIndex = INDEX_NONE;
+
+	if (!IndexBySessionName.RemoveAndCopyValue(arg_SessionName, SessionIndex))
+	{
+		return false;
+	}
+
+	--NumByState[static_cast<int32>(Sessions[SessionIndex].State)];
+
+	// Swap the last session into the hole, its index has to follow
+	const int32 LastSessionIndex = Sessions.Num() - 1;
+
+	if (SessionIndex != LastSessionIndex)
+	{
+		IndexBySessionName.Add(Sessions[LastSessionIndex].SessionName, SessionIndex);
+	}
+
+	Sessions.RemoveAtSwap(SessionIndex, 1, false);
+
+	return true;
+}
+
+FUOnlineHostedSession* FUOnlineSessionRegistry::Find(FName arg_SessionName)
+{
+	const int32* SessionIndex = IndexBySessionName.Find(arg_SessionName);
+
+	return SessionIndex ? &Sessions[*SessionIndex] : nullptr;
+}
+
+const FUOnlineHostedSession* FUOnlineSessionRegistry::Find(FName arg_SessionName) const
+{
+	const int32* SessionIndex = IndexBySessionName.Find(arg_SessionName);
+
+	return SessionIndex ? &Sessions[*SessionIndex] : nullptr;
+}
+
+FUOnlineHostedSession* FUOnlineSessionRegistry::FindOldest(EUOnlineHostedSessionState arg_State)
+{
+	if (Num(arg_State) == 0)
+	{
+		return nullptr;
+	}
+
+	FUOnlineHostedSession* OldestSession = nullptr;
+
+	for (FUOnlineHostedSession& Session : Sessions)
+	{
+		if (Session.State == arg_State && (!OldestSession || Session.StateTime < OldestSession->StateTime))
+		{
+			OldestSession = &Session;
+		}
+	}
+
+	return OldestSession;
+}
+
+void FUOnlineSessionRegistry::SetState(FUOnlineHostedSession& arg_Session, EUOnlineHostedSessionState arg_State, double arg_Now)
+{
+	--NumByState[static_cast<int32>(arg_Session.State)];
+	++NumByState[static_cast<int32>(arg_State)];
+
+	arg_Session.State = arg_State;
+	arg_Session.StateTime = arg_Now;
+}
+
+void FUOnlineSessionRegistry::GetSessionNames(TArray<FName>& arg_OutSessionNames) const
+{
+	arg_OutSessionNames.Reset(Sessions.Num());
+
+	for (const FUOnlineHostedSession& Session : Sessions)
+	{
+		arg_OutSessionNames.Add(Session.SessionName);
+	}
+}
+
+void FUOnlineSessionRegistry::Empty()
+{
+	Sessions.Empty();
+	IndexBySessionName.Empty();
+	FMemory::Memzero(NumByState);
+}
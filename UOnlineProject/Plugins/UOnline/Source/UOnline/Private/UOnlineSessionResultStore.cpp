@@ -0,0 +1,287 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionResultStore.h"
+
+namespace
+{
+	// Booleans of FOnlineSessionSettings, the position in this table is their bit in FColdData::Flags
+	bool FOnlineSessionSettings::* const SessionFlags[] =
+	{
+		&FOnlineSessionSettings::bShouldAdvertise,
+		&FOnlineSessionSettings::bAllowJoinInProgress,
+		&FOnlineSessionSettings::bIsLANMatch,
+		&FOnlineSessionSettings::bIsDedicated,
+		&FOnlineSessionSettings::bUsesStats,
+		&FOnlineSessionSettings::bAllowInvites,
+		&FOnlineSessionSettings::bUsesPresence,
+		&FOnlineSessionSettings::bAllowJoinViaPresence,
+		&FOnlineSessionSettings::bAllowJoinViaPresenceFriendsOnly,
+		&FOnlineSessionSettings::bAntiCheatProtected
+	};
+
+	const int32 NumSessionFlags = ARRAY_COUNT(SessionFlags);
+	static_assert(ARRAY_COUNT(SessionFlags) <= 16, "The session flags have to fit in FColdData::Flags");
+}
+
+FUOnlineSessionResultStore::FUOnlineSessionResultStore()
+{
+
+}
+
+void FUOnlineSessionResultStore::Reserve(int32 arg_NumResults)
+{
+	PingsInMs.Reserve(arg_NumResults);
+	NumOpenSlots.Reserve(arg_NumResults);
+	MapIds.Reserve(arg_NumResults);
+	OwnerNameIds.Reserve(arg_NumResults);
+	ColdData.Reserve(arg_NumResults);
+}
+
+int32 FUOnlineSessionResultStore::Add(const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	const FOnlineSession& Session = arg_SearchResult.Session;
+	const FOnlineSessionSettings& SessionSettings = Session.SessionSettings;
+
+	const int32 Index = PingsInMs.Add(arg_SearchResult.PingInMs);
+	NumOpenSlots.Add(Session.NumOpenPublicConnections);
+	OwnerNameIds.Add(InternString(Session.OwningUserName));
+
+	FColdData& Cold = ColdData[ColdData.AddDefaulted()];
+	Cold.OwningUserId = Session.OwningUserId;
+	Cold.SessionInfo = Session.SessionInfo;
+	Cold.NumPublicConnections = SessionSettings.NumPublicConnections;
+	Cold.NumPrivateConnections = SessionSettings.NumPrivateConnections;
+	Cold.NumOpenPrivateConnections = Session.NumOpenPrivateConnections;
+	Cold.BuildUniqueId = SessionSettings.BuildUniqueId;
+	Cold.Flags = 0;
+	Cold.FirstSetting = Settings.Num();
+	Cold.NumSettings = SessionSettings.Settings.Num();
+
+	for (int32 FlagIndex = 0; FlagIndex < NumSessionFlags; ++FlagIndex)
+	{
+		if (SessionSettings.*SessionFlags[FlagIndex])
+		{
+			Cold.Flags |= 1 << FlagIndex;
+		}
+	}
+
+	int32 MapId = INDEX_NONE;
+
+	for (const TPair<FName, FOnlineSessionSetting>& SessionSetting : SessionSettings.Settings)
+	{
+		FSetting& Setting = Settings[Settings.AddDefaulted()];
+		Setting.KeyIndex = InternKey(SessionSetting.Key);
+		Setting.Id = SessionSetting.Value.ID;
+		Setting.AdvertisementType = static_cast<uint8>(SessionSetting.Value.AdvertisementType);
+		Setting.StringId = INDEX_NONE;
+
+		// Map names, game modes and the like repeat across most sessions, so each is only stored once
+		if (SessionSetting.Value.Data.GetType() == EOnlineKeyValuePairDataType::String)
+		{
+			FString Value;
+			SessionSetting.Value.Data.GetValue(Value);
+			Setting.StringId = InternString(Value);
+
+			if (SessionSetting.Key == SETTING_MAPNAME)
+			{
+				MapId = Setting.StringId;
+			}
+		}
+		else
+		{
+			Setting.Data = SessionSetting.Value.Data;
+		}
+	}
+
+	MapIds.Add(MapId);
+
+	return Index;
+}
+
+void FUOnlineSessionResultStore::Empty()
+{
+	PingsInMs.Empty();
+	NumOpenSlots.Empty();
+	MapIds.Empty();
+	OwnerNameIds.Empty();
+	ColdData.Empty();
+	Settings.Empty();
+	Keys.Empty();
+	KeyIndices.Empty();
+	Strings.Empty();
+	StringIds.Empty();
+}
+
+const FString& FUOnlineSessionResultStore::GetString(int32 arg_StringId) const
+{
+	if (!Strings.IsValidIndex(arg_StringId))
+	{
+		static const FString EmptyString;
+		return EmptyString;
+	}
+
+	return Strings[arg_StringId];
+}
+
+int32 FUOnlineSessionResultStore::FindStringId(const FString& arg_String) const
+{
+	const int32* StringId = StringIds.Find(arg_String);
+	return StringId ? *StringId : INDEX_NONE;
+}
+
+FString FUOnlineSessionResultStore::GetSessionId(int32 arg_Index) const
+{
+	const FColdData& Cold = ColdData[arg_Index];
+
+	if (!Cold.SessionInfo.IsValid())
+	{
+		return FString();
+	}
+
+	return Cold.SessionInfo->GetSessionId().ToString();
+}
+
+bool FUOnlineSessionResultStore::GetSetting(int32 arg_Index, FName arg_Key, FVariantData& arg_OutData) const
+{
+	const uint16* KeyIndex = KeyIndices.Find(arg_Key);
+
+	if (!KeyIndex)
+	{
+		return false;
+	}
+
+	const FColdData& Cold = ColdData[arg_Index];
+
+	for (int32 SettingIndex = Cold.FirstSetting; SettingIndex < Cold.FirstSetting + Cold.NumSettings; ++SettingIndex)
+	{
+		if (Settings[SettingIndex].KeyIndex == *KeyIndex)
+		{
+			GetSettingData(Settings[SettingIndex], arg_OutData);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FUOnlineSessionResultStore::GetIndicesByPing(TArray<int32>& arg_OutIndices, int32 arg_MinOpenSlots) const
+{
+	arg_OutIndices.Reset(Num());
+
+	for (int32 Index = 0; Index < Num(); ++Index)
+	{
+		if (NumOpenSlots[Index] >= arg_MinOpenSlots)
+		{
+			arg_OutIndices.Add(Index);
+		}
+	}
+
+	const TArray<int32>& Pings = PingsInMs;
+
+	arg_OutIndices.Sort([&Pings](int32 arg_IndexA, int32 arg_IndexB)
+	{
+		return Pings[arg_IndexA] < Pings[arg_IndexB];
+	});
+}
+
+void FUOnlineSessionResultStore::Rehydrate(int32 arg_Index, FOnlineSessionSearchResult& arg_OutSearchResult) const
+{
+	const FColdData& Cold = ColdData[arg_Index];
+
+	arg_OutSearchResult.PingInMs = PingsInMs[arg_Index];
+
+	FOnlineSession& Session = arg_OutSearchResult.Session;
+	Session.OwningUserId = Cold.OwningUserId;
+	Session.OwningUserName = GetOwnerName(arg_Index);
+	Session.SessionInfo = Cold.SessionInfo;
+	Session.NumOpenPublicConnections = NumOpenSlots[arg_Index];
+	Session.NumOpenPrivateConnections = Cold.NumOpenPrivateConnections;
+
+	FOnlineSessionSettings& SessionSettings = Session.SessionSettings;
+	SessionSettings.NumPublicConnections = Cold.NumPublicConnections;
+	SessionSettings.NumPrivateConnections = Cold.NumPrivateConnections;
+	SessionSettings.BuildUniqueId = Cold.BuildUniqueId;
+
+	for (int32 FlagIndex = 0; FlagIndex < NumSessionFlags; ++FlagIndex)
+	{
+		SessionSettings.*SessionFlags[FlagIndex] = (Cold.Flags & (1 << FlagIndex)) != 0;
+	}
+
+	SessionSettings.Settings.Empty(Cold.NumSettings);
+
+	for (int32 SettingIndex = Cold.FirstSetting; SettingIndex < Cold.FirstSetting + Cold.NumSettings; ++SettingIndex)
+	{
+		const FSetting& Setting = Settings[SettingIndex];
+
+		FOnlineSessionSetting& SessionSetting = SessionSettings.Settings.Add(Keys[Setting.KeyIndex]);
+		GetSettingData(Setting, SessionSetting.Data);
+		SessionSetting.AdvertisementType = static_cast<EOnlineDataAdvertisementType::Type>(Setting.AdvertisementType);
+		SessionSetting.ID = Setting.Id;
+	}
+}
+
+void FUOnlineSessionResultStore::RehydrateAll(TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const
+{
+	arg_OutSearchResults.Reset(Num());
+
+	for (int32 Index = 0; Index < Num(); ++Index)
+	{
+		Rehydrate(Index, arg_OutSearchResults[arg_OutSearchResults.AddDefaulted()]);
+	}
+}
+
+SIZE_T FUOnlineSessionResultStore::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = PingsInMs.GetAllocatedSize() + NumOpenSlots.GetAllocatedSize() + MapIds.GetAllocatedSize() + OwnerNameIds.GetAllocatedSize();
+	AllocatedSize += ColdData.GetAllocatedSize() + Settings.GetAllocatedSize();
+	AllocatedSize += Keys.GetAllocatedSize() + KeyIndices.GetAllocatedSize();
+	AllocatedSize += Strings.GetAllocatedSize() + StringIds.GetAllocatedSize();
+
+	// Every interned string is held by the table and the lookup
+	for (const FString& String : Strings)
+	{
+		AllocatedSize += String.GetAllocatedSize() * 2;
+	}
+
+	return AllocatedSize;
+}
+
+int32 FUOnlineSessionResultStore::InternString(const FString& arg_String)
+{
+	if (const int32* StringId = StringIds.Find(arg_String))
+	{
+		return *StringId;
+	}
+
+	const int32 StringId = Strings.Add(arg_String);
+	StringIds.Add(arg_String, StringId);
+
+	return StringId;
+}
+
+uint16 FUOnlineSessionResultStore::InternKey(FName arg_Key)
+{
+	if (const uint16* KeyIndex = KeyIndices.Find(arg_Key))
+	{
+		return *KeyIndex;
+	}
+
+	check(Keys.Num() < MAX_uint16);
+
+	const uint16 KeyIndex = static_cast<uint16>(Keys.Add(arg_Key));
+	KeyIndices.Add(arg_Key, KeyIndex);
+
+	return KeyIndex;
+}
+
+void FUOnlineSessionResultStore::GetSettingData(const FSetting& arg_Setting, FVariantData& arg_OutData) const
+{
+	if (arg_Setting.StringId != INDEX_NONE)
+	{
+		arg_OutData.SetValue(Strings[arg_Setting.StringId]);
+	}
+	else
+	{
+		arg_OutData = arg_Setting.Data;
+	}
+}
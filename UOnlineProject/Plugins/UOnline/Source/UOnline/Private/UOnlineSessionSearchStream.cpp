@@ -0,0 +1,71 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionSearchStream.h"
+
+FUOnlineSessionSearchStream::FUOnlineSessionSearchStream(const TSharedRef<FOnlineSessionSearch>& arg_SessionSearch, const FUOnlineSessionSearchStreamOptions& arg_Options, const TSharedPtr<const FUOnlineSessionFilterPredicate>& arg_Filter)
+	: SessionSearch(arg_SessionSearch)
+	, Options(arg_Options)
+	, Filter(arg_Filter)
+	, NextResultIndex(0)
+	, NumGoodResults(0)
+	, NextBatchTime(0.0)
+	, bIsComplete(false)
+	, bWasCancelled(false)
+{
+	Options.BatchSize = FMath::Max(1, Options.BatchSize);
+}
+
+bool FUOnlineSessionSearchStream::TakeBatch(double arg_Now, TArray<FOnlineSessionSearchResult>& arg_OutBatch)
+{
+	arg_OutBatch.Reset();
+
+	if (arg_Now < NextBatchTime)
+	{
+		return false;
+	}
+
+	NextBatchTime = arg_Now + Options.BatchInterval;
+
+	const TArray<FOnlineSessionSearchResult>& SearchResults = SessionSearch->SearchResults;
+	const int32 LastResultIndex = FMath::Min(SearchResults.Num(), NextResultIndex + Options.BatchSize);
+
+	for (; NextResultIndex < LastResultIndex; ++NextResultIndex)
+	{
+		const FOnlineSessionSearchResult& SearchResult = SearchResults[NextResultIndex];
+
+		if (!SearchResult.IsValid() || (Filter.IsValid() && !Filter->Matches(SearchResult)))
+		{
+			continue;
+		}
+
+		if (IsGoodResult(SearchResult))
+		{
+			++NumGoodResults;
+		}
+
+		arg_OutBatch.Add(SearchResult);
+	}
+
+	return arg_OutBatch.Num() > 0;
+}
+
+void FUOnlineSessionSearchStream::MarkComplete(bool arg_bWasCancelled)
+{
+	bIsComplete = true;
+	bWasCancelled = arg_bWasCancelled;
+}
+
+bool FUOnlineSessionSearchStream::HasEnoughGoodResults() const
+{
+	return Options.DesiredGoodResults > 0 && NumGoodResults >= Options.DesiredGoodResults;
+}
+
+bool FUOnlineSessionSearchStream::IsDrained() const
+{
+	return bIsComplete && NextResultIndex >= SessionSearch->SearchResults.Num();
+}
+
+bool FUOnlineSessionSearchStream::IsGoodResult(const FOnlineSessionSearchResult& arg_SearchResult) const
+{
+	return arg_SearchResult.PingInMs <= Options.MaxGoodPingInMs && arg_SearchResult.Session.NumOpenPublicConnections >= Options.MinGoodOpenSlots;
+}
@@ -0,0 +1,267 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineSessionSettingsTracker.h"
+
+FUOnlineSessionSettingsTracker::FUOnlineSessionSettingsTracker() : MinUpdateInterval(1.f)
+{
+
+}
+
+void FUOnlineSessionSettingsTracker::SetMinUpdateInterval(float arg_MinUpdateInterval)
+{
+	MinUpdateInterval = FMath::Max(0.f, arg_MinUpdateInterval);
+}
+
+void FUOnlineSessionSettingsTracker::Track(FName arg_SessionName, const FOnlineSessionSettings& arg_Settings)
+{
+	FTrackedSession& Session = Sessions.Add(arg_SessionName);
+	Session.Advertised = arg_Settings;
+	Session.Wanted = arg_Settings;
+}
+
+void FUOnlineSessionSettingsTracker::Untrack(FName arg_SessionName)
+{
+	Sessions.Remove(arg_SessionName);
+}
+
+bool FUOnlineSessionSettingsTracker::SetSetting(FName arg_SessionName, FName arg_Key, const FVariantData& arg_Value, EOnlineDataAdvertisementType::Type arg_AdvertisementType)
+{
+	FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	if (!Session)
+	{
+		return false;
+	}
+
+	const FOnlineSessionSetting NewSetting(arg_Value, arg_AdvertisementType);
+
+	if (IsSameSetting(Session->Wanted.Settings.Find(arg_Key), &NewSetting))
+	{
+		return false;
+	}
+
+	Session->Wanted.Settings.Add(arg_Key, NewSetting);
+	Session->DirtyKeys.Add(arg_Key);
+
+	return true;
+}
+
+bool FUOnlineSessionSettingsTracker::RemoveSetting(FName arg_SessionName, FName arg_Key)
+{
+	FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	if (!Session || Session->Wanted.Settings.Remove(arg_Key) == 0)
+	{
+		return false;
+	}
+
+	Session->DirtyKeys.Add(arg_Key);
+
+	return true;
+}
+
+bool FUOnlineSessionSettingsTracker::ModifySettings(FName arg_SessionName, TFunctionRef<void(FOnlineSessionSettings&)> arg_Modifier)
+{
+	FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	if (!Session)
+	{
+		return false;
+	}
+
+	const FOnlineSessionSettings PreviousSettings = Session->Wanted;
+	arg_Modifier(Session->Wanted);
+
+	bool bHasChanged = false;
+
+	if (!IsSameMembers(PreviousSettings, Session->Wanted))
+	{
+		Session->bAreMembersDirty = true;
+		bHasChanged = true;
+	}
+
+	// Keys can be changed, added and removed
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : Session->Wanted.Settings)
+	{
+		if (!IsSameSetting(PreviousSettings.Settings.Find(Setting.Key), &Setting.Value))
+		{
+			Session->DirtyKeys.Add(Setting.Key);
+			bHasChanged = true;
+		}
+	}
+
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : PreviousSettings.Settings)
+	{
+		if (!Session->Wanted.Settings.Contains(Setting.Key))
+		{
+			Session->DirtyKeys.Add(Setting.Key);
+			bHasChanged = true;
+		}
+	}
+
+	return bHasChanged;
+}
+
+void FUOnlineSessionSettingsTracker::Reset(FName arg_SessionName, const FOnlineSessionSettings& arg_Settings)
+{
+	FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	if (!Session)
+	{
+		return;
+	}
+
+	// Whatever was in flight is overtaken by this update
+	*Session = FTrackedSession();
+	Session->Advertised = arg_Settings;
+	Session->Wanted = arg_Settings;
+}
+
+void FUOnlineSessionSettingsTracker::TakeDueUpdates(double arg_Now, TArray<FName>& arg_OutSessionNames)
+{
+	arg_OutSessionNames.Reset();
+
+	for (TPair<FName, FTrackedSession>& TrackedSession : Sessions)
+	{
+		FTrackedSession& Session = TrackedSession.Value;
+
+		// One update at a time per session, and no more often than the interval allows
+		if (!Session.IsDirty() || Session.bIsUpdateInFlight || arg_Now < Session.LastUpdateTime + MinUpdateInterval)
+		{
+			continue;
+		}
+
+		// A player that joined and left again leaves nothing to send
+		for (TSet<FName>::TIterator DirtyKey = Session.DirtyKeys.CreateIterator(); DirtyKey; ++DirtyKey)
+		{
+			if (IsSameSetting(Session.Advertised.Settings.Find(*DirtyKey), Session.Wanted.Settings.Find(*DirtyKey)))
+			{
+				DirtyKey.RemoveCurrent();
+			}
+		}
+
+		if (Session.bAreMembersDirty && IsSameMembers(Session.Advertised, Session.Wanted))
+		{
+			Session.bAreMembersDirty = false;
+		}
+
+		if (Session.IsDirty())
+		{
+			arg_OutSessionNames.Add(TrackedSession.Key);
+		}
+	}
+}
+
+TSharedRef<FOnlineSessionSettings> FUOnlineSessionSettingsTracker::BeginUpdate(FName arg_SessionName, double arg_Now)
+{
+	FTrackedSession& Session = Sessions.FindChecked(arg_SessionName);
+
+	Session.InFlight = MakeShareable(new FOnlineSessionSettings(Session.Wanted));
+	Session.InFlightKeys = MoveTemp(Session.DirtyKeys);
+	Session.bAreInFlightMembersDirty = Session.bAreMembersDirty;
+	Session.DirtyKeys.Reset();
+	Session.bAreMembersDirty = false;
+	Session.bIsUpdateInFlight = true;
+	Session.LastUpdateTime = arg_Now;
+
+	return Session.InFlight.ToSharedRef();
+}
+
+void FUOnlineSessionSettingsTracker::EndUpdate(FName arg_SessionName, bool arg_bWasSuccessful)
+{
+	FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	if (!Session || !Session->bIsUpdateInFlight)
+	{
+		return;
+	}
+
+	if (arg_bWasSuccessful)
+	{
+		Session->Advertised = *Session->InFlight;
+	}
+	else
+	{
+		Session->DirtyKeys.Append(Session->InFlightKeys);
+		Session->bAreMembersDirty |= Session->bAreInFlightMembersDirty;
+	}
+
+	Session->InFlight.Reset();
+	Session->InFlightKeys.Reset();
+	Session->bAreInFlightMembersDirty = false;
+	Session->bIsUpdateInFlight = false;
+}
+
+const FOnlineSessionSettings* FUOnlineSessionSettingsTracker::GetSettings(FName arg_SessionName) const
+{
+	const FTrackedSession* Session = Sessions.Find(arg_SessionName);
+
+	return Session ? &Session->Wanted : nullptr;
+}
+
+bool FUOnlineSessionSettingsTracker::HasDirtySessions() const
+{
+	for (const TPair<FName, FTrackedSession>& TrackedSession : Sessions)
+	{
+		if (TrackedSession.Value.IsDirty())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FUOnlineSessionSettingsTracker::IsSameSettings(const FOnlineSessionSettings& arg_SettingsA, const FOnlineSessionSettings& arg_SettingsB)
+{
+	if (!IsSameMembers(arg_SettingsA, arg_SettingsB) || arg_SettingsA.Settings.Num() != arg_SettingsB.Settings.Num())
+	{
+		return false;
+	}
+
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : arg_SettingsA.Settings)
+	{
+		if (!IsSameSetting(&Setting.Value, arg_SettingsB.Settings.Find(Setting.Key)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FUOnlineSessionSettingsTracker::CanUpdateInPlace(const FOnlineSessionSettings& arg_Current, const FOnlineSessionSettings& arg_New)
+{
+	// These pick the backend session type at creation, updates ignore them or are refused
+	return arg_Current.bIsLANMatch == arg_New.bIsLANMatch
+		&& arg_Current.bUsesPresence == arg_New.bUsesPresence
+		&& arg_Current.bIsDedicated == arg_New.bIsDedicated
+		&& arg_Current.bUsesStats == arg_New.bUsesStats;
+}
+
+bool FUOnlineSessionSettingsTracker::IsSameSetting(const FOnlineSessionSetting* arg_SettingA, const FOnlineSessionSetting* arg_SettingB)
+{
+	if (!arg_SettingA || !arg_SettingB)
+	{
+		return arg_SettingA == arg_SettingB;
+	}
+
+	return arg_SettingA->AdvertisementType == arg_SettingB->AdvertisementType && arg_SettingA->Data == arg_SettingB->Data;
+}
+
+bool FUOnlineSessionSettingsTracker::IsSameMembers(const FOnlineSessionSettings& arg_SettingsA, const FOnlineSessionSettings& arg_SettingsB)
+{
+	return arg_SettingsA.NumPublicConnections == arg_SettingsB.NumPublicConnections
+		&& arg_SettingsA.NumPrivateConnections == arg_SettingsB.NumPrivateConnections
+		&& arg_SettingsA.bShouldAdvertise == arg_SettingsB.bShouldAdvertise
+		&& arg_SettingsA.bAllowJoinInProgress == arg_SettingsB.bAllowJoinInProgress
+		&& arg_SettingsA.bIsLANMatch == arg_SettingsB.bIsLANMatch
+		&& arg_SettingsA.bIsDedicated == arg_SettingsB.bIsDedicated
+		&& arg_SettingsA.bUsesStats == arg_SettingsB.bUsesStats
+		&& arg_SettingsA.bAllowInvites == arg_SettingsB.bAllowInvites
+		&& arg_SettingsA.bUsesPresence == arg_SettingsB.bUsesPresence
+		&& arg_SettingsA.bAllowJoinViaPresence == arg_SettingsB.bAllowJoinViaPresence
+		&& arg_SettingsA.bAllowJoinViaPresenceFriendsOnly == arg_SettingsB.bAllowJoinViaPresenceFriendsOnly
+		&& arg_SettingsA.bAntiCheatProtected == arg_SettingsB.bAntiCheatProtected
+		&& arg_SettingsA.BuildUniqueId == arg_SettingsB.BuildUniqueId;
+}
@@ -0,0 +1,995 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineStandInSession.h"
+#include "Misc/Parse.h"
+#include "UOnlineStats.h"
+
+#if !UE_BUILD_SHIPPING
+
+FUOnlineStandInOptions::FUOnlineStandInOptions()
+	: RandomSeed(0)
+	, NumAdvertisedSessions(2000)
+	, MaxPlayersPerSession(16)
+	, SessionChurn(0.1f)
+{
+	MapNames.Add(TEXT("Highrise"));
+	MapNames.Add(TEXT("Sanctuary"));
+	MapNames.Add(TEXT("Deck16"));
+	MapNames.Add(TEXT("Outpost23"));
+
+	JoinErrors.Add(EOnJoinSessionCompleteResult::SessionIsFull);
+	JoinErrors.Add(EOnJoinSessionCompleteResult::SessionDoesNotExist);
+	JoinErrors.Add(EOnJoinSessionCompleteResult::CouldNotRetrieveAddress);
+	JoinErrors.Add(EOnJoinSessionCompleteResult::UnknownError);
+
+	// Searches are the slowest call on every backend
+	GetCall(EUOnlineStandInCall::FindSessions).MedianLatency = 0.5f;
+}
+
+void FUOnlineStandInOptions::ParseCommandLine(const TCHAR* arg_CommandLine)
+{
+	FParse::Value(arg_CommandLine, TEXT("StandInSeed="), RandomSeed);
+	FParse::Value(arg_CommandLine, TEXT("StandInSessions="), NumAdvertisedSessions);
+	FParse::Value(arg_CommandLine, TEXT("StandInMaxPlayers="), MaxPlayersPerSession);
+	FParse::Value(arg_CommandLine, TEXT("StandInChurn="), SessionChurn);
+
+	NumAdvertisedSessions = FMath::Max(0, NumAdvertisedSessions);
+	MaxPlayersPerSession = FMath::Max(1, MaxPlayersPerSession);
+
+	for (int32 CallIndex = 0; CallIndex < static_cast<int32>(EUOnlineStandInCall::Num); ++CallIndex)
+	{
+		FUOnlineStandInCallOptions& Call = Calls[CallIndex];
+		const FString CallName = ToString(static_cast<EUOnlineStandInCall>(CallIndex));
+
+		// The values for every call first, then the ones for this call
+		const FString Prefixes[] = { TEXT("StandIn"), FString(TEXT("StandIn")) + CallName };
+
+		for (const FString& Prefix : Prefixes)
+		{
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("Latency=")), Call.MedianLatency);
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("LatencySpread=")), Call.LatencySpread);
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("MaxLatency=")), Call.MaxLatency);
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("RefuseRate=")), Call.RefuseRate);
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("FailureRate=")), Call.FailureRate);
+			FParse::Value(arg_CommandLine, *(Prefix + TEXT("DropRate=")), Call.DropRate);
+		}
+	}
+}
+
+const TCHAR* FUOnlineStandInOptions::ToString(EUOnlineStandInCall arg_Call)
+{
+	switch (arg_Call)
+	{
+	case EUOnlineStandInCall::CreateSession:
+		return TEXT("CreateSession");
+
+	case EUOnlineStandInCall::StartSession:
+		return TEXT("StartSession");
+
+	case EUOnlineStandInCall::UpdateSession:
+		return TEXT("UpdateSession");
+
+	case EUOnlineStandInCall::EndSession:
+		return TEXT("EndSession");
+
+	case EUOnlineStandInCall::DestroySession:
+		return TEXT("DestroySession");
+
+	case EUOnlineStandInCall::FindSessions:
+		return TEXT("FindSessions");
+
+	case EUOnlineStandInCall::JoinSession:
+		return TEXT("JoinSession");
+
+	case EUOnlineStandInCall::RegisterPlayers:
+		return TEXT("RegisterPlayers");
+
+	case EUOnlineStandInCall::UnregisterPlayers:
+		return TEXT("UnregisterPlayers");
+
+	default:
+		break;
+	}
+
+	return TEXT("Unknown");
+}
+
+FUOnlineStandInSession::FUOnlineStandInSession(const FUOnlineStandInOptions& arg_Options)
+	: Options(arg_Options)
+	, Random(arg_Options.RandomSeed)
+	, NextCallbackId(1)
+	, NumDroppedCallbacks(0)
+	, CurrentSearchCallbackId(0)
+	, NextHostedSessionId(0)
+{
+	GenerateAdvertisedSessions();
+
+	UE_LOG(LogUOnline, Log, TEXT("Stand-in session interface advertises %d sessions"), AdvertisedSessions.Num());
+}
+
+FUOnlineStandInSession::~FUOnlineStandInSession()
+{
+
+}
+
+bool FUOnlineStandInSession::Tick(float arg_DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// One at a time, completions may schedule new calls
+	while (PendingCallbacks.Num() > 0 && PendingCallbacks.HeapTop().DueTime <= Now)
+	{
+		FPendingCallback PendingCallback;
+		PendingCallbacks.HeapPop(PendingCallback, FPendingCallbackOrder(), false);
+
+		PendingCallback.Completion(PendingCallback.bWasSuccessful, PendingCallback.bNotify);
+	}
+
+	return true;
+}
+
+TSharedPtr<const FUniqueNetId> FUOnlineStandInSession::CreateSessionIdFromString(const FString& arg_SessionIdStr)
+{
+	if (arg_SessionIdStr.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	return MakeShareable(new FUniqueNetIdString(arg_SessionIdStr));
+}
+
+FNamedOnlineSession* FUOnlineStandInSession::GetNamedSession(FName arg_SessionName)
+{
+	for (FNamedOnlineSession& Session : Sessions)
+	{
+		if (Session.SessionName == arg_SessionName)
+		{
+			return &Session;
+		}
+	}
+
+	return nullptr;
+}
+
+void FUOnlineStandInSession::RemoveNamedSession(FName arg_SessionName)
+{
+	for (int32 SessionIndex = 0; SessionIndex < Sessions.Num(); ++SessionIndex)
+	{
+		if (Sessions[SessionIndex].SessionName == arg_SessionName)
+		{
+			Sessions.RemoveAtSwap(SessionIndex);
+			return;
+		}
+	}
+}
+
+bool FUOnlineStandInSession::HasPresenceSession()
+{
+	for (const FNamedOnlineSession& Session : Sessions)
+	{
+		if (Session.SessionSettings.bUsesPresence)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+EOnlineSessionState::Type FUOnlineStandInSession::GetSessionState(FName arg_SessionName) const
+{
+	for (const FNamedOnlineSession& Session : Sessions)
+	{
+		if (Session.SessionName == arg_SessionName)
+		{
+			return Session.SessionState;
+		}
+	}
+
+	return EOnlineSessionState::NoSession;
+}
+
+bool FUOnlineStandInSession::CreateSession(int32 arg_HostingPlayerNum, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings)
+{
+	return StartCreateSession(nullptr, arg_SessionName, arg_NewSessionSettings);
+}
+
+bool FUOnlineStandInSession::CreateSession(const FUniqueNetId& arg_HostingPlayerId, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings)
+{
+	return StartCreateSession(arg_HostingPlayerId.AsShared(), arg_SessionName, arg_NewSessionSettings);
+}
+
+bool FUOnlineStandInSession::StartSession(FName arg_SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+	if (!Session || (Session->SessionState != EOnlineSessionState::Pending && Session->SessionState != EOnlineSessionState::Ended))
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::StartSession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	Session->SessionState = EOnlineSessionState::Starting;
+
+	Schedule(EUOnlineStandInCall::StartSession, Outcome, [this, arg_SessionName](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* StartedSession = GetNamedSession(arg_SessionName);
+
+		if (StartedSession && StartedSession->SessionState == EOnlineSessionState::Starting)
+		{
+			StartedSession->SessionState = arg_bWasSuccessful ? EOnlineSessionState::InProgress : EOnlineSessionState::Pending;
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnStartSessionCompleteDelegates(arg_SessionName, arg_bWasSuccessful && StartedSession);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::UpdateSession(FName arg_SessionName, FOnlineSessionSettings& arg_UpdatedSessionSettings, bool arg_bShouldRefreshOnlineData)
+{
+	if (!GetNamedSession(arg_SessionName))
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::UpdateSession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	const FOnlineSessionSettings UpdatedSessionSettings = arg_UpdatedSessionSettings;
+
+	Schedule(EUOnlineStandInCall::UpdateSession, Outcome, [this, arg_SessionName, UpdatedSessionSettings](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* UpdatedSession = GetNamedSession(arg_SessionName);
+
+		if (UpdatedSession && arg_bWasSuccessful)
+		{
+			UpdatedSession->SessionSettings = UpdatedSessionSettings;
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnUpdateSessionCompleteDelegates(arg_SessionName, arg_bWasSuccessful && UpdatedSession);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::EndSession(FName arg_SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+	if (!Session || Session->SessionState != EOnlineSessionState::InProgress)
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::EndSession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	Session->SessionState = EOnlineSessionState::Ending;
+
+	Schedule(EUOnlineStandInCall::EndSession, Outcome, [this, arg_SessionName](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* EndedSession = GetNamedSession(arg_SessionName);
+
+		if (EndedSession && EndedSession->SessionState == EOnlineSessionState::Ending)
+		{
+			EndedSession->SessionState = arg_bWasSuccessful ? EOnlineSessionState::Ended : EOnlineSessionState::InProgress;
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnEndSessionCompleteDelegates(arg_SessionName, arg_bWasSuccessful && EndedSession);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::DestroySession(FName arg_SessionName, const FOnDestroySessionCompleteDelegate& arg_CompletionDelegate)
+{
+	FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+	if (!Session || Session->SessionState == EOnlineSessionState::Destroying)
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::DestroySession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	const EOnlineSessionState::Type PreviousState = Session->SessionState;
+	Session->SessionState = EOnlineSessionState::Destroying;
+
+	Schedule(EUOnlineStandInCall::DestroySession, Outcome, [this, arg_SessionName, arg_CompletionDelegate, PreviousState](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* DestroyedSession = GetNamedSession(arg_SessionName);
+
+		if (DestroyedSession && arg_bWasSuccessful)
+		{
+			RemoveNamedSession(arg_SessionName);
+		}
+		else if (DestroyedSession)
+		{
+			DestroyedSession->SessionState = PreviousState;
+		}
+
+		if (arg_bNotify)
+		{
+			arg_CompletionDelegate.ExecuteIfBound(arg_SessionName, arg_bWasSuccessful);
+			TriggerOnDestroySessionCompleteDelegates(arg_SessionName, arg_bWasSuccessful);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::IsPlayerInSession(FName arg_SessionName, const FUniqueNetId& arg_UniqueId)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+	if (!Session)
+	{
+		return false;
+	}
+
+	return Session->RegisteredPlayers.ContainsByPredicate([&arg_UniqueId](const TSharedRef<const FUniqueNetId>& arg_Player)
+	{
+		return *arg_Player == arg_UniqueId;
+	});
+}
+
+bool FUOnlineStandInSession::StartMatchmaking(const TArray<TSharedRef<const FUniqueNetId>>& arg_LocalPlayers, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings, TSharedRef<FOnlineSessionSearch>& arg_SearchSettings)
+{
+	// Not simulated, the plugin doesn't use backend matchmaking
+	return false;
+}
+
+bool FUOnlineStandInSession::CancelMatchmaking(int32 arg_SearchingPlayerNum, FName arg_SessionName)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::CancelMatchmaking(const FUniqueNetId& arg_SearchingPlayerId, FName arg_SessionName)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::FindSessions(int32 arg_SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings)
+{
+	return StartFindSessions(arg_SearchSettings);
+}
+
+bool FUOnlineStandInSession::FindSessions(const FUniqueNetId& arg_SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings)
+{
+	return StartFindSessions(arg_SearchSettings);
+}
+
+bool FUOnlineStandInSession::FindSessionById(const FUniqueNetId& arg_SearchingUserId, const FUniqueNetId& arg_SessionId, const FUniqueNetId& arg_FriendId, const FOnSingleSessionResultCompleteDelegate& arg_CompletionDelegate)
+{
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::FindSessions);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	const FString SessionId = arg_SessionId.ToString();
+
+	Schedule(EUOnlineStandInCall::FindSessions, Outcome, [this, SessionId, arg_CompletionDelegate](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		const FOnlineSessionSearchResult* SearchResult = arg_bWasSuccessful ? FindAdvertisedSession(SessionId) : nullptr;
+
+		if (arg_bNotify)
+		{
+			arg_CompletionDelegate.ExecuteIfBound(0, SearchResult != nullptr, SearchResult ? *SearchResult : FOnlineSessionSearchResult());
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::CancelFindSessions()
+{
+	if (!CurrentSearch.IsValid())
+	{
+		return false;
+	}
+
+	const int32 PendingIndex = PendingCallbacks.IndexOfByPredicate([this](const FPendingCallback& arg_PendingCallback)
+	{
+		return arg_PendingCallback.Id == CurrentSearchCallbackId;
+	});
+
+	if (PendingIndex != INDEX_NONE)
+	{
+		PendingCallbacks.HeapRemoveAt(PendingIndex, FPendingCallbackOrder(), false);
+	}
+
+	CurrentSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	CurrentSearch.Reset();
+	CurrentSearchCallbackId = 0;
+
+	// Told on the next tick like every other callback, not before the call returned
+	FPendingCallback PendingCallback;
+	PendingCallback.DueTime = FPlatformTime::Seconds();
+	PendingCallback.Id = NextCallbackId++;
+	PendingCallback.bWasSuccessful = true;
+	PendingCallback.bNotify = true;
+	PendingCallback.Completion = [this](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		TriggerOnCancelFindSessionsCompleteDelegates(arg_bWasSuccessful);
+	};
+
+	PendingCallbacks.HeapPush(MoveTemp(PendingCallback), FPendingCallbackOrder());
+
+	return true;
+}
+
+bool FUOnlineStandInSession::PingSearchResults(const FOnlineSessionSearchResult& arg_SearchResult)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::JoinSession(int32 arg_PlayerNum, FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession)
+{
+	return StartJoinSession(arg_SessionName, arg_DesiredSession);
+}
+
+bool FUOnlineStandInSession::JoinSession(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession)
+{
+	return StartJoinSession(arg_SessionName, arg_DesiredSession);
+}
+
+bool FUOnlineStandInSession::FindFriendSession(int32 arg_LocalUserNum, const FUniqueNetId& arg_Friend)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::FindFriendSession(const FUniqueNetId& arg_LocalUserId, const FUniqueNetId& arg_Friend)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::FindFriendSession(const FUniqueNetId& arg_LocalUserId, const TArray<TSharedRef<const FUniqueNetId>>& arg_FriendList)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::SendSessionInviteToFriend(int32 arg_LocalUserNum, FName arg_SessionName, const FUniqueNetId& arg_Friend)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::SendSessionInviteToFriend(const FUniqueNetId& arg_LocalUserId, FName arg_SessionName, const FUniqueNetId& arg_Friend)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::SendSessionInviteToFriends(int32 arg_LocalUserNum, FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Friends)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::SendSessionInviteToFriends(const FUniqueNetId& arg_LocalUserId, FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Friends)
+{
+	return false;
+}
+
+bool FUOnlineStandInSession::GetResolvedConnectString(FName arg_SessionName, FString& arg_ConnectInfo, FName arg_PortType)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+	return Session && GetConnectString(*Session, arg_ConnectInfo);
+}
+
+bool FUOnlineStandInSession::GetResolvedConnectString(const FOnlineSessionSearchResult& arg_SearchResult, FName arg_PortType, FString& arg_ConnectInfo)
+{
+	return GetConnectString(arg_SearchResult.Session, arg_ConnectInfo);
+}
+
+FOnlineSessionSettings* FUOnlineStandInSession::GetSessionSettings(FName arg_SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+	return Session ? &Session->SessionSettings : nullptr;
+}
+
+bool FUOnlineStandInSession::RegisterPlayer(FName arg_SessionName, const FUniqueNetId& arg_PlayerId, bool arg_bWasInvited)
+{
+	TArray<TSharedRef<const FUniqueNetId>> Players;
+	Players.Add(arg_PlayerId.AsShared());
+
+	return RegisterPlayers(arg_SessionName, Players, arg_bWasInvited);
+}
+
+bool FUOnlineStandInSession::RegisterPlayers(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasInvited)
+{
+	if (!GetNamedSession(arg_SessionName))
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::RegisterPlayers);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	Schedule(EUOnlineStandInCall::RegisterPlayers, Outcome, [this, arg_SessionName, arg_Players](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+		if (Session && arg_bWasSuccessful)
+		{
+			for (const TSharedRef<const FUniqueNetId>& Player : arg_Players)
+			{
+				if (!IsPlayerInSession(arg_SessionName, *Player))
+				{
+					Session->RegisteredPlayers.Add(Player);
+					Session->NumOpenPublicConnections = FMath::Max(0, Session->NumOpenPublicConnections - 1);
+				}
+			}
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnRegisterPlayersCompleteDelegates(arg_SessionName, arg_Players, arg_bWasSuccessful && Session);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::UnregisterPlayer(FName arg_SessionName, const FUniqueNetId& arg_PlayerId)
+{
+	TArray<TSharedRef<const FUniqueNetId>> Players;
+	Players.Add(arg_PlayerId.AsShared());
+
+	return UnregisterPlayers(arg_SessionName, Players);
+}
+
+bool FUOnlineStandInSession::UnregisterPlayers(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players)
+{
+	if (!GetNamedSession(arg_SessionName))
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::UnregisterPlayers);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	Schedule(EUOnlineStandInCall::UnregisterPlayers, Outcome, [this, arg_SessionName, arg_Players](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* Session = GetNamedSession(arg_SessionName);
+
+		if (Session && arg_bWasSuccessful)
+		{
+			for (const TSharedRef<const FUniqueNetId>& Player : arg_Players)
+			{
+				const int32 NumRemoved = Session->RegisteredPlayers.RemoveAll([&Player](const TSharedRef<const FUniqueNetId>& arg_RegisteredPlayer)
+				{
+					return *arg_RegisteredPlayer == *Player;
+				});
+
+				Session->NumOpenPublicConnections = FMath::Min(Session->SessionSettings.NumPublicConnections, Session->NumOpenPublicConnections + NumRemoved);
+			}
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnUnregisterPlayersCompleteDelegates(arg_SessionName, arg_Players, arg_bWasSuccessful && Session);
+		}
+	});
+
+	return true;
+}
+
+void FUOnlineStandInSession::RegisterLocalPlayer(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnRegisterLocalPlayerCompleteDelegate& arg_Delegate)
+{
+	arg_Delegate.ExecuteIfBound(arg_PlayerId, EOnJoinSessionCompleteResult::Success);
+}
+
+void FUOnlineStandInSession::UnregisterLocalPlayer(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& arg_Delegate)
+{
+	arg_Delegate.ExecuteIfBound(arg_PlayerId, true);
+}
+
+int32 FUOnlineStandInSession::GetNumSessions()
+{
+	return Sessions.Num();
+}
+
+void FUOnlineStandInSession::DumpSessionState()
+{
+	UE_LOG(LogUOnline, Display, TEXT("Stand-in: %d sessions, %d advertised, %d callbacks pending, %d dropped"), Sessions.Num(), AdvertisedSessions.Num(), PendingCallbacks.Num(), NumDroppedCallbacks);
+
+	for (const FNamedOnlineSession& Session : Sessions)
+	{
+		UE_LOG(LogUOnline, Display, TEXT("  %s: %s, %d players"), *Session.SessionName.ToString(), EOnlineSessionState::ToString(Session.SessionState), Session.RegisteredPlayers.Num());
+	}
+}
+
+FNamedOnlineSession* FUOnlineStandInSession::AddNamedSession(FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings)
+{
+	return &Sessions[Sessions.Emplace(arg_SessionName, arg_SessionSettings)];
+}
+
+FNamedOnlineSession* FUOnlineStandInSession::AddNamedSession(FName arg_SessionName, const FOnlineSession& arg_Session)
+{
+	return &Sessions[Sessions.Emplace(arg_SessionName, arg_Session)];
+}
+
+FUOnlineStandInSession::EOutcome FUOnlineStandInSession::RollOutcome(EUOnlineStandInCall arg_Call)
+{
+	const FUOnlineStandInCallOptions& Call = Options.GetCall(arg_Call);
+	const float Roll = Random.FRand();
+
+	if (Roll < Call.RefuseRate)
+	{
+		return EOutcome::Refuse;
+	}
+
+	if (Roll < Call.RefuseRate + Call.FailureRate)
+	{
+		return EOutcome::Fail;
+	}
+
+	if (Roll < Call.RefuseRate + Call.FailureRate + Call.DropRate)
+	{
+		return EOutcome::Drop;
+	}
+
+	return EOutcome::Succeed;
+}
+
+double FUOnlineStandInSession::RollLatency(EUOnlineStandInCall arg_Call)
+{
+	const FUOnlineStandInCallOptions& Call = Options.GetCall(arg_Call);
+
+	if (Call.MedianLatency <= 0.f)
+	{
+		return 0.0;
+	}
+
+	// Box-Muller, the log of the latency is normally distributed
+	const float Uniform1 = FMath::Max(Random.FRand(), SMALL_NUMBER);
+	const float Uniform2 = Random.FRand();
+	const float Normal = FMath::Sqrt(-2.f * FMath::Loge(Uniform1)) * FMath::Cos(2.f * PI * Uniform2);
+
+	return FMath::Min(Call.MedianLatency * FMath::Exp(Call.LatencySpread * Normal), Call.MaxLatency);
+}
+
+int32 FUOnlineStandInSession::Schedule(EUOnlineStandInCall arg_Call, EOutcome arg_Outcome, FCompletion&& arg_Completion)
+{
+	FPendingCallback PendingCallback;
+	PendingCallback.DueTime = FPlatformTime::Seconds() + RollLatency(arg_Call);
+	PendingCallback.Id = NextCallbackId++;
+	PendingCallback.Completion = MoveTemp(arg_Completion);
+	PendingCallback.bWasSuccessful = arg_Outcome != EOutcome::Fail;
+	PendingCallback.bNotify = arg_Outcome != EOutcome::Drop;
+
+	if (arg_Outcome == EOutcome::Drop)
+	{
+		++NumDroppedCallbacks;
+		UE_LOG(LogUOnline, Verbose, TEXT("Stand-in drops the callback of %s"), FUOnlineStandInOptions::ToString(arg_Call));
+	}
+
+	const int32 CallbackId = PendingCallback.Id;
+	PendingCallbacks.HeapPush(MoveTemp(PendingCallback), FPendingCallbackOrder());
+
+	return CallbackId;
+}
+
+bool FUOnlineStandInSession::StartCreateSession(TSharedPtr<const FUniqueNetId> arg_HostingPlayerId, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings)
+{
+	if (GetNamedSession(arg_SessionName))
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::CreateSession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	// The name is taken from the call on, like on every backend
+	FNamedOnlineSession* Session = AddNamedSession(arg_SessionName, arg_NewSessionSettings);
+	Session->SessionState = EOnlineSessionState::Creating;
+	Session->OwningUserId = arg_HostingPlayerId;
+	Session->OwningUserName = arg_HostingPlayerId.IsValid() ? arg_HostingPlayerId->ToString() : FString(TEXT("StandInServer"));
+	Session->NumOpenPublicConnections = arg_NewSessionSettings.NumPublicConnections;
+	Session->NumOpenPrivateConnections = arg_NewSessionSettings.NumPrivateConnections;
+	Session->bHosting = true;
+
+	const int32 HostedSessionId = NextHostedSessionId++;
+
+	Schedule(EUOnlineStandInCall::CreateSession, Outcome, [this, arg_SessionName, HostedSessionId](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		FNamedOnlineSession* CreatedSession = GetNamedSession(arg_SessionName);
+
+		if (CreatedSession && arg_bWasSuccessful)
+		{
+			CreatedSession->SessionState = EOnlineSessionState::Pending;
+			CreatedSession->SessionInfo = MakeShareable(new FUOnlineStandInSessionInfo(FString::Printf(TEXT("StandInHosted%d"), HostedSessionId), TEXT("127.0.0.1:7777")));
+		}
+		else if (CreatedSession)
+		{
+			RemoveNamedSession(arg_SessionName);
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnCreateSessionCompleteDelegates(arg_SessionName, arg_bWasSuccessful && CreatedSession);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::StartFindSessions(const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings)
+{
+	// One search at a time, like every backend
+	if (CurrentSearch.IsValid())
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::FindSessions);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	arg_SearchSettings->SearchResults.Reset();
+	arg_SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	CurrentSearch = arg_SearchSettings;
+
+	CurrentSearchCallbackId = Schedule(EUOnlineStandInCall::FindSessions, Outcome, [this, arg_SearchSettings](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		CurrentSearch.Reset();
+		CurrentSearchCallbackId = 0;
+
+		if (!arg_bWasSuccessful)
+		{
+			arg_SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
+		}
+		else
+		{
+			ChurnAdvertisedSessions();
+
+			const int32 MaxSearchResults = arg_SearchSettings->MaxSearchResults > 0 ? arg_SearchSettings->MaxSearchResults : MAX_int32;
+
+			// Sessions hosted here first, so a search after a create finds it like it would on the Null subsystem
+			for (const FNamedOnlineSession& Session : Sessions)
+			{
+				if (arg_SearchSettings->SearchResults.Num() < MaxSearchResults && Session.bHosting && Session.SessionInfo.IsValid()
+					&& Session.SessionSettings.bShouldAdvertise && MatchesQuery(Session, arg_SearchSettings->QuerySettings))
+				{
+					FOnlineSessionSearchResult& SearchResult = arg_SearchSettings->SearchResults[arg_SearchSettings->SearchResults.AddDefaulted()];
+					SearchResult.Session = Session;
+					SearchResult.PingInMs = 1;
+				}
+			}
+
+			for (const FOnlineSessionSearchResult& AdvertisedSession : AdvertisedSessions)
+			{
+				if (arg_SearchSettings->SearchResults.Num() >= MaxSearchResults)
+				{
+					break;
+				}
+
+				if (MatchesQuery(AdvertisedSession.Session, arg_SearchSettings->QuerySettings))
+				{
+					FOnlineSessionSearchResult& SearchResult = arg_SearchSettings->SearchResults[arg_SearchSettings->SearchResults.Add(AdvertisedSession)];
+
+					// Pings vary a little from search to search
+					SearchResult.PingInMs = FMath::Max(1, AdvertisedSession.PingInMs + Random.RandRange(-5, 5));
+				}
+			}
+
+			arg_SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnFindSessionsCompleteDelegates(arg_bWasSuccessful);
+		}
+	});
+
+	return true;
+}
+
+bool FUOnlineStandInSession::StartJoinSession(FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession)
+{
+	if (GetNamedSession(arg_SessionName) || !arg_DesiredSession.IsValid())
+	{
+		return false;
+	}
+
+	const EOutcome Outcome = RollOutcome(EUOnlineStandInCall::JoinSession);
+
+	if (Outcome == EOutcome::Refuse)
+	{
+		return false;
+	}
+
+	FNamedOnlineSession* Session = AddNamedSession(arg_SessionName, arg_DesiredSession.Session);
+	Session->SessionState = EOnlineSessionState::Pending;
+	Session->bHosting = false;
+
+	// Session infos hold their id by value, it can't be shared
+	const FString SessionId = arg_DesiredSession.Session.SessionInfo->GetSessionId().ToString();
+
+	Schedule(EUOnlineStandInCall::JoinSession, Outcome, [this, arg_SessionName, SessionId](bool arg_bWasSuccessful, bool arg_bNotify)
+	{
+		EOnJoinSessionCompleteResult::Type Result = EOnJoinSessionCompleteResult::Success;
+		FOnlineSessionSearchResult* AdvertisedSession = FindAdvertisedSession(SessionId);
+
+		if (!arg_bWasSuccessful)
+		{
+			Result = Options.JoinErrors.Num() > 0 ? Options.JoinErrors[Random.RandRange(0, Options.JoinErrors.Num() - 1)] : EOnJoinSessionCompleteResult::UnknownError;
+		}
+		else if (AdvertisedSession && AdvertisedSession->Session.NumOpenPublicConnections <= 0)
+		{
+			// Filled up since it was found
+			Result = EOnJoinSessionCompleteResult::SessionIsFull;
+		}
+
+		if (Result == EOnJoinSessionCompleteResult::Success)
+		{
+			if (AdvertisedSession)
+			{
+				--AdvertisedSession->Session.NumOpenPublicConnections;
+			}
+		}
+		else
+		{
+			RemoveNamedSession(arg_SessionName);
+		}
+
+		if (arg_bNotify)
+		{
+			TriggerOnJoinSessionCompleteDelegates(arg_SessionName, Result);
+		}
+	});
+
+	return true;
+}
+
+void FUOnlineStandInSession::GenerateAdvertisedSessions()
+{
+	AdvertisedSessions.Reset(Options.NumAdvertisedSessions);
+
+	for (int32 SessionIndex = 0; SessionIndex < Options.NumAdvertisedSessions; ++SessionIndex)
+	{
+		FOnlineSessionSearchResult& SearchResult = AdvertisedSessions[AdvertisedSessions.AddDefaulted()];
+		SearchResult.PingInMs = Random.RandRange(10, 250);
+
+		FOnlineSession& Session = SearchResult.Session;
+		Session.OwningUserId = MakeShareable(new FUniqueNetIdString(FString::Printf(TEXT("StandInHost%d"), SessionIndex)));
+		Session.OwningUserName = FString::Printf(TEXT("StandIn Host %d"), SessionIndex);
+
+		const FString HostAddress = FString::Printf(TEXT("10.%d.%d.%d:7777"), (SessionIndex >> 16) & 0xFF, (SessionIndex >> 8) & 0xFF, SessionIndex & 0xFF);
+		Session.SessionInfo = MakeShareable(new FUOnlineStandInSessionInfo(FString::Printf(TEXT("StandInSession%d"), SessionIndex), HostAddress));
+
+		FOnlineSessionSettings& SessionSettings = Session.SessionSettings;
+		SessionSettings.NumPublicConnections = Options.MaxPlayersPerSession;
+		SessionSettings.NumPrivateConnections = 0;
+		SessionSettings.bShouldAdvertise = true;
+		SessionSettings.bAllowJoinInProgress = true;
+		SessionSettings.bAllowInvites = true;
+		SessionSettings.bUsesPresence = false;
+		SessionSettings.bIsDedicated = true;
+
+		if (Options.MapNames.Num() > 0)
+		{
+			SessionSettings.Set(SETTING_MAPNAME, Options.MapNames[SessionIndex % Options.MapNames.Num()], EOnlineDataAdvertisementType::ViaOnlineService);
+		}
+
+		Session.NumOpenPublicConnections = Random.RandRange(0, Options.MaxPlayersPerSession);
+		Session.NumOpenPrivateConnections = 0;
+	}
+}
+
+void FUOnlineStandInSession::ChurnAdvertisedSessions()
+{
+	if (AdvertisedSessions.Num() == 0 || Options.SessionChurn <= 0.f)
+	{
+		return;
+	}
+
+	const int32 NumChanged = FMath::CeilToInt(AdvertisedSessions.Num() * FMath::Min(Options.SessionChurn, 1.f));
+
+	for (int32 ChangeIndex = 0; ChangeIndex < NumChanged; ++ChangeIndex)
+	{
+		FOnlineSession& Session = AdvertisedSessions[Random.RandRange(0, AdvertisedSessions.Num() - 1)].Session;
+		Session.NumOpenPublicConnections = Random.RandRange(0, Session.SessionSettings.NumPublicConnections);
+	}
+}
+
+bool FUOnlineStandInSession::MatchesQuery(const FOnlineSession& arg_Session, const FOnlineSearchSettings& arg_QuerySettings)
+{
+	for (const TPair<FName, FOnlineSessionSearchParam>& SearchParam : arg_QuerySettings.SearchParams)
+	{
+		if (SearchParam.Value.ComparisonOp != EOnlineComparisonOp::Equals)
+		{
+			continue;
+		}
+
+		// Keys such as SEARCH_PRESENCE aren't settings of the session, backends treat them as flags
+		const FOnlineSessionSetting* Setting = arg_Session.SessionSettings.Settings.Find(SearchParam.Key);
+
+		if (Setting && !(Setting->Data == SearchParam.Value.Data))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FOnlineSessionSearchResult* FUOnlineStandInSession::FindAdvertisedSession(const FString& arg_SessionId)
+{
+	// Ids of made up sessions carry their index
+	const FString Prefix(TEXT("StandInSession"));
+
+	if (!arg_SessionId.StartsWith(Prefix))
+	{
+		return nullptr;
+	}
+
+	const int32 SessionIndex = FCString::Atoi(*arg_SessionId.Mid(Prefix.Len()));
+
+	return AdvertisedSessions.IsValidIndex(SessionIndex) ? &AdvertisedSessions[SessionIndex] : nullptr;
+}
+
+FName FUOnlineStandInSessionInfo::GetSessionIdType()
+{
+	static const FName SessionIdType(TEXT("UOnlineStandIn"));
+	return SessionIdType;
+}
+
+bool FUOnlineStandInSession::GetConnectString(const FOnlineSession& arg_Session, FString& arg_OutConnectInfo)
+{
+	// Results of a real subsystem, or rebuilt from a compact result store, carry another session info
+	if (!arg_Session.SessionInfo.IsValid() || !arg_Session.SessionInfo->IsValid() || arg_Session.SessionInfo->GetSessionId().GetType() != FUOnlineStandInSessionInfo::GetSessionIdType())
+	{
+		return false;
+	}
+
+	arg_OutConnectInfo = static_cast<const FUOnlineStandInSessionInfo*>(arg_Session.SessionInfo.Get())->GetHostAddress();
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,291 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineStats.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+DEFINE_LOG_CATEGORY(LogUOnline);
+
+CSV_DEFINE_CATEGORY(UOnline, true);
+
+// Every operation gets the same set of stats, in the order of EUOnlineOperation
+#define UONLINE_OPERATIONS(Operation) \
+	Operation(CreateSession) \
+	Operation(StartSession) \
+	Operation(FindSessions) \
+	Operation(JoinSession) \
+	Operation(DestroySession) \
+	Operation(UpdateSession) \
+	Operation(RecycleSession) \
+	Operation(ReadFriendsList) \
+	Operation(Login) \
+	Operation(JoinAndTravel)
+
+#define UONLINE_DECLARE_OPERATION_STATS(Operation) \
+	DECLARE_DWORD_ACCUMULATOR_STAT(TEXT(#Operation " in flight"), STAT_UOnline_##Operation##_InFlight, STATGROUP_UOnline); \
+	DECLARE_DWORD_ACCUMULATOR_STAT(TEXT(#Operation " succeeded"), STAT_UOnline_##Operation##_Succeeded, STATGROUP_UOnline); \
+	DECLARE_DWORD_ACCUMULATOR_STAT(TEXT(#Operation " failed"), STAT_UOnline_##Operation##_Failed, STATGROUP_UOnline); \
+	DECLARE_DWORD_ACCUMULATOR_STAT(TEXT(#Operation " timed out"), STAT_UOnline_##Operation##_TimedOut, STATGROUP_UOnline); \
+	DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT(#Operation " last latency (ms)"), STAT_UOnline_##Operation##_LastLatency, STATGROUP_UOnline);
+
+UONLINE_OPERATIONS(UONLINE_DECLARE_OPERATION_STATS)
+
+#undef UONLINE_DECLARE_OPERATION_STATS
+
+namespace UOnlineStats
+{
+	static FAutoConsoleCommand DumpStatsCommand(
+		TEXT("UOnline.DumpStats"),
+		TEXT("Logs counters and latency percentiles of every UOnline operation."),
+		FConsoleCommandDelegate::CreateLambda([]() { FUOnlineStats::Get().Dump(); }));
+}
+
+const double FUOnlineLatencyHistogram::BucketUpperBounds[FUOnlineLatencyHistogram::NumBuckets] =
+{
+	1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0, 1000.0, 2000.0, 5000.0, 10000.0, 20000.0, 60000.0, TNumericLimits<double>::Max()
+};
+
+FUOnlineLatencyHistogram::FUOnlineLatencyHistogram()
+{
+	Reset();
+}
+
+void FUOnlineLatencyHistogram::Add(double arg_Milliseconds)
+{
+	int32 BucketIndex = 0;
+
+	while (BucketIndex < NumBuckets - 1 && arg_Milliseconds > BucketUpperBounds[BucketIndex])
+	{
+		++BucketIndex;
+	}
+
+	++BucketCounts[BucketIndex];
+	++Count;
+	TotalMilliseconds += arg_Milliseconds;
+	MinMilliseconds = FMath::Min(MinMilliseconds, arg_Milliseconds);
+	MaxMilliseconds = FMath::Max(MaxMilliseconds, arg_Milliseconds);
+}
+
+void FUOnlineLatencyHistogram::Reset()
+{
+	FMemory::Memzero(BucketCounts);
+	Count = 0;
+	TotalMilliseconds = 0.0;
+	MinMilliseconds = TNumericLimits<double>::Max();
+	MaxMilliseconds = 0.0;
+}
+
+FUOnlineSampleSummary::FUOnlineSampleSummary(const TArray<double>& arg_Samples) : Sorted(arg_Samples), Total(0.0)
+{
+	Sorted.Sort();
+
+	for (double Sample : Sorted)
+	{
+		Total += Sample;
+	}
+}
+
+double FUOnlineSampleSummary::GetPercentile(double arg_Percentile) const
+{
+	if (Sorted.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	const int32 Rank = FMath::CeilToInt(static_cast<float>(arg_Percentile / 100.0 * Sorted.Num()));
+
+	return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+}
+
+FString FUOnlineSampleSummary::GetPercentileName(double arg_Percentile)
+{
+	if (arg_Percentile <= 0.0)
+	{
+		return TEXT("Min");
+	}
+
+	if (arg_Percentile >= 100.0)
+	{
+		return TEXT("Max");
+	}
+
+	return FString::Printf(TEXT("P%d"), FMath::RoundToInt(static_cast<float>(arg_Percentile)));
+}
+
+double FUOnlineLatencyHistogram::GetPercentile(double arg_Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const int32 Rank = FMath::Max(1, FMath::CeilToInt(static_cast<float>(arg_Percentile / 100.0 * Count)));
+	int32 NumBelow = 0;
+
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets; ++BucketIndex)
+	{
+		NumBelow += BucketCounts[BucketIndex];
+
+		if (NumBelow >= Rank)
+		{
+			return FMath::Min(BucketUpperBounds[BucketIndex], MaxMilliseconds);
+		}
+	}
+
+	return MaxMilliseconds;
+}
+
+FUOnlineStats& FUOnlineStats::Get()
+{
+	static FUOnlineStats Stats;
+	return Stats;
+}
+
+EUOnlineOperation FUOnlineStats::GetOperation(EUOnlineRequestType arg_Type)
+{
+	switch (arg_Type)
+	{
+	case EUOnlineRequestType::CreateSession:
+		return EUOnlineOperation::CreateSession;
+
+	case EUOnlineRequestType::FindSessions:
+		return EUOnlineOperation::FindSessions;
+
+	case EUOnlineRequestType::JoinSession:
+		return EUOnlineOperation::JoinSession;
+
+	case EUOnlineRequestType::DestroySession:
+		return EUOnlineOperation::DestroySession;
+
+	case EUOnlineRequestType::UpdateSession:
+		return EUOnlineOperation::UpdateSession;
+
+	case EUOnlineRequestType::RecycleSession:
+		return EUOnlineOperation::RecycleSession;
+	}
+
+	return EUOnlineOperation::CreateSession;
+}
+
+const TCHAR* FUOnlineStats::ToString(EUOnlineOperation arg_Operation)
+{
+	switch (arg_Operation)
+	{
+#define UONLINE_OPERATION_NAME(Operation) case EUOnlineOperation::Operation: return TEXT(#Operation);
+		UONLINE_OPERATIONS(UONLINE_OPERATION_NAME)
+#undef UONLINE_OPERATION_NAME
+
+	default:
+		break;
+	}
+
+	return TEXT("Unknown");
+}
+
+void FUOnlineStats::BeginOperation(EUOnlineOperation arg_Operation)
+{
+	// Operations outlive any scope, so captures get a marker at each end: a named event for the timeline and a CSV event
+	SCOPED_NAMED_EVENT_FSTRING(FString::Printf(TEXT("UOnline %s begin"), ToString(arg_Operation)), FColor::Blue);
+	CSV_EVENT_GLOBAL(TEXT("UOnline %s begin"), ToString(arg_Operation));
+
+	++Operations[static_cast<int32>(arg_Operation)].NumInFlight;
+
+	Publish(arg_Operation, -1.0);
+}
+
+void FUOnlineStats::EndOperation(EUOnlineOperation arg_Operation, double arg_StartTime, bool arg_bWasSuccessful)
+{
+	SCOPED_NAMED_EVENT_FSTRING(FString::Printf(TEXT("UOnline %s end"), ToString(arg_Operation)), arg_bWasSuccessful ? FColor::Green : FColor::Red);
+
+	FOperationStats& OperationStats = Operations[static_cast<int32>(arg_Operation)];
+
+	OperationStats.NumInFlight = FMath::Max(0, OperationStats.NumInFlight - 1);
+
+	const double Milliseconds = (FPlatformTime::Seconds() - arg_StartTime) * 1000.0;
+
+	CSV_EVENT_GLOBAL(TEXT("UOnline %s %s after %.1f ms"), ToString(arg_Operation), arg_bWasSuccessful ? TEXT("succeeded") : TEXT("failed"), Milliseconds);
+
+	if (arg_bWasSuccessful)
+	{
+		++OperationStats.NumSucceeded;
+
+		// Failures often come back right away and would only drag the percentiles down
+		OperationStats.Latency.Add(Milliseconds);
+	}
+	else
+	{
+		++OperationStats.NumFailed;
+	}
+
+	UE_LOG(LogUOnline, Verbose, TEXT("%s %s after %.2f ms"), ToString(arg_Operation), arg_bWasSuccessful ? TEXT("succeeded") : TEXT("failed"), Milliseconds);
+
+	Publish(arg_Operation, arg_bWasSuccessful ? Milliseconds : -1.0);
+}
+
+void FUOnlineStats::AddTimeout(EUOnlineOperation arg_Operation)
+{
+	++Operations[static_cast<int32>(arg_Operation)].NumTimedOut;
+
+	CSV_EVENT_GLOBAL(TEXT("UOnline %s timed out"), ToString(arg_Operation));
+
+	UE_LOG(LogUOnline, Warning, TEXT("%s timed out"), ToString(arg_Operation));
+
+	Publish(arg_Operation, -1.0);
+}
+
+void FUOnlineStats::Dump() const
+{
+	for (int32 OperationIndex = 0; OperationIndex < static_cast<int32>(EUOnlineOperation::Num); ++OperationIndex)
+	{
+		const FOperationStats& OperationStats = Operations[OperationIndex];
+		const FUOnlineLatencyHistogram& Latency = OperationStats.Latency;
+
+		UE_LOG(LogUOnline, Display, TEXT("%s: %d in flight, %d succeeded, %d failed, %d timed out | min %.1f, mean %.1f, p50 %.1f, p90 %.1f, p99 %.1f, max %.1f ms"),
+			ToString(static_cast<EUOnlineOperation>(OperationIndex)), OperationStats.NumInFlight, OperationStats.NumSucceeded, OperationStats.NumFailed, OperationStats.NumTimedOut,
+			Latency.GetMin(), Latency.GetMean(), Latency.GetPercentile(50.0), Latency.GetPercentile(90.0), Latency.GetPercentile(99.0), Latency.GetMax());
+	}
+}
+
+void FUOnlineStats::Reset()
+{
+	for (FOperationStats& OperationStats : Operations)
+	{
+		// Operations in flight still have to end
+		const int32 NumInFlight = OperationStats.NumInFlight;
+		OperationStats = FOperationStats();
+		OperationStats.NumInFlight = NumInFlight;
+	}
+}
+
+void FUOnlineStats::Publish(EUOnlineOperation arg_Operation, double arg_Milliseconds) const
+{
+#if STATS || CSV_PROFILER
+	const FOperationStats& OperationStats = Operations[static_cast<int32>(arg_Operation)];
+
+	switch (arg_Operation)
+	{
+#define UONLINE_PUBLISH_OPERATION_STATS(Operation) \
+	case EUOnlineOperation::Operation: \
+		SET_DWORD_STAT(STAT_UOnline_##Operation##_InFlight, OperationStats.NumInFlight); \
+		SET_DWORD_STAT(STAT_UOnline_##Operation##_Succeeded, OperationStats.NumSucceeded); \
+		SET_DWORD_STAT(STAT_UOnline_##Operation##_Failed, OperationStats.NumFailed); \
+		SET_DWORD_STAT(STAT_UOnline_##Operation##_TimedOut, OperationStats.NumTimedOut); \
+		CSV_CUSTOM_STAT(UOnline, Operation##InFlight, OperationStats.NumInFlight, ECsvCustomStatOp::Set); \
+		if (arg_Milliseconds >= 0.0) \
+		{ \
+			SET_FLOAT_STAT(STAT_UOnline_##Operation##_LastLatency, arg_Milliseconds); \
+			CSV_CUSTOM_STAT(UOnline, Operation##LatencyMs, static_cast<float>(arg_Milliseconds), ECsvCustomStatOp::Set); \
+		} \
+		break;
+
+		UONLINE_OPERATIONS(UONLINE_PUBLISH_OPERATION_STATS)
+#undef UONLINE_PUBLISH_OPERATION_STATS
+
+	default:
+		break;
+	}
+#endif
+}
+
+#undef UONLINE_OPERATIONS
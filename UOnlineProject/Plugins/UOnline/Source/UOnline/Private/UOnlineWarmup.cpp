@@ -0,0 +1,567 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "UOnlineWarmup.h"
+#include "Containers/Ticker.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Modules/ModuleManager.h"
+#include "OnlineSubsystem.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "UOnlineStats.h"
+#include "UOnlineObject.h"
+
+namespace UOnlineWarmup
+{
+	static const TCHAR* ConfigSection = TEXT("UOnline.Warmup");
+
+	static EUOnlineOperation GetOperation(EUOnlineWarmupStage arg_Stage)
+	{
+		switch (arg_Stage)
+		{
+		case EUOnlineWarmupStage::Login:
+			return EUOnlineOperation::Login;
+
+		case EUOnlineWarmupStage::ReadFriendsList:
+			return EUOnlineOperation::ReadFriendsList;
+
+		default:
+			break;
+		}
+
+		return EUOnlineOperation::FindSessions;
+	}
+}
+
+FUOnlineWarmupOptions::FUOnlineWarmupOptions()
+	: bEnabled(false)
+	, OnlineSubsystemName(NAME_None)
+	, LocalUserNum(0)
+	, bLogin(true)
+	, bReadFriendsList(true)
+	, bFindSessions(true)
+	, bIsLANQuery(false)
+	, bIsPresenceQuery(true)
+	, SubsystemWaitTimeout(30.f)
+	, StageTimeout(30.f)
+{
+
+}
+
+void FUOnlineWarmupOptions::LoadConfig()
+{
+	if (GConfig)
+	{
+		FString SubsystemString;
+
+		if (GConfig->GetString(UOnlineWarmup::ConfigSection, TEXT("OnlineSubsystemName"), SubsystemString, GGameIni) && !SubsystemString.IsEmpty())
+		{
+			OnlineSubsystemName = FName(*SubsystemString);
+		}
+
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bEnabled"), bEnabled, GGameIni);
+		GConfig->GetInt(UOnlineWarmup::ConfigSection, TEXT("LocalUserNum"), LocalUserNum, GGameIni);
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bLogin"), bLogin, GGameIni);
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bReadFriendsList"), bReadFriendsList, GGameIni);
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bFindSessions"), bFindSessions, GGameIni);
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bIsLANQuery"), bIsLANQuery, GGameIni);
+		GConfig->GetBool(UOnlineWarmup::ConfigSection, TEXT("bIsPresenceQuery"), bIsPresenceQuery, GGameIni);
+		GConfig->GetFloat(UOnlineWarmup::ConfigSection, TEXT("SubsystemWaitTimeout"), SubsystemWaitTimeout, GGameIni);
+		GConfig->GetFloat(UOnlineWarmup::ConfigSection, TEXT("StageTimeout"), StageTimeout, GGameIni);
+	}
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("UOnlineWarmup")))
+	{
+		bEnabled = true;
+	}
+	else if (FParse::Param(FCommandLine::Get(), TEXT("NoUOnlineWarmup")))
+	{
+		bEnabled = false;
+	}
+}
+
+FUOnlineWarmup::FUOnlineWarmup(const FUOnlineWarmupOptions& arg_Options)
+	: Options(arg_Options)
+	, StartTime(0.0)
+	, bIsComplete(false)
+	, bAreResultsTaken(false)
+	, bAreSearchResultsTaken(false)
+	, bHasStartedStages(false)
+	, bIsStartingStages(false)
+	, bReadFriendsAfterLogin(false)
+{
+	Results.OnlineSubsystemName = Options.OnlineSubsystemName;
+	Results.LocalUserNum = Options.LocalUserNum;
+	Results.bIsLANQuery = Options.bIsLANQuery;
+	Results.bIsPresenceQuery = Options.bIsPresenceQuery;
+}
+
+FUOnlineWarmup::~FUOnlineWarmup()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+void FUOnlineWarmup::Start()
+{
+	if (StartTime > 0.0)
+	{
+		return;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FUOnlineWarmup::Tick));
+
+	UE_LOG(LogUOnline, Log, TEXT("Online warm-up waits for the subsystem"));
+}
+
+void FUOnlineWarmup::Stop()
+{
+	if (bIsComplete)
+	{
+		return;
+	}
+
+	UnbindDelegates();
+
+	for (int32 StageIndex = 0; StageIndex < static_cast<int32>(EUOnlineWarmupStage::Num); ++StageIndex)
+	{
+		if (!Stages[StageIndex].IsDone())
+		{
+			EndStage(static_cast<EUOnlineWarmupStage>(StageIndex), EUOnlineWarmupStageState::Failed);
+		}
+	}
+}
+
+bool FUOnlineWarmup::TakeResults(FUOnlineWarmupResults& arg_OutResults)
+{
+	if (!bIsComplete || bAreResultsTaken)
+	{
+		return false;
+	}
+
+	arg_OutResults = MoveTemp(Results);
+	bAreResultsTaken = true;
+
+	return true;
+}
+
+bool FUOnlineWarmup::TakeSearchResults(FUOnlineWarmupResults& arg_OutResults)
+{
+	if (!GetStage(EUOnlineWarmupStage::FindSessions).IsDone() || bAreResultsTaken || bAreSearchResultsTaken)
+	{
+		return false;
+	}
+
+	arg_OutResults.OnlineSubsystemName = Results.OnlineSubsystemName;
+	arg_OutResults.LocalUserNum = Results.LocalUserNum;
+	arg_OutResults.bHasSearchResults = Results.bHasSearchResults;
+	arg_OutResults.bIsLANQuery = Results.bIsLANQuery;
+	arg_OutResults.bIsPresenceQuery = Results.bIsPresenceQuery;
+	arg_OutResults.SearchResults = MoveTemp(Results.SearchResults);
+	arg_OutResults.SearchTime = Results.SearchTime;
+
+	// TakeResults hands out the rest
+	Results.bHasSearchResults = false;
+	Results.SearchResults.Empty();
+	bAreSearchResultsTaken = true;
+
+	return true;
+}
+
+const TCHAR* FUOnlineWarmup::ToString(EUOnlineWarmupStage arg_Stage)
+{
+	switch (arg_Stage)
+	{
+	case EUOnlineWarmupStage::Login:
+		return TEXT("Login");
+
+	case EUOnlineWarmupStage::ReadFriendsList:
+		return TEXT("ReadFriendsList");
+
+	case EUOnlineWarmupStage::FindSessions:
+		return TEXT("FindSessions");
+
+	default:
+		break;
+	}
+
+	return TEXT("Unknown");
+}
+
+bool FUOnlineWarmup::Tick(float arg_DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// Wait for the subsystem. Asking for it before its module is loaded would load it out of order
+	if (!bHasStartedStages)
+	{
+		if (FModuleManager::Get().IsModuleLoaded(TEXT("OnlineSubsystem")) && IOnlineSubsystem::Get(Options.OnlineSubsystemName))
+		{
+			UE_LOG(LogUOnline, Log, TEXT("Online subsystem available after %.2f s, warm-up starts"), Now - StartTime);
+			bHasStartedStages = true;
+			StartStages();
+		}
+		else if (Now - StartTime >= Options.SubsystemWaitTimeout)
+		{
+			UE_LOG(LogUOnline, Warning, TEXT("Online subsystem %s still unavailable after %.0f s, warm-up gives up"), *Options.OnlineSubsystemName.ToString(), Now - StartTime);
+			Stop();
+		}
+
+		if (!bIsComplete)
+		{
+			return true;
+		}
+	}
+
+	for (int32 StageIndex = 0; StageIndex < static_cast<int32>(EUOnlineWarmupStage::Num) && !bIsComplete; ++StageIndex)
+	{
+		const FUOnlineWarmupStageResult& Stage = Stages[StageIndex];
+
+		if (Stage.State == EUOnlineWarmupStageState::Running && Now - Stage.StartTime >= Options.StageTimeout)
+		{
+			const EUOnlineWarmupStage TimedOutStage = static_cast<EUOnlineWarmupStage>(StageIndex);
+
+			FUOnlineStats::Get().AddTimeout(UOnlineWarmup::GetOperation(TimedOutStage));
+			EndStage(TimedOutStage, EUOnlineWarmupStageState::Failed);
+		}
+	}
+
+	if (bIsComplete)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FUOnlineWarmup::StartStages()
+{
+	// A subsystem that answers right away must not complete the warm-up before every stage started
+	bIsStartingStages = true;
+
+	if (Options.bLogin)
+	{
+		StartLogin();
+	}
+	else
+	{
+		EndStage(EUOnlineWarmupStage::Login, EUOnlineWarmupStageState::Skipped);
+	}
+
+	if (Options.bReadFriendsList)
+	{
+		StartReadFriendsList();
+	}
+	else
+	{
+		EndStage(EUOnlineWarmupStage::ReadFriendsList, EUOnlineWarmupStageState::Skipped);
+	}
+
+	if (Options.bFindSessions)
+	{
+		StartFindSessions();
+	}
+	else
+	{
+		EndStage(EUOnlineWarmupStage::FindSessions, EUOnlineWarmupStageState::Skipped);
+	}
+
+	bIsStartingStages = false;
+
+	CompleteIfDone();
+}
+
+void FUOnlineWarmup::StartLogin()
+{
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(Options.OnlineSubsystemName);
+	IOnlineIdentityPtr OnlineIdentityInterface = OnlineSubsystemInterface ? OnlineSubsystemInterface->GetIdentityInterface() : nullptr;
+
+	if (!OnlineIdentityInterface.IsValid())
+	{
+		EndStage(EUOnlineWarmupStage::Login, EUOnlineWarmupStageState::Skipped);
+		return;
+	}
+
+	BeginStage(EUOnlineWarmupStage::Login);
+
+	// The platform may have logged the user in already
+	if (OnlineIdentityInterface->GetLoginStatus(Options.LocalUserNum) == ELoginStatus::LoggedIn)
+	{
+		Results.UserId = OnlineIdentityInterface->GetUniquePlayerId(Options.LocalUserNum);
+		EndStage(EUOnlineWarmupStage::Login, EUOnlineWarmupStageState::Succeeded);
+		return;
+	}
+
+	OnLoginCompleteDelegateHandle = OnlineIdentityInterface->AddOnLoginCompleteDelegate_Handle(Options.LocalUserNum, FOnLoginCompleteDelegate::CreateSP(this, &FUOnlineWarmup::OnLoginComplete));
+
+	if (!OnlineIdentityInterface->AutoLogin(Options.LocalUserNum))
+	{
+		// Some subsystems report the failure through the delegate before returning
+		if (!GetStage(EUOnlineWarmupStage::Login).IsDone())
+		{
+			OnlineIdentityInterface->ClearOnLoginCompleteDelegate_Handle(Options.LocalUserNum, OnLoginCompleteDelegateHandle);
+			EndStage(EUOnlineWarmupStage::Login, EUOnlineWarmupStageState::Failed);
+		}
+	}
+}
+
+void FUOnlineWarmup::StartReadFriendsList()
+{
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(Options.OnlineSubsystemName);
+	IOnlineFriendsPtr OnlineFriendInterface = OnlineSubsystemInterface ? OnlineSubsystemInterface->GetFriendsInterface() : nullptr;
+
+	if (!OnlineFriendInterface.IsValid())
+	{
+		EndStage(EUOnlineWarmupStage::ReadFriendsList, EUOnlineWarmupStageState::Skipped);
+		return;
+	}
+
+	// Reading again after the login, the stage keeps running
+	if (GetStage(EUOnlineWarmupStage::ReadFriendsList).State != EUOnlineWarmupStageState::Running)
+	{
+		BeginStage(EUOnlineWarmupStage::ReadFriendsList);
+	}
+
+	bReadFriendsAfterLogin = false;
+
+	if (!OnlineFriendInterface->ReadFriendsList(Options.LocalUserNum, EFriendsLists::ToString(EFriendsLists::Default), FOnReadFriendsListComplete::CreateSP(this, &FUOnlineWarmup::OnReadFriendsListComplete)))
+	{
+		if (GetStage(EUOnlineWarmupStage::ReadFriendsList).IsDone() || bReadFriendsAfterLogin)
+		{
+			return;
+		}
+
+		// Most likely not logged in yet
+		if (GetStage(EUOnlineWarmupStage::Login).State == EUOnlineWarmupStageState::Running)
+		{
+			bReadFriendsAfterLogin = true;
+		}
+		else
+		{
+			EndStage(EUOnlineWarmupStage::ReadFriendsList, EUOnlineWarmupStageState::Failed);
+		}
+	}
+}
+
+void FUOnlineWarmup::StartFindSessions()
+{
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(Options.OnlineSubsystemName);
+	IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface ? OnlineSubsystemInterface->GetSessionInterface() : nullptr;
+
+	if (!OnlineSessionInterface.IsValid())
+	{
+		EndStage(EUOnlineWarmupStage::FindSessions, EUOnlineWarmupStageState::Skipped);
+		return;
+	}
+
+	BeginStage(EUOnlineWarmupStage::FindSessions);
+
+	// The query UOnlineObject searches with, including its configured result count, so the results end up under the key its searches use.
+	// The default object is only asked now, it may not exist yet when the module starts up
+	SessionSearch = GetDefault<UOnlineObject>()->MakeSessionSearch(Options.bIsLANQuery, Options.bIsPresenceQuery);
+
+	OnFindSessionsCompleteDelegateHandle = OnlineSessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FOnFindSessionsCompleteDelegate::CreateSP(this, &FUOnlineWarmup::OnFindSessionsComplete));
+
+	// Searching needs no login, so it doesn't wait for it
+	if (!OnlineSessionInterface->FindSessions(Options.LocalUserNum, SessionSearch.ToSharedRef()))
+	{
+		if (!GetStage(EUOnlineWarmupStage::FindSessions).IsDone())
+		{
+			OnlineSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+			EndStage(EUOnlineWarmupStage::FindSessions, EUOnlineWarmupStageState::Failed);
+		}
+	}
+}
+
+void FUOnlineWarmup::BeginStage(EUOnlineWarmupStage arg_Stage)
+{
+	FUOnlineWarmupStageResult& Stage = Stages[static_cast<int32>(arg_Stage)];
+	Stage.State = EUOnlineWarmupStageState::Running;
+	Stage.StartTime = FPlatformTime::Seconds();
+
+	FUOnlineStats::Get().BeginOperation(UOnlineWarmup::GetOperation(arg_Stage));
+}
+
+void FUOnlineWarmup::EndStage(EUOnlineWarmupStage arg_Stage, EUOnlineWarmupStageState arg_State)
+{
+	FUOnlineWarmupStageResult& Stage = Stages[static_cast<int32>(arg_Stage)];
+
+	if (Stage.IsDone())
+	{
+		return;
+	}
+
+	// Only a running stage asked the subsystem for something
+	if (Stage.State == EUOnlineWarmupStageState::Running)
+	{
+		// A search that timed out or was stopped still runs in the subsystem
+		if (arg_Stage == EUOnlineWarmupStage::FindSessions && arg_State != EUOnlineWarmupStageState::Succeeded)
+		{
+			CancelFindSessions();
+		}
+
+		FUOnlineStats::Get().EndOperation(UOnlineWarmup::GetOperation(arg_Stage), Stage.StartTime, arg_State == EUOnlineWarmupStageState::Succeeded);
+
+		Stage.EndTime = FPlatformTime::Seconds();
+
+		UE_LOG(LogUOnline, Log, TEXT("Warm-up %s %s in %.3f s"), ToString(arg_Stage), arg_State == EUOnlineWarmupStageState::Succeeded ? TEXT("succeeded") : TEXT("failed"), Stage.GetDuration());
+	}
+
+	Stage.State = arg_State;
+
+	if (arg_Stage == EUOnlineWarmupStage::FindSessions)
+	{
+		OnSearchCompleteDelegate.Broadcast();
+	}
+
+	if (!bIsStartingStages)
+	{
+		CompleteIfDone();
+	}
+}
+
+void FUOnlineWarmup::CompleteIfDone()
+{
+	if (bIsComplete)
+	{
+		return;
+	}
+
+	for (const FUOnlineWarmupStageResult& Stage : Stages)
+	{
+		if (!Stage.IsDone())
+		{
+			return;
+		}
+	}
+
+	UnbindDelegates();
+	SessionSearch.Reset();
+	bIsComplete = true;
+
+	UE_LOG(LogUOnline, Log, TEXT("Warm-up complete %.3f s after it started"), FPlatformTime::Seconds() - StartTime);
+
+	OnCompleteDelegate.Broadcast();
+}
+
+void FUOnlineWarmup::OnLoginComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FUniqueNetId& arg_UserId, const FString& arg_Error)
+{
+	if (GetStage(EUOnlineWarmupStage::Login).State != EUOnlineWarmupStageState::Running)
+	{
+		return;
+	}
+
+	if (arg_bWasSuccessful)
+	{
+		Results.UserId = arg_UserId.AsShared();
+	}
+	else
+	{
+		UE_LOG(LogUOnline, Warning, TEXT("Warm-up login of local user %d failed: %s"), arg_LocalUserNum, *arg_Error);
+	}
+
+	EndStage(EUOnlineWarmupStage::Login, arg_bWasSuccessful ? EUOnlineWarmupStageState::Succeeded : EUOnlineWarmupStageState::Failed);
+
+	if (bReadFriendsAfterLogin)
+	{
+		if (arg_bWasSuccessful)
+		{
+			StartReadFriendsList();
+		}
+		else
+		{
+			EndStage(EUOnlineWarmupStage::ReadFriendsList, EUOnlineWarmupStageState::Failed);
+		}
+	}
+}
+
+void FUOnlineWarmup::OnReadFriendsListComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FString& arg_ListName, const FString& arg_ErrorString)
+{
+	if (GetStage(EUOnlineWarmupStage::ReadFriendsList).State != EUOnlineWarmupStageState::Running)
+	{
+		return;
+	}
+
+	// Reading the list may need the login that is still running
+	if (!arg_bWasSuccessful && GetStage(EUOnlineWarmupStage::Login).State == EUOnlineWarmupStageState::Running)
+	{
+		bReadFriendsAfterLogin = true;
+		return;
+	}
+
+	Results.bHasFriendsList = arg_bWasSuccessful;
+
+	EndStage(EUOnlineWarmupStage::ReadFriendsList, arg_bWasSuccessful ? EUOnlineWarmupStageState::Succeeded : EUOnlineWarmupStageState::Failed);
+}
+
+void FUOnlineWarmup::OnFindSessionsComplete(bool arg_bWasSuccessful)
+{
+	// Other code can search on the same interface
+	if (GetStage(EUOnlineWarmupStage::FindSessions).State != EUOnlineWarmupStageState::Running || !SessionSearch.IsValid() || SessionSearch->SearchState == EOnlineAsyncTaskState::InProgress)
+	{
+		return;
+	}
+
+	if (arg_bWasSuccessful)
+	{
+		Results.bHasSearchResults = true;
+		Results.SearchResults = MoveTemp(SessionSearch->SearchResults);
+		Results.SearchTime = FPlatformTime::Seconds();
+	}
+
+	EndStage(EUOnlineWarmupStage::FindSessions, arg_bWasSuccessful ? EUOnlineWarmupStageState::Succeeded : EUOnlineWarmupStageState::Failed);
+}
+
+void FUOnlineWarmup::CancelFindSessions()
+{
+	if (!SessionSearch.IsValid() || SessionSearch->SearchState != EOnlineAsyncTaskState::InProgress)
+	{
+		return;
+	}
+
+	const IOnlineSubsystem* OnlineSubsystemInterface = IOnlineSubsystem::Get(Options.OnlineSubsystemName);
+	IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface ? OnlineSubsystemInterface->GetSessionInterface() : nullptr;
+
+	if (OnlineSessionInterface.IsValid())
+	{
+		// The stage is over, the callback of the cancelled search must not end it again
+		OnlineSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+		OnFindSessionsCompleteDelegateHandle.Reset();
+
+		OnlineSessionInterface->CancelFindSessions();
+	}
+}
+
+void FUOnlineWarmup::UnbindDelegates()
+{
+	// Don't bring a subsystem up just to unbind from it
+	IOnlineSubsystem* OnlineSubsystemInterface = FModuleManager::Get().IsModuleLoaded(TEXT("OnlineSubsystem")) ? IOnlineSubsystem::Get(Options.OnlineSubsystemName) : nullptr;
+
+	if (OnlineSubsystemInterface)
+	{
+		IOnlineIdentityPtr OnlineIdentityInterface = OnlineSubsystemInterface->GetIdentityInterface();
+
+		if (OnlineIdentityInterface.IsValid() && OnLoginCompleteDelegateHandle.IsValid())
+		{
+			OnlineIdentityInterface->ClearOnLoginCompleteDelegate_Handle(Options.LocalUserNum, OnLoginCompleteDelegateHandle);
+		}
+
+		IOnlineSessionPtr OnlineSessionInterface = OnlineSubsystemInterface->GetSessionInterface();
+
+		if (OnlineSessionInterface.IsValid() && OnFindSessionsCompleteDelegateHandle.IsValid())
+		{
+			OnlineSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+		}
+	}
+
+	OnLoginCompleteDelegateHandle.Reset();
+	OnFindSessionsCompleteDelegateHandle.Reset();
+
+	// A friends read can't be cancelled, its delegate only holds a weak pointer to us
+}
@@ -4,10 +4,26 @@
 
 #include "Modules/ModuleManager.h"
 
+class FUOnlineWarmup;
+
 class FUOnlineModule : public IModuleInterface
 {
 public:
 	// IModuleInterface implementation
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+	/**
+	* @returns the module if it is loaded, nullptr otherwise.
+	*/
+	static FUOnlineModule* GetPtr() { return FModuleManager::GetModulePtr<FUOnlineModule>("UOnline"); }
+
+	/**
+	* @returns the online warm-up that started with the module, nullptr if it is turned off.
+	*/
+	TSharedPtr<FUOnlineWarmup> GetWarmup() const { return Warmup; }
+
+private:
+	// Logs in, reads friends and searches while the game is still loading, see FUOnlineWarmup
+	TSharedPtr<FUOnlineWarmup> Warmup;
 };
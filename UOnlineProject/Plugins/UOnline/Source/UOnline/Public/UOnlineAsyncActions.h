@@ -0,0 +1,247 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "FindSessionsCallbackProxy.h"
+#include "UOnlineRequest.h"
+#include "UOnlineSessionFilter.h"
+#include "UOnlineJoinPipeline.h"
+#include "UOnlineAsyncActions.generated.h"
+
+class APlayerController;
+class UOnlineObject;
+
+/**
+ * Outcome of a join, as reported by the subsystem or refused before it was sent.
+ */
+UENUM(BlueprintType)
+enum class EUOnlineJoinResult : uint8
+{
+	Success,
+	SessionIsFull,
+	SessionDoesNotExist,
+	CouldNotRetrieveAddress,
+	AlreadyInSession,
+	// Joined, but travel couldn't be started
+	CouldNotTravel,
+	UnknownError
+};
+
+/**
+ * A cached friend as seen from Blueprint.
+ */
+USTRUCT(BlueprintType)
+struct FUOnlineBlueprintFriend
+{
+	GENERATED_BODY()
+
+	FUOnlineBlueprintFriend() : bIsOnline(false), bIsPlayingThisGame(false) {}
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Friends")
+	FUniqueNetIdRepl UserId;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Friends")
+	FString DisplayName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Friends")
+	bool bIsOnline;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Friends")
+	bool bIsPlayingThisGame;
+
+	// Rich presence status
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Friends")
+	FString Status;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnUOnlineSessionActionComplete, FName, SessionName, EUOnlineRequestStatus, Status);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnUOnlineFindSessionsActionComplete, const TArray<FBlueprintSessionResult>&, Results, EUOnlineRequestStatus, Status);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnUOnlineJoinSessionActionComplete, EUOnlineJoinResult, Result, float, TimeToTravelInMs);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUOnlineReadFriendsActionComplete, const TArray<FUOnlineBlueprintFriend>&, Friends);
+
+/**
+ * Base of the Blueprint nodes that wait for an operation of UOnlineObject. Every node fires exactly one of its output pins.
+ */
+UCLASS(Abstract)
+class UOnlineAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+protected:
+	/**
+	* @param PlayerController: a local player controller.
+	* @returns the unique net id of its player, or nullptr.
+	*/
+	static TSharedPtr<const FUniqueNetId> GetUserNetId(APlayerController* arg_PlayerController);
+
+	/**
+	* @param PlayerController: a local player controller.
+	* @returns the controller number of its local player, 0 if it has none.
+	*/
+	static int32 GetLocalUserNum(APlayerController* arg_PlayerController);
+
+protected:
+	UPROPERTY()
+	UOnlineObject* OnlineObject;
+
+	// The node fired its output, late callbacks are ignored
+	bool bIsDone;
+};
+
+/**
+ * Creates and starts a session.
+ */
+UCLASS()
+class UOnlineCreateSessionAction : public UOnlineAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineSessionActionComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineSessionActionComplete OnFailure;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "UOnline Create Session"), Category = "UOnline|Session")
+	static UOnlineCreateSessionAction* CreateSession(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, FName SessionName, FName MapName, bool bIsLAN, bool bIsPresence, int32 MaxNumPlayers);
+
+	// UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	void OnRequestComplete(const FUOnlineRequestResult& arg_Result);
+
+private:
+	TWeakObjectPtr<APlayerController> PlayerController;
+	FName SessionName;
+	FName MapName;
+	bool bIsLAN;
+	bool bIsPresence;
+	int32 MaxNumPlayers;
+};
+
+/**
+ * Searches sessions, optionally filtered, and hands out the results.
+ */
+UCLASS()
+class UOnlineFindSessionsAction : public UOnlineAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineFindSessionsActionComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineFindSessionsActionComplete OnFailure;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "UOnline Find Sessions"), Category = "UOnline|Session")
+	static UOnlineFindSessionsAction* FindSessions(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, bool bIsLAN, bool bIsPresence, const FUOnlineSessionFilter& Filter);
+
+	// UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	void OnRequestComplete(const FUOnlineRequestResult& arg_Result);
+
+private:
+	TWeakObjectPtr<APlayerController> PlayerController;
+	bool bIsLAN;
+	bool bIsPresence;
+	FUOnlineSessionFilter Filter;
+};
+
+/**
+ * Joins a session and travels to it.
+ */
+UCLASS()
+class UOnlineJoinSessionAction : public UOnlineAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineJoinSessionActionComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineJoinSessionActionComplete OnFailure;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "UOnline Join Session"), Category = "UOnline|Session")
+	static UOnlineJoinSessionAction* JoinSession(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController, FName SessionName, const FBlueprintSessionResult& SearchResult);
+
+	// UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	void OnJoinComplete(const FUOnlineJoinResult& arg_Result);
+
+	static EUOnlineJoinResult ToJoinResult(const FUOnlineJoinResult& arg_Result);
+
+private:
+	TWeakObjectPtr<APlayerController> PlayerController;
+	FName SessionName;
+	FBlueprintSessionResult SearchResult;
+};
+
+/**
+ * Destroys a session.
+ */
+UCLASS()
+class UOnlineDestroySessionAction : public UOnlineAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineSessionActionComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineSessionActionComplete OnFailure;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "UOnline Destroy Session"), Category = "UOnline|Session")
+	static UOnlineDestroySessionAction* DestroySession(UObject* WorldContextObject, UOnlineObject* OnlineObject, FName SessionName);
+
+	// UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	void OnRequestComplete(const FUOnlineRequestResult& arg_Result);
+
+private:
+	FName SessionName;
+};
+
+/**
+ * Reads the friends list of the local player and hands out the cached friends.
+ */
+UCLASS()
+class UOnlineReadFriendsAction : public UOnlineAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineReadFriendsActionComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnUOnlineReadFriendsActionComplete OnFailure;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "UOnline Read Friends"), Category = "UOnline|Friends")
+	static UOnlineReadFriendsAction* ReadFriends(UObject* WorldContextObject, UOnlineObject* OnlineObject, APlayerController* PlayerController);
+
+	// UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	void OnFriendsListRead(int32 arg_LocalUserNum, bool arg_bWasSuccessful);
+
+	void Finish(bool arg_bWasSuccessful);
+
+private:
+	int32 LocalUserNum;
+	FDelegateHandle OnFriendsListReadHandle;
+};
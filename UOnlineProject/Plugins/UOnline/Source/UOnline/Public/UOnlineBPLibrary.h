@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "FindSessionsCallbackProxy.h"
+#include "UOnlineSessionFilter.h"
 #include "UOnlineBPLibrary.generated.h"
 
 /* 
@@ -29,4 +31,22 @@ class UUOnlineBPLibrary : public UBlueprintFunctionLibrary
 
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Execute Sample function", Keywords = "UOnline sample test testing"), Category = "UOnlineTesting")
 	static float UOnlineSampleFunction(float Param);
+
+	/**
+	* Adds a comparison of an integer session setting to a filter.
+	*/
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Add Integer Session Filter", Keywords = "UOnline search filter session"), Category = "UOnline|Search")
+	static FUOnlineSessionFilter AddIntSessionFilter(const FUOnlineSessionFilter& Filter, FName Key, EUOnlineSessionFilterOp Op, int32 Value, bool bLocalOnly);
+
+	/**
+	* Adds a comparison of a string session setting to a filter.
+	*/
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Add String Session Filter", Keywords = "UOnline search filter session"), Category = "UOnline|Search")
+	static FUOnlineSessionFilter AddStringSessionFilter(const FUOnlineSessionFilter& Filter, FName Key, EUOnlineSessionFilterOp Op, const FString& Value, bool bLocalOnly);
+
+	/**
+	* Keeps the sessions that meet every criterion of a filter, e.g. to narrow down results of the engine's Find Sessions node.
+	*/
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Filter Session Results", Keywords = "UOnline search filter session"), Category = "UOnline|Search")
+	static TArray<FBlueprintSessionResult> FilterSessionResults(const TArray<FBlueprintSessionResult>& Results, const FUOnlineSessionFilter& Filter);
 };
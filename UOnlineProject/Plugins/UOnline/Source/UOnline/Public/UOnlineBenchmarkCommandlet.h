@@ -0,0 +1,143 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UOnlineRequest.h"
+#include "UOnlineBenchmarkCommandlet.generated.h"
+
+class UOnlineObject;
+
+/**
+ * Headless benchmark of the session flow of UOnlineObject on the Null online subsystem, no network access needed.
+ *
+ * Measures the round trip of create and start, find, join, rematch and destroy one after another, then many creates, searches and
+ * destroys at the same time. Percentiles and throughput are written as JSON so CI can compare runs.
+ * Returns a non-zero exit code if any operation failed or timed out.
+ *
+ * UE4Editor-Cmd.exe UOnlineProject -run=UOnlineBenchmark -Iterations=50 -Concurrency=8 -Timeout=30 -Output=Benchmarks/UOnline.json
+ *
+ * With -StandIn sessions go to a FUOnlineStandInSession instead, with backend latencies, thousands of advertised sessions and
+ * the faults its options ask for, e.g. -StandIn -StandInLatency=0.1 -StandInFailureRate=0.05. See FUOnlineStandInOptions.
+ * The stand-in is not part of shipping builds.
+ */
+UCLASS()
+class UOnlineBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// UCommandlet interface
+	virtual int32 Main(const FString& arg_Params) override;
+
+private:
+	/**
+	* Outcome of one request, filled in by its completion delegate.
+	*/
+	struct FCompletion
+	{
+		FCompletion() : RequestId(0), bIsDone(false), bWasSuccessful(false), StartTime(FPlatformTime::Seconds()), EndTime(0.0) {}
+
+		int32 RequestId;
+		bool bIsDone;
+		bool bWasSuccessful;
+		double StartTime;
+		double EndTime;
+
+		// Copy of the search results, the ones in the request result are only valid during the callback
+		TArray<FOnlineSessionSearchResult> SearchResults;
+	};
+
+	/**
+	* Latencies of one kind of operation.
+	*/
+	struct FSamples
+	{
+		FSamples() : NumFailures(0) {}
+
+		TArray<double> Milliseconds;
+		int32 NumFailures;
+	};
+
+	/**
+	* Runs create, find, join, rematch and destroy one after another.
+	*/
+	void RunLifecycle();
+
+	/**
+	* Runs many creates, searches and destroys at the same time.
+	*/
+	void RunThroughput();
+
+	/**
+	* @param Completion: outcome to fill in.
+	* @returns a delegate that fills in the completion when the request finishes.
+	*/
+	static FOnUOnlineRequestComplete MakeCompletion(const TSharedRef<FCompletion>& arg_Completion);
+
+	/**
+	* Remembers the request of a completion and marks it as failed if the request was never queued.
+	*
+	* @param RequestId: id returned by UOnlineObject.
+	* @param Completion: outcome of the request.
+	*/
+	static void Track(int32 arg_RequestId, const TSharedRef<FCompletion>& arg_Completion);
+
+	/**
+	* Ticks until every completion is done or the timeout passed.
+	*
+	* @param Completions: requests to wait for.
+	* @returns true if every request finished in time.
+	*/
+	bool WaitFor(const TArray<TSharedRef<FCompletion>>& arg_Completions);
+
+	/**
+	* Pumps the core ticker and the game thread tasks once, this is what drives the subsystem and the request pipeline.
+	*/
+	void TickOnce();
+
+	/**
+	* Records the latency of a finished request, or a failure.
+	*
+	* @param Name: operation the request performed.
+	* @param Completion: outcome of the request.
+	*/
+	void AddSample(const FString& arg_Name, const FCompletion& arg_Completion);
+
+	/**
+	* Records the latency of every request of a phase and the number of successful requests per second.
+	*
+	* @param Name: name of the phase.
+	* @param Completions: requests started at the same time.
+	*/
+	void AddThroughput(const FString& arg_Name, const TArray<TSharedRef<FCompletion>>& arg_Completions);
+
+	/**
+	* Writes the collected samples and throughput as JSON.
+	*
+	* @param Filename: file to write to.
+	* @returns true if the file was written.
+	*/
+	bool WriteReport(const FString& arg_Filename) const;
+
+private:
+	UPROPERTY()
+	UOnlineObject* OnlineObject;
+
+	TSharedPtr<const FUniqueNetId> UserNetId;
+
+	FName SubsystemName;
+	int32 Iterations;
+	int32 Concurrency;
+	double Timeout;
+	double LastTickTime;
+
+	// Operation names in the order they were first recorded
+	TArray<FString> SampleNames;
+	TMap<FString, FSamples> Samples;
+
+	// Successful requests per second per throughput phase
+	TArray<FString> ThroughputNames;
+	TMap<FString, double> Throughput;
+};
@@ -0,0 +1,201 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystemTypes.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+
+/**
+ * What the cache keeps of a friend, enough to answer "is this my friend" and "what are they doing" without the subsystem.
+ */
+struct FUOnlineFriendEntry
+{
+	FUOnlineFriendEntry(const FOnlineFriend& arg_Friend)
+		: UserId(arg_Friend.GetUserId())
+		, DisplayName(arg_Friend.GetDisplayName())
+		, InviteStatus(arg_Friend.GetInviteStatus())
+		, Presence(arg_Friend.GetPresence())
+	{
+	}
+
+	TSharedRef<const FUniqueNetId> UserId;
+	FString DisplayName;
+	EInviteStatus::Type InviteStatus;
+	FOnlineUserPresence Presence;
+};
+
+typedef TSharedRef<const TArray<FUOnlineFriendEntry>, ESPMode::ThreadSafe> FUOnlineFriendsSnapshotRef;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineFriendsUpdated, int32 /*LocalUserNum*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnUOnlineFriendsListRead, int32 /*LocalUserNum*/, bool /*bWasSuccessful*/);
+
+/**
+ * Friends of every local user, indexed by unique net id.
+ * The cache is filled by a full read once and kept up to date with the changes the subsystem reports afterwards.
+ */
+class FUOnlineFriendsCache
+{
+public:
+	FUOnlineFriendsCache();
+
+	/**
+	* @param MaxFriendsPerUser: number of friends kept per local user, online friends are kept first.
+	*/
+	void SetMaxFriendsPerUser(int32 arg_MaxFriendsPerUser);
+
+	/**
+	* Remembers which unique net id belongs to a local user, so events that only carry the id can be routed.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param LocalUserId: unique net id of the local user.
+	*/
+	void SetLocalUserId(int32 arg_LocalUserNum, const FUniqueNetId& arg_LocalUserId);
+
+	/**
+	* @param LocalUserId: unique net id of a local user.
+	* @returns the controller number of the local user, INDEX_NONE if unknown.
+	*/
+	int32 FindLocalUserNum(const FUniqueNetId& arg_LocalUserId) const;
+
+	/**
+	* Replaces the friends of a local user with a complete list, only entries that differ are touched.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param Friends: complete friends list read from the subsystem.
+	* @returns true if anything changed.
+	*/
+	bool ApplyFriendsList(int32 arg_LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& arg_Friends);
+
+	/**
+	* Starts replacing the friends of a local user with a complete list, see ApplyFriendsList.
+	* The list is applied a slice at a time by ContinueFriendsList, so a long list never stalls a frame. A list that is still being applied is dropped.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param Friends: complete friends list read from the subsystem.
+	*/
+	void BeginFriendsList(int32 arg_LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& arg_Friends);
+
+	/**
+	* Applies the next slice of the list started by BeginFriendsList.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param MaxFriends: number of friends looked at in this slice.
+	* @param OutbHasChanged: receives whether anything changed over all slices, once the list is applied.
+	* @returns true once the list is applied completely, or if there is none.
+	*/
+	bool ContinueFriendsList(int32 arg_LocalUserNum, int32 arg_MaxFriends, bool& arg_OutbHasChanged);
+
+	/**
+	* Adds a friend or updates the entry of an existing one.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param Friend: the friend as known by the subsystem.
+	* @returns true if anything changed.
+	*/
+	bool UpdateFriend(int32 arg_LocalUserNum, const FOnlineFriend& arg_Friend);
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param FriendId: friend to remove.
+	* @returns true if the friend was removed.
+	*/
+	bool RemoveFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_FriendId);
+
+	/**
+	* Updates the presence of a user in the friends list of every local user that has them.
+	*
+	* @param UserId: user whose presence changed.
+	* @param Presence: new presence.
+	* @param OutLocalUserNums: receives the local users whose friends list changed.
+	*/
+	void UpdatePresence(const FUniqueNetId& arg_UserId, const FOnlineUserPresence& arg_Presence, TArray<int32>& arg_OutLocalUserNums);
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param UserId: user to look up.
+	* @returns the cached friend or nullptr. The pointer is only valid until the cache changes.
+	*/
+	const FUOnlineFriendEntry* FindFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const;
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param UserId: user to look up.
+	* @returns true if the user is a friend of the local user.
+	*/
+	bool IsFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const;
+
+	/**
+	* Immutable copy of the friends of a local user, rebuilt only after the list changed.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @returns the snapshot, empty if the local user has no friends list.
+	*/
+	FUOnlineFriendsSnapshotRef GetSnapshot(int32 arg_LocalUserNum) const;
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @returns the number of cached friends of the local user.
+	*/
+	int32 NumFriends(int32 arg_LocalUserNum) const;
+
+	/**
+	* Drops the friends of a local user, e.g. on logout.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	*/
+	void ResetUser(int32 arg_LocalUserNum);
+
+private:
+	// A complete list being applied, first its ids are collected, then friends that left are removed, then the others are added or updated
+	struct FPendingFriendsList
+	{
+		enum class EStep : uint8
+		{
+			CollectUserIds,
+			Remove,
+			AddOrUpdate
+		};
+
+		FPendingFriendsList() : Step(EStep::CollectUserIds), NextIndex(0), bHasChanged(false) {}
+
+		TArray<TSharedRef<FOnlineFriend>> Friends;
+		TSet<FString> UserIds;
+
+		EStep Step;
+
+		// Next friend to look at in the current step. The removal walks the cached friends backwards
+		int32 NextIndex;
+
+		bool bHasChanged;
+	};
+
+	struct FUserFriends
+	{
+		FUserFriends() : bIsSnapshotDirty(true) {}
+
+		FString LocalUserId;
+
+		TArray<FUOnlineFriendEntry> Friends;
+
+		// Index in Friends, keyed by the string form of the unique net id
+		TMap<FString, int32> IndexByUserId;
+
+		// Last snapshot handed out, only valid while bIsSnapshotDirty is false
+		TSharedPtr<const TArray<FUOnlineFriendEntry>, ESPMode::ThreadSafe> Snapshot;
+		bool bIsSnapshotDirty;
+
+		// List started by BeginFriendsList that is not fully applied yet
+		TSharedPtr<FPendingFriendsList> PendingList;
+	};
+
+	bool AddOrUpdate(FUserFriends& arg_UserFriends, const FOnlineFriend& arg_Friend);
+	bool RemoveAt(FUserFriends& arg_UserFriends, int32 arg_FriendIndex);
+
+	static bool IsSamePresence(const FOnlineUserPresence& arg_PresenceA, const FOnlineUserPresence& arg_PresenceB);
+
+private:
+	mutable TMap<int32, FUserFriends> Users;
+	int32 MaxFriendsPerUser;
+};
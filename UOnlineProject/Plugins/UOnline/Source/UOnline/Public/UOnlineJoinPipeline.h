@@ -0,0 +1,159 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+
+class APlayerController;
+
+/**
+ * Time spent in every stage between asking to join a session and starting travel, in milliseconds.
+ */
+struct FUOnlineJoinTimings
+{
+	FUOnlineJoinTimings() : ValidateInMs(0.0), LeaveInMs(0.0), JoinInMs(0.0), ResolveInMs(0.0), TotalInMs(0.0) {}
+
+	// Capacity check and connect string lookup before the join is sent
+	double ValidateInMs;
+
+	// Destroying a previous session of the same name before the join is queued, 0 if there was none
+	double LeaveInMs;
+
+	// From queueing the join until the subsystem answered
+	double JoinInMs;
+
+	// Resolving the connect string after the join, close to zero when it was prefetched
+	double ResolveInMs;
+
+	// From the call until travel was started or the join failed
+	double TotalInMs;
+};
+
+/**
+ * Outcome of a join that travels on success.
+ */
+struct FUOnlineJoinResult
+{
+	FUOnlineJoinResult()
+		: RequestId(0)
+		, SessionName(NAME_None)
+		, JoinResult(EOnJoinSessionCompleteResult::UnknownError)
+		, bHasTravelled(false)
+		, bWasPrefetched(false)
+	{
+	}
+
+	bool WasSuccessful() const
+	{
+		return JoinResult == EOnJoinSessionCompleteResult::Success && bHasTravelled;
+	}
+
+	// Id returned for the join, 0 if the join was refused before it was queued
+	int32 RequestId;
+	FName SessionName;
+	EOnJoinSessionCompleteResult::Type JoinResult;
+
+	// Address travelled to
+	FString ConnectString;
+
+	bool bHasTravelled;
+
+	// The connect string came from the prefetch cache
+	bool bWasPrefetched;
+
+	FUOnlineJoinTimings Timings;
+};
+
+DECLARE_DELEGATE_OneParam(FOnUOnlineJoinComplete, const FUOnlineJoinResult&);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineJoinFinished, const FUOnlineJoinResult&);
+
+/**
+ * Connect strings of search results resolved ahead of time, so travel can start as soon as a join succeeds.
+ */
+class FUOnlineConnectStringCache
+{
+public:
+	FUOnlineConnectStringCache();
+
+	/**
+	* @param TimeToLive: seconds a connect string is used before it's resolved again.
+	* @param MaxEntries: maximum number of cached connect strings.
+	*/
+	void SetLimits(double arg_TimeToLive, int32 arg_MaxEntries);
+
+	/**
+	* Resolves the connect strings of the sessions with the lowest ping that still have room.
+	*
+	* @param SessionInterface: interface used to resolve the connect strings.
+	* @param SearchResults: results of a search.
+	* @param MaxSessions: number of sessions to resolve.
+	* @param Now: current time in seconds.
+	* @returns the number of connect strings that were resolved.
+	*/
+	int32 Prefetch(const IOnlineSessionPtr& arg_SessionInterface, const TArray<FOnlineSessionSearchResult>& arg_SearchResults, int32 arg_MaxSessions, double arg_Now);
+
+	/**
+	* Resolves the connect strings of sessions picked by SelectCandidates.
+	*
+	* @param SessionInterface: interface used to resolve the connect strings.
+	* @param SearchResults: results of a search.
+	* @param CandidateIndices: indices in SearchResults of the sessions to resolve.
+	* @param Now: current time in seconds.
+	* @returns the number of connect strings that were resolved.
+	*/
+	int32 Prefetch(const IOnlineSessionPtr& arg_SessionInterface, const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const TArray<int32>& arg_CandidateIndices, double arg_Now);
+
+	/**
+	* Picks the sessions with the lowest ping that still have room. Only reads the results, so it can run on a worker thread.
+	*
+	* @param SearchResults: results of a search.
+	* @param MaxSessions: number of sessions to pick.
+	* @param OutCandidateIndices: receives the indices of the picked sessions, lowest ping first.
+	*/
+	static void SelectCandidates(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, int32 arg_MaxSessions, TArray<int32>& arg_OutCandidateIndices);
+
+	/**
+	* @param SearchResult: session to look up.
+	* @param Now: current time in seconds.
+	* @returns the connect string, or nullptr if it wasn't prefetched or is too old.
+	*/
+	const FString* Find(const FOnlineSessionSearchResult& arg_SearchResult, double arg_Now) const;
+
+	void Empty();
+
+private:
+	struct FEntry
+	{
+		FString ConnectString;
+		double ResolveTime;
+	};
+
+	// Connect strings by session id
+	TMap<FString, FEntry> Entries;
+
+	double TimeToLive;
+	int32 MaxEntries;
+};
+
+/**
+ * A join that travels once it succeeded, shared with the completion of its request.
+ */
+struct FUOnlineJoinTravel
+{
+	FUOnlineJoinTravel() : PendingRequestId(0), bIsFinished(false), StartTime(0.0), LeaveStartTime(0.0), JoinStartTime(0.0) {}
+
+	TWeakObjectPtr<APlayerController> PlayerController;
+	FOnUOnlineJoinComplete OnComplete;
+	FUOnlineJoinResult Result;
+
+	// Request the join waits for, the destroy of a previous session and then the join itself
+	int32 PendingRequestId;
+	bool bIsFinished;
+
+	double StartTime;
+	double LeaveStartTime;
+	double JoinStartTime;
+};
@@ -0,0 +1,360 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+
+class IUOnlineLanTransport;
+
+/**
+ * Session info of a session found by the LAN beacon, the session id and the address to travel to.
+ */
+class FUOnlineLanBeaconSessionInfo : public FOnlineSessionInfo
+{
+public:
+	FUOnlineLanBeaconSessionInfo(const FString& arg_SessionId, const FString& arg_ConnectString) : SessionId(arg_SessionId), ConnectString(arg_ConnectString) {}
+
+	// FOnlineSessionInfo interface
+	virtual const uint8* GetBytes() const override { return nullptr; }
+	virtual int32 GetSize() const override { return sizeof(FUOnlineLanBeaconSessionInfo); }
+	virtual bool IsValid() const override { return SessionId.IsValid(); }
+	virtual FString ToString() const override { return SessionId.ToString(); }
+	virtual FString ToDebugString() const override { return FString::Printf(TEXT("SessionId: %s ConnectString: %s"), *SessionId.ToDebugString(), *ConnectString); }
+	virtual const FUniqueNetId& GetSessionId() const override { return SessionId; }
+
+	const FString& GetConnectString() const { return ConnectString; }
+
+private:
+	FUniqueNetIdString SessionId;
+	FString ConnectString;
+};
+
+/**
+ * What the LAN beacon advertises about a session, only what the server browser shows and what joining needs.
+ */
+struct FUOnlineLanBeaconSession
+{
+	FUOnlineLanBeaconSession() : NumPlayers(0), MaxPlayers(0), Port(0), PingInMs(0), Sequence(0), LastSeenTime(0.0) {}
+
+	/**
+	* @param NamedSession: session hosted by this process.
+	* @param Port: port clients connect to.
+	* @returns the advertised part of the session.
+	*/
+	static FUOnlineLanBeaconSession FromNamedSession(const FNamedOnlineSession& arg_NamedSession, int32 arg_Port);
+
+	/**
+	* @returns a search result for the server browser, see FUOnlineServerBrowser::AddOrUpdate.
+	*/
+	FOnlineSessionSearchResult ToSearchResult() const;
+
+	/**
+	* @returns the address to travel to, host and port.
+	*/
+	FString GetConnectString() const;
+
+	FString SessionId;
+	FString OwnerName;
+	FString MapName;
+	FString GameMode;
+	int32 NumPlayers;
+	int32 MaxPlayers;
+	int32 Port;
+
+	// Known to clients only. Transport address the host answered from
+	FString HostAddress;
+	int32 PingInMs;
+
+	// Advertised state the client has, grows with every change of the host and keeps growing when it advertises again
+	uint32 Sequence;
+	double LastSeenTime;
+};
+
+struct FUOnlineLanBeaconOptions
+{
+	FUOnlineLanBeaconOptions()
+		: ProtocolId(0)
+		, MaxResponsesPerSecond(50.f)
+		, ResponseBurst(10)
+		, ResponseJitter(0.1f)
+		, MaxPendingResponses(64)
+		, MinAnnounceInterval(0.5f)
+		, ResponseTimeout(3.f)
+		, QueryInterval(5.f)
+		, RandomSeed(0)
+	{
+	}
+
+	// Beacons of another game or build ignore each other, e.g. the build unique id
+	uint32 ProtocolId;
+
+	// Hosts answer queries at this rate at most, with a burst of that many answers at once
+	float MaxResponsesPerSecond;
+	int32 ResponseBurst;
+
+	// Hosts wait up to this many seconds before answering, so hundreds of hosts don't answer the same query at once
+	float ResponseJitter;
+
+	// Queries a host keeps waiting for an answer. The ones above are dropped, the host answers the next query of those clients
+	int32 MaxPendingResponses;
+
+	// Changes a host makes within this many seconds go out as one announcement
+	float MinAnnounceInterval;
+
+	// Seconds clients wait for hosts to answer a query, hosts that didn't are gone
+	float ResponseTimeout;
+
+	// Seconds between the queries of a searching client. 0 queries once per Search, hosts that dropped that query are then only found
+	// once they announce a new session
+	float QueryInterval;
+
+	int32 RandomSeed;
+};
+
+/**
+ * Base of the LAN beacon host and client: a transport, a ticker and the compact binary packets both speak.
+ *
+ * Every packet starts with a 12 byte header: magic, version, type, protocol id and nonce. Sessions follow as a field mask and only the
+ * fields in it, with variable length integers and UTF-8 strings, a typical answer is well under 100 bytes. Fields added later get
+ * higher mask bits and go after the existing ones, so older beacons read what they know and skip the rest. The version only changes
+ * when packets can't be read that way anymore.
+ *
+ * The beacon runs next to the default one of the subsystem, sessions it advertises don't need bIsLANMatch. Only used from the game thread.
+ */
+class FUOnlineLanBeacon
+{
+public:
+	FUOnlineLanBeacon(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options);
+	virtual ~FUOnlineLanBeacon();
+
+	/**
+	* Updates the beacon from the core ticker.
+	*/
+	void Start();
+
+	void Stop();
+
+	/**
+	* Receives and sends what is due, called by the ticker or directly with a simulated time.
+	*
+	* @param Now: current time in seconds.
+	*/
+	virtual void Update(double arg_Now) = 0;
+
+	const FUOnlineLanBeaconOptions& GetOptions() const { return Options; }
+
+	int32 NumPacketsSent;
+	int32 NumPacketsReceived;
+
+	// Received packets that were malformed, of another version or of another protocol
+	int32 NumPacketsRejected;
+
+protected:
+	enum class EPacketType : uint8
+	{
+		Query = 1,
+		Response = 2,
+		Announce = 3,
+		Withdraw = 4
+	};
+
+	/**
+	* Fields of a session in a packet.
+	*/
+	enum ESessionField : uint8
+	{
+		Field_OwnerName = 1 << 0,
+		Field_MapName = 1 << 1,
+		Field_GameMode = 1 << 2,
+		Field_NumPlayers = 1 << 3,
+		Field_MaxPlayers = 1 << 4,
+		Field_Port = 1 << 5,
+
+		Field_All = Field_OwnerName | Field_MapName | Field_GameMode | Field_NumPlayers | Field_MaxPlayers | Field_Port
+	};
+
+	/**
+	* @returns the fields that differ between two sessions.
+	*/
+	static uint8 DiffFields(const FUOnlineLanBeaconSession& arg_A, const FUOnlineLanBeaconSession& arg_B);
+
+	/**
+	* Copies the fields in the mask from one session to another.
+	*/
+	static void CopyFields(FUOnlineLanBeaconSession& arg_To, const FUOnlineLanBeaconSession& arg_From, uint8 arg_Fields);
+
+	void WriteHeader(TArray<uint8>& arg_OutPacket, EPacketType arg_Type, uint32 arg_Nonce) const;
+
+	/**
+	* Writes the session id, the sequence, the field mask and the fields in it.
+	*/
+	static void WriteSession(TArray<uint8>& arg_OutPacket, const FUOnlineLanBeaconSession& arg_Session, uint8 arg_Fields);
+
+	/**
+	* @param Packet: received packet.
+	* @param OutType: receives the type.
+	* @param OutNonce: receives the nonce.
+	* @param OutOffset: receives where the body starts.
+	* @returns false if the packet isn't one of this protocol and version.
+	*/
+	bool ReadHeader(const TArray<uint8>& arg_Packet, EPacketType& arg_OutType, uint32& arg_OutNonce, int32& arg_OutOffset) const;
+
+	/**
+	* Reads a session written by WriteSession, only the fields in the mask are changed.
+	*
+	* @returns false if the packet is malformed.
+	*/
+	static bool ReadSession(const TArray<uint8>& arg_Packet, int32& arg_InOutOffset, FUOnlineLanBeaconSession& arg_OutSession, uint8& arg_OutFields);
+
+	void Broadcast(const TArray<uint8>& arg_Packet);
+	void SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet);
+
+	/**
+	* @returns the header of the next valid packet, false once no packet is waiting.
+	*/
+	bool ReceiveNext(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress, EPacketType& arg_OutType, uint32& arg_OutNonce, int32& arg_OutOffset);
+
+protected:
+	TSharedRef<IUOnlineLanTransport> Transport;
+	FUOnlineLanBeaconOptions Options;
+	FRandomStream Random;
+
+private:
+	bool Tick(float arg_DeltaTime);
+
+private:
+	FDelegateHandle TickerHandle;
+};
+
+/**
+ * Advertises one hosted session on the LAN.
+ *
+ * Answers are held back by a random jitter and rate limited, a query that comes again from the same address while its answer waits
+ * doesn't cost another one. Changes are announced to every client as soon as the announce interval allows, with only the fields that changed.
+ */
+class FUOnlineLanBeaconHost : public FUOnlineLanBeacon
+{
+public:
+	FUOnlineLanBeaconHost(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options = FUOnlineLanBeaconOptions());
+	virtual ~FUOnlineLanBeaconHost();
+
+	/**
+	* Starts advertising a session, or announces what changed about it.
+	*
+	* @param Session: session to advertise, the client side fields are ignored.
+	*/
+	void Advertise(const FUOnlineLanBeaconSession& arg_Session);
+
+	/**
+	* Tells the clients the session is gone and stops answering.
+	*/
+	void StopAdvertising();
+
+	bool IsAdvertising() const { return bIsAdvertising; }
+
+	// FUOnlineLanBeacon interface
+	virtual void Update(double arg_Now) override;
+
+	int32 NumResponses;
+	int32 NumAnnouncements;
+
+	// Queries dropped because too many answers were waiting
+	int32 NumQueriesDropped;
+
+private:
+	struct FPendingResponse
+	{
+		FString Address;
+		uint32 Nonce;
+		double ReceiveTime;
+		double SendTime;
+	};
+
+	void ReceiveQueries(double arg_Now);
+	void SendResponses(double arg_Now);
+	void SendAnnouncement(double arg_Now);
+
+private:
+	FUOnlineLanBeaconSession Session;
+	bool bIsAdvertising;
+
+	// Fields changed since the last announcement, and the sequence clients must have to apply it
+	uint8 PendingAnnounceFields;
+	uint32 AnnounceBaseSequence;
+	double LastAnnounceTime;
+
+	// By send time, oldest first
+	TArray<FPendingResponse> PendingResponses;
+
+	// Answers that may be sent right now, refilled at MaxResponsesPerSecond
+	float ResponseTokens;
+	double LastUpdateTime;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineLanSessionChanged, const FUOnlineLanBeaconSession& /*Session*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineLanSessionLost, const FString& /*SessionId*/);
+
+/**
+ * Finds the sessions hosts advertise on the LAN and keeps them up to date with their announcements.
+ * Feed a FUOnlineServerBrowser with OnSessionFound and OnSessionUpdated through ToSearchResult, and OnSessionLost through Remove.
+ * Join by traveling to the connect string of a session, it has no session info of the subsystem to join it with.
+ */
+class FUOnlineLanBeaconClient : public FUOnlineLanBeacon
+{
+public:
+	FUOnlineLanBeaconClient(const TSharedRef<IUOnlineLanTransport>& arg_Transport, const FUOnlineLanBeaconOptions& arg_Options = FUOnlineLanBeaconOptions());
+
+	/**
+	* Queries every host, again every QueryInterval if set.
+	*/
+	void Search();
+
+	void StopSearching();
+
+	bool IsSearching() const { return bIsSearching; }
+
+	const TMap<FString, FUOnlineLanBeaconSession>& GetSessions() const { return Sessions; }
+
+	// FUOnlineLanBeacon interface
+	virtual void Update(double arg_Now) override;
+
+public:
+	FOnUOnlineLanSessionChanged OnSessionFound;
+	FOnUOnlineLanSessionChanged OnSessionUpdated;
+	FOnUOnlineLanSessionLost OnSessionLost;
+
+private:
+	/**
+	* @param Address: address to query, empty for every host.
+	* @param Now: current time in seconds.
+	*/
+	void SendQuery(const FString& arg_Address, double arg_Now);
+
+	void OnResponse(const TArray<uint8>& arg_Packet, int32 arg_Offset, const FString& arg_Address, uint32 arg_Nonce, double arg_Now);
+	void OnAnnouncement(const TArray<uint8>& arg_Packet, int32 arg_Offset, const FString& arg_Address, double arg_Now);
+	void OnWithdraw(const TArray<uint8>& arg_Packet, int32 arg_Offset);
+
+	/**
+	* Drops the sessions whose host didn't answer the last query in time.
+	*/
+	void ExpireSessions(double arg_Now);
+
+private:
+	TMap<FString, FUOnlineLanBeaconSession> Sessions;
+
+	bool bIsSearching;
+
+	// A search was asked for and goes out with the next update
+	bool bHasPendingSearch;
+
+	double LastBroadcastTime;
+
+	// Hosts that don't answer the last broadcast query in time are dropped
+	bool bHasPendingExpiry;
+
+	// Time every query still waiting for answers was sent, by nonce
+	TMap<uint32, double> QueryTimes;
+};
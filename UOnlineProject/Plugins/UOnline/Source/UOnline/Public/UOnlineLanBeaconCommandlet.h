@@ -0,0 +1,45 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UOnlineLanBeacon.h"
+#include "UOnlineLanBeaconCommandlet.generated.h"
+
+/**
+ * Runs many LAN beacon hosts and clients in one process over a FUOnlineLanLoopbackNetwork, in simulated time.
+ *
+ * Every client searches once every host is up, hosts keep changing their player count while the clients listen. Reports how long the
+ * clients took to find every host, the packets and bytes that went over the network and how many sessions the clients still had wrong
+ * once the changes stopped, as JSON. Without packet loss, returns a non-zero exit code if a client missed a host or kept a stale session.
+ *
+ * UE4Editor-Cmd.exe UOnlineProject -run=UOnlineLanBeacon -Hosts=500 -Clients=8 -Duration=30 -ChangeRate=0.2 -LossRate=0.01
+ *
+ * Beacon options go on the same command line, e.g. -MaxResponsesPerSecond=20 -ResponseJitter=0.2 -QueryInterval=5.
+ */
+UCLASS()
+class UOnlineLanBeaconCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// UCommandlet interface
+	virtual int32 Main(const FString& arg_Params) override;
+
+private:
+	int32 NumHosts;
+	int32 NumClients;
+
+	// Simulated seconds hosts change their sessions, then SettleTime more without changes for the clients to catch up
+	float Duration;
+	float SettleTime;
+	float TickInterval;
+
+	// Changes per host and simulated second
+	float ChangeRate;
+
+	float LossRate;
+
+	FUOnlineLanBeaconOptions BeaconOptions;
+};
@@ -0,0 +1,135 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+class FSocket;
+class FInternetAddr;
+class FUOnlineLanLoopbackEndpoint;
+
+/**
+ * Moves the datagrams of the LAN beacon, see FUOnlineLanBeacon.
+ * Addresses are opaque strings, a beacon only sends to addresses it received from.
+ */
+class IUOnlineLanTransport
+{
+public:
+	virtual ~IUOnlineLanTransport() {}
+
+	/**
+	* Sends a packet to every beacon of the other side, hosts broadcast to clients and clients to hosts.
+	*
+	* @param Packet: packet to send.
+	* @returns false if the packet could not be sent.
+	*/
+	virtual bool Broadcast(const TArray<uint8>& arg_Packet) = 0;
+
+	/**
+	* @param Address: address a packet was received from.
+	* @param Packet: packet to send.
+	* @returns false if the packet could not be sent.
+	*/
+	virtual bool SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet) = 0;
+
+	/**
+	* Takes the next received packet, never blocks.
+	*
+	* @param OutPacket: receives the packet.
+	* @param OutAddress: receives the address of the sender.
+	* @returns false if no packet is waiting.
+	*/
+	virtual bool Receive(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress) = 0;
+};
+
+/**
+ * UDP broadcast on the local network. Hosts listen on the beacon port and clients on the port after it, so hosts and clients
+ * on the same machine each get the broadcasts meant for them.
+ */
+class FUOnlineLanSocketTransport : public IUOnlineLanTransport
+{
+public:
+	/**
+	* @param ListenPort: port packets are received on.
+	* @param BroadcastPort: port broadcasts are sent to.
+	*/
+	FUOnlineLanSocketTransport(int32 arg_ListenPort, int32 arg_BroadcastPort);
+	virtual ~FUOnlineLanSocketTransport();
+
+	/**
+	* @returns a transport for a host, nullptr if its socket could not be opened.
+	*/
+	static TSharedPtr<IUOnlineLanTransport> CreateHost(int32 arg_BeaconPort = DefaultBeaconPort);
+
+	/**
+	* @returns a transport for a client, nullptr if its socket could not be opened.
+	*/
+	static TSharedPtr<IUOnlineLanTransport> CreateClient(int32 arg_BeaconPort = DefaultBeaconPort);
+
+	bool IsValid() const { return Socket != nullptr; }
+
+	// IUOnlineLanTransport interface
+	virtual bool Broadcast(const TArray<uint8>& arg_Packet) override;
+	virtual bool SendTo(const FString& arg_Address, const TArray<uint8>& arg_Packet) override;
+	virtual bool Receive(TArray<uint8>& arg_OutPacket, FString& arg_OutAddress) override;
+
+	// Not the port of the default beacon, both can run side by side
+	static const int32 DefaultBeaconPort = 14011;
+
+private:
+	bool Send(const FInternetAddr& arg_Address, const TArray<uint8>& arg_Packet);
+
+private:
+	FSocket* Socket;
+	TSharedPtr<FInternetAddr> BroadcastAddress;
+};
+
+/**
+ * A LAN in memory, for tests with many hosts and clients in one process. Packets are delivered on the next receive,
+ * in the order they were sent, and can be lost at random.
+ */
+class FUOnlineLanLoopbackNetwork : public TSharedFromThis<FUOnlineLanLoopbackNetwork>
+{
+public:
+	/**
+	* @param LossRate: share of the packets that are lost, per receiver.
+	* @param RandomSeed: seed of the losses.
+	*/
+	explicit FUOnlineLanLoopbackNetwork(float arg_LossRate = 0.f, int32 arg_RandomSeed = 0);
+
+	/**
+	* @param bIsHost: true for the transport of a host, false for a client.
+	* @returns a transport on this network, it stays on it for as long as it exists.
+	*/
+	TSharedRef<IUOnlineLanTransport> CreateEndpoint(bool arg_bIsHost);
+
+	// Packets sent, a broadcast counts once
+	int32 NumPacketsSent;
+	int64 NumBytesSent;
+
+	// Packets that arrived, a broadcast counts once per receiver
+	int32 NumPacketsDelivered;
+	int32 NumPacketsLost;
+
+private:
+	friend class FUOnlineLanLoopbackEndpoint;
+
+	void Broadcast(const FUOnlineLanLoopbackEndpoint& arg_From, const TArray<uint8>& arg_Packet);
+	bool SendTo(const FUOnlineLanLoopbackEndpoint& arg_From, const FString& arg_Address, const TArray<uint8>& arg_Packet);
+
+	/**
+	* Queues a packet on an endpoint unless it gets lost.
+	*/
+	void Deliver(FUOnlineLanLoopbackEndpoint& arg_To, const FString& arg_FromAddress, const TArray<uint8>& arg_Packet);
+
+	void AddEndpoint(FUOnlineLanLoopbackEndpoint& arg_Endpoint);
+	void RemoveEndpoint(FUOnlineLanLoopbackEndpoint& arg_Endpoint);
+
+private:
+	float LossRate;
+	FRandomStream Random;
+
+	// Index is the address of the endpoint
+	TSparseArray<FUOnlineLanLoopbackEndpoint*> Endpoints;
+};
@@ -0,0 +1,192 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "UOnlineLobbyComponent.generated.h"
+
+class UOnlineLobbyComponent;
+struct FUOnlineLobbyRoster;
+
+/**
+ * A player in the lobby roster.
+ */
+USTRUCT(BlueprintType)
+struct FUOnlineLobbyMember : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FUOnlineLobbyMember() : bIsReady(false), Team(0) {}
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Lobby")
+	FUniqueNetIdRepl UserId;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Lobby")
+	FString DisplayName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Lobby")
+	bool bIsReady;
+
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Lobby")
+	uint8 Team;
+
+	// Items the player picked, meaning is up to the game
+	UPROPERTY(BlueprintReadOnly, Category = "UOnline|Lobby")
+	TArray<FName> Loadout;
+
+	// FFastArraySerializerItem interface, called on clients
+	void PreReplicatedRemove(const FUOnlineLobbyRoster& arg_Roster);
+	void PostReplicatedAdd(const FUOnlineLobbyRoster& arg_Roster);
+	void PostReplicatedChange(const FUOnlineLobbyRoster& arg_Roster);
+};
+
+/**
+ * The members of a lobby, delta replicated. Only members that were marked dirty are sent, so a change costs the same in a lobby of 64 as in a lobby of 2.
+ */
+USTRUCT()
+struct FUOnlineLobbyRoster : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FUOnlineLobbyRoster() : OwnerComponent(nullptr) {}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& arg_DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FUOnlineLobbyMember, FUOnlineLobbyRoster>(Members, arg_DeltaParms, *this);
+	}
+
+	UPROPERTY()
+	TArray<FUOnlineLobbyMember> Members;
+
+	// Component the roster belongs to, receives the change callbacks
+	UOnlineLobbyComponent* OwnerComponent;
+};
+
+template<>
+struct TStructOpsTypeTraits<FUOnlineLobbyRoster> : public TStructOpsTypeTraitsBase2<FUOnlineLobbyRoster>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUOnlineLobbyMemberEvent, const FUOnlineLobbyMember&, Member);
+
+/**
+ * Lobby or party roster for a replicated actor, usually the game state.
+ *
+ * The server adds players as they register with the session and removes them when they unregister, games that don't register
+ * players can call AddMember and RemoveMember themselves. Setters only mark a member dirty when a value actually changed.
+ * Both the server and the clients are told about every added, changed and removed member.
+ */
+UCLASS(ClassGroup = (UOnline), meta = (BlueprintSpawnableComponent))
+class UOnlineLobbyComponent : public UActorComponent
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type arg_EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	* Adds a player, or updates the display name of a player that is in the roster already. Server only.
+	*
+	* @returns true if the roster changed.
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "UOnline|Lobby")
+	bool AddMember(const FUniqueNetIdRepl& UserId, const FString& DisplayName);
+
+	/**
+	* Server only.
+	*
+	* @returns true if the player was in the roster.
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "UOnline|Lobby")
+	bool RemoveMember(const FUniqueNetIdRepl& UserId);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "UOnline|Lobby")
+	bool SetReady(const FUniqueNetIdRepl& UserId, bool bIsReady);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "UOnline|Lobby")
+	bool SetTeam(const FUniqueNetIdRepl& UserId, uint8 Team);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "UOnline|Lobby")
+	bool SetLoadout(const FUniqueNetIdRepl& UserId, const TArray<FName>& Loadout);
+
+	UFUNCTION(BlueprintPure, Category = "UOnline|Lobby")
+	const TArray<FUOnlineLobbyMember>& GetMembers() const { return Roster.Members; }
+
+	/**
+	* @param UserId: player to look up.
+	* @param OutMember: receives the member.
+	* @returns true if the player is in the roster.
+	*/
+	UFUNCTION(BlueprintPure, Category = "UOnline|Lobby")
+	bool FindMember(const FUniqueNetIdRepl& UserId, FUOnlineLobbyMember& OutMember) const;
+
+	/**
+	* @returns true if the roster isn't empty and every member is ready.
+	*/
+	UFUNCTION(BlueprintPure, Category = "UOnline|Lobby")
+	bool AreAllMembersReady() const;
+
+	// Called from the roster as it replicates
+	void NotifyMemberAdded(const FUOnlineLobbyMember& arg_Member) { OnMemberAdded.Broadcast(arg_Member); }
+	void NotifyMemberChanged(const FUOnlineLobbyMember& arg_Member) { OnMemberChanged.Broadcast(arg_Member); }
+	void NotifyMemberRemoved(const FUOnlineLobbyMember& arg_Member) { OnMemberRemoved.Broadcast(arg_Member); }
+
+public:
+	UPROPERTY(BlueprintAssignable, Category = "UOnline|Lobby")
+	FOnUOnlineLobbyMemberEvent OnMemberAdded;
+
+	UPROPERTY(BlueprintAssignable, Category = "UOnline|Lobby")
+	FOnUOnlineLobbyMemberEvent OnMemberChanged;
+
+	// Called before the member is gone
+	UPROPERTY(BlueprintAssignable, Category = "UOnline|Lobby")
+	FOnUOnlineLobbyMemberEvent OnMemberRemoved;
+
+	// Session whose registered players make up the roster
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UOnline|Lobby")
+	FName SessionName;
+
+	// Online subsystem of the session, NAME_None for the default one
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UOnline|Lobby")
+	FName OnlineSubsystemName;
+
+private:
+	/**
+	* @returns the index of the member, INDEX_NONE if the player isn't in the roster.
+	*/
+	int32 FindMemberIndex(const FUniqueNetIdRepl& arg_UserId) const;
+
+	/**
+	* Sends a changed member with the next update and tells the server side listeners.
+	*/
+	void MarkMemberDirty(int32 arg_MemberIndex);
+
+	/**
+	* @returns the name of the player in the game state, empty if the player has no player state yet.
+	*/
+	FString FindPlayerName(const FUniqueNetId& arg_UserId) const;
+
+	void OnRegisterPlayersComplete(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasSuccessful);
+	void OnUnregisterPlayersComplete(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasSuccessful);
+
+private:
+	UPROPERTY(Replicated)
+	FUOnlineLobbyRoster Roster;
+
+	// Session interface the delegates are registered with
+	TWeakPtr<IOnlineSession, ESPMode::ThreadSafe> BoundSessionInterface;
+
+	FDelegateHandle OnRegisterPlayersCompleteDelegateHandle;
+	FDelegateHandle OnUnregisterPlayersCompleteDelegateHandle;
+};
@@ -0,0 +1,40 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineRequest.h"
+#include "UOnlineSessionCache.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineLocalUserInvite, int32 /*LocalUserNum*/);
+
+/**
+ * What one local user of a split-screen game does online: the query their session browser shows and the invite they accepted.
+ * Their friends are kept by FUOnlineFriendsCache, which is per local user already.
+ */
+struct FUOnlineLocalUserState
+{
+	FUOnlineLocalUserState()
+		: LocalUserNum(INDEX_NONE)
+		, bHasSearched(false)
+		, SearchRequestId(FUOnlineRequest::InvalidId)
+		, bIsInvitePending(false)
+		, InviteRequestId(FUOnlineRequest::InvalidId)
+	{
+	}
+
+	int32 LocalUserNum;
+	TSharedPtr<const FUniqueNetId> UserNetId;
+
+	// Last query of the user's session browser. Users with the same query share one request and one cached snapshot
+	bool bHasSearched;
+	FUOnlineSessionQueryKey SearchQueryKey;
+	int32 SearchRequestId;
+
+	// Last accepted invite. It is pending while the game decides whether the other local users leave their session for it,
+	// otherwise InviteRequestId is the join that follows it
+	FOnlineSessionSearchResult Invite;
+	bool bIsInvitePending;
+	int32 InviteRequestId;
+};
@@ -0,0 +1,307 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UOnlineObject;
+
+struct FUOnlineMatchmakingOptions
+{
+	FUOnlineMatchmakingOptions()
+		: PlayersPerMatch(8)
+		, SkillBucketWidth(100.f)
+		, WideningInterval(10.f)
+		, MaxSkillWidening(3)
+		, MaxTicketsPerTick(4096)
+		, TicketTimeout(300.f)
+	{
+	}
+
+	int32 PlayersPerMatch;
+
+	// Players whose skill falls in the same bucket of this width are matched first
+	float SkillBucketWidth;
+
+	// Seconds a ticket waits before it also matches with the next skill bucket on either side, up to MaxSkillWidening buckets away
+	float WideningInterval;
+	int32 MaxSkillWidening;
+
+	// Queued tickets a tick looks at, bounds the cost of a tick whatever the size of the queue
+	int32 MaxTicketsPerTick;
+
+	// Seconds before a ticket that found no match is dropped, 0 to keep it forever
+	float TicketTimeout;
+};
+
+/**
+ * A player waiting for a match.
+ */
+struct FUOnlineMatchmakingTicket
+{
+	FUOnlineMatchmakingTicket() : Id(0), Skill(0.f), EnqueueTime(0.0) {}
+
+	int32 Id;
+	TSharedPtr<const FUniqueNetId> PlayerId;
+	FName Region;
+	float Skill;
+	double EnqueueTime;
+};
+
+/**
+ * Players that go into the same session, either a new match or the open slots of a running one.
+ */
+struct FUOnlineMatch
+{
+	FUOnlineMatch() : Skill(0.f), bIsBackfill(false) {}
+
+	// Session the players join, NAME_None for a new match the caller still has to host
+	FName SessionName;
+
+	FName Region;
+
+	// Average skill of the players
+	float Skill;
+
+	bool bIsBackfill;
+
+	TArray<FUOnlineMatchmakingTicket> Tickets;
+};
+
+/**
+ * Matchmaking queue. Tickets are bucketed by region and skill, every bucket is a queue in arrival order.
+ * A tick backfills the open slots of running sessions first, then forms new matches going round the buckets, and stops
+ * once it looked at MaxTicketsPerTick tickets so tens of thousands of queued tickets cost no more than a few hundred.
+ * Only matches players of the same region. Doesn't know about online subsystems, see FUOnlineMatchmakingService.
+ */
+class FUOnlineMatchmaker
+{
+public:
+	explicit FUOnlineMatchmaker(const FUOnlineMatchmakingOptions& arg_Options = FUOnlineMatchmakingOptions());
+
+	const FUOnlineMatchmakingOptions& GetOptions() const { return Options; }
+
+	/**
+	* @param PlayerId: player the ticket is for.
+	* @param Region: region the player wants to play in.
+	* @param Skill: skill rating of the player.
+	* @param Now: current time in seconds.
+	* @returns the id of the ticket.
+	*/
+	int32 Enqueue(const TSharedPtr<const FUniqueNetId>& arg_PlayerId, FName arg_Region, float arg_Skill, double arg_Now);
+
+	/**
+	* @returns true if the ticket was queued.
+	*/
+	bool Cancel(int32 arg_TicketId);
+
+	/**
+	* Puts a ticket that was taken out of the queue back in, with its id and the time it was first queued.
+	*
+	* @param Ticket: ticket of a match that could not be hosted.
+	* @returns false if the ticket is still queued.
+	*/
+	bool Requeue(const FUOnlineMatchmakingTicket& arg_Ticket);
+
+	const FUOnlineMatchmakingTicket* FindTicket(int32 arg_TicketId) const { return Tickets.Find(arg_TicketId); }
+
+	/**
+	* Adds or updates a running session whose open slots are filled with queued players of its region and skill.
+	*
+	* @param SessionName: name of the session.
+	* @param Region: region of the session.
+	* @param Skill: skill the players of the session have on average.
+	* @param NumOpenSlots: number of players the session still takes.
+	*/
+	void SetBackfillSession(FName arg_SessionName, FName arg_Region, float arg_Skill, int32 arg_NumOpenSlots);
+
+	void RemoveBackfillSession(FName arg_SessionName);
+
+	/**
+	* @param SessionName: name of a backfilled session.
+	* @param NumSlots: number of slots that opened, negative for slots that were taken outside of the queue.
+	* @returns false if the session isn't backfilled.
+	*/
+	bool AddOpenSlots(FName arg_SessionName, int32 arg_NumSlots);
+
+	/**
+	* @returns the open slots of a backfilled session, 0 if the session isn't backfilled.
+	*/
+	int32 GetNumOpenSlots(FName arg_SessionName) const;
+
+	/**
+	* Drops tickets that waited too long, backfills running sessions, then forms new matches.
+	*
+	* @param Now: current time in seconds.
+	* @param MaxNewMatches: number of new matches that may be formed, e.g. the sessions that are ready to host them.
+	* @param OutMatches: receives the backfills and the new matches.
+	* @param OutTimedOutTickets: receives the tickets that were dropped.
+	*/
+	void Tick(double arg_Now, int32 arg_MaxNewMatches, TArray<FUOnlineMatch>& arg_OutMatches, TArray<FUOnlineMatchmakingTicket>& arg_OutTimedOutTickets);
+
+	int32 NumQueued() const { return Tickets.Num(); }
+	int32 NumBuckets() const { return Buckets.Num(); }
+	int32 NumBackfillSessions() const { return BackfillSessions.Num(); }
+
+private:
+	struct FBucketKey
+	{
+		FBucketKey() : SkillBucket(0) {}
+		FBucketKey(FName arg_Region, int32 arg_SkillBucket) : Region(arg_Region), SkillBucket(arg_SkillBucket) {}
+
+		bool operator==(const FBucketKey& arg_Other) const { return Region == arg_Other.Region && SkillBucket == arg_Other.SkillBucket; }
+
+		friend uint32 GetTypeHash(const FBucketKey& arg_Key) { return HashCombine(GetTypeHash(arg_Key.Region), GetTypeHash(arg_Key.SkillBucket)); }
+
+		FName Region;
+		int32 SkillBucket;
+	};
+
+	struct FBucket
+	{
+		FBucket() : Head(0), NumQueued(0) {}
+
+		// In arrival order. Ids of tickets that left the queue stay until the head passes them
+		TArray<int32> TicketIds;
+		int32 Head;
+
+		int32 NumQueued;
+	};
+
+	struct FBackfillSession
+	{
+		FBucketKey Key;
+		float Skill;
+		int32 NumOpenSlots;
+	};
+
+	FBucketKey MakeKey(FName arg_Region, float arg_Skill) const;
+
+	/**
+	* @returns how many skill buckets away from its own a ticket may be matched.
+	*/
+	int32 GetWidening(const FUOnlineMatchmakingTicket& arg_Ticket, double arg_Now) const;
+
+	/**
+	* @returns the number of tickets queued in a bucket and the buckets around it that widening can reach.
+	*/
+	int32 CountReachable(const FBucketKey& arg_Center) const;
+
+	/**
+	* Picks tickets for a match in a bucket, from the bucket itself first and then the buckets next to it, oldest first.
+	* Tickets from another bucket must have waited long enough to reach this one. Nothing leaves the queue.
+	*
+	* @param Center: bucket of the match.
+	* @param NumWanted: number of tickets wanted.
+	* @param Now: current time in seconds.
+	* @param InOutBudget: tickets that may still be looked at this tick, decreased by every ticket looked at.
+	* @param OutTicketIds: receives the picked tickets.
+	*/
+	void PeekTickets(const FBucketKey& arg_Center, int32 arg_NumWanted, double arg_Now, int32& arg_InOutBudget, TArray<int32>& arg_OutTicketIds) const;
+
+	/**
+	* Moves picked tickets out of the queue into a match.
+	*/
+	void TakeTickets(const TArray<int32>& arg_TicketIds, FUOnlineMatch& arg_OutMatch);
+
+	/**
+	* Queues a ticket in arrival order among the others of its bucket.
+	*
+	* @param Ticket: ticket to queue.
+	* @param bIsRequeued: the ticket was queued before, so its old id may still be in the bucket.
+	*/
+	void AddTicket(const FUOnlineMatchmakingTicket& arg_Ticket, bool arg_bIsRequeued);
+
+	/**
+	* Removes a ticket from the queue.
+	*
+	* @param TicketId: ticket to remove.
+	* @param OutTicket: receives the ticket, can be nullptr.
+	* @returns true if the ticket was queued.
+	*/
+	bool RemoveTicket(int32 arg_TicketId, FUOnlineMatchmakingTicket* arg_OutTicket);
+
+	/**
+	* Drops the ids of tickets that left the queue from the front of a bucket.
+	*/
+	static void TrimBucket(FBucket& arg_Bucket, const TMap<int32, FUOnlineMatchmakingTicket>& arg_Tickets);
+
+private:
+	FUOnlineMatchmakingOptions Options;
+
+	TMap<int32, FUOnlineMatchmakingTicket> Tickets;
+
+	TMap<FBucketKey, FBucket> Buckets;
+
+	// Buckets in the order new matches are looked for, a tick starts where the previous one stopped
+	TArray<FBucketKey> BucketOrder;
+	int32 NextBucketIndex;
+
+	TMap<FName, FBackfillSession> BackfillSessions;
+
+	int32 NextTicketId;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineMatchFound, const FUOnlineMatch& /*Match*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineMatchmakingTicketTimedOut, const FUOnlineMatchmakingTicket& /*Ticket*/);
+
+/**
+ * Server side matchmaking on the sessions a UOnlineObject hosts with HostSessions.
+ *
+ * Every tick interval the queue forms as many new matches as there are hosted sessions available, each takes one with
+ * AcquireHostedSession. Sessions that allow joining in progress are backfilled until their public connections are full.
+ * OnMatchFound tells the game which players go to which session, getting them there (e.g. JoinSession on the client) is up to the game.
+ * Only used from the game thread.
+ */
+class FUOnlineMatchmakingService
+{
+public:
+	explicit FUOnlineMatchmakingService(const FUOnlineMatchmakingOptions& arg_Options = FUOnlineMatchmakingOptions());
+	~FUOnlineMatchmakingService();
+
+	/**
+	* @param OnlineObject: object hosting the sessions.
+	* @param TickInterval: seconds between two ticks of the queue.
+	*/
+	void Start(UOnlineObject* arg_OnlineObject, float arg_TickInterval = 1.f);
+
+	void Stop();
+
+	int32 Enqueue(const TSharedPtr<const FUniqueNetId>& arg_PlayerId, FName arg_Region, float arg_Skill);
+	bool Cancel(int32 arg_TicketId) { return Matchmaker.Cancel(arg_TicketId); }
+
+	/**
+	* A player left a session, the slot is backfilled.
+	*
+	* @returns false if the session isn't backfilled.
+	*/
+	bool NotifyPlayerLeft(FName arg_SessionName);
+
+	/**
+	* A match is over. The session is no longer backfilled and goes back to the hosted sessions.
+	*
+	* @param SessionName: session of the match.
+	* @param NextSessionSettings: settings for the next match, nullptr to keep the current ones.
+	* @returns true if the session was handed back.
+	*/
+	bool EndMatch(FName arg_SessionName, const FOnlineSessionSettings* arg_NextSessionSettings = nullptr);
+
+	const FUOnlineMatchmaker& GetMatchmaker() const { return Matchmaker; }
+
+public:
+	FOnUOnlineMatchFound OnMatchFound;
+	FOnUOnlineMatchmakingTicketTimedOut OnTicketTimedOut;
+
+private:
+	bool Tick(float arg_DeltaTime);
+
+private:
+	FUOnlineMatchmaker Matchmaker;
+
+	TWeakObjectPtr<UOnlineObject> OnlineObject;
+
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,116 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UOnlineMatchmaker.h"
+#include "UOnlineMatchmakingCommandlet.generated.h"
+
+/**
+ * Runs FUOnlineMatchmaker against simulated players in simulated time, no online subsystem needed.
+ *
+ * Players arrive at a fixed rate in random regions with normally distributed skill, matches run for a while and lose players
+ * that get backfilled. Reports wait times, timeouts, the skill spread of matches and the wall time every tick of the queue took
+ * as JSON. Returns a non-zero exit code if -MaxTickCostMs is given and the slowest tick took longer.
+ *
+ * UE4Editor-Cmd.exe UOnlineProject -run=UOnlineMatchmaking -ArrivalRate=500 -Duration=1800 -Regions=4 -PlayersPerMatch=8 -MaxPlayers=10
+ */
+UCLASS()
+class UOnlineMatchmakingCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// UCommandlet interface
+	virtual int32 Main(const FString& arg_Params) override;
+
+private:
+	/**
+	* A simulated match.
+	*/
+	struct FSimulatedSession
+	{
+		FSimulatedSession() : NumPlayers(0), EndTime(0.0) {}
+
+		int32 NumPlayers;
+		double EndTime;
+	};
+
+	/**
+	* Runs the simulation from start to end.
+	*/
+	void Simulate();
+
+	/**
+	* Counts the players of a match and how long they waited.
+	*
+	* @param Match: match the queue formed.
+	* @param Now: simulated time in seconds.
+	*/
+	void RecordMatch(const FUOnlineMatch& arg_Match, double arg_Now);
+
+	/**
+	* @returns a skill rating from the simulated population.
+	*/
+	float RollSkill();
+
+	/**
+	* Writes the options and the outcome as JSON.
+	*
+	* @param Filename: file to write to.
+	* @returns true if the file was written.
+	*/
+	bool WriteReport(const FString& arg_Filename) const;
+
+private:
+	FUOnlineMatchmakingOptions MatchmakingOptions;
+
+	// Players per second
+	float ArrivalRate;
+
+	// Simulated seconds
+	float Duration;
+	float TickInterval;
+
+	int32 NumRegions;
+	float SkillMean;
+	float SkillDeviation;
+
+	// Public connections of a session, above PlayersPerMatch leaves room to backfill right away
+	int32 MaxPlayers;
+
+	// Simulated seconds a match lasts
+	float MatchLength;
+
+	// Chance per player and simulated second to leave a running match
+	float LeaveRate;
+
+	// Sessions that can run at the same time, 0 for no limit
+	int32 NumSessions;
+
+	FRandomStream Random;
+
+	TArray<FName> RegionNames;
+	TMap<FName, FSimulatedSession> Sessions;
+	int32 NextSessionNumber;
+
+	int32 NumEnqueued;
+	int32 NumMatched;
+	int32 NumBackfilled;
+	int32 NumTimedOut;
+	int32 NumLeft;
+	int32 NumMatches;
+	int32 NumBackfills;
+	int32 PeakQueued;
+	int32 PeakBuckets;
+
+	// Seconds, per matched player
+	TArray<double> WaitSeconds;
+
+	// Difference between the highest and the lowest skill, per new match
+	TArray<double> SkillSpreads;
+
+	// Wall time of every tick of the queue
+	TArray<double> TickMilliseconds;
+};
@@ -8,28 +8,68 @@
 #include "UnrealNetwork.h"
 #include "Online.h"
 #include "OnlineSubsystemUtils.h"
+#include "UOnlineSessionCache.h"
+#include "UOnlineSessionSearchStream.h"
+#include "UOnlineRequest.h"
+#include "UOnlineRequestQueue.h"
+#include "UOnlineSessionRanking.h"
+#include "UOnlineFriendsCache.h"
+#include "UOnlineSessionRegistry.h"
+#include "UOnlineSessionSettingsTracker.h"
+#include "UOnlineSessionFilter.h"
+#include "UOnlineJoinPipeline.h"
+#include "UOnlineSearchPostProcess.h"
+#include "UOnlineLocalUser.h"
 #include "UOnlineObject.generated.h"
 
+struct FUOnlineWarmupResults;
+
 /**
  * Unreal Online object to handle sessions, identity and friends.
+ *
+ * Session operations go through a request pipeline. Every call returns a request id and reports back through its own completion delegate,
+ * so several searches, creates, joins and destroys can be in flight at once. Operations on the same session name run one after another,
+ * searches run one at a time since the subsystem only supports a single search.
+ * Local users of a split-screen game each have their own friends, session browser query and invite, see FindSessionsForLocalUser.
  */
-UCLASS()
+UCLASS(Config = Game, BlueprintType)
 class UOnlineObject : public UObject
 {
 	GENERATED_UCLASS_BODY()
 
 public:
+	// UObject interface
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+
 	/**
-	* Function to call create session.
+	* Selects the online subsystem every request goes through, e.g. "Null" to run on the local network only.
+	*
+	* @param SubsystemName: name of the subsystem, NAME_None for the default one.
+	*/
+	void SetOnlineSubsystemName(FName arg_SubsystemName);
+
+#if !UE_BUILD_SHIPPING
+	/**
+	* Sends every session call to another session interface than the subsystem's, e.g. a FUOnlineStandInSession for load tests.
+	*
+	* @param SessionInterface: interface to use, nullptr to go back to the subsystem's.
+	*/
+	void SetSessionInterfaceOverride(IOnlineSessionPtr arg_SessionInterface);
+#endif
+
+	/**
+	* Function to call create session. The session is started once it has been created.
 	*
 	* @param UserNetId: user that started the request.
 	* @param SessionName: name of the session.
 	* @param bIsLAN: is this is LAN Game?
 	* @param bIsPresence: is the Session to create a presence session.
 	* @param MaxNumPlayers: number of Maximum allowed players on this session.
-	* @returns true if successful, false otherwise.
+	* @param OnComplete: called when the session has been created and started, or when either failed.
+	* @returns the id of the request, 0 if it could not be queued.
 	*/
-	bool CreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxNumPlayers);
+	int32 CreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxNumPlayers, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
 
 	/**
 	* Joins a session via a search result.
@@ -37,26 +77,356 @@ public:
 	* @param UserNetId: user that started the request.
 	* @param SessionName: name of session.
 	* @param SearchResult: session to join.
-	* @returns true if successful, false otherwise.
+	* @param OnComplete: called when the join has completed.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 JoinSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Joins a session and travels to it as soon as the join succeeded.
+	* A session that was full when it was found is refused without a round trip, a previous session of the same name is left first,
+	* and the connect string comes from the prefetch cache when the session was found recently.
+	*
+	* @param UserNetId: user that joins.
+	* @param PlayerController: player controller that travels.
+	* @param SessionName: name of the session.
+	* @param SearchResult: session to join.
+	* @param OnComplete: called once travel started or the join failed, with the time spent in every stage. Called before returning if the join was refused.
+	* @returns the id of the join, valid for CancelRequest and IsRequestInFlight until OnComplete. 0 if the join was refused or could not be queued.
+	*/
+	int32 JoinSessionAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, const FOnUOnlineJoinComplete& arg_OnComplete = FOnUOnlineJoinComplete());
+
+	/**
+	* Joins a session of a compact result list and travels to it, see above. Only the joined session is rebuilt in full.
+	*
+	* @param SearchResults: sessions found, e.g. from GetCachedSessionResults.
+	* @param ResultIndex: index of the session to join.
 	*/
-	bool JoinSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult);
+	int32 JoinSessionAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FUOnlineSessionResultStore& arg_SearchResults, int32 arg_ResultIndex, const FOnUOnlineJoinComplete& arg_OnComplete = FOnUOnlineJoinComplete());
+
+	/**
+	* Resolves the connect strings of the closest sessions that have room, so a join can travel right away.
+	* Done for every search, only needed for results found some other way.
+	*
+	* @param SearchResults: sessions a player may join.
+	*/
+	void PrefetchConnectStrings(const TArray<FOnlineSessionSearchResult>& arg_SearchResults);
 
 	/**
 	* Find an online session.
+	* Results of a query that is still fresh are served from the cache without contacting the subsystem,
+	* stale results are served right away while a refresh runs in the background.
+	* OnSessionSearchUpdated tells a cached snapshot can be read with GetCachedSessionResults, what the refresh changed follows as a delta.
+	*
+	* @param UserNetId: user that initiated the request.
+	* @param bIsLAN: are we searching LAN matches.
+	* @param bIsPresence: are we searching presence sessions.
+	* @param OnComplete: called with the search results, right away and as the CachedResults snapshot when they are served from the cache.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Find online sessions that meet a filter. Comparisons of advertised settings are sent with the query, so backends that evaluate them
+	* spend the result budget on sessions we can use. The results are checked against every criterion before they are cached and handed out.
 	*
 	* @param UserNetId: user that initiated the request.
 	* @param bIsLAN: are we searching LAN matches.
 	* @param bIsPresence: are we searching presence sessions.
+	* @param Filter: criteria the sessions have to meet.
+	* @param OnComplete: called with the matching sessions, right away and as the CachedResults snapshot when they are served from the cache.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Find online sessions and hand out the results in batches through OnSessionSearchBatch while the query is running.
+	* The search stops early once enough good results were found.
+	*
+	* @param UserNetId: user that initiated the request.
+	* @param bIsLAN: are we searching LAN matches.
+	* @param bIsPresence: are we searching presence sessions.
+	* @param Options: result cap, batching and early termination settings.
+	* @param OnComplete: called when the subsystem has finished the search, remaining batches may still follow.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 FindSessionsStreaming(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionSearchStreamOptions& arg_Options, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Streaming search that only hands out sessions meeting a filter, see FindSessions.
+	* Only matching sessions count towards the good results that stop the search early.
+	*
+	* @param Filter: criteria the sessions have to meet.
+	*/
+	int32 FindSessionsStreaming(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionSearchStreamOptions& arg_Options, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Get the last known sessions of a query without contacting the subsystem.
+	*
+	* @param bIsLAN: LAN matches or not.
+	* @param bIsPresence: presence sessions or not.
+	* @param OutSearchResults: receives the cached sessions.
+	* @returns true if the query has been completed before, false otherwise.
+	*/
+	bool GetCachedSessions(bool arg_bIsLAN, bool arg_bIsPresence, TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const;
+
+	/**
+	* Get the last known sessions of a filtered query without contacting the subsystem.
+	*
+	* @param Filter: criteria the query was made with.
+	*/
+	bool GetCachedSessions(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const;
+
+	/**
+	* Get the last known sessions of a query in compact form, for browsers that sort and filter large lists.
+	* Nothing is copied, the snapshot stays valid after the next search replaced it in the cache.
+	*
+	* @param bIsLAN: LAN matches or not.
+	* @param bIsPresence: presence sessions or not.
+	* @param Filter: criteria the query was made with.
+	* @returns the cached sessions, nullptr if the query has not been completed before.
+	*/
+	TSharedPtr<const FUOnlineSessionResultStore> GetCachedSessionResults(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter = FUOnlineSessionFilter()) const;
+
+	/**
+	* Find online sessions for the session browser of one local user, see FindSessions.
+	* Local users with the same query share a single request and cached snapshot. A query of theirs that is still waiting behind
+	* other searches is cancelled when they search for something else, so one user going through filters doesn't hold up the others.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param bIsLAN: are we searching LAN matches.
+	* @param bIsPresence: are we searching presence sessions.
+	* @param Filter: criteria the sessions have to meet.
+	* @param OnComplete: called with the matching sessions, right away and as the CachedResults snapshot when they are served from the cache.
+	* @returns the id of the request, 0 if the user isn't signed in or the request could not be queued.
+	*/
+	int32 FindSessionsForLocalUser(int32 arg_LocalUserNum, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter = FUOnlineSessionFilter(), const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @returns the cached sessions of the last query of the local user, nullptr if it has not been completed yet.
+	*/
+	TSharedPtr<const FUOnlineSessionResultStore> GetLocalUserSessionResults(int32 arg_LocalUserNum) const;
+
+	/**
+	* Builds the search that FindSessions sends for a query. The online warm-up builds its search with the class default object,
+	* so its results are cached under the same key.
+	*
+	* @param bIsLAN: are we searching LAN matches.
+	* @param bIsPresence: are we searching presence sessions.
+	* @param MaxResults: number of results to ask for, INDEX_NONE to use SessionSearchMaxResults.
+	* @returns the new search.
+	*/
+	TSharedRef<FOnlineSessionSearch> MakeSessionSearch(bool arg_bIsLAN, bool arg_bIsPresence, int32 arg_MaxResults = INDEX_NONE) const;
+
+	/**
+	* Forget all cached search results, the next search of every query goes to the subsystem.
 	*/
-	void FindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence);
+	void InvalidateSessionCache();
+
+	/**
+	* Ranks search results on measured round trip time, fill ratio and map. The hosts are probed in parallel at a limited rate.
+	*
+	* @param SearchResults: sessions to rank, e.g. the SearchResults of a completed search request.
+	* @param Options: probe limits, score weights and shortlist size.
+	* @param OnComplete: called with the shortlist, best session first.
+	*/
+	void RankSessions(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const FUOnlineSessionRankingOptions& arg_Options, const FOnUOnlineSessionRankingComplete& arg_OnComplete);
 
 	/**
 	* Destroy an online session.
 	*
 	* @param SessionName: name of session.
-	* @returns true if successful, false otherwise.
+	* @param OnComplete: called when the session has been destroyed.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 DestroySession(FName arg_SessionName, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Updates the settings of a session that is already created.
+	*
+	* @param SessionName: name of the session.
+	* @param SessionSettings: the new settings.
+	* @param OnComplete: called when the subsystem has updated the session.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 UpdateSession(FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Changes one advertised setting of a session, e.g. the player count or the game state.
+	* Changes are collected and sent in a single update, at most once every SessionUpdateMinInterval seconds per session,
+	* and not at all if they cancel each other out before the update is due.
+	*
+	* @param SessionName: name of the session.
+	* @param Key: setting to change.
+	* @param Value: new value of the setting.
+	* @param AdvertisementType: how the setting is advertised.
+	* @returns true if the setting changed and an update is pending.
+	*/
+	bool SetSessionSetting(FName arg_SessionName, FName arg_Key, const FVariantData& arg_Value, EOnlineDataAdvertisementType::Type arg_AdvertisementType = EOnlineDataAdvertisementType::ViaOnlineService);
+
+	/**
+	* Removes one advertised setting of a session, sent the same way as SetSessionSetting.
+	*
+	* @param SessionName: name of the session.
+	* @param Key: setting to remove.
+	* @returns true if the setting existed and an update is pending.
 	*/
-	bool DestroySession(FName arg_SessionName);
+	bool RemoveSessionSetting(FName arg_SessionName, FName arg_Key);
+
+	/**
+	* Changes the settings of a session in place, e.g. the number of open connections, sent the same way as SetSessionSetting.
+	*
+	* @param SessionName: name of the session.
+	* @param Modifier: called with the settings to change.
+	* @returns true if anything changed and an update is pending.
+	*/
+	bool ModifySessionSettings(FName arg_SessionName, TFunctionRef<void(FOnlineSessionSettings&)> arg_Modifier);
+
+	/**
+	* Gets a session we host ready for the next match without tearing it down. The session is ended, updated only if its settings changed,
+	* and started again, so registered players stay in and it keeps its id. It is only destroyed and created again when the new settings
+	* can't be applied to a live session, e.g. going from LAN to online, when it doesn't exist anymore or when one of the steps fails.
+	*
+	* @param UserNetId: user hosting the session, only used if it has to be created again. May be null on a dedicated server.
+	* @param SessionName: name of the session.
+	* @param SessionSettings: settings for the next match.
+	* @param OnComplete: called when the session has been started again, or when recycling failed.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 RecycleSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Recycles a session for a rematch on another map, keeping every other setting, see above.
+	*
+	* @param Map: map of the next match, NAME_None to keep the current one.
+	*/
+	int32 RecycleSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, FName arg_Map, const FOnUOnlineRequestComplete& arg_OnComplete = FOnUOnlineRequestComplete());
+
+	/**
+	* Hosts many sessions from this process, e.g. to pack several matches into one dedicated server.
+	* The sessions are named Prefix_1 to Prefix_N and are created and started a few per tick, so booting dozens of them doesn't stall a frame.
+	* Hosting a name that failed before retries it, names that are already hosted are left alone.
+	*
+	* @param UserNetId: user hosting the sessions, may be null on a dedicated server.
+	* @param SessionNamePrefix: prefix of the session names.
+	* @param NumSessions: number of sessions to host.
+	* @param SessionSettings: settings every session is created with.
+	* @returns the number of sessions that were queued.
+	*/
+	int32 HostSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionNamePrefix, int32 arg_NumSessions, const FOnlineSessionSettings& arg_SessionSettings);
+
+	/**
+	* Takes the hosted session that has been waiting for a match the longest.
+	*
+	* @returns the name of the session, NAME_None if no session is available.
+	*/
+	FName AcquireHostedSession();
+
+	/**
+	* Hands a hosted session back after its match. The session is recycled in place with RecycleSession and stays registered.
+	* If that fails the session is destroyed and queued to be created again.
+	*
+	* @param SessionName: session to hand back.
+	* @param SessionSettings: settings for the next match, nullptr to keep the current ones.
+	* @returns true if the session is being recycled.
+	*/
+	bool ReleaseHostedSession(FName arg_SessionName, const FOnlineSessionSettings* arg_SessionSettings = nullptr);
+
+	/**
+	* Destroys every hosted session. Sessions that are still being created are destroyed once they are.
+	*/
+	void StopHostingSessions();
+
+	/**
+	* @param SessionName: name of a hosted session.
+	* @returns the hosted session, or nullptr. Only valid until sessions are hosted or stopped.
+	*/
+	const FUOnlineHostedSession* GetHostedSession(FName arg_SessionName) const;
+
+	/**
+	* @param State: state to count.
+	* @returns the number of hosted sessions in the state.
+	*/
+	int32 GetNumHostedSessions(EUOnlineHostedSessionState arg_State) const;
+
+	/**
+	* Reads the friends list of a local user into the friends cache. From then on the cache follows friend and presence events.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @returns true if the read was started or is already running, false otherwise.
+	*/
+	bool ReadFriendsList(int32 arg_LocalUserNum);
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param UserId: user to look up.
+	* @returns true if the user is a cached friend of the local user.
+	*/
+	bool IsFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const;
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param UserId: user to look up.
+	* @returns the cached friend with their presence, or nullptr. Only valid until the friends list changes.
+	*/
+	const FUOnlineFriendEntry* FindFriend(int32 arg_LocalUserNum, const FUniqueNetId& arg_UserId) const;
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @returns an immutable copy of the cached friends, the same copy is returned until the list changes.
+	*/
+	FUOnlineFriendsSnapshotRef GetFriendsSnapshot(int32 arg_LocalUserNum) const;
+
+	/**
+	* @param LocalUserNum: controller number of the local user.
+	* @param OutInvite: receives the session the local user was invited to.
+	* @returns true if the local user accepted an invite that waits for the game, see OnLocalUserInvitePending.
+	*/
+	bool GetPendingInvite(int32 arg_LocalUserNum, FOnlineSessionSearchResult& arg_OutInvite) const;
+
+	/**
+	* Joins the pending invite of a local user as the game session, which takes the other local players out of their current session.
+	* The join travels with the player controller of the local user and is reported through OnJoinAndTravelComplete.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @returns the id of the join, see JoinSessionAndTravel. 0 if there is no pending invite or the join was refused.
+	*/
+	int32 AcceptPendingInvite(int32 arg_LocalUserNum);
+
+	/**
+	* Drops the pending invite of a local user.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	*/
+	void DeclinePendingInvite(int32 arg_LocalUserNum);
+
+	/**
+	* Forgets a local user that left, e.g. when their controller was disconnected: their search, invite and cached friends.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	*/
+	void RemoveLocalUser(int32 arg_LocalUserNum);
+
+	/**
+	* Cancel a request. Queued requests and searches stop right away, other running operations can't be stopped in the subsystem,
+	* their outcome is ignored once it arrives. A join and travel is cancelled at whichever step it is waiting for.
+	*
+	* @param RequestId: id returned when the request was made.
+	* @returns true if the request was found and cancelled, false otherwise.
+	*/
+	bool CancelRequest(int32 arg_RequestId);
+
+	/**
+	* @param RequestId: id returned when the request was made.
+	* @returns true if the request is queued or running.
+	*/
+	bool IsRequestInFlight(int32 arg_RequestId) const;
+
+	/**
+	* @returns the number of queued and running requests.
+	*/
+	int32 GetNumRequestsInFlight() const;
 
 private:
 	/**
@@ -75,6 +445,14 @@ private:
 	*/
 	void OnStartSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful);
 
+	/**
+	* Function fired when a session end request has completed.
+	*
+	* @param SessionName: the name of the session this callback is for.
+	* @param bWasSuccessful: true if the async action completed without error, false if there was an error.
+	*/
+	void OnEndSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful);
+
 	/**
 	* Delegate fired when a session search query has completed.
 	*
@@ -98,6 +476,14 @@ private:
 	*/
 	void OnDestroySessionComplete(FName arg_SessionName, bool arg_bWasSuccessful);
 
+	/**
+	* Delegate fired when updating an online session has completed.
+	*
+	* @param SessionName: the name of the session this callback is for.
+	* @param bWasSuccessful: true if the async action completed without error, false if there was an error.
+	*/
+	void OnUpdateSessionComplete(FName arg_SessionName, bool arg_bWasSuccessful);
+
 	/**
 	 * Delegate used when reading friends list using query.
 	 *
@@ -108,6 +494,37 @@ private:
 	 */
 	void OnReadFriendsListComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FString& arg_FriendsListName, const FString& arg_ErrorString);
 
+	/**
+	* Delegate fired when the friends list of a local user changed in a way the subsystem doesn't describe.
+	*
+	* @param LocalUserNum: the controller number of the user whose list changed.
+	*/
+	void OnFriendsChange(int32 arg_LocalUserNum);
+
+	/**
+	* Delegate fired when a friend was removed.
+	*
+	* @param UserId: local user whose friend was removed.
+	* @param FriendId: the friend that was removed.
+	*/
+	void OnFriendRemoved(const FUniqueNetId& arg_UserId, const FUniqueNetId& arg_FriendId);
+
+	/**
+	* Delegate fired when a friend invite was accepted, which adds a friend.
+	*
+	* @param UserId: local user that got a new friend.
+	* @param FriendId: the new friend.
+	*/
+	void OnFriendInviteAccepted(const FUniqueNetId& arg_UserId, const FUniqueNetId& arg_FriendId);
+
+	/**
+	* Delegate fired when presence of a user was received.
+	*
+	* @param UserId: user the presence belongs to.
+	* @param Presence: the new presence.
+	*/
+	void OnPresenceReceived(const FUniqueNetId& arg_UserId, const TSharedRef<FOnlineUserPresence>& arg_Presence);
+
 	/**
 	 * Called when a user accepts a session invitation. Allows the game code a chance
 	 * to clean up any existing state before accepting the invite. The invite must be
@@ -120,17 +537,478 @@ private:
 	 */
 	void OnSessionUserInviteAccepted(const bool arg_bWasSuccesful, const int32 arg_LocalUserNum, TSharedPtr<const FUniqueNetId> arg_NetId, const FOnlineSessionSearchResult& arg_SessionSearchResult);
 
+	/**
+	* Validates and queues a join that travels on success. A session of the same name is destroyed first, and the join is only
+	* queued once the destroy succeeded.
+	*
+	* @param bCanUsePrivateSlots: the join comes from an invite, so private connections count as room.
+	* @returns the id of the join request, or of the destroy that runs before it, which then stands for the whole join and is kept in JoinTravels.
+	* 0 if the join was refused or could not be queued.
+	*/
+	int32 SubmitJoinAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, APlayerController* arg_PlayerController, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, bool arg_bCanUsePrivateSlots, const FOnUOnlineJoinComplete& arg_OnComplete);
+
+	/**
+	* Queues the join of a join and travel once the session of the same name is gone, or fails it if the destroy failed.
+	*
+	* @param Result: outcome of the destroy request.
+	* @param UserNetId: user that joins.
+	* @param SearchResult: session to join.
+	* @param JoinTravel: the join and its timings.
+	*/
+	void OnJoinAndTravelDestroyComplete(const FUOnlineRequestResult& arg_Result, TSharedPtr<const FUniqueNetId> arg_UserNetId, FOnlineSessionSearchResult arg_SearchResult, TSharedRef<FUOnlineJoinTravel> arg_JoinTravel);
+
+	/**
+	* Queues the join request of a join and travel.
+	*
+	* @returns the id of the join request, 0 if it could not be queued.
+	*/
+	int32 StartJoinAndTravel(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_SearchResult, const TSharedRef<FUOnlineJoinTravel>& arg_JoinTravel);
+
+	/**
+	* Resolves the connect string if it wasn't prefetched and starts travel once the join succeeded.
+	*
+	* @param Result: outcome of the join request.
+	* @param JoinTravel: the join and its timings.
+	*/
+	void OnJoinAndTravelRequestComplete(const FUOnlineRequestResult& arg_Result, TSharedRef<FUOnlineJoinTravel> arg_JoinTravel);
+
+	/**
+	* Records the timings of a join and tells listeners.
+	*/
+	void FinishJoinAndTravel(const TSharedRef<FUOnlineJoinTravel>& arg_JoinTravel);
+
+	/**
+	* @param LocalUserNum: controller number of a local user.
+	* @returns the player controller of the local user in the game world, or nullptr.
+	*/
+	APlayerController* FindLocalPlayerController(int32 arg_LocalUserNum) const;
+
+	/**
+	* @returns the number of local players in the game world.
+	*/
+	int32 GetNumLocalPlayers() const;
+
+	/**
+	* Gets the state of a local user, with the unique net id they are signed in with now.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @returns the state, added if the local user had none yet.
+	*/
+	FUOnlineLocalUserState& FindOrAddLocalUser(int32 arg_LocalUserNum);
+
+	/**
+	* Joins the invite of a local user as the game session, and travels if the local user has a player in the game world.
+	*
+	* @param LocalUserNum: controller number of the local user whose invite is joined.
+	* @returns the id of the join, see JoinSessionAndTravel. 0 if the join was refused or could not be queued.
+	*/
+	int32 JoinLocalUserInvite(int32 arg_LocalUserNum);
+
+	/**
+	* FindSessions on behalf of a local user, or of a caller of FindSessions.
+	*
+	* @param LocalUserNum: local user the search is for, INDEX_NONE for a caller of FindSessions.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 SubmitFindSessions(TSharedPtr<const FUniqueNetId> arg_UserNetId, bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter, const FOnUOnlineRequestComplete& arg_OnComplete, int32 arg_LocalUserNum);
+
+	/**
+	* Cancels a search a local user moved on from if it hasn't started and the user was its only owner.
+	*
+	* @param RequestId: id of the search request.
+	* @param LocalUserNum: local user that moved on.
+	*/
+	void CancelSupersededSearch(int32 arg_RequestId, int32 arg_LocalUserNum);
+
+	/**
+	* @param bIsLAN: LAN matches or not.
+	* @param bIsPresence: presence sessions or not.
+	* @param Filter: criteria of the query.
+	* @returns the key the results of the query are cached with.
+	*/
+	FUOnlineSessionQueryKey MakeSessionQueryKey(bool arg_bIsLAN, bool arg_bIsPresence, const FUOnlineSessionFilter& arg_Filter) const;
+
+	/**
+	* @param Filter: criteria of a search.
+	* @returns the predicate results of the search are checked with, or nullptr if the filter is empty.
+	*/
+	TSharedPtr<const FUOnlineSessionFilterPredicate> MakeSessionFilter(const FUOnlineSessionFilter& arg_Filter) const;
+
+	/**
+	* @returns the session interface override if there is one, else the session interface of the selected online subsystem, or nullptr if there is none.
+	*/
+	IOnlineSessionPtr GetSessionInterface() const;
+
+	/**
+	* Registers the subsystem callbacks once, they are routed to the matching request by session name.
+	*/
+	void BindSessionDelegates();
+
+	/**
+	* Removes the subsystem callbacks registered by BindSessionDelegates.
+	*/
+	void UnbindSessionDelegates();
+
+	/**
+	* Registers the friends and presence callbacks that keep the friends cache up to date.
+	*
+	* @param LocalUserNum: local user to follow friends list changes for.
+	*/
+	void BindFriendsDelegates(int32 arg_LocalUserNum);
+
+	/**
+	* Removes the callbacks registered by BindFriendsDelegates.
+	*/
+	void UnbindFriendsDelegates();
+
+	/**
+	* Queues a create request with settings that are ready to use.
+	*
+	* @param UserNetId: user that hosts the session, may be null for the hosting registry.
+	* @param SessionName: name of the session.
+	* @param SessionSettings: settings of the session, not changed afterwards.
+	* @param OnComplete: called when the session has been created and started, or when either failed.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 SubmitCreateSession(TSharedPtr<const FUniqueNetId> arg_UserNetId, FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete);
+
+	/**
+	* Queues an update request with settings that are ready to use.
+	*
+	* @param SessionName: name of the session.
+	* @param SessionSettings: settings to send, not changed afterwards.
+	* @param OnComplete: called when the subsystem has updated the session.
+	* @returns the id of the request, 0 if it could not be queued.
+	*/
+	int32 SubmitUpdateSession(FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_SessionSettings, const FOnUOnlineRequestComplete& arg_OnComplete);
+
+	/**
+	* Picks the next subsystem call of a recycle request.
+	*
+	* @param Request: the recycle request.
+	* @param bWasSuccessful: outcome of the current call, ignored before the first one.
+	* @returns the next call, None once the request is done.
+	*/
+	EUOnlineRecycleStep GetNextRecycleStep(const FUOnlineRequest& arg_Request, bool arg_bWasSuccessful) const;
+
+	/**
+	* Makes the next subsystem call of a recycle request, or completes it.
+	*
+	* @param Request: the recycle request.
+	* @param bWasSuccessful: outcome of the current call, ignored before the first one.
+	*/
+	void AdvanceRecycleSession(const TSharedRef<FUOnlineRequest>& arg_Request, bool arg_bWasSuccessful);
+
+	/**
+	* Routes a subsystem callback to the recycle request of the session, if it is waiting for it.
+	*
+	* @param SessionName: the name of the session the callback is for.
+	* @param Step: the call that completed.
+	* @param bWasSuccessful: outcome of the call.
+	* @returns true if the callback belonged to a recycle request.
+	*/
+	bool CompleteRecycleStep(FName arg_SessionName, EUOnlineRecycleStep arg_Step, bool arg_bWasSuccessful);
+
+	/**
+	* Starts tracking the settings of a session that exists in the subsystem but was created elsewhere.
+	*
+	* @param SessionName: name of the session.
+	* @returns true if the session is tracked.
+	*/
+	bool TrackSessionSettings(FName arg_SessionName);
+
+	/**
+	* Sends the coalesced settings changes of every session whose update is due.
+	*
+	* @param Now: current time in seconds.
+	*/
+	void PumpSessionUpdates(double arg_Now);
+
+	/**
+	* Applies the outcome of a coalesced update to the settings tracker.
+	*
+	* @param Result: outcome of the request.
+	*/
+	void OnSessionUpdateComplete(const FUOnlineRequestResult& arg_Result);
+
+	/**
+	* Creates queued hosted sessions, a limited number per call.
+	*/
+	void PumpHostedSessions();
+
+	/**
+	* Moves a hosted session on when its create, update or destroy request finished.
+	*
+	* @param Result: outcome of the request.
+	*/
+	void OnHostedSessionRequestComplete(const FUOnlineRequestResult& arg_Result);
+
+	/**
+	* Moves a hosted session to another state and tells listeners.
+	*/
+	void SetHostedSessionState(FUOnlineHostedSession& arg_Session, EUOnlineHostedSessionState arg_State);
+
+	/**
+	* Queues a request and starts it if its lane is free.
+	*
+	* @param Request: request to queue.
+	* @returns the id of the request, 0 if the queue is full.
+	*/
+	int32 SubmitRequest(const TSharedRef<FUOnlineRequest>& arg_Request);
+
+	/**
+	* Starts every queued request that may run now.
+	*/
+	void PumpRequests();
+
+	/**
+	* Hands a request to the subsystem.
+	*
+	* @param Request: request to start.
+	* @returns true if the subsystem accepted it, false otherwise.
+	*/
+	bool StartRequest(const TSharedRef<FUOnlineRequest>& arg_Request);
+
+	/**
+	* Removes a request from the pipeline and tells its listeners, unless it was abandoned before.
+	*
+	* @param Request: request that finished.
+	* @param Status: final status of the request.
+	*/
+	void CompleteRequest(const TSharedRef<FUOnlineRequest>& arg_Request, EUOnlineRequestStatus arg_Status);
+
+	/**
+	* Stops a request that was cancelled or timed out.
+	*
+	* @param Request: request to stop.
+	* @param Status: Cancelled or TimedOut.
+	*/
+	void StopRequest(const TSharedRef<FUOnlineRequest>& arg_Request, EUOnlineRequestStatus arg_Status);
+
+	/**
+	* Calls the completion delegates of a request.
+	*
+	* @param Request: request that finished.
+	*/
+	void NotifyRequestComplete(const FUOnlineRequest& arg_Request) const;
+
+	/**
+	* Makes sure the pipeline ticker runs while there are requests or search streams.
+	*/
+	void EnsureRequestTicker();
+
+	/**
+	* Ticker that handles timeouts and hands out streaming search batches.
+	*
+	* @param DeltaTime: seconds since the last tick.
+	* @returns true to keep ticking, false once the pipeline is idle.
+	*/
+	bool TickRequests(float arg_DeltaTime);
+
+	/**
+	* Hands out the next batch of a streaming search.
+	*
+	* @param Request: search request with a stream.
+	* @param Now: current time in seconds.
+	* @returns true once the final batch was handed out.
+	*/
+	bool TickSearchStream(const TSharedRef<FUOnlineRequest>& arg_Request, double arg_Now);
+
+	/**
+	* Hands the results of a finished search to a worker thread, the request completes once they come back.
+	*
+	* @param Request: search request the subsystem has answered.
+	*/
+	void StartSearchPostProcess(const TSharedRef<FUOnlineRequest>& arg_Request);
+
+	/**
+	* Stores the processed results of a search and completes its request, on the game thread.
+	*
+	* @param PostProcess: the processed results.
+	*/
+	void FinishSearchPostProcess(const TSharedRef<FUOnlineSearchPostProcess, ESPMode::ThreadSafe>& arg_PostProcess);
+
+	/**
+	* Applies the next slice of a friends list that was read, and finishes the read once it's applied.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @returns true once the list is applied.
+	*/
+	bool ApplyFriendsListSlice(int32 arg_LocalUserNum);
+
+	/**
+	* Tells listeners a friends list read is over, and reads again if the list changed meanwhile.
+	*
+	* @param LocalUserNum: controller number of the local user.
+	* @param bWasSuccessful: whether the read succeeded.
+	* @param bHasChanged: whether the cached friends changed.
+	*/
+	void FinishFriendsListRead(int32 arg_LocalUserNum, bool arg_bWasSuccessful, bool arg_bHasChanged);
+
+	/**
+	* Takes the session search and friends list of the online warm-up of FUOnlineModule, if no other object did.
+	* While the warm-up still runs, this waits for it, and searches wait for its search so they aren't sent next to it.
+	*/
+	void ConsumeWarmup();
+
+	/**
+	* Takes the search results of the warm-up and lets the searches that waited for them go, without waiting for the other stages.
+	*/
+	void ConsumeWarmupSearch();
+
+	/**
+	* Caches the sessions the warm-up found, keyed like the search FindSessions would make.
+	*
+	* @param WarmupResults: results of the warm-up.
+	*/
+	void ApplyWarmupSearchResults(const FUOnlineWarmupResults& arg_WarmupResults);
+
+public:
+	// Broadcast with the sessions that changed since the last snapshot of a query, or an empty delta when its snapshot was served from
+	// the cache, see GetCachedSessionResults. Can feed FUOnlineServerBrowser::ApplyDelta directly
+	FOnUOnlineSessionSearchUpdated OnSessionSearchUpdated;
+
+	// Broadcast with every batch of a streaming search
+	FOnUOnlineSessionSearchBatch OnSessionSearchBatch;
+
+	// Broadcast with the local user whose cached friends list changed
+	FOnUOnlineFriendsUpdated OnFriendsUpdated;
+
+	// Broadcast whenever a read of a friends list finished, whether or not anything changed
+	FOnUOnlineFriendsListRead OnFriendsListRead;
+
+	// Broadcast whenever a hosted session changes state
+	FOnUOnlineHostedSessionChanged OnHostedSessionChanged;
+
+	// Broadcast for every join that travels, including joins of accepted invites
+	FOnUOnlineJoinFinished OnJoinAndTravelComplete;
+
+	// Broadcast with the local user whose accepted invite would take the other local players out of their session.
+	// The game asks them and calls AcceptPendingInvite or DeclinePendingInvite
+	FOnUOnlineLocalUserInvite OnLocalUserInvitePending;
+
 private:
-	TSharedPtr<class FOnlineSessionSettings> SessionSettings;
-	TSharedPtr<class FOnlineSessionSearch> SessionSearch;
-	TArray<TSharedRef<FOnlineFriend>> FriendsList;
+	// Number of results a regular search asks for
+	UPROPERTY(Config)
+	int32 SessionSearchMaxResults;
+
+	// Seconds a search result snapshot is served without asking the subsystem again
+	UPROPERTY(Config)
+	float SessionCacheTimeToLive;
+
+	// Maximum number of different queries kept in the cache
+	UPROPERTY(Config)
+	int32 SessionCacheMaxQueries;
+
+	// Seconds before a request times out, 0 to never time out
+	UPROPERTY(Config)
+	float RequestTimeout;
+
+	// Maximum number of requests running at the same time
+	UPROPERTY(Config)
+	int32 MaxActiveRequests;
+
+	// Maximum number of requests waiting to be started, further requests are rejected
+	UPROPERTY(Config)
+	int32 MaxPendingRequests;
+
+	// Maximum number of friends cached per local user
+	UPROPERTY(Config)
+	int32 MaxFriendsPerLocalUser;
+
+	// Online subsystem to use, None for the default one
+	UPROPERTY(Config)
+	FName OnlineSubsystemName;
+
+	// Maximum number of hosted sessions handed to the pipeline per tick
+	UPROPERTY(Config)
+	int32 HostedSessionCreatesPerTick;
+
+	// Minimum number of seconds between two coalesced settings updates of the same session
+	UPROPERTY(Config)
+	float SessionUpdateMinInterval;
+
+	// Sessions hosted by this process
+	FUOnlineSessionRegistry SessionRegistry;
+
+	// Advertised and wanted settings of the sessions we created
+	FUOnlineSessionSettingsTracker SessionSettingsTracker;
+
+	// User hosting the sessions in the registry
+	TSharedPtr<const FUniqueNetId> HostUserNetId;
+
+	// Number of search results whose connect string is resolved ahead of a join
+	UPROPERTY(Config)
+	int32 ConnectStringPrefetchCount;
+
+	// Searches with at least this many results are processed on a worker thread, smaller ones aren't worth the extra frame
+	UPROPERTY(Config)
+	int32 SearchPostProcessMinResults;
+
+	// Maximum number of friends of a read list applied to the cache per tick
+	UPROPERTY(Config)
+	int32 FriendsAppliedPerTick;
+
+#if !UE_BUILD_SHIPPING
+	// Used instead of the subsystem's session interface when set
+	IOnlineSessionPtr SessionInterfaceOverride;
+#endif
+
+	// Last results per query
+	FUOnlineSessionCache SessionCache;
+
+	// Connect strings of recently found sessions
+	FUOnlineConnectStringCache ConnectStringCache;
+
+	// Friends of every local user, indexed by unique net id
+	FUOnlineFriendsCache FriendsCache;
 
+	// Local users with a friends list read in flight, with the time the read started
+	TMap<int32, double> FriendsListReadsInFlight;
+
+	// Local users whose friends list changed during a read and need another one
+	TSet<int32> FriendsListRereads;
+
+	// Local users whose friends list was read and is being applied to the cache
+	TSet<int32> FriendsListsApplying;
+
+	// Search and invite of every local user, by controller number
+	TMap<int32, FUOnlineLocalUserState> LocalUsers;
+
+	// Joins and travels that leave a previous session first, by the id of the destroy that was returned for them
+	TMap<int32, TSharedRef<FUOnlineJoinTravel>> JoinTravels;
+
+	// Queued and running requests
+	FUOnlineRequestQueue RequestQueue;
+
+	// Finished search requests whose stream still has batches to hand out
+	TArray<TSharedRef<FUOnlineRequest>> DrainingSearchRequests;
+
+	// Handle to the ticker of the request pipeline
+	FDelegateHandle RequestTickerHandle;
+
+	// Set while waiting for the online warm-up to complete
+	FDelegateHandle WarmupCompleteDelegateHandle;
+
+	// Set while searches wait for the search of the online warm-up
+	FDelegateHandle WarmupSearchCompleteDelegateHandle;
+
+	// Rankers that are probing hosts, finished ones are dropped when the next ranking starts
+	TArray<TSharedRef<FUOnlineSessionRanker>> SessionRankers;
+
+	// Session interface the delegates are registered with
+	TWeakPtr<IOnlineSession, ESPMode::ThreadSafe> BoundSessionInterface;
+
+private:
 	// Delegate called when session created
 	FOnCreateSessionCompleteDelegate OnCreateSessionCompleteDelegate;
 
-	// Delegate called when session started 
+	// Delegate called when session started
 	FOnStartSessionCompleteDelegate OnStartSessionCompleteDelegate;
 
+	// Delegate called when session ended
+	FOnEndSessionCompleteDelegate OnEndSessionCompleteDelegate;
+
 	// Delegate for searching for sessions
 	FOnFindSessionsCompleteDelegate OnFindSessionsCompleteDelegate;
 
@@ -140,18 +1018,33 @@ private:
 	// Delegate for destroying a session
 	FOnDestroySessionCompleteDelegate OnDestroySessionCompleteDelegate;
 
+	// Delegate for updating a session
+	FOnUpdateSessionCompleteDelegate OnUpdateSessionCompleteDelegate;
+
 	// Delegate for reading friends list using query
 	FOnReadFriendsListComplete OnReadFriendsListCompleteDelegate;
 
 	// Delegate for when an invite is accepted (including rich presence)
 	FOnSessionUserInviteAcceptedDelegate OnSessionUserInviteAcceptedDelegate;
 
+	// Delegate for when a friend was removed
+	FOnFriendRemovedDelegate OnFriendRemovedDelegate;
+
+	// Delegate for when a friend invite was accepted
+	FOnInviteAcceptedDelegate OnFriendInviteAcceptedDelegate;
+
+	// Delegate for when presence of a user was received
+	FOnPresenceReceivedDelegate OnPresenceReceivedDelegate;
+
 	// Handles to registered delegates for creation
 	FDelegateHandle OnCreateSessionCompleteDelegateHandle;
 
 	// Handles to registered delegates for starting
 	FDelegateHandle OnStartSessionCompleteDelegateHandle;
 
+	// Handles to registered delegates for ending
+	FDelegateHandle OnEndSessionCompleteDelegateHandle;
+
 	// Handle to registered delegate for searching a session
 	FDelegateHandle OnFindSessionsCompleteDelegateHandle;
 
@@ -161,6 +1054,25 @@ private:
 	// Handle to registered delegate for destroying a session
 	FDelegateHandle OnDestroySessionCompleteDelegateHandle;
 
+	// Handle to registered delegate for updating a session
+	FDelegateHandle OnUpdateSessionCompleteDelegateHandle;
+
 	// Handles to registered delegates for accepting an invite
 	FDelegateHandle OnSessionUserInviteAcceptedDelegateHandle;
+
+	// Handles to registered delegates for friends list changes, per local user
+	TMap<int32, FDelegateHandle> OnFriendsChangeDelegateHandles;
+
+	// Handle to registered delegate for removed friends
+	FDelegateHandle OnFriendRemovedDelegateHandle;
+
+	// Handle to registered delegate for accepted friend invites
+	FDelegateHandle OnFriendInviteAcceptedDelegateHandle;
+
+	// Handle to registered delegate for received presence
+	FDelegateHandle OnPresenceReceivedDelegateHandle;
+
+	// Friends and presence interfaces the delegates are registered with
+	TWeakPtr<IOnlineFriends, ESPMode::ThreadSafe> BoundFriendsInterface;
+	TWeakPtr<IOnlinePresence, ESPMode::ThreadSafe> BoundPresenceInterface;
 };
@@ -0,0 +1,178 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionCache.h"
+#include "UOnlineSessionSearchStream.h"
+#include "UOnlineSessionFilter.h"
+#include "UOnlineRequest.generated.h"
+
+/**
+ * Kind of operation a request performs on the session interface.
+ */
+UENUM(BlueprintType)
+enum class EUOnlineRequestType : uint8
+{
+	CreateSession,
+	FindSessions,
+	JoinSession,
+	DestroySession,
+	UpdateSession,
+	RecycleSession
+};
+
+/**
+ * Subsystem call a recycle request is waiting for.
+ */
+enum class EUOnlineRecycleStep : uint8
+{
+	None,
+	EndSession,
+	UpdateSession,
+	StartSession,
+	DestroySession,
+	CreateSession
+};
+
+/**
+ * Where a request is in its lifetime.
+ */
+UENUM(BlueprintType)
+enum class EUOnlineRequestStatus : uint8
+{
+	Pending,
+	Running,
+	Succeeded,
+	Failed,
+	Cancelled,
+	TimedOut
+};
+
+/**
+ * Outcome of a request, handed to its completion delegates.
+ */
+struct FUOnlineRequestResult
+{
+	FUOnlineRequestResult()
+		: RequestId(0)
+		, Type(EUOnlineRequestType::CreateSession)
+		, Status(EUOnlineRequestStatus::Failed)
+		, SessionName(NAME_None)
+		, JoinResult(EOnJoinSessionCompleteResult::UnknownError)
+		, SearchResults(nullptr)
+	{
+	}
+
+	bool WasSuccessful() const
+	{
+		return Status == EUOnlineRequestStatus::Succeeded;
+	}
+
+	int32 RequestId;
+	EUOnlineRequestType Type;
+	EUOnlineRequestStatus Status;
+	FName SessionName;
+
+	// Result of the subsystem for join requests
+	EOnJoinSessionCompleteResult::Type JoinResult;
+
+	// Sessions found by a search request, only valid during the completion callback
+	const TArray<FOnlineSessionSearchResult>* SearchResults;
+
+	// Snapshot a search request was answered with from the cache, SearchResults is nullptr then. Rehydrate only the results you read
+	TSharedPtr<const FUOnlineSessionResultStore> CachedResults;
+};
+
+DECLARE_DELEGATE_OneParam(FOnUOnlineRequestComplete, const FUOnlineRequestResult&);
+
+/**
+ * A single operation in the request pipeline of UOnlineObject, holding everything it needs to run on its own.
+ */
+struct FUOnlineRequest
+{
+	static const int32 InvalidId = 0;
+
+	FUOnlineRequest(EUOnlineRequestType arg_Type, FName arg_SessionName)
+		: Id(InvalidId)
+		, Type(arg_Type)
+		, SessionName(arg_SessionName)
+		, Status(EUOnlineRequestStatus::Pending)
+		, EnqueueTime(0.0)
+		, StartTime(0.0)
+		, Timeout(0.f)
+		, bIsAbandoned(false)
+		, AbandonTime(0.0)
+		, bIsStarting(false)
+		, StartSessionTime(0.0)
+		, bIsPostProcessing(false)
+		, RecycleStep(EUOnlineRecycleStep::None)
+		, NumRecycleSteps(0)
+		, RecycleStepTime(0.0)
+		, bIsRecreating(false)
+		, JoinResult(EOnJoinSessionCompleteResult::UnknownError)
+	{
+	}
+
+	/**
+	* Requests in the same lane never run at the same time.
+	* Session operations are serialized per session name, searches share a single lane since the subsystem runs one at a time.
+	*
+	* @returns the lane of this request.
+	*/
+	FName GetLane() const
+	{
+		return Type == EUOnlineRequestType::FindSessions ? NAME_None : SessionName;
+	}
+
+	int32 Id;
+	EUOnlineRequestType Type;
+	FName SessionName;
+	EUOnlineRequestStatus Status;
+
+	double EnqueueTime;
+	double StartTime;
+
+	// Seconds a request may wait to be started, and then run, before it times out. 0 for no timeout
+	float Timeout;
+
+	// Completed towards the caller, but still waiting for the subsystem callback so the lane stays blocked
+	bool bIsAbandoned;
+	double AbandonTime;
+
+	TSharedPtr<const FUniqueNetId> UserNetId;
+
+	// Create, update and recycle: settings of the session, and for creates whether and since when the session is being started
+	TSharedPtr<FOnlineSessionSettings> SessionSettings;
+	bool bIsStarting;
+	double StartSessionTime;
+
+	// Find: the search, the query it was built for, the criteria results are checked against and the stream when results are handed out in batches
+	TSharedPtr<FOnlineSessionSearch> SessionSearch;
+	FUOnlineSessionQueryKey QueryKey;
+	TSharedPtr<const FUOnlineSessionFilterPredicate> SessionFilter;
+	TSharedPtr<FUOnlineSessionSearchStream> SearchStream;
+
+	// Find: snapshot the request was answered with when the cache got fresh while it waited
+	TSharedPtr<const FUOnlineSessionResultStore> CachedResults;
+
+	// Find: the subsystem answered and the results are being processed on a worker thread
+	bool bIsPostProcessing;
+
+	// Find: local users whose session browser shares the search, INDEX_NONE for callers of FindSessions
+	TSet<int32> SearchOwners;
+
+	// Recycle: the subsystem call in flight, how many were made and when the last one began, and whether the session is created again
+	EUOnlineRecycleStep RecycleStep;
+	int32 NumRecycleSteps;
+	double RecycleStepTime;
+	bool bIsRecreating;
+
+	// Join: the session to join and the result of the subsystem
+	FOnlineSessionSearchResult SearchResult;
+	EOnJoinSessionCompleteResult::Type JoinResult;
+
+	TArray<FOnUOnlineRequestComplete> Completions;
+};
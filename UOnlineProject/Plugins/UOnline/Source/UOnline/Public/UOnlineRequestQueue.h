@@ -0,0 +1,122 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UOnlineRequest.h"
+
+/**
+ * Bookkeeping of the request pipeline: ids, a bounded queue of pending requests and the requests that are running.
+ * Requests start in order, as long as nothing else runs in their lane and the number of running requests is below the limit.
+ */
+class FUOnlineRequestQueue
+{
+public:
+	FUOnlineRequestQueue();
+
+	/**
+	* @param MaxActive: number of requests that may run at the same time.
+	* @param MaxPending: number of requests that may wait to be started.
+	*/
+	void SetLimits(int32 arg_MaxActive, int32 arg_MaxPending);
+
+	/**
+	* @returns a new request id that was never handed out before.
+	*/
+	int32 AllocateId();
+
+	/**
+	* Adds a request to the back of the queue.
+	*
+	* @param Request: request to add, receives an id if it has none yet.
+	* @param Now: current time in seconds.
+	* @returns the id of the request, or FUOnlineRequest::InvalidId when the queue is full.
+	*/
+	int32 Enqueue(const TSharedRef<FUOnlineRequest>& arg_Request, double arg_Now);
+
+	/**
+	* Moves every pending request that may start now to the running requests.
+	*
+	* @param Now: current time in seconds.
+	* @param OutRequests: receives the requests to start, in queue order.
+	*/
+	void TakeStartable(double arg_Now, TArray<TSharedRef<FUOnlineRequest>>& arg_OutRequests);
+
+	/**
+	* Finds the running request a subsystem callback belongs to.
+	*
+	* @param Type: type of the request.
+	* @param Lane: lane of the request, see FUOnlineRequest::GetLane.
+	* @returns the request, an abandoned one first, or nullptr if there is none.
+	*/
+	TSharedPtr<FUOnlineRequest> FindActive(EUOnlineRequestType arg_Type, FName arg_Lane) const;
+
+	/**
+	* Checks whether a session callback is the late answer to a request that was dropped after it was abandoned.
+	*
+	* @param Lane: lane of the callback, the session name.
+	* @param Now: current time in seconds.
+	* @returns true if the callback was owed to a dropped request and is to be ignored.
+	*/
+	bool ConsumeStaleCallback(FName arg_Lane, double arg_Now);
+
+	/**
+	* @param RequestId: id of the request.
+	* @returns the pending or running request with this id, or nullptr.
+	*/
+	TSharedPtr<FUOnlineRequest> Find(int32 arg_RequestId) const;
+
+	/**
+	* Finds a request that is not abandoned and matches a predicate.
+	*
+	* @param Predicate: returns true for the request to find.
+	* @returns the first matching pending or running request, or nullptr.
+	*/
+	TSharedPtr<FUOnlineRequest> FindByPredicate(TFunctionRef<bool(const FUOnlineRequest&)> arg_Predicate) const;
+
+	/**
+	* Removes a pending or running request.
+	*
+	* @param RequestId: id of the request.
+	* @returns the removed request or nullptr if there was none.
+	*/
+	TSharedPtr<FUOnlineRequest> Remove(int32 arg_RequestId);
+
+	/**
+	* Collects requests that ran out of time, pending ones since they were enqueued and running ones since they started.
+	* Abandoned requests whose callback never came are dropped after a second timeout.
+	*
+	* @param Now: current time in seconds.
+	* @param OutRequests: receives the requests that timed out, they are still in the queue.
+	*/
+	void CollectTimedOut(double arg_Now, TArray<TSharedRef<FUOnlineRequest>>& arg_OutRequests);
+
+	/**
+	* Keeps the requests of a lane pending, e.g. while something outside the pipeline uses it.
+	*
+	* @param Lane: lane to hold or release.
+	* @param bIsHeld: true to hold the lane, false to release it.
+	*/
+	void SetLaneHeld(FName arg_Lane, bool arg_bIsHeld);
+
+	bool IsEmpty() const { return Pending.Num() == 0 && Active.Num() == 0; }
+	int32 NumPending() const { return Pending.Num(); }
+	int32 NumActive() const { return Active.Num(); }
+
+private:
+	bool IsLaneBusy(FName arg_Lane) const;
+
+private:
+	TArray<TSharedRef<FUOnlineRequest>> Pending;
+	TArray<TSharedRef<FUOnlineRequest>> Active;
+
+	// Lanes whose requests may not start
+	TSet<FName> HeldLanes;
+
+	// Lanes of dropped requests whose callback may still come, with the time it is no longer waited for
+	TArray<TPair<FName, double>> StaleCallbacks;
+
+	int32 NextRequestId;
+	int32 MaxActive;
+	int32 MaxPending;
+};
@@ -0,0 +1,42 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionCache.h"
+#include "UOnlineSessionFilter.h"
+
+/**
+ * The results of a finished search, filtered and turned into a cache snapshot on a worker thread.
+ *
+ * The subsystem is done with the results once it called back, so they are moved in here and the worker owns everything until it hands
+ * the whole thing back to the game thread. The game thread moves the outputs out again, so nothing that isn't thread safe is shared.
+ */
+struct FUOnlineSearchPostProcess
+{
+	FUOnlineSearchPostProcess() : RequestId(0), MaxPrefetchCandidates(0), bLogResults(false), NumFilteredOut(0) {}
+
+	/**
+	* Runs the post processing, on any thread.
+	*/
+	void Run();
+
+	// Inputs
+	int32 RequestId;
+	FUOnlineSessionQueryKey QueryKey;
+	TUniquePtr<FUOnlineSessionFilterPredicate> SessionFilter;
+	FUOnlineSessionFingerprintsPtr PreviousFingerprints;
+	int32 MaxPrefetchCandidates;
+	bool bLogResults;
+
+	// The results, filtered in place
+	TArray<FOnlineSessionSearchResult> SearchResults;
+
+	// Outputs
+	int32 NumFilteredOut;
+	FUOnlineSessionCacheUpdate CacheUpdate;
+
+	// Indices in SearchResults whose connect string is worth resolving
+	TArray<int32> PrefetchCandidates;
+};
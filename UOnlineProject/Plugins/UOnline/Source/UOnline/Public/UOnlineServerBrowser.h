@@ -0,0 +1,205 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionCache.h"
+
+/**
+ * Columns the server browser can be sorted by.
+ */
+enum class EUOnlineServerBrowserSort : uint8
+{
+	Ping,
+	Players,
+	Name,
+
+	Num
+};
+
+/**
+ * A session as shown in the server browser.
+ */
+struct FUOnlineServerBrowserRow
+{
+	FUOnlineServerBrowserRow() : PingInMs(0), NumPlayers(0), MaxPlayers(0), Fingerprint(0) {}
+
+	FString SessionId;
+
+	// Name of the host
+	FString Name;
+
+	FString MapName;
+	int32 PingInMs;
+	int32 NumPlayers;
+	int32 MaxPlayers;
+
+	// Fingerprint of the advertised state, see FUOnlineSessionCache::ComputeFingerprint
+	uint32 Fingerprint;
+
+	// Session to join
+	FOnlineSessionSearchResult SearchResult;
+};
+
+/**
+ * A row changed place in the visible rows.
+ *
+ * @param ViewIndex: position of the row in the visible rows, for a removal the position it had.
+ * @param RowId: id of the row, see FUOnlineServerBrowser::GetRow.
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnUOnlineServerBrowserRowEvent, int32 /*ViewIndex*/, int32 /*RowId*/);
+DECLARE_MULTICAST_DELEGATE(FOnUOnlineServerBrowserViewReset);
+
+typedef TFunction<bool(const FUOnlineServerBrowserRow&)> FUOnlineServerBrowserFilter;
+
+/**
+ * Data model of a server browser, meant to back a virtualized list such as a UListView.
+ *
+ * Rows keep their id for as long as their session is listed. Every sort column has an index that is kept sorted as rows come and go,
+ * so switching the sort is a single pass over an index. The visible rows are the ids of the rows that pass the filter in sort order,
+ * and every insert, removal or update of a visible row is reported with its position, so a list only touches the rows that changed.
+ * Changing the sort or the filter rebuilds the visible rows and reports a reset instead.
+ */
+class FUOnlineServerBrowser
+{
+public:
+	FUOnlineServerBrowser();
+
+	/**
+	* Replaces the rows with a complete list of results, reporting only what changed.
+	*
+	* @param SearchResults: results of a search.
+	*/
+	void Reset(const TArray<FOnlineSessionSearchResult>& arg_SearchResults);
+
+	/**
+	* Applies the changes of a search, e.g. from UOnlineObject::OnSessionSearchUpdated.
+	*
+	* @param SearchDelta: added, changed and removed sessions.
+	*/
+	void ApplyDelta(const FUOnlineSessionSearchDelta& arg_SearchDelta);
+
+	/**
+	* Adds results or updates the rows of sessions that are listed already, e.g. with the batches of a streaming search.
+	*
+	* @param SearchResults: results to add or update.
+	*/
+	void AddOrUpdate(const TArray<FOnlineSessionSearchResult>& arg_SearchResults);
+
+	/**
+	* @param SessionId: id of the session to remove.
+	*/
+	void Remove(const FString& arg_SessionId);
+
+	/**
+	* Removes every row and reports a reset.
+	*/
+	void Empty();
+
+	/**
+	* @param SortBy: column to sort by.
+	* @param bAscending: lowest first if true.
+	*/
+	void SetSort(EUOnlineServerBrowserSort arg_SortBy, bool arg_bAscending);
+
+	/**
+	* @param Filter: rows it returns false for are hidden, an unbound function shows every row.
+	*/
+	void SetFilter(const FUOnlineServerBrowserFilter& arg_Filter);
+
+	/**
+	* Checks every row against the filter again, after what the filter depends on changed.
+	*/
+	void RefreshFilter();
+
+	int32 NumRows() const { return RowIds.Num(); }
+	int32 NumVisible() const { return VisibleRowIds.Num(); }
+
+	// Ids of the visible rows in sort order
+	const TArray<int32>& GetVisibleRowIds() const { return VisibleRowIds; }
+
+	const FUOnlineServerBrowserRow& GetRow(int32 arg_RowId) const { return Rows[arg_RowId]; }
+
+	/**
+	* @param ViewIndex: position in the visible rows.
+	* @returns the row shown at this position.
+	*/
+	const FUOnlineServerBrowserRow& GetVisibleRow(int32 arg_ViewIndex) const { return Rows[VisibleRowIds[arg_ViewIndex]]; }
+
+	/**
+	* @param SessionId: id of a session.
+	* @returns the id of its row, INDEX_NONE if it isn't listed.
+	*/
+	int32 FindRowId(const FString& arg_SessionId) const;
+
+	/**
+	* @param RowId: id of a row.
+	* @returns the position of the row in the visible rows, INDEX_NONE if it's hidden.
+	*/
+	int32 FindViewIndex(int32 arg_RowId) const;
+
+public:
+	FOnUOnlineServerBrowserRowEvent OnRowInserted;
+	FOnUOnlineServerBrowserRowEvent OnRowRemoved;
+	FOnUOnlineServerBrowserRowEvent OnRowUpdated;
+
+	// The visible rows were rebuilt, lists have to be refreshed completely
+	FOnUOnlineServerBrowserViewReset OnViewReset;
+
+private:
+	/**
+	* Strict order of two rows on a column, ascending, ties are broken by row id.
+	*/
+	bool IsBefore(EUOnlineServerBrowserSort arg_SortBy, int32 arg_RowIdA, int32 arg_RowIdB) const;
+
+	/**
+	* Strict order of two rows in the visible rows.
+	*/
+	bool IsBeforeInView(int32 arg_RowIdA, int32 arg_RowIdB) const;
+
+	/**
+	* @returns the first position in a sorted index whose row doesn't come before the row.
+	*/
+	int32 LowerBound(const TArray<int32>& arg_Index, EUOnlineServerBrowserSort arg_SortBy, int32 arg_RowId) const;
+
+	/**
+	* @returns the first position in the visible rows whose row doesn't come before the row.
+	*/
+	int32 LowerBoundInView(int32 arg_RowId) const;
+
+	bool PassesFilter(int32 arg_RowId) const;
+
+	void AddRow(const FOnlineSessionSearchResult& arg_SearchResult);
+	void UpdateRow(int32 arg_RowId, const FOnlineSessionSearchResult& arg_SearchResult);
+	void RemoveRow(int32 arg_RowId);
+
+	void AddToIndices(int32 arg_RowId);
+	void RemoveFromIndices(int32 arg_RowId);
+
+	/**
+	* Fills an empty browser in one go, sorting once instead of inserting row by row.
+	*/
+	void AddRowsInBulk(const TArray<FOnlineSessionSearchResult>& arg_SearchResults);
+
+	void RebuildView();
+
+	static void FillRow(FUOnlineServerBrowserRow& arg_Row, const FOnlineSessionSearchResult& arg_SearchResult);
+
+private:
+	// Rows keep their index for as long as they are listed, which is their id
+	TSparseArray<FUOnlineServerBrowserRow> Rows;
+
+	// Row ids by session id
+	TMap<FString, int32> RowIds;
+
+	// Row ids sorted ascending on every column
+	TArray<int32> SortIndices[static_cast<int32>(EUOnlineServerBrowserSort::Num)];
+
+	TArray<int32> VisibleRowIds;
+
+	EUOnlineServerBrowserSort SortBy;
+	bool bSortAscending;
+
+	FUOnlineServerBrowserFilter Filter;
+};
@@ -0,0 +1,237 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionFilter.h"
+#include "UOnlineSessionResultStore.h"
+
+/**
+ * Identifies a session query by the parameters that influence its results.
+ */
+struct FUOnlineSessionQueryKey
+{
+	FUOnlineSessionQueryKey();
+
+	/**
+	* Builds a key from a search that is about to be sent.
+	*
+	* @param bIsLAN: is this a LAN query.
+	* @param bIsPresence: is this a presence query.
+	* @param SessionSearch: search whose query settings and result cap are copied into the key.
+	* @param ResultFilter: criteria the results are filtered with after the search, nullptr if they aren't.
+	*/
+	FUOnlineSessionQueryKey(bool arg_bIsLAN, bool arg_bIsPresence, const FOnlineSessionSearch& arg_SessionSearch, const FUOnlineSessionFilterPredicate* arg_ResultFilter = nullptr);
+
+	/**
+	* Two keys are the same query if every parameter is equal, the hash only picks the bucket.
+	*/
+	bool operator==(const FUOnlineSessionQueryKey& arg_Other) const;
+
+	friend uint32 GetTypeHash(const FUOnlineSessionQueryKey& arg_Key)
+	{
+		return arg_Key.Hash;
+	}
+
+	struct FQueryParam
+	{
+		FName Key;
+		FVariantData Value;
+		EOnlineComparisonOp::Type ComparisonOp;
+	};
+
+	bool bIsLAN;
+	bool bIsPresence;
+
+	// Every QuerySettings comparison, sorted by key so the order the filters were set in doesn't matter
+	TArray<FQueryParam> QueryParams;
+
+	// The result cap changes what comes back, so it's part of the query
+	int32 MaxSearchResults;
+
+	// So do criteria that are only checked on the results. A copy, keys go to the post processing worker with their request
+	TOptional<FUOnlineSessionFilterPredicate> ResultFilter;
+
+	// Hash of all of the above
+	uint32 Hash;
+};
+
+/**
+ * The sessions that were added, changed or removed since the last snapshot of a query.
+ */
+struct FUOnlineSessionSearchDelta
+{
+	FUOnlineSessionSearchDelta() : bFromCache(false) {}
+	FUOnlineSessionSearchDelta(const FUOnlineSessionQueryKey& arg_Key, bool arg_bFromCache) : Key(arg_Key), bFromCache(arg_bFromCache) {}
+
+	bool HasChanges() const
+	{
+		return Added.Num() > 0 || Changed.Num() > 0 || Removed.Num() > 0;
+	}
+
+	FUOnlineSessionQueryKey Key;
+
+	// Sessions that were not part of the previous snapshot
+	TArray<FOnlineSessionSearchResult> Added;
+
+	// Sessions whose advertised state differs from the previous snapshot
+	TArray<FOnlineSessionSearchResult> Changed;
+
+	// Session ids that are no longer advertised
+	TArray<FString> Removed;
+
+	// True when served from the cache without a subsystem round trip
+	bool bFromCache;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnUOnlineSessionSearchUpdated, const FUOnlineSessionSearchDelta&);
+
+// Fingerprint of every session of a snapshot, keyed by session id. Never changes once built, so it can be handed to other threads
+typedef TSharedPtr<const TMap<FString, uint32>, ESPMode::ThreadSafe> FUOnlineSessionFingerprintsPtr;
+
+/**
+ * A new snapshot of a query and how it differs from the previous one, see FUOnlineSessionCache::BuildUpdate.
+ */
+struct FUOnlineSessionCacheUpdate
+{
+	TSharedPtr<const FUOnlineSessionResultStore> Results;
+	FUOnlineSessionFingerprintsPtr Fingerprints;
+	FUOnlineSessionSearchDelta Delta;
+};
+
+/**
+ * Keeps the last search results per query so repeated searches can be served right away
+ * and refreshes only report what changed. Snapshots are kept in compact form, see FUOnlineSessionResultStore.
+ */
+class FUOnlineSessionCache
+{
+public:
+	FUOnlineSessionCache();
+
+	/**
+	* Sets how long a snapshot is considered fresh.
+	*
+	* @param TimeToLive: lifetime of a snapshot in seconds.
+	*/
+	void SetTimeToLive(double arg_TimeToLive);
+
+	/**
+	* Sets the maximum number of queries kept, the least recently updated one is evicted first.
+	*
+	* @param MaxEntries: number of queries to keep.
+	*/
+	void SetMaxEntries(int32 arg_MaxEntries);
+
+	/**
+	* @param Key: query to look up.
+	* @returns true if a snapshot exists for this query.
+	*/
+	bool Contains(const FUOnlineSessionQueryKey& arg_Key) const;
+
+	/**
+	* @param Key: query to look up.
+	* @param Now: current time in seconds.
+	* @returns true if a snapshot exists and is younger than the time to live.
+	*/
+	bool IsFresh(const FUOnlineSessionQueryKey& arg_Key, double arg_Now) const;
+
+	/**
+	* @param Key: query to look up.
+	* @returns true if a refresh for this query is in flight.
+	*/
+	bool IsRefreshing(const FUOnlineSessionQueryKey& arg_Key) const;
+
+	/**
+	* Flags a query as being refreshed, creating an empty entry if needed.
+	*
+	* @param Key: query that is being refreshed.
+	* @param bIsRefreshing: new state of the refresh.
+	*/
+	void SetRefreshing(const FUOnlineSessionQueryKey& arg_Key, bool arg_bIsRefreshing);
+
+	/**
+	* Stores new results for a query and computes the difference with the previous snapshot.
+	*
+	* @param Key: query the results belong to.
+	* @param Results: complete results returned by the subsystem.
+	* @param Now: current time in seconds.
+	* @param OutDelta: receives the added, changed and removed sessions.
+	*/
+	void Apply(const FUOnlineSessionQueryKey& arg_Key, const TArray<FOnlineSessionSearchResult>& arg_Results, double arg_Now, FUOnlineSessionSearchDelta& arg_OutDelta);
+
+	/**
+	* @param Key: query to look up.
+	* @returns the fingerprints of the current snapshot, nullptr when the query was never completed.
+	*/
+	FUOnlineSessionFingerprintsPtr GetFingerprints(const FUOnlineSessionQueryKey& arg_Key) const;
+
+	/**
+	* Builds the snapshot of new results and the difference with the previous one, the expensive half of Apply.
+	* Doesn't touch the cache, so it can run on a worker thread as long as nothing else uses the results meanwhile.
+	*
+	* @param Key: query the results belong to.
+	* @param Results: complete results returned by the subsystem.
+	* @param PreviousFingerprints: fingerprints of the current snapshot, see GetFingerprints.
+	* @param OutUpdate: receives the snapshot and the delta.
+	*/
+	static void BuildUpdate(const FUOnlineSessionQueryKey& arg_Key, const TArray<FOnlineSessionSearchResult>& arg_Results, const FUOnlineSessionFingerprintsPtr& arg_PreviousFingerprints, FUOnlineSessionCacheUpdate& arg_OutUpdate);
+
+	/**
+	* Stores a snapshot made by BuildUpdate.
+	*
+	* @param Key: query the snapshot belongs to.
+	* @param Update: the snapshot.
+	* @param Now: current time in seconds.
+	*/
+	void Commit(const FUOnlineSessionQueryKey& arg_Key, const FUOnlineSessionCacheUpdate& arg_Update, double arg_Now);
+
+	/**
+	* @param Key: query to look up.
+	* @returns the current snapshot or nullptr when the query was never completed. A snapshot never changes, a refresh replaces it.
+	*/
+	TSharedPtr<const FUOnlineSessionResultStore> GetResults(const FUOnlineSessionQueryKey& arg_Key) const;
+
+	/**
+	* Drops a single query.
+	*
+	* @param Key: query to forget.
+	*/
+	void Invalidate(const FUOnlineSessionQueryKey& arg_Key);
+
+	/**
+	* Drops every query.
+	*/
+	void Empty();
+
+	/**
+	* Hash of the advertised state of a session, pings are left out since they change on every query.
+	*
+	* @param SearchResult: session to hash.
+	* @returns the fingerprint of the session.
+	*/
+	static uint32 ComputeFingerprint(const FOnlineSessionSearchResult& arg_SearchResult);
+
+private:
+	struct FEntry
+	{
+		FEntry() : LastUpdateTime(0.0), bHasResults(false), bIsRefreshing(false) {}
+
+		TSharedPtr<const FUOnlineSessionResultStore> Results;
+
+		// Fingerprint of each session in Results
+		FUOnlineSessionFingerprintsPtr Fingerprints;
+
+		double LastUpdateTime;
+		bool bHasResults;
+		bool bIsRefreshing;
+	};
+
+	void EvictOldest();
+
+private:
+	TMap<FUOnlineSessionQueryKey, FEntry> Entries;
+	double TimeToLive;
+	int32 MaxEntries;
+};
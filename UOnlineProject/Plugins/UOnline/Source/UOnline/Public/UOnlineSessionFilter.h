@@ -0,0 +1,197 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionFilter.generated.h"
+
+/**
+ * How a session setting is compared with the value of a filter.
+ */
+UENUM(BlueprintType)
+enum class EUOnlineSessionFilterOp : uint8
+{
+	Equals,
+	NotEquals,
+	GreaterThan,
+	GreaterThanEquals,
+	LessThan,
+	LessThanEquals
+};
+
+/**
+ * A comparison of one advertised session setting.
+ */
+USTRUCT(BlueprintType)
+struct FUOnlineSessionFilterSetting
+{
+	GENERATED_BODY()
+
+	FUOnlineSessionFilterSetting()
+		: Key(NAME_None)
+		, Op(EUOnlineSessionFilterOp::Equals)
+		, bIsInteger(false)
+		, IntValue(0)
+		, bLocalOnly(false)
+	{
+	}
+
+	// Key of the session setting
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	FName Key;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	EUOnlineSessionFilterOp Op;
+
+	// Compare IntValue if true, StringValue otherwise
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	bool bIsInteger;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	int32 IntValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	FString StringValue;
+
+	// Never sent to the subsystem, for keys the backend can't compare
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	bool bLocalOnly;
+};
+
+/**
+ * Criteria a search result has to meet.
+ *
+ * Comparisons of advertised settings go into the QuerySettings of the search, so backends that evaluate them only return sessions we can use.
+ * Everything is checked again on the results, which covers subsystems that ignore QuerySettings and criteria no backend can evaluate, like ping.
+ *
+ *	FUOnlineSessionFilter Filter = FUOnlineSessionFilter().WithMap(TEXT("Arena")).WithMinOpenSlots(2).Where(SETTING_GAMEMODE, EUOnlineSessionFilterOp::Equals, TEXT("CTF"));
+ */
+USTRUCT(BlueprintType)
+struct FUOnlineSessionFilter
+{
+	GENERATED_BODY()
+
+	FUOnlineSessionFilter()
+		: MapName(NAME_None)
+		, MinOpenSlots(0)
+		, MaxPingInMs(0)
+		, BuildUniqueId(0)
+		, bDedicatedOnly(false)
+	{
+	}
+
+	FUOnlineSessionFilter& WithMap(FName arg_MapName) { MapName = arg_MapName; return *this; }
+	FUOnlineSessionFilter& WithGameMode(const FString& arg_GameMode) { GameMode = arg_GameMode; return *this; }
+	FUOnlineSessionFilter& WithMinOpenSlots(int32 arg_MinOpenSlots) { MinOpenSlots = arg_MinOpenSlots; return *this; }
+	FUOnlineSessionFilter& WithMaxPing(int32 arg_MaxPingInMs) { MaxPingInMs = arg_MaxPingInMs; return *this; }
+	FUOnlineSessionFilter& WithBuildUniqueId(int32 arg_BuildUniqueId) { BuildUniqueId = arg_BuildUniqueId; return *this; }
+	FUOnlineSessionFilter& DedicatedOnly() { bDedicatedOnly = true; return *this; }
+
+	/**
+	* Adds a comparison of an integer setting.
+	*
+	* @param Key: key of the session setting.
+	* @param Op: how the setting is compared with the value.
+	* @param Value: value to compare with.
+	* @param bLocalOnly: only check the results, don't send the comparison to the subsystem.
+	*/
+	FUOnlineSessionFilter& Where(FName arg_Key, EUOnlineSessionFilterOp arg_Op, int32 arg_Value, bool arg_bLocalOnly = false);
+
+	/**
+	* Adds a comparison of a string setting.
+	*/
+	FUOnlineSessionFilter& Where(FName arg_Key, EUOnlineSessionFilterOp arg_Op, const FString& arg_Value, bool arg_bLocalOnly = false);
+	FUOnlineSessionFilter& Where(FName arg_Key, EUOnlineSessionFilterOp arg_Op, const TCHAR* arg_Value, bool arg_bLocalOnly = false) { return Where(arg_Key, arg_Op, FString(arg_Value), arg_bLocalOnly); }
+
+	/**
+	* @returns true if every session passes.
+	*/
+	bool IsEmpty() const;
+
+	/**
+	* Adds the comparisons the subsystem can evaluate to the QuerySettings of a search.
+	*
+	* @param SessionSearch: search that is about to be sent.
+	*/
+	void ApplyToSearch(FOnlineSessionSearch& arg_SessionSearch) const;
+
+	// Map the session has to run, None for any
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	FName MapName;
+
+	// Game mode the session has to run, empty for any
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	FString GameMode;
+
+	// Lowest number of open public connections, 0 for any
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	int32 MinOpenSlots;
+
+	// Highest ping the subsystem reported, 0 for any. Only checked on the results
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	int32 MaxPingInMs;
+
+	// Build the session has to run, 0 for any
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	int32 BuildUniqueId;
+
+	// Only sessions on dedicated servers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	bool bDedicatedOnly;
+
+	// Further comparisons of advertised settings
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UOnline|Search")
+	TArray<FUOnlineSessionFilterSetting> Settings;
+};
+
+/**
+ * A filter turned into a flat list of comparisons with prebuilt values, so checking a result doesn't convert anything.
+ */
+class FUOnlineSessionFilterPredicate
+{
+public:
+	explicit FUOnlineSessionFilterPredicate(const FUOnlineSessionFilter& arg_Filter);
+
+	/**
+	* @param SearchResult: result to check.
+	* @returns true if the result meets every criterion.
+	*/
+	bool Matches(const FOnlineSessionSearchResult& arg_SearchResult) const;
+
+	/**
+	* Removes every result that doesn't match, keeping the order of the others.
+	*
+	* @param SearchResults: results to filter in place.
+	* @returns the number of removed results.
+	*/
+	int32 FilterResults(TArray<FOnlineSessionSearchResult>& arg_SearchResults) const;
+
+	/**
+	* @returns a hash of every criterion, predicates that are equal hash the same.
+	*/
+	uint32 GetHash() const { return Hash; }
+
+	/**
+	* @returns true if both predicates have the same criteria, whatever order they were added in.
+	*/
+	bool operator==(const FUOnlineSessionFilterPredicate& arg_Other) const;
+
+private:
+	struct FComparison
+	{
+		FName Key;
+		FVariantData Value;
+		EUOnlineSessionFilterOp Op;
+	};
+
+	static bool Compare(const FVariantData& arg_SettingValue, const FVariantData& arg_FilterValue, EUOnlineSessionFilterOp arg_Op);
+
+private:
+	TArray<FComparison> Comparisons;
+	int32 MinOpenSlots;
+	int32 MaxPingInMs;
+	int32 BuildUniqueId;
+	bool bDedicatedOnly;
+	uint32 Hash;
+};
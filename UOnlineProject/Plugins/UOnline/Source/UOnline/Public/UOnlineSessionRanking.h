@@ -0,0 +1,152 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+
+/**
+ * How search results are probed and scored.
+ */
+struct FUOnlineSessionRankingOptions
+{
+	FUOnlineSessionRankingOptions()
+		: MaxCandidates(64)
+		, MaxConcurrentProbes(8)
+		, ProbesPerSecond(32.f)
+		, ProbeTimeout(1.f)
+		, MaxAcceptablePingInMs(250)
+		, PingWeight(0.6f)
+		, FillWeight(0.3f)
+		, MapWeight(0.1f)
+		, PreferredMap(NAME_None)
+		, ShortlistSize(5)
+	{
+	}
+
+	// Number of results that get probed, ordered by the ping the subsystem reported. The rest is scored with that ping
+	int32 MaxCandidates;
+
+	// Maximum number of probes in flight at the same time
+	int32 MaxConcurrentProbes;
+
+	// Maximum number of probes started per second
+	float ProbesPerSecond;
+
+	// Seconds to wait for a single probe
+	float ProbeTimeout;
+
+	// Round trip time at which the ping score reaches zero
+	int32 MaxAcceptablePingInMs;
+
+	// Weights of the score components, each component is in the range [0, 1]
+	float PingWeight;
+	float FillWeight;
+	float MapWeight;
+
+	// Map that gets the full map score, NAME_None to ignore the map
+	FName PreferredMap;
+
+	// Number of sessions in the shortlist
+	int32 ShortlistSize;
+};
+
+/**
+ * A search result with its measured latency and score.
+ */
+struct FUOnlineRankedSession
+{
+	FUOnlineRankedSession() : RoundTripInMs(0), bWasProbed(false), FillRatio(0.f), Score(0.f) {}
+
+	FOnlineSessionSearchResult SearchResult;
+
+	// Measured round trip time, or the ping reported by the subsystem if the host couldn't be probed
+	int32 RoundTripInMs;
+	bool bWasProbed;
+
+	// Part of the public connections that is taken
+	float FillRatio;
+
+	float Score;
+};
+
+DECLARE_DELEGATE_OneParam(FOnUOnlineSessionRankingComplete, const TArray<FUOnlineRankedSession>& /*Shortlist*/);
+
+/**
+ * Probes the hosts of search results in parallel and ranks them on round trip time, fill ratio and map.
+ * Probes are ICMP echoes to the address of the resolved connect string, hosts sharing an address are probed once.
+ */
+class FUOnlineSessionRanker : public TSharedFromThis<FUOnlineSessionRanker>
+{
+public:
+	FUOnlineSessionRanker(const TArray<FOnlineSessionSearchResult>& arg_SearchResults, const FUOnlineSessionRankingOptions& arg_Options, const FOnUOnlineSessionRankingComplete& arg_OnComplete);
+	~FUOnlineSessionRanker();
+
+	/**
+	* Resolves the host addresses and starts probing.
+	*
+	* @param SessionInterface: interface used to resolve the connect strings.
+	*/
+	void Start(IOnlineSessionPtr arg_SessionInterface);
+
+	/**
+	* Stops probing without calling the completion delegate.
+	*/
+	void Cancel();
+
+	bool IsComplete() const { return bIsComplete; }
+
+	/**
+	* Scores sessions with the round trip times they already have and sorts them, best first. Full sessions are left out.
+	*
+	* @param Sessions: sessions to score and sort in place.
+	* @param Options: weights and preferred map.
+	*/
+	static void ScoreSessions(TArray<FUOnlineRankedSession>& arg_Sessions, const FUOnlineSessionRankingOptions& arg_Options);
+
+	/**
+	* Takes the host address out of a connect string such as "127.0.0.1:7777".
+	*
+	* @param ConnectString: resolved connect string.
+	* @returns the address without the port.
+	*/
+	static FString GetHostAddress(const FString& arg_ConnectString);
+
+private:
+	struct FProbe
+	{
+		FProbe() : bIsStarted(false) {}
+
+		FString Address;
+
+		// Index of every ranked session hosted on this address
+		TArray<int32> SessionIndices;
+
+		bool bIsStarted;
+	};
+
+	bool Tick(float arg_DeltaTime);
+	void OnProbeComplete(int32 arg_ProbeIndex, bool arg_bWasSuccessful, float arg_RoundTripInSeconds);
+	void Finish();
+
+private:
+	TArray<FUOnlineRankedSession> Sessions;
+	TArray<FProbe> Probes;
+	FUOnlineSessionRankingOptions Options;
+	FOnUOnlineSessionRankingComplete OnComplete;
+
+	FDelegateHandle TickerHandle;
+
+	int32 NextProbeIndex;
+	int32 NumProbesInFlight;
+	int32 NumProbesComplete;
+
+	// Token bucket that limits the probe rate
+	float ProbeTokens;
+
+	// Time after which probes that didn't answer are given up on
+	double Deadline;
+
+	bool bIsComplete;
+};
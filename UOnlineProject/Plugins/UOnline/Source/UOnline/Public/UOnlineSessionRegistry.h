@@ -0,0 +1,122 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionRegistry.generated.h"
+
+/**
+ * Where a hosted session is in its lifetime.
+ */
+UENUM(BlueprintType)
+enum class EUOnlineHostedSessionState : uint8
+{
+	// Waiting for its turn to be created
+	Queued,
+	// Being created and started
+	Creating,
+	// Running and advertised, waiting for a match
+	Available,
+	// Running a match
+	InUse,
+	// Being ended and started again with the settings of the next match
+	Recycling,
+	// Being destroyed
+	Destroying,
+	// Could not be created, hosting it again retries
+	Failed,
+	Num UMETA(Hidden)
+};
+
+/**
+ * A session hosted by this process.
+ */
+struct FUOnlineHostedSession
+{
+	FUOnlineHostedSession(FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_Settings)
+		: SessionName(arg_SessionName)
+		, State(EUOnlineHostedSessionState::Queued)
+		, Settings(arg_Settings)
+		, RequestId(0)
+		, NumMatches(0)
+		, StateTime(0.0)
+		, bRecreateAfterDestroy(false)
+	{
+	}
+
+	FName SessionName;
+	EUOnlineHostedSessionState State;
+
+	// Settings the session was created or last recycled with, replaced as a whole and never changed in place
+	TSharedRef<FOnlineSessionSettings> Settings;
+
+	// Request currently running for this session, 0 if none
+	int32 RequestId;
+
+	// Number of matches hosted in this session so far
+	int32 NumMatches;
+
+	// Time the session entered its current state, in seconds
+	double StateTime;
+
+	// A recycle failed, the session gets created again once it has been destroyed
+	bool bRecreateAfterDestroy;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnUOnlineHostedSessionChanged, FName /*SessionName*/, EUOnlineHostedSessionState /*State*/);
+
+/**
+ * Sessions hosted by one process, indexed by session name, with a count per state so the hosting loop never has to scan.
+ */
+class FUOnlineSessionRegistry
+{
+public:
+	FUOnlineSessionRegistry();
+
+	/**
+	* @param SessionName: name of the new session.
+	* @param Settings: settings to create the session with.
+	* @param Now: current time in seconds.
+	* @returns the new session, or nullptr if the name is taken.
+	*/
+	FUOnlineHostedSession* Add(FName arg_SessionName, const TSharedRef<FOnlineSessionSettings>& arg_Settings, double arg_Now);
+
+	/**
+	* @param SessionName: session to remove.
+	* @returns true if the session was removed.
+	*/
+	bool Remove(FName arg_SessionName);
+
+	FUOnlineHostedSession* Find(FName arg_SessionName);
+	const FUOnlineHostedSession* Find(FName arg_SessionName) const;
+
+	/**
+	* @param State: state to look for.
+	* @returns the session that has been in the state the longest, or nullptr.
+	*/
+	FUOnlineHostedSession* FindOldest(EUOnlineHostedSessionState arg_State);
+
+	/**
+	* Moves a session to another state and keeps the counts up to date.
+	*/
+	void SetState(FUOnlineHostedSession& arg_Session, EUOnlineHostedSessionState arg_State, double arg_Now);
+
+	/**
+	* @param OutSessionNames: receives the names of every session.
+	*/
+	void GetSessionNames(TArray<FName>& arg_OutSessionNames) const;
+
+	int32 Num() const { return Sessions.Num(); }
+	int32 Num(EUOnlineHostedSessionState arg_State) const { return NumByState[static_cast<int32>(arg_State)]; }
+
+	void Empty();
+
+private:
+	TArray<FUOnlineHostedSession> Sessions;
+
+	// Index in Sessions by session name
+	TMap<FName, int32> IndexBySessionName;
+
+	int32 NumByState[static_cast<int32>(EUOnlineHostedSessionState::Num)];
+};
@@ -0,0 +1,152 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+
+/**
+ * Compact copy of a list of search results.
+ *
+ * The fields a server browser sorts and filters on live in one array each, so going over thousands of sessions only touches what it reads.
+ * Strings such as owner and map names and the keys of the advertised settings are interned, every other field is packed per result.
+ * A full FOnlineSessionSearchResult is only rebuilt for the session that is actually joined.
+ */
+class FUOnlineSessionResultStore
+{
+public:
+	FUOnlineSessionResultStore();
+
+	/**
+	* @param NumResults: number of results that are going to be added.
+	*/
+	void Reserve(int32 arg_NumResults);
+
+	/**
+	* Copies a search result into the store.
+	*
+	* @param SearchResult: result to add.
+	* @returns the index of the result.
+	*/
+	int32 Add(const FOnlineSessionSearchResult& arg_SearchResult);
+
+	void Empty();
+
+	int32 Num() const { return PingsInMs.Num(); }
+
+	// Hot fields, indexed like the results
+	const TArray<int32>& GetPingsInMs() const { return PingsInMs; }
+	const TArray<int32>& GetNumOpenSlots() const { return NumOpenSlots; }
+	const TArray<int32>& GetMapIds() const { return MapIds; }
+	const TArray<int32>& GetOwnerNameIds() const { return OwnerNameIds; }
+
+	int32 GetPingInMs(int32 arg_Index) const { return PingsInMs[arg_Index]; }
+	int32 GetNumOpenSlots(int32 arg_Index) const { return NumOpenSlots[arg_Index]; }
+	const FString& GetMapName(int32 arg_Index) const { return GetString(MapIds[arg_Index]); }
+	const FString& GetOwnerName(int32 arg_Index) const { return GetString(OwnerNameIds[arg_Index]); }
+
+	/**
+	* @param StringId: id of an interned string, e.g. a map id.
+	* @returns the string, empty for INDEX_NONE.
+	*/
+	const FString& GetString(int32 arg_StringId) const;
+
+	/**
+	* Looks up an interned string, so results can be compared by id instead of by string.
+	*
+	* @param String: string to look up.
+	* @returns its id, INDEX_NONE if no result uses it.
+	*/
+	int32 FindStringId(const FString& arg_String) const;
+
+	/**
+	* @param Index: index of a result.
+	* @returns the id of the session, empty if it has no session info.
+	*/
+	FString GetSessionId(int32 arg_Index) const;
+
+	/**
+	* @param Index: index of a result.
+	* @param Key: key of the advertised setting.
+	* @param OutData: receives the value of the setting.
+	* @returns true if the session advertises the setting.
+	*/
+	bool GetSetting(int32 arg_Index, FName arg_Key, FVariantData& arg_OutData) const;
+
+	/**
+	* Indices of the results sorted by ping, lowest first.
+	*
+	* @param OutIndices: receives the indices.
+	* @param MinOpenSlots: results with fewer open public connections are left out.
+	*/
+	void GetIndicesByPing(TArray<int32>& arg_OutIndices, int32 arg_MinOpenSlots = 0) const;
+
+	/**
+	* Rebuilds the full search result, e.g. to join it.
+	*
+	* @param Index: index of a result.
+	* @param OutSearchResult: receives the search result.
+	*/
+	void Rehydrate(int32 arg_Index, FOnlineSessionSearchResult& arg_OutSearchResult) const;
+
+	/**
+	* Rebuilds every search result, for code that needs the subsystem types.
+	*
+	* @param OutSearchResults: receives the search results, in store order.
+	*/
+	void RehydrateAll(TArray<FOnlineSessionSearchResult>& arg_OutSearchResults) const;
+
+	/**
+	* @returns the number of bytes allocated by the store.
+	*/
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// Fields that are only read to rebuild a result
+	struct FColdData
+	{
+		TSharedPtr<const FUniqueNetId> OwningUserId;
+		TSharedPtr<FOnlineSessionInfo> SessionInfo;
+		int32 NumPublicConnections;
+		int32 NumPrivateConnections;
+		int32 NumOpenPrivateConnections;
+		int32 BuildUniqueId;
+
+		// One bit per boolean of FOnlineSessionSettings
+		uint16 Flags;
+
+		// Range of the settings of this result in Settings
+		int32 FirstSetting;
+		int32 NumSettings;
+	};
+
+	struct FSetting
+	{
+		// String values are interned and leave Data empty
+		FVariantData Data;
+		int32 StringId;
+		int32 Id;
+		uint16 KeyIndex;
+		uint8 AdvertisementType;
+	};
+
+	int32 InternString(const FString& arg_String);
+	uint16 InternKey(FName arg_Key);
+
+	void GetSettingData(const FSetting& arg_Setting, FVariantData& arg_OutData) const;
+
+private:
+	TArray<int32> PingsInMs;
+	TArray<int32> NumOpenSlots;
+	TArray<int32> MapIds;
+	TArray<int32> OwnerNameIds;
+
+	TArray<FColdData> ColdData;
+	TArray<FSetting> Settings;
+
+	TArray<FName> Keys;
+	TMap<FName, uint16> KeyIndices;
+
+	TArray<FString> Strings;
+	TMap<FString, int32> StringIds;
+};
@@ -0,0 +1,116 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "UOnlineSessionFilter.h"
+
+/**
+ * Options for a search whose results are handed out in batches while the query is running.
+ */
+struct FUOnlineSessionSearchStreamOptions
+{
+	FUOnlineSessionSearchStreamOptions()
+		: MaxResults(200)
+		, BatchSize(16)
+		, BatchInterval(0.1f)
+		, DesiredGoodResults(0)
+		, MaxGoodPingInMs(100)
+		, MinGoodOpenSlots(1)
+	{
+	}
+
+	// Total number of results the subsystem is asked for
+	int32 MaxResults;
+
+	// Maximum number of results handed out per batch
+	int32 BatchSize;
+
+	// Seconds between two batches
+	float BatchInterval;
+
+	// Stop the search once this many good results were found, 0 to always run the search to completion
+	int32 DesiredGoodResults;
+
+	// Highest ping of a good result
+	int32 MaxGoodPingInMs;
+
+	// Lowest number of open public connections of a good result
+	int32 MinGoodOpenSlots;
+};
+
+/**
+ * A batch of results of a streaming search.
+ *
+ * @param RequestId: id of the search request the batch belongs to.
+ * @param SearchResults: results found since the previous batch.
+ * @param bIsFinalBatch: true if the search is over and no more batches follow.
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnUOnlineSessionSearchBatch, int32 /*RequestId*/, const TArray<FOnlineSessionSearchResult>& /*SearchResults*/, bool /*bIsFinalBatch*/);
+
+/**
+ * Tracks how far the results of a running search have been handed out.
+ * Subsystems append to SearchResults as responses arrive, so the stream only has to remember the last index it has seen.
+ */
+class FUOnlineSessionSearchStream
+{
+public:
+	/**
+	* @param SessionSearch: search whose results are handed out.
+	* @param Options: batching and early termination settings.
+	* @param Filter: results that don't match are skipped and don't count as good results, null to hand out every result.
+	*/
+	FUOnlineSessionSearchStream(const TSharedRef<FOnlineSessionSearch>& arg_SessionSearch, const FUOnlineSessionSearchStreamOptions& arg_Options, const TSharedPtr<const FUOnlineSessionFilterPredicate>& arg_Filter = nullptr);
+
+	/**
+	* Takes the next batch of results that have not been handed out yet, at most one every BatchInterval.
+	*
+	* @param Now: current time in seconds.
+	* @param OutBatch: receives at most BatchSize results.
+	* @returns true if a batch was taken, false if it's too early or there was nothing new.
+	*/
+	bool TakeBatch(double arg_Now, TArray<FOnlineSessionSearchResult>& arg_OutBatch);
+
+	/**
+	* Flags the search as finished, remaining results are still handed out by TakeBatch.
+	*
+	* @param bWasCancelled: true if the search was stopped before the subsystem completed it.
+	*/
+	void MarkComplete(bool arg_bWasCancelled);
+
+	/**
+	* @returns true if enough good results were seen to stop searching.
+	*/
+	bool HasEnoughGoodResults() const;
+
+	/**
+	* @returns true if the search is finished and every result has been handed out.
+	*/
+	bool IsDrained() const;
+
+	bool IsComplete() const { return bIsComplete; }
+	bool WasCancelled() const { return bWasCancelled; }
+	const FUOnlineSessionSearchStreamOptions& GetOptions() const { return Options; }
+	const TSharedRef<FOnlineSessionSearch>& GetSessionSearch() const { return SessionSearch; }
+
+private:
+	bool IsGoodResult(const FOnlineSessionSearchResult& arg_SearchResult) const;
+
+private:
+	TSharedRef<FOnlineSessionSearch> SessionSearch;
+	FUOnlineSessionSearchStreamOptions Options;
+	TSharedPtr<const FUOnlineSessionFilterPredicate> Filter;
+
+	// Index of the first result in SearchResults that was not handed out
+	int32 NextResultIndex;
+
+	// Number of handed out results that match the good result criteria
+	int32 NumGoodResults;
+
+	// Earliest time the next batch may be taken
+	double NextBatchTime;
+
+	bool bIsComplete;
+	bool bWasCancelled;
+};
@@ -0,0 +1,134 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+
+/**
+ * Tracks changes to the settings of sessions we host and turns bursts of changes into a single update.
+ *
+ * Every session has the settings the subsystem advertises and the settings we want advertised. Changes only mark keys dirty,
+ * an update is sent at most once per interval and only if the wanted settings still differ from the advertised ones.
+ */
+class FUOnlineSessionSettingsTracker
+{
+public:
+	FUOnlineSessionSettingsTracker();
+
+	/**
+	* @param MinUpdateInterval: minimum number of seconds between two updates of the same session.
+	*/
+	void SetMinUpdateInterval(float arg_MinUpdateInterval);
+
+	/**
+	* Starts tracking a session with the settings the subsystem currently advertises.
+	*
+	* @param SessionName: name of the session.
+	* @param Settings: advertised settings.
+	*/
+	void Track(FName arg_SessionName, const FOnlineSessionSettings& arg_Settings);
+
+	void Untrack(FName arg_SessionName);
+
+	bool IsTracked(FName arg_SessionName) const { return Sessions.Contains(arg_SessionName); }
+
+	/**
+	* Sets a key in the wanted settings.
+	*
+	* @returns true if the key changed.
+	*/
+	bool SetSetting(FName arg_SessionName, FName arg_Key, const FVariantData& arg_Value, EOnlineDataAdvertisementType::Type arg_AdvertisementType);
+
+	/**
+	* Removes a key from the wanted settings.
+	*
+	* @returns true if the key existed.
+	*/
+	bool RemoveSetting(FName arg_SessionName, FName arg_Key);
+
+	/**
+	* Lets the caller change the wanted settings in place, e.g. the number of connections, and finds out what changed.
+	*
+	* @returns true if anything changed.
+	*/
+	bool ModifySettings(FName arg_SessionName, TFunctionRef<void(FOnlineSessionSettings&)> arg_Modifier);
+
+	/**
+	* Replaces both the wanted and the advertised settings, for a full update sent outside the tracker.
+	*/
+	void Reset(FName arg_SessionName, const FOnlineSessionSettings& arg_Settings);
+
+	/**
+	* Collects the sessions whose update is due. Sessions whose changes cancelled each other out are marked clean without an update.
+	*
+	* @param Now: current time in seconds.
+	* @param OutSessionNames: receives the sessions to update.
+	*/
+	void TakeDueUpdates(double arg_Now, TArray<FName>& arg_OutSessionNames);
+
+	/**
+	* Marks an update as sent.
+	*
+	* @returns the settings to send.
+	*/
+	TSharedRef<FOnlineSessionSettings> BeginUpdate(FName arg_SessionName, double arg_Now);
+
+	/**
+	* The subsystem answered an update. A failed update marks its keys dirty again, so they go out with the next one.
+	*/
+	void EndUpdate(FName arg_SessionName, bool arg_bWasSuccessful);
+
+	/**
+	* @returns the wanted settings of a session, or nullptr if it isn't tracked.
+	*/
+	const FOnlineSessionSettings* GetSettings(FName arg_SessionName) const;
+
+	/**
+	* @returns true if any session has changes that haven't been sent.
+	*/
+	bool HasDirtySessions() const;
+
+	/**
+	* @returns true if the settings are the same in everything that gets advertised.
+	*/
+	static bool IsSameSettings(const FOnlineSessionSettings& arg_SettingsA, const FOnlineSessionSettings& arg_SettingsB);
+
+	/**
+	* @param Current: settings the session was created with.
+	* @param New: settings it should have.
+	* @returns true if an update can take the session from one to the other, false if it has to be created again.
+	*/
+	static bool CanUpdateInPlace(const FOnlineSessionSettings& arg_Current, const FOnlineSessionSettings& arg_New);
+
+private:
+	struct FTrackedSession
+	{
+		FTrackedSession() : bAreMembersDirty(false), bAreInFlightMembersDirty(false), bIsUpdateInFlight(false), LastUpdateTime(-DBL_MAX) {}
+
+		bool IsDirty() const { return bAreMembersDirty || DirtyKeys.Num() > 0; }
+
+		// What the subsystem advertises, and what we want it to advertise
+		FOnlineSessionSettings Advertised;
+		FOnlineSessionSettings Wanted;
+
+		// Keys changed since the last update, and whether any of the plain members changed
+		TSet<FName> DirtyKeys;
+		bool bAreMembersDirty;
+
+		// The update that is in flight, applied to Advertised once it succeeds
+		TSharedPtr<FOnlineSessionSettings> InFlight;
+		TSet<FName> InFlightKeys;
+		bool bAreInFlightMembersDirty;
+		bool bIsUpdateInFlight;
+
+		double LastUpdateTime;
+	};
+
+	static bool IsSameSetting(const FOnlineSessionSetting* arg_SettingA, const FOnlineSessionSetting* arg_SettingB);
+	static bool IsSameMembers(const FOnlineSessionSettings& arg_SettingsA, const FOnlineSessionSettings& arg_SettingsB);
+
+private:
+	TMap<FName, FTrackedSession> Sessions;
+	float MinUpdateInterval;
+};
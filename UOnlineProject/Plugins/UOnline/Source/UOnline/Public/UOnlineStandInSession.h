@@ -0,0 +1,296 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Math/RandomStream.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+
+// A development tool, shipping builds only ever talk to the subsystem
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Session interface calls the stand-in simulates.
+ */
+enum class EUOnlineStandInCall : uint8
+{
+	CreateSession,
+	StartSession,
+	UpdateSession,
+	EndSession,
+	DestroySession,
+	FindSessions,
+	JoinSession,
+	RegisterPlayers,
+	UnregisterPlayers,
+
+	Num
+};
+
+/**
+ * How one kind of call behaves.
+ */
+struct FUOnlineStandInCallOptions
+{
+	FUOnlineStandInCallOptions() : MedianLatency(0.05f), LatencySpread(0.5f), MaxLatency(10.f), RefuseRate(0.f), FailureRate(0.f), DropRate(0.f) {}
+
+	// Latency is log-normal around the median, in seconds. The spread is the standard deviation of its logarithm, 0 for a fixed latency
+	float MedianLatency;
+	float LatencySpread;
+	float MaxLatency;
+
+	// Share of calls that return false right away
+	float RefuseRate;
+
+	// Share of calls that call back with a failure
+	float FailureRate;
+
+	// Share of calls that take effect but never call back
+	float DropRate;
+};
+
+/**
+ * Behaviour of FUOnlineStandInSession.
+ */
+struct FUOnlineStandInOptions
+{
+	FUOnlineStandInOptions();
+
+	/**
+	* Reads the options from a command line, e.g. -StandInSessions=5000 -StandInLatency=0.08 -StandInFailureRate=0.02.
+	* Latency, spread and rates apply to every call, -StandInFindSessionsLatency= and the like override a single call.
+	*
+	* @param CommandLine: command line to parse.
+	*/
+	void ParseCommandLine(const TCHAR* arg_CommandLine);
+
+	FUOnlineStandInCallOptions& GetCall(EUOnlineStandInCall arg_Call) { return Calls[static_cast<int32>(arg_Call)]; }
+	const FUOnlineStandInCallOptions& GetCall(EUOnlineStandInCall arg_Call) const { return Calls[static_cast<int32>(arg_Call)]; }
+
+	static const TCHAR* ToString(EUOnlineStandInCall arg_Call);
+
+	// Same seed, same sessions, latencies and faults
+	int32 RandomSeed;
+
+	// Sessions other hosts advertise
+	int32 NumAdvertisedSessions;
+	int32 MaxPlayersPerSession;
+
+	// Share of the advertised sessions whose player count changes between two searches
+	float SessionChurn;
+
+	// Maps the advertised sessions are spread over
+	TArray<FString> MapNames;
+
+	// Failed joins report one of these
+	TArray<EOnJoinSessionCompleteResult::Type> JoinErrors;
+
+	FUOnlineStandInCallOptions Calls[static_cast<int32>(EUOnlineStandInCall::Num)];
+};
+
+/**
+ * Session info of the stand-in, the session id and a made up address.
+ */
+class FUOnlineStandInSessionInfo : public FOnlineSessionInfo
+{
+public:
+	FUOnlineStandInSessionInfo(const FString& arg_SessionId, const FString& arg_HostAddress) : SessionId(arg_SessionId, GetSessionIdType()), HostAddress(arg_HostAddress) {}
+
+	/**
+	* @returns the type of the session ids of the stand-in, tells its session infos apart from those of a subsystem.
+	*/
+	static FName GetSessionIdType();
+
+	// FOnlineSessionInfo interface
+	virtual const uint8* GetBytes() const override { return nullptr; }
+	virtual int32 GetSize() const override { return sizeof(FUOnlineStandInSessionInfo); }
+	virtual bool IsValid() const override { return SessionId.IsValid(); }
+	virtual FString ToString() const override { return SessionId.ToString(); }
+	virtual FString ToDebugString() const override { return FString::Printf(TEXT("SessionId: %s HostAddress: %s"), *SessionId.ToDebugString(), *HostAddress); }
+	virtual const FUniqueNetId& GetSessionId() const override { return SessionId; }
+
+	const FString& GetHostAddress() const { return HostAddress; }
+
+private:
+	FUniqueNetIdString SessionId;
+	FString HostAddress;
+};
+
+/**
+ * Local stand-in for the session interface of a live backend, for load and fault injection tests. Point a UOnlineObject at it with SetSessionInterfaceOverride.
+ *
+ * It advertises thousands of sessions of made up hosts, answers every call after a random latency and fails, refuses or drops calls
+ * at configurable rates. Callbacks never fire before the call returned, they are delivered from the core ticker like a real backend's.
+ * Hosted and joined sessions behave like the Null subsystem's otherwise, and hosted sessions show up in searches.
+ * Only used from the game thread.
+ */
+class FUOnlineStandInSession : public IOnlineSession, public FTickerObjectBase
+{
+public:
+	explicit FUOnlineStandInSession(const FUOnlineStandInOptions& arg_Options);
+	virtual ~FUOnlineStandInSession();
+
+	const FUOnlineStandInOptions& GetOptions() const { return Options; }
+
+	int32 GetNumAdvertisedSessions() const { return AdvertisedSessions.Num(); }
+
+	// Callbacks that are scheduled, and callbacks that were dropped on purpose
+	int32 GetNumPendingCallbacks() const { return PendingCallbacks.Num(); }
+	int32 GetNumDroppedCallbacks() const { return NumDroppedCallbacks; }
+
+	// FTickerObjectBase interface
+	virtual bool Tick(float arg_DeltaTime) override;
+
+	// IOnlineSession interface
+	virtual TSharedPtr<const FUniqueNetId> CreateSessionIdFromString(const FString& arg_SessionIdStr) override;
+	virtual FNamedOnlineSession* GetNamedSession(FName arg_SessionName) override;
+	virtual void RemoveNamedSession(FName arg_SessionName) override;
+	virtual bool HasPresenceSession() override;
+	virtual EOnlineSessionState::Type GetSessionState(FName arg_SessionName) const override;
+	virtual bool CreateSession(int32 arg_HostingPlayerNum, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings) override;
+	virtual bool CreateSession(const FUniqueNetId& arg_HostingPlayerId, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings) override;
+	virtual bool StartSession(FName arg_SessionName) override;
+	virtual bool UpdateSession(FName arg_SessionName, FOnlineSessionSettings& arg_UpdatedSessionSettings, bool arg_bShouldRefreshOnlineData = true) override;
+	virtual bool EndSession(FName arg_SessionName) override;
+	virtual bool DestroySession(FName arg_SessionName, const FOnDestroySessionCompleteDelegate& arg_CompletionDelegate = FOnDestroySessionCompleteDelegate()) override;
+	virtual bool IsPlayerInSession(FName arg_SessionName, const FUniqueNetId& arg_UniqueId) override;
+	virtual bool StartMatchmaking(const TArray<TSharedRef<const FUniqueNetId>>& arg_LocalPlayers, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings, TSharedRef<FOnlineSessionSearch>& arg_SearchSettings) override;
+	virtual bool CancelMatchmaking(int32 arg_SearchingPlayerNum, FName arg_SessionName) override;
+	virtual bool CancelMatchmaking(const FUniqueNetId& arg_SearchingPlayerId, FName arg_SessionName) override;
+	virtual bool FindSessions(int32 arg_SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings) override;
+	virtual bool FindSessions(const FUniqueNetId& arg_SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings) override;
+	virtual bool FindSessionById(const FUniqueNetId& arg_SearchingUserId, const FUniqueNetId& arg_SessionId, const FUniqueNetId& arg_FriendId, const FOnSingleSessionResultCompleteDelegate& arg_CompletionDelegate) override;
+	virtual bool CancelFindSessions() override;
+	virtual bool PingSearchResults(const FOnlineSessionSearchResult& arg_SearchResult) override;
+	virtual bool JoinSession(int32 arg_PlayerNum, FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession) override;
+	virtual bool JoinSession(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession) override;
+	virtual bool FindFriendSession(int32 arg_LocalUserNum, const FUniqueNetId& arg_Friend) override;
+	virtual bool FindFriendSession(const FUniqueNetId& arg_LocalUserId, const FUniqueNetId& arg_Friend) override;
+	virtual bool FindFriendSession(const FUniqueNetId& arg_LocalUserId, const TArray<TSharedRef<const FUniqueNetId>>& arg_FriendList) override;
+	virtual bool SendSessionInviteToFriend(int32 arg_LocalUserNum, FName arg_SessionName, const FUniqueNetId& arg_Friend) override;
+	virtual bool SendSessionInviteToFriend(const FUniqueNetId& arg_LocalUserId, FName arg_SessionName, const FUniqueNetId& arg_Friend) override;
+	virtual bool SendSessionInviteToFriends(int32 arg_LocalUserNum, FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Friends) override;
+	virtual bool SendSessionInviteToFriends(const FUniqueNetId& arg_LocalUserId, FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Friends) override;
+	virtual bool GetResolvedConnectString(FName arg_SessionName, FString& arg_ConnectInfo, FName arg_PortType = NAME_GamePort) override;
+	virtual bool GetResolvedConnectString(const FOnlineSessionSearchResult& arg_SearchResult, FName arg_PortType, FString& arg_ConnectInfo) override;
+	virtual FOnlineSessionSettings* GetSessionSettings(FName arg_SessionName) override;
+	virtual bool RegisterPlayer(FName arg_SessionName, const FUniqueNetId& arg_PlayerId, bool arg_bWasInvited) override;
+	virtual bool RegisterPlayers(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players, bool arg_bWasInvited = false) override;
+	virtual bool UnregisterPlayer(FName arg_SessionName, const FUniqueNetId& arg_PlayerId) override;
+	virtual bool UnregisterPlayers(FName arg_SessionName, const TArray<TSharedRef<const FUniqueNetId>>& arg_Players) override;
+	virtual void RegisterLocalPlayer(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnRegisterLocalPlayerCompleteDelegate& arg_Delegate) override;
+	virtual void UnregisterLocalPlayer(const FUniqueNetId& arg_PlayerId, FName arg_SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& arg_Delegate) override;
+	virtual int32 GetNumSessions() override;
+	virtual void DumpSessionState() override;
+
+protected:
+	// IOnlineSession interface
+	virtual FNamedOnlineSession* AddNamedSession(FName arg_SessionName, const FOnlineSessionSettings& arg_SessionSettings) override;
+	virtual FNamedOnlineSession* AddNamedSession(FName arg_SessionName, const FOnlineSession& arg_Session) override;
+
+private:
+	/**
+	* What happens to a call.
+	*/
+	enum class EOutcome : uint8
+	{
+		Succeed,
+		Fail,
+		Drop,
+		Refuse
+	};
+
+	/**
+	* Applies the effect of a call once its latency passed.
+	*
+	* @param bWasSuccessful: whether the call succeeded.
+	* @param bNotify: false if the callback was dropped, the effect still applies.
+	*/
+	typedef TFunction<void(bool /*bWasSuccessful*/, bool /*bNotify*/)> FCompletion;
+
+	struct FPendingCallback
+	{
+		double DueTime;
+		int32 Id;
+		FCompletion Completion;
+		bool bWasSuccessful;
+		bool bNotify;
+	};
+
+	struct FPendingCallbackOrder
+	{
+		bool operator()(const FPendingCallback& arg_A, const FPendingCallback& arg_B) const
+		{
+			// Calls with the same latency complete in the order they were made
+			return arg_A.DueTime < arg_B.DueTime || (arg_A.DueTime == arg_B.DueTime && arg_A.Id < arg_B.Id);
+		}
+	};
+
+	/**
+	* @returns what happens to the next call of a kind.
+	*/
+	EOutcome RollOutcome(EUOnlineStandInCall arg_Call);
+
+	/**
+	* @returns the latency of the next call of a kind, in seconds.
+	*/
+	double RollLatency(EUOnlineStandInCall arg_Call);
+
+	/**
+	* Completes a call after its latency.
+	*
+	* @returns the id of the callback, to cancel it.
+	*/
+	int32 Schedule(EUOnlineStandInCall arg_Call, EOutcome arg_Outcome, FCompletion&& arg_Completion);
+
+	bool StartCreateSession(TSharedPtr<const FUniqueNetId> arg_HostingPlayerId, FName arg_SessionName, const FOnlineSessionSettings& arg_NewSessionSettings);
+	bool StartFindSessions(const TSharedRef<FOnlineSessionSearch>& arg_SearchSettings);
+	bool StartJoinSession(FName arg_SessionName, const FOnlineSessionSearchResult& arg_DesiredSession);
+
+	/**
+	* Makes up the sessions other hosts advertise.
+	*/
+	void GenerateAdvertisedSessions();
+
+	/**
+	* Changes the player count of some advertised sessions, so consecutive searches differ like they do live.
+	*/
+	void ChurnAdvertisedSessions();
+
+	/**
+	* @returns true if a session meets the equality comparisons of a search, other comparisons are left to the caller.
+	*/
+	static bool MatchesQuery(const FOnlineSession& arg_Session, const FOnlineSearchSettings& arg_QuerySettings);
+
+	/**
+	* @returns the advertised session with the id, or nullptr.
+	*/
+	FOnlineSessionSearchResult* FindAdvertisedSession(const FString& arg_SessionId);
+
+	static bool GetConnectString(const FOnlineSession& arg_Session, FString& arg_OutConnectInfo);
+
+private:
+	FUOnlineStandInOptions Options;
+	FRandomStream Random;
+
+	TArray<FOnlineSessionSearchResult> AdvertisedSessions;
+
+	// Sessions hosted or joined through this interface
+	TArray<FNamedOnlineSession> Sessions;
+
+	// Min-heap on due time
+	TArray<FPendingCallback> PendingCallbacks;
+	int32 NextCallbackId;
+	int32 NumDroppedCallbacks;
+
+	// The search in progress and its callback
+	TSharedPtr<FOnlineSessionSearch> CurrentSearch;
+	int32 CurrentSearchCallbackId;
+
+	int32 NextHostedSessionId;
+};
+
+#endif
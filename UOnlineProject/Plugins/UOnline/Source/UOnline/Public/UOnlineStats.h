@@ -0,0 +1,182 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "UOnlineRequest.h"
+
+// Log and Verbose messages are compiled out of shipping builds, warnings and errors stay
+#if UE_BUILD_SHIPPING
+DECLARE_LOG_CATEGORY_EXTERN(LogUOnline, Warning, Warning);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogUOnline, Log, All);
+#endif
+
+DECLARE_STATS_GROUP(TEXT("UOnline"), STATGROUP_UOnline, STATCAT_Advanced);
+
+/**
+ * Operations that are counted and timed.
+ */
+enum class EUOnlineOperation : uint8
+{
+	CreateSession,
+	StartSession,
+	FindSessions,
+	JoinSession,
+	DestroySession,
+	UpdateSession,
+	RecycleSession,
+	ReadFriendsList,
+	Login,
+	JoinAndTravel,
+	Num
+};
+
+/**
+ * Latency histogram with fixed buckets from 1 ms up to a minute, so recording never allocates.
+ */
+class FUOnlineLatencyHistogram
+{
+public:
+	FUOnlineLatencyHistogram();
+
+	void Add(double arg_Milliseconds);
+	void Reset();
+
+	int32 GetCount() const { return Count; }
+	double GetMin() const { return Count > 0 ? MinMilliseconds : 0.0; }
+	double GetMax() const { return MaxMilliseconds; }
+	double GetMean() const { return Count > 0 ? TotalMilliseconds / Count : 0.0; }
+
+	/**
+	* @param Percentile: percentile in the range [0, 100].
+	* @returns the upper bound of the bucket the percentile falls in, capped by the largest sample.
+	*/
+	double GetPercentile(double arg_Percentile) const;
+
+	static const int32 NumBuckets = 16;
+
+private:
+	// Upper bound of every bucket, the last one takes everything above
+	static const double BucketUpperBounds[NumBuckets];
+
+	int32 BucketCounts[NumBuckets];
+	int32 Count;
+	double TotalMilliseconds;
+	double MinMilliseconds;
+	double MaxMilliseconds;
+};
+
+/**
+ * Exact summary of the raw samples of a commandlet run, by nearest rank. FUOnlineLatencyHistogram is for the game, this is for reports.
+ */
+class FUOnlineSampleSummary
+{
+public:
+	/**
+	* @param Samples: samples in any order, they are copied and sorted.
+	*/
+	explicit FUOnlineSampleSummary(const TArray<double>& arg_Samples);
+
+	int32 GetCount() const { return Sorted.Num(); }
+	double GetMean() const { return Sorted.Num() > 0 ? Total / Sorted.Num() : 0.0; }
+
+	/**
+	* @param Percentile: percentile in the range [0, 100].
+	* @returns the sample at the percentile, nearest rank.
+	*/
+	double GetPercentile(double arg_Percentile) const;
+
+	/**
+	* Writes percentiles into the current object of a JSON report, 0 as Min, 100 as Max and the others as P50, P90 and so on.
+	*
+	* @param Writer: JSON writer of the report.
+	* @param Percentiles: percentiles to write, in the range [0, 100].
+	*/
+	template<typename WriterType>
+	void WritePercentiles(WriterType& arg_Writer, const TArray<double>& arg_Percentiles) const
+	{
+		for (double Percentile : arg_Percentiles)
+		{
+			arg_Writer.WriteValue(GetPercentileName(Percentile), GetPercentile(Percentile));
+		}
+	}
+
+private:
+	static FString GetPercentileName(double arg_Percentile);
+
+private:
+	TArray<double> Sorted;
+	double Total;
+};
+
+/**
+ * Counters and latency histograms per operation, published to the UOnline stat group and the CSV profiler.
+ * Every operation also leaves a named event and a CSV event where it begins and ends, so it can be found in profiler captures.
+ * Only used from the game thread.
+ */
+class FUOnlineStats
+{
+public:
+	static FUOnlineStats& Get();
+
+	/**
+	* @param Type: type of a session request.
+	* @returns the operation a request of this type starts with.
+	*/
+	static EUOnlineOperation GetOperation(EUOnlineRequestType arg_Type);
+
+	static const TCHAR* ToString(EUOnlineOperation arg_Operation);
+
+	/**
+	* An operation was handed to the subsystem.
+	*/
+	void BeginOperation(EUOnlineOperation arg_Operation);
+
+	/**
+	* The subsystem answered an operation, or refused it.
+	*
+	* @param Operation: operation that ended.
+	* @param StartTime: time the operation began, in seconds.
+	* @param bWasSuccessful: whether the subsystem reported success.
+	*/
+	void EndOperation(EUOnlineOperation arg_Operation, double arg_StartTime, bool arg_bWasSuccessful);
+
+	/**
+	* An operation took longer than its timeout. It stays in flight until the subsystem answers.
+	*/
+	void AddTimeout(EUOnlineOperation arg_Operation);
+
+	int32 GetNumInFlight(EUOnlineOperation arg_Operation) const { return Operations[static_cast<int32>(arg_Operation)].NumInFlight; }
+	int32 GetNumSucceeded(EUOnlineOperation arg_Operation) const { return Operations[static_cast<int32>(arg_Operation)].NumSucceeded; }
+	int32 GetNumFailed(EUOnlineOperation arg_Operation) const { return Operations[static_cast<int32>(arg_Operation)].NumFailed; }
+	int32 GetNumTimedOut(EUOnlineOperation arg_Operation) const { return Operations[static_cast<int32>(arg_Operation)].NumTimedOut; }
+	const FUOnlineLatencyHistogram& GetLatency(EUOnlineOperation arg_Operation) const { return Operations[static_cast<int32>(arg_Operation)].Latency; }
+
+	/**
+	* Logs counters and latency percentiles of every operation, also available as the UOnline.DumpStats console command.
+	*/
+	void Dump() const;
+
+	void Reset();
+
+private:
+	FUOnlineStats() {}
+
+	struct FOperationStats
+	{
+		FOperationStats() : NumInFlight(0), NumSucceeded(0), NumFailed(0), NumTimedOut(0) {}
+
+		int32 NumInFlight;
+		int32 NumSucceeded;
+		int32 NumFailed;
+		int32 NumTimedOut;
+		FUOnlineLatencyHistogram Latency;
+	};
+
+	void Publish(EUOnlineOperation arg_Operation, double arg_Milliseconds) const;
+
+private:
+	FOperationStats Operations[static_cast<int32>(EUOnlineOperation::Num)];
+};
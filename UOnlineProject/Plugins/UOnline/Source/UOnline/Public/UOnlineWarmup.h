@@ -0,0 +1,222 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+
+/**
+ * Online work the warm-up does at startup, all of it at the same time.
+ */
+enum class EUOnlineWarmupStage : uint8
+{
+	Login,
+	ReadFriendsList,
+	FindSessions,
+
+	Num
+};
+
+enum class EUOnlineWarmupStageState : uint8
+{
+	Pending,
+	Running,
+	Succeeded,
+	Failed,
+
+	// Turned off, or the subsystem has no such interface
+	Skipped
+};
+
+struct FUOnlineWarmupStageResult
+{
+	FUOnlineWarmupStageResult() : State(EUOnlineWarmupStageState::Pending), StartTime(0.0), EndTime(0.0) {}
+
+	bool IsDone() const { return State != EUOnlineWarmupStageState::Pending && State != EUOnlineWarmupStageState::Running; }
+
+	// In seconds, 0 for a stage that never ran
+	double GetDuration() const { return EndTime > StartTime ? EndTime - StartTime : 0.0; }
+
+	EUOnlineWarmupStageState State;
+	double StartTime;
+	double EndTime;
+};
+
+/**
+ * Read from the [UOnline.Warmup] section of the game ini. -UOnlineWarmup on the command line turns the warm-up on, -NoUOnlineWarmup off.
+ */
+struct FUOnlineWarmupOptions
+{
+	FUOnlineWarmupOptions();
+
+	void LoadConfig();
+
+	bool bEnabled;
+
+	// Subsystem to warm up, NAME_None for the default one
+	FName OnlineSubsystemName;
+
+	int32 LocalUserNum;
+
+	bool bLogin;
+	bool bReadFriendsList;
+	bool bFindSessions;
+
+	// The search UOnlineObject::FindSessions would make with these flags, built by UOnlineObject::MakeSessionSearch
+	bool bIsLANQuery;
+	bool bIsPresenceQuery;
+
+	// Seconds to wait for the subsystem to load, and for each stage to answer
+	float SubsystemWaitTimeout;
+	float StageTimeout;
+};
+
+/**
+ * What the warm-up got, for the first UOnlineObject to take.
+ */
+struct FUOnlineWarmupResults
+{
+	FUOnlineWarmupResults() : LocalUserNum(0), bHasFriendsList(false), bHasSearchResults(false), bIsLANQuery(false), bIsPresenceQuery(false), SearchTime(0.0) {}
+
+	FName OnlineSubsystemName;
+	int32 LocalUserNum;
+
+	// Valid if the user is logged in
+	TSharedPtr<const FUniqueNetId> UserId;
+
+	// The friends list itself stays in the subsystem
+	bool bHasFriendsList;
+
+	bool bHasSearchResults;
+	bool bIsLANQuery;
+	bool bIsPresenceQuery;
+	TArray<FOnlineSessionSearchResult> SearchResults;
+
+	// Time the search completed, in seconds
+	double SearchTime;
+};
+
+/**
+ * Logs in, reads the friends list and searches for sessions as soon as the online subsystem is available, so the main menu
+ * doesn't start empty. The stages don't wait for each other, a friends list that needs the login is read again once it succeeded.
+ * Owned by FUOnlineModule, only used from the game thread.
+ */
+class FUOnlineWarmup : public TSharedFromThis<FUOnlineWarmup>
+{
+public:
+	explicit FUOnlineWarmup(const FUOnlineWarmupOptions& arg_Options);
+	~FUOnlineWarmup();
+
+	/**
+	* Waits for the subsystem on the core ticker, then starts every stage.
+	*/
+	void Start();
+
+	/**
+	* Stops listening to the subsystem, stages that are still running fail.
+	*/
+	void Stop();
+
+	bool IsComplete() const { return bIsComplete; }
+
+	/**
+	* @returns true while the search runs or is still to come, other searches on the subsystem would be refused or mixed up with it.
+	*/
+	bool IsSearching() const { return Options.bFindSessions && !bIsComplete && !GetStage(EUOnlineWarmupStage::FindSessions).IsDone(); }
+
+	const FUOnlineWarmupOptions& GetOptions() const { return Options; }
+
+	const FUOnlineWarmupStageResult& GetStage(EUOnlineWarmupStage arg_Stage) const { return Stages[static_cast<int32>(arg_Stage)]; }
+
+	/**
+	* Hands the results out once, to the first consumer that asks after the warm-up completed.
+	*
+	* @param OutResults: receives the results, without the search results if TakeSearchResults took them.
+	* @returns false if the warm-up isn't complete or the results were taken already.
+	*/
+	bool TakeResults(FUOnlineWarmupResults& arg_OutResults);
+
+	/**
+	* Hands the search results out once, as soon as the search is done, so searches that waited for it don't wait for the other stages.
+	*
+	* @param OutResults: receives the search results and the query they belong to.
+	* @returns false if the search isn't done or its results were taken already.
+	*/
+	bool TakeSearchResults(FUOnlineWarmupResults& arg_OutResults);
+
+	bool AreResultsTaken() const { return bAreResultsTaken; }
+
+	// Broadcast once every stage is done, or the warm-up was stopped
+	FSimpleMulticastDelegate& OnComplete() { return OnCompleteDelegate; }
+
+	// Broadcast once the search is done, the subsystem is free for other searches from then on
+	FSimpleMulticastDelegate& OnSearchComplete() { return OnSearchCompleteDelegate; }
+
+	static const TCHAR* ToString(EUOnlineWarmupStage arg_Stage);
+
+private:
+	bool Tick(float arg_DeltaTime);
+
+	/**
+	* Starts every enabled stage, the subsystem is there.
+	*/
+	void StartStages();
+
+	void StartLogin();
+	void StartReadFriendsList();
+	void StartFindSessions();
+
+	void BeginStage(EUOnlineWarmupStage arg_Stage);
+
+	/**
+	* Records the outcome of a stage and completes the warm-up when it was the last one.
+	*/
+	void EndStage(EUOnlineWarmupStage arg_Stage, EUOnlineWarmupStageState arg_State);
+
+	/**
+	* Tells the consumers once every stage is done.
+	*/
+	void CompleteIfDone();
+
+	void OnLoginComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FUniqueNetId& arg_UserId, const FString& arg_Error);
+	void OnReadFriendsListComplete(int32 arg_LocalUserNum, bool arg_bWasSuccessful, const FString& arg_ListName, const FString& arg_ErrorString);
+	void OnFindSessionsComplete(bool arg_bWasSuccessful);
+
+	/**
+	* Stops the search in the subsystem, so it doesn't refuse or answer the searches that waited for it.
+	*/
+	void CancelFindSessions();
+
+	/**
+	* Removes every callback from the subsystem.
+	*/
+	void UnbindDelegates();
+
+private:
+	FUOnlineWarmupOptions Options;
+
+	FUOnlineWarmupStageResult Stages[static_cast<int32>(EUOnlineWarmupStage::Num)];
+
+	double StartTime;
+	bool bIsComplete;
+	bool bAreResultsTaken;
+	bool bAreSearchResultsTaken;
+
+	// The subsystem was there and the stages were started
+	bool bHasStartedStages;
+	bool bIsStartingStages;
+
+	// The friends read was refused before the login completed, read again once it did
+	bool bReadFriendsAfterLogin;
+
+	TSharedPtr<FOnlineSessionSearch> SessionSearch;
+	FUOnlineWarmupResults Results;
+
+	FDelegateHandle TickerHandle;
+	FDelegateHandle OnLoginCompleteDelegateHandle;
+	FDelegateHandle OnFindSessionsCompleteDelegateHandle;
+
+	FSimpleMulticastDelegate OnCompleteDelegate;
+	FSimpleMulticastDelegate OnSearchCompleteDelegate;
+};
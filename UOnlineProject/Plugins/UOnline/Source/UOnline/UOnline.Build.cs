@@ -39,7 +39,10 @@ public class UOnline : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"Slate",
-				"SlateCore"
+				"SlateCore",
+				"Icmp",
+				"Sockets",
+				"Json"
             }
 			);
 		
@@ -47,7 +50,8 @@ public class UOnline : ModuleRules
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
-                "OnlineSubsystemSteam"
+                "OnlineSubsystemSteam",
+                "OnlineSubsystemNull"
             }
 			);
 	}